@@ -15,11 +15,24 @@
 #include <furi_hal_spi_types.h>
 
 #include <cli/cli.h>
+#include <storage/storage.h>
 
 #include "views/terminal_view.h"
+#include "flipper_spi_terminal_record.h"
+#include "flipper_spi_terminal_sequence.h"
+#include "flipper_spi_terminal_sim.h"
+#include "flipper_spi_terminal_trigger.h"
+#include "flipper_spi_terminal_tx.h"
+#include "toolbox/cycle_clock.h"
+#include "toolbox/latency_histogram.h"
+#include "toolbox/page_cache.h"
+#include "toolbox/spsc_ring.h"
+#include "toolbox/timestamp_index.h"
 
 typedef enum {
-    FlipperSPITerminalEventReceivedData
+    FlipperSPITerminalEventReceivedData,
+    FlipperSPITerminalEventTriggerChanged,
+    FlipperSPITerminalEventViewerClosed, // No capture file was selected
 } FlipperSPITerminalEvent;
 
 typedef struct {
@@ -31,10 +44,25 @@ typedef enum {
     TerminalBufferBehaviourKeep
 } TerminalBufferBehaviour;
 
+typedef enum {
+    TerminalIngestModeStream, // ISR copies every DMA half into rx_buffer_ring
+    TerminalIngestModeDirect, // ISR only publishes a write index, the view reads the DMA buffer
+} TerminalIngestMode;
+
+typedef enum {
+    TerminalFramingModeOff,
+    TerminalFramingModeChipSelect, // Every CS deassertion ends a transaction
+} TerminalFramingMode;
+
 typedef struct {
     TerminalDisplayMode display_mode;
     TerminalBufferBehaviour terminal_buffer_behaviour;
+    size_t capture_buffer_size; // 0 => all free memory
+    TerminalIngestMode ingest_mode;
     size_t rx_dma_buffer_size;
+    uint32_t refresh_interval_ms;
+    TerminalFramingMode framing_mode;
+    size_t record_buffer_size; // 0 => not recorded
     LL_SPI_InitTypeDef spi;
     FlipperSPITerminalAppConfigDebug debug;
 } FlipperSPITerminalAppConfig;
@@ -46,15 +74,105 @@ typedef struct {
     const char* help_string;
 } FlipperSPITerminalAppScreenConfig;
 
+typedef struct {
+    bool enabled;
+    LatencyHistogram rx; // DMA half/full callback to rx_buffer_ring
+    LatencyHistogram append; // rx_buffer_ring to terminal view
+    LatencyHistogram draw; // Rendering of the terminal view
+} FlipperSPITerminalAppTerminalProfile;
+
+// Per session counters of the receive path. Written from the DMA ISR.
+typedef struct {
+    volatile uint32_t bytes_received;
+    volatile uint32_t bytes_dropped; // rx_buffer_ring was full
+    volatile uint32_t dma_half_events;
+    volatile uint32_t dma_full_events;
+    volatile uint32_t dma_flush_events; // Partial halves, delivered on a idle bus
+    volatile uint32_t transfer_errors;
+    volatile uint32_t transactions; // CS deassertions
+    uint32_t sequence_runs;
+    uint32_t sequence_failures; // Runs with a failed expect or a bus error
+} FlipperSPITerminalAppTerminalStats;
+
+// CS transaction timing in CPU cycles. Written by the GUI thread from the timestamp index.
+typedef struct {
+    uint64_t start; // Start of the current transaction, 0 => unknown
+    uint64_t end; // End of the last transaction, 0 => unknown
+    uint32_t last_gap;
+    uint32_t last_burst;
+    LatencyHistogram gap; // End of a transaction to the start of the next one
+    LatencyHistogram burst; // Start to end of a transaction
+} FlipperSPITerminalAppTerminalTiming;
+
 typedef struct {
     TerminalView* view;
     bool is_active;
 
     uint8_t* rx_dma_buffer;
-    FuriStreamBuffer* rx_buffer_stream;
-    FuriTimer* recv_timer;
+    size_t rx_dma_half_size; // Bytes. rx_dma_buffer_size, but at least one frame
+    size_t frame_size; // Bytes per SPI frame. 2 for data widths above 8 bit.
+    // Index handoff for TerminalIngestModeDirect. Both counters are byte counts since the start of
+    // the DMA transfer. Only the ISR writes rx_dma_write_count, only the GUI thread reads it.
+    volatile uint32_t rx_dma_write_count;
+    uint32_t rx_dma_read_count;
+    size_t rx_dma_position; // Offset in rx_dma_buffer up to which data was delivered. ISR only.
+    size_t rx_dma_idle_position; // DMA position at the last flush timer tick
+    uint32_t rx_dma_idle_ticks; // Flush timer ticks, the DMA did not move. Timer only.
+    volatile bool rx_dma_running; // The flush timer may be armed. Set by start_capture.
+    volatile bool rx_dma_flush_requested;
+    volatile bool rx_dma_transaction_started; // CS was asserted, handled with the next flush
+    volatile bool rx_dma_transaction_ended; // CS was deasserted, handled with the next flush
+    volatile uint32_t cs_start_cycles; // DWT cycle counter at the last CS assertion
+    volatile uint32_t cs_end_cycles; // DWT cycle counter at the last CS deassertion
+    // rx_dma_write_count at the end of a stopped trigger capture. Set by the DMA ISR.
+    volatile uint32_t rx_dma_capture_end;
+    FuriTimer* flush_timer;
+    SpscRing* rx_buffer_ring; // Only written by the DMA ISR, read by the GUI thread
+    // Debug data and the simulated DMA. Moved to rx_buffer_ring by the DMA ISR, so the ring keeps
+    // a single producer. The threads, which inject, hold inject_lock.
+    SpscRing* inject_ring;
+    FuriMutex* inject_lock;
+    // Transaction ends as uint32_t. In the ingest mode Stream, they are positions in
+    // rx_buffer_ring. In Direct, they are values of rx_dma_write_count.
+    SpscRing* transaction_ring;
+    CycleClock clock;
+    TimestampIndex* timestamps; // Delivered chunks and CS edges. Written by the DMA ISR.
+    FuriThread* notify_thread; // Sends FlipperSPITerminalEventReceivedData
+    atomic_bool event_pending; // A event was sent, but not processed by the GUI thread yet
+
+    // Checked by the DMA ISR. Only replaced by the GUI thread, while the Terminal Screen is
+    // active.
+    FlipperSPITerminalTrigger* volatile trigger;
+    FlipperSPITerminalTrigger* _Atomic trigger_pending; // Replaces trigger, NULL => none
+    bool trigger_trimmed; // The stopped capture was cut to the trigger window
+
+    // Recording to the SD card. Only used by the GUI thread, NULL => off.
+    FlipperSPITerminalRecord* record;
+    bool record_failed; // Recording is configured, but the staging buffer or the file failed
+    uint32_t record_dropped; // stats.bytes_dropped, when the recording was checked last
+    volatile bool record_idle; // The bus is idle, the staged data can be written. Timer only.
+
+    FlipperSPITerminalTx* tx; // Only running in master mode
+    FlipperSPITerminalSequence* sequence; // Loaded with the CLI, NULL => none
+    // Copy of the received data for a running sequence. Written by the DMA ISR, NULL => off.
+    SpscRing* volatile rx_tap;
+    volatile uint32_t rx_tap_dropped;
+    FlipperSPITerminalSim* sim;
+    FlipperSPITerminalAppTerminalProfile profile;
+    FlipperSPITerminalAppTerminalStats stats;
+    FlipperSPITerminalAppTerminalTiming timing;
 } FlipperSPITerminalAppScreenTerminal;
 
+// Offline viewer of a capture file. Only the pages around the visible rows are kept in memory.
+typedef struct {
+    TerminalView* view;
+    FuriString* path; // Last selected file, the file browser starts there
+    Storage* storage;
+    File* file;
+    CaptureFileReader* reader; // NULL => no file open
+    PageCache pages;
+} FlipperSPITerminalAppScreenViewer;
+
 typedef struct {
     Gui* gui;
     ViewDispatcher* view_dispatcher;
@@ -66,5 +184,6 @@ typedef struct {
     DialogEx* main_screen;
     FlipperSPITerminalAppScreenConfig config_screen;
     FlipperSPITerminalAppScreenTerminal terminal_screen;
+    FlipperSPITerminalAppScreenViewer viewer_screen;
     TextBox* about_screen;
 } FlipperSPITerminalApp;
@@ -0,0 +1,335 @@
+#include "flipper_spi_terminal_bench.h"
+#include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_config.h"
+#include "toolbox/byte_scan.h"
+
+#include <furi_hal_cortex.h>
+
+// Simulated bus speeds. The last one is the maximum slave speed of the STM32WB55.
+static const uint32_t flipper_spi_terminal_bench_bit_rates[] = {
+    8000,
+    64000,
+    256000,
+    1000000,
+    4000000,
+    8000000,
+    16000000,
+    24000000,
+};
+
+// Bus speed and chunk size used while comparing the display modes
+#define SPI_TERM_BENCH_DISPLAY_MODE_BIT_RATE   1000000
+#define SPI_TERM_BENCH_DISPLAY_MODE_CHUNK_SIZE 64
+
+typedef struct {
+    FlipperSPITerminalSimStats sim;
+    uint32_t elapsed_ms;
+} FlipperSPITerminalBenchResult;
+
+static void
+    flipper_spi_terminal_bench_reset_profile(FlipperSPITerminalAppTerminalProfile* profile) {
+    latency_histogram_reset(&profile->rx);
+    latency_histogram_reset(&profile->append);
+    latency_histogram_reset(&profile->draw);
+}
+
+static bool flipper_spi_terminal_bench_step(
+    FlipperSPITerminalApp* app,
+    uint32_t bit_rate,
+    size_t chunk_size,
+    uint32_t duration_ms,
+    FlipperSPITerminalBenchResult* result) {
+    FlipperSPITerminalAppTerminalProfile* profile = &app->terminal_screen.profile;
+
+    flipper_spi_terminal_bench_reset_profile(profile);
+    profile->enabled = true;
+
+    bool interrupted = false;
+    const uint32_t start = furi_get_tick();
+    flipper_spi_terminal_sim_start(app->terminal_screen.sim, bit_rate, chunk_size);
+    while(furi_get_tick() - start < furi_ms_to_ticks(duration_ms)) {
+        if(cli_cmd_interrupt_received(app->cli)) {
+            interrupted = true;
+            break;
+        }
+        furi_delay_ms(10);
+    }
+    flipper_spi_terminal_sim_stop(app->terminal_screen.sim);
+    const uint32_t elapsed = furi_get_tick() - start;
+
+    profile->enabled = false;
+
+    flipper_spi_terminal_sim_get_stats(app->terminal_screen.sim, &result->sim);
+    result->elapsed_ms = (uint64_t)elapsed * 1000 / furi_kernel_get_tick_frequency();
+    if(result->elapsed_ms == 0) {
+        result->elapsed_ms = 1;
+    }
+
+    return !interrupted;
+}
+
+static void flipper_spi_terminal_bench_print_histogram(
+    const char* name,
+    const LatencyHistogram* histogram) {
+    printf(
+        " %s p50/p90/p99/max: %lu/%lu/%lu/%lu",
+        name,
+        latency_histogram_percentile(histogram, 50),
+        latency_histogram_percentile(histogram, 90),
+        latency_histogram_percentile(histogram, 99),
+        histogram->max);
+}
+
+static bool
+    flipper_spi_terminal_bench_run_throughput(FlipperSPITerminalApp* app, uint32_t step_ms) {
+    printf("=== Throughput (latencies in CPU cycles) ===\n");
+
+    FlipperSPITerminalBenchResult result;
+    for(size_t i = 0; i < COUNT_OF(spi_config_rx_dma_buffer_size_values); i++) {
+        const size_t chunk_size = spi_config_rx_dma_buffer_size_values[i];
+
+        for(size_t j = 0; j < COUNT_OF(flipper_spi_terminal_bench_bit_rates); j++) {
+            const uint32_t bit_rate = flipper_spi_terminal_bench_bit_rates[j];
+
+            if(!flipper_spi_terminal_bench_step(app, bit_rate, chunk_size, step_ms, &result)) {
+                return false;
+            }
+
+            const uint64_t lost = result.sim.bytes_generated - result.sim.bytes_accepted;
+            printf(
+                "DMA %3zu B @ %8lu bit/s: generated %lu B/s, sustained %lu B/s, lost %lu B;",
+                chunk_size,
+                bit_rate,
+                (uint32_t)(result.sim.bytes_generated * 1000 / result.elapsed_ms),
+                (uint32_t)(result.sim.bytes_accepted * 1000 / result.elapsed_ms),
+                (uint32_t)lost);
+            flipper_spi_terminal_bench_print_histogram("isr", &app->terminal_screen.profile.rx);
+            flipper_spi_terminal_bench_print_histogram(
+                "view", &app->terminal_screen.profile.append);
+            printf("\n");
+        }
+    }
+
+    return true;
+}
+
+static bool
+    flipper_spi_terminal_bench_run_display_modes(FlipperSPITerminalApp* app, uint32_t step_ms) {
+    printf(
+        "=== Display modes (DMA %u B @ %u bit/s, latencies in CPU cycles) ===\n",
+        SPI_TERM_BENCH_DISPLAY_MODE_CHUNK_SIZE,
+        SPI_TERM_BENCH_DISPLAY_MODE_BIT_RATE);
+
+    bool completed = true;
+    FlipperSPITerminalBenchResult result;
+    terminal_view_set_draw_profile(
+        app->terminal_screen.view, &app->terminal_screen.profile.draw);
+    for(size_t i = 0; i < COUNT_OF(spi_config_display_mode_values); i++) {
+        terminal_view_set_display_mode(
+            app->terminal_screen.view, spi_config_display_mode_values[i]);
+
+        if(!flipper_spi_terminal_bench_step(
+               app,
+               SPI_TERM_BENCH_DISPLAY_MODE_BIT_RATE,
+               SPI_TERM_BENCH_DISPLAY_MODE_CHUNK_SIZE,
+               step_ms,
+               &result)) {
+            completed = false;
+            break;
+        }
+
+        printf(
+            "%-6s: %lu redraws;",
+            spi_config_display_mode_strings[i],
+            app->terminal_screen.profile.draw.count);
+        flipper_spi_terminal_bench_print_histogram("draw", &app->terminal_screen.profile.draw);
+        printf("\n");
+    }
+    terminal_view_set_draw_profile(app->terminal_screen.view, NULL);
+    terminal_view_set_display_mode(app->terminal_screen.view, app->config.display_mode);
+
+    return completed;
+}
+
+#define SPI_TERM_BENCH_RING_SIZE   4096
+#define SPI_TERM_BENCH_RING_PASSES 16
+#define SPI_TERM_BENCH_RING_CHUNK  1024
+#define SPI_TERM_BENCH_RING_CHUNKS (SPI_TERM_BENCH_RING_SIZE / SPI_TERM_BENCH_RING_CHUNK)
+
+// Byte access of the terminal buffer before it was moved to SpscRing: pointer wrap with a signed
+// modulo for every byte.
+static inline uint8_t
+    flipper_spi_terminal_bench_legacy_get(uint8_t* buffer, uint8_t* start, size_t offset) {
+    int pos = (start + offset) - buffer;
+    int offset_from_start_of_buffer = pos % SPI_TERM_BENCH_RING_SIZE;
+    return buffer[offset_from_start_of_buffer];
+}
+
+static void flipper_spi_terminal_bench_run_ring(void) {
+    printf("=== Ring buffer access (CPU cycles per 100 bytes) ===\n");
+
+    uint8_t* buffer = malloc(SPI_TERM_BENCH_RING_SIZE);
+    SpscRing ring;
+    spsc_ring_init(&ring, buffer, SPI_TERM_BENCH_RING_SIZE);
+    // Fill the ring and move the oldest byte into the middle, so every access has to wrap
+    spsc_ring_commit(&ring, SPI_TERM_BENCH_RING_SIZE / 2);
+    spsc_ring_consume(&ring, SPI_TERM_BENCH_RING_SIZE / 2);
+    spsc_ring_commit(&ring, SPI_TERM_BENCH_RING_SIZE);
+
+    const size_t bytes = SPI_TERM_BENCH_RING_SIZE * SPI_TERM_BENCH_RING_PASSES;
+    volatile uint8_t sink = 0;
+    uint32_t start;
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_RING_PASSES; pass++) {
+        for(size_t i = 0; i < SPI_TERM_BENCH_RING_SIZE; i++) {
+            sink += flipper_spi_terminal_bench_legacy_get(
+                buffer, buffer + SPI_TERM_BENCH_RING_SIZE / 2, i);
+        }
+    }
+    const uint32_t legacy = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_RING_PASSES; pass++) {
+        for(size_t i = 0; i < SPI_TERM_BENCH_RING_SIZE; i++) {
+            sink += spsc_ring_get(&ring, i);
+        }
+    }
+    const uint32_t masked = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_RING_PASSES; pass++) {
+        SpscRingSpan spans[2];
+        spsc_ring_peek_span(&ring, 0, SPI_TERM_BENCH_RING_SIZE, spans);
+        for(size_t j = 0; j < COUNT_OF(spans); j++) {
+            for(size_t i = 0; i < spans[j].length; i++) {
+                sink += spans[j].data[i];
+            }
+        }
+    }
+    const uint32_t spans = DWT->CYCCNT - start;
+
+    // Same size split into chunks, like the capture buffer of the terminal view
+    ChunkArena arena = {0};
+    chunk_arena_alloc(&arena, SPI_TERM_BENCH_RING_CHUNK, SPI_TERM_BENCH_RING_CHUNKS);
+    spsc_ring_init_chunked(&ring, arena.chunks, arena.chunk_count, arena.chunk_size);
+    spsc_ring_commit(&ring, SPI_TERM_BENCH_RING_SIZE / 2);
+    spsc_ring_consume(&ring, SPI_TERM_BENCH_RING_SIZE / 2);
+    spsc_ring_commit(&ring, SPI_TERM_BENCH_RING_SIZE);
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_RING_PASSES; pass++) {
+        for(size_t i = 0; i < SPI_TERM_BENCH_RING_SIZE; i++) {
+            sink += spsc_ring_get(&ring, i);
+        }
+    }
+    const uint32_t chunked = DWT->CYCCNT - start;
+    UNUSED(sink);
+
+    printf("Modulo pointer wrap: %lu\n", (uint32_t)((uint64_t)legacy * 100 / bytes));
+    printf("Masked index: %lu\n", (uint32_t)((uint64_t)masked * 100 / bytes));
+    printf("Spans: %lu\n", (uint32_t)((uint64_t)spans * 100 / bytes));
+    printf("Chunked index: %lu\n", (uint32_t)((uint64_t)chunked * 100 / bytes));
+
+    chunk_arena_free(&arena);
+    free(buffer);
+}
+
+#define SPI_TERM_BENCH_SCAN_SIZE   4096
+#define SPI_TERM_BENCH_SCAN_PASSES 16
+
+static uint32_t flipper_spi_terminal_bench_per_100_bytes(uint32_t cycles) {
+    return (uint64_t)cycles * 100 / (SPI_TERM_BENCH_SCAN_SIZE * SPI_TERM_BENCH_SCAN_PASSES);
+}
+
+static void flipper_spi_terminal_bench_run_byte_scan(void) {
+    printf("=== Byte scanning (CPU cycles per 100 bytes, loop/word) ===\n");
+
+    // Idle bus: Everything is FF, except the last byte
+    uint8_t* a = malloc(SPI_TERM_BENCH_SCAN_SIZE);
+    uint8_t* b = malloc(SPI_TERM_BENCH_SCAN_SIZE);
+    memset(a, 0xFF, SPI_TERM_BENCH_SCAN_SIZE);
+    memset(b, 0xFF, SPI_TERM_BENCH_SCAN_SIZE);
+    a[SPI_TERM_BENCH_SCAN_SIZE - 1] = 0x00;
+
+    volatile size_t sink = 0;
+    uint32_t start;
+    uint32_t loop;
+    uint32_t word;
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        size_t i = 0;
+        while(i < SPI_TERM_BENCH_SCAN_SIZE && a[i] == 0xFF) {
+            i++;
+        }
+        sink += i;
+    }
+    loop = DWT->CYCCNT - start;
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        sink += byte_scan_find_not(a, SPI_TERM_BENCH_SCAN_SIZE, 0xFF);
+    }
+    word = DWT->CYCCNT - start;
+    printf(
+        "Find not: %lu/%lu\n",
+        flipper_spi_terminal_bench_per_100_bytes(loop),
+        flipper_spi_terminal_bench_per_100_bytes(word));
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        size_t count = 0;
+        for(size_t i = 0; i < SPI_TERM_BENCH_SCAN_SIZE; i++) {
+            count += a[i] == 0xFF;
+        }
+        sink += count;
+    }
+    loop = DWT->CYCCNT - start;
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        sink += byte_scan_count(a, SPI_TERM_BENCH_SCAN_SIZE, 0xFF);
+    }
+    word = DWT->CYCCNT - start;
+    printf(
+        "Count: %lu/%lu\n",
+        flipper_spi_terminal_bench_per_100_bytes(loop),
+        flipper_spi_terminal_bench_per_100_bytes(word));
+
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        size_t i = 0;
+        while(i < SPI_TERM_BENCH_SCAN_SIZE && a[i] == b[i]) {
+            i++;
+        }
+        sink += i;
+    }
+    loop = DWT->CYCCNT - start;
+    start = DWT->CYCCNT;
+    for(size_t pass = 0; pass < SPI_TERM_BENCH_SCAN_PASSES; pass++) {
+        sink += byte_scan_match_length(a, b, SPI_TERM_BENCH_SCAN_SIZE);
+    }
+    word = DWT->CYCCNT - start;
+    printf(
+        "Compare: %lu/%lu\n",
+        flipper_spi_terminal_bench_per_100_bytes(loop),
+        flipper_spi_terminal_bench_per_100_bytes(word));
+    UNUSED(sink);
+
+    free(b);
+    free(a);
+}
+
+void flipper_spi_terminal_bench_run(FlipperSPITerminalApp* app, uint32_t step_duration_ms) {
+    furi_check(app);
+    furi_check(step_duration_ms > 0);
+
+    flipper_spi_terminal_bench_run_ring();
+    flipper_spi_terminal_bench_run_byte_scan();
+
+    if(!flipper_spi_terminal_bench_run_throughput(app, step_duration_ms) ||
+       !flipper_spi_terminal_bench_run_display_modes(app, step_duration_ms)) {
+        printf("Benchmark interrupted!\n");
+    }
+
+    terminal_view_reset(app->terminal_screen.view);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "flipper_spi_terminal_app.h"
+
+// Drives the capture pipeline with the simulated DMA source and prints throughput, lost bytes and
+// per stage latencies for every DMA RX Buffer size, a set of bus speeds and every display mode.
+void flipper_spi_terminal_bench_run(FlipperSPITerminalApp* app, uint32_t step_duration_ms);
@@ -1,7 +1,18 @@
 #include "flipper_spi_terminal_cli.h"
 #include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_dump.h"
+#include "flipper_spi_terminal_bench.h"
+#include "flipper_spi_terminal_emu.h"
+#include "flipper_spi_terminal_flash.h"
+#include "flipper_spi_terminal_stream.h"
+#include "scenes/scenes.h"
+#include "toolbox/hex_string.h"
+#include <furi_hal_cortex.h>
+#include <storage/storage.h>
 #include <toolbox/args.h>
 
+#include <stdlib.h>
+
 struct FlipperSpiTerminalCliCommand {
     const char* name;
     const char* format;
@@ -138,12 +149,17 @@ void flipper_spi_terminal_cli_command_debug_terminal_data(
         }
 
         const char* str = furi_string_get_cstr(data);
-        const size_t length = furi_string_size(data);
-        furi_stream_buffer_send(
-            app->terminal_screen.rx_buffer_stream, str, length, FuriWaitForever);
+        size_t length = furi_string_size(data);
+        while(length > 0) {
+            size_t sent = flipper_spi_terminal_scene_terminal_inject(app, str, length);
+            str += sent;
+            length -= sent;
 
-        view_dispatcher_send_custom_event(
-            app->view_dispatcher, FlipperSPITerminalEventReceivedData);
+            if(length > 0) {
+                // Wait for the terminal to make some room
+                furi_delay_ms(10);
+            }
+        }
     } else {
         printf("Non on terminal screen!");
     }
@@ -164,3 +180,630 @@ void flipper_spi_terminal_cli_command_debug_data(FlipperSPITerminalApp* app, Fur
         printf("Can not set test data while terminal is active!");
     }
 }
+
+void flipper_spi_terminal_cli_command_debug_sim(
+    FlipperSPITerminalApp* app,
+    FuriString* args,
+    bool start) {
+    furi_check(app);
+
+    if(!app->terminal_screen.is_active) {
+        printf("Non on terminal screen!");
+        return;
+    }
+
+    if(!start) {
+        flipper_spi_terminal_sim_stop(app->terminal_screen.sim);
+        return;
+    }
+
+    int bit_rate;
+    if(!args_read_int_and_trim(args, &bit_rate) || bit_rate < 8) {
+        printf("Invalid bit rate!");
+        return;
+    }
+
+    int chunk_size;
+    if(!args_read_int_and_trim(args, &chunk_size)) {
+        chunk_size = app->config.rx_dma_buffer_size;
+    } else if(chunk_size < 1) {
+        printf("Invalid chunk size!");
+        return;
+    }
+
+    flipper_spi_terminal_sim_start(app->terminal_screen.sim, bit_rate, chunk_size);
+}
+
+void flipper_spi_terminal_cli_command_debug_bench(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    if(!app->terminal_screen.is_active) {
+        printf("Non on terminal screen!");
+        return;
+    }
+
+    int step_duration;
+    if(!args_read_int_and_trim(args, &step_duration)) {
+        step_duration = 250;
+    } else if(step_duration < 1) {
+        printf("Invalid duration!");
+        return;
+    }
+
+    flipper_spi_terminal_bench_run(app, step_duration);
+}
+
+static void
+    flipper_spi_terminal_cli_print_timing(const char* name, const LatencyHistogram* histogram) {
+    const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+
+    printf(
+        "%s: n=%lu p50=%lu us p99=%lu us max=%lu us\n",
+        name,
+        histogram->count,
+        latency_histogram_percentile(histogram, 50) / cycles_per_us,
+        latency_histogram_percentile(histogram, 99) / cycles_per_us,
+        histogram->max / cycles_per_us);
+}
+
+void flipper_spi_terminal_cli_command_print_stats(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    const FlipperSPITerminalAppTerminalStats* stats = &app->terminal_screen.stats;
+
+    printf("Terminal active: %s\n", app->terminal_screen.is_active ? "yes" : "no");
+    printf("Bytes received: %lu\n", stats->bytes_received);
+    printf("Bytes dropped: %lu\n", stats->bytes_dropped);
+    printf("DMA half transfer events: %lu\n", stats->dma_half_events);
+    printf("DMA transfer complete events: %lu\n", stats->dma_full_events);
+    printf("DMA idle flushes: %lu\n", stats->dma_flush_events);
+    printf("DMA transfer errors: %lu\n", stats->transfer_errors);
+    printf("CS transactions: %lu\n", stats->transactions);
+    printf("Sequence runs: %lu\n", stats->sequence_runs);
+    printf("Failed sequence runs: %lu\n", stats->sequence_failures);
+    flipper_spi_terminal_cli_print_timing("CS gap", &app->terminal_screen.timing.gap);
+    flipper_spi_terminal_cli_print_timing("CS burst", &app->terminal_screen.timing.burst);
+
+    FlipperSPITerminalTxStats tx_stats;
+    flipper_spi_terminal_tx_get_stats(app->terminal_screen.tx, &tx_stats);
+    printf("Bytes sent: %lu\n", tx_stats.bytes_sent);
+    printf("TX DMA transfers: %lu\n", tx_stats.transfers);
+    printf("TX DMA transfer errors: %lu\n", tx_stats.errors);
+
+    if(stats->bytes_dropped > 0 || stats->transfer_errors > 0) {
+        printf("Capture is incomplete!\n");
+    }
+}
+
+void flipper_spi_terminal_cli_command_stream_capture(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    if(!app->terminal_screen.is_active) {
+        printf("Non on terminal screen!");
+        return;
+    }
+
+    // Everything between these two lines is framed binary data
+    printf("Streaming, press Ctrl+C to stop\n");
+    FlipperSPITerminalStreamStats stats;
+    if(!flipper_spi_terminal_stream_run(app, &stats)) {
+        printf("A sequence is running!");
+        return;
+    }
+    printf(
+        "\nSent %lu bytes in %lu frames and %lu writes, %lu bytes dropped in %lu overruns\n",
+        stats.bytes_sent,
+        stats.frames,
+        stats.writes,
+        stats.bytes_dropped,
+        stats.overruns);
+}
+
+void flipper_spi_terminal_cli_command_transmit(
+    FlipperSPITerminalApp* app,
+    FuriString* args,
+    bool repeat) {
+    furi_check(app);
+
+    if(!flipper_spi_terminal_tx_is_running(app->terminal_screen.tx)) {
+        printf("Sending needs the terminal screen in master mode!");
+        return;
+    }
+
+    uint8_t data[256];
+    int length = hex_string_decode(furi_string_get_cstr(args), data, sizeof(data));
+    if(length <= 0) {
+        printf("Invalid hex data!");
+        return;
+    }
+
+    if(repeat) {
+        flipper_spi_terminal_tx_repeat(app->terminal_screen.tx, data, length);
+    } else if(
+        flipper_spi_terminal_tx_write(app->terminal_screen.tx, data, length, FuriWaitForever) !=
+        (size_t)length) {
+        printf("Sending was canceled!");
+    }
+
+    // The received answer might not fill a half of the RX DMA buffer
+    flipper_spi_terminal_scene_terminal_watch(app);
+}
+
+void flipper_spi_terminal_cli_command_sequence_load(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    // The SD card is not accessed while the terminal is active
+    if(app->terminal_screen.is_active) {
+        printf("Can not load a sequence while terminal is active!");
+        return;
+    }
+
+    furi_string_trim(args, " \t");
+    if(furi_string_empty(args)) {
+        printf("Missing sequence name!");
+        return;
+    }
+
+    FuriString* error = furi_string_alloc();
+    FlipperSPITerminalSequence* sequence =
+        flipper_spi_terminal_sequence_load(furi_string_get_cstr(args), error);
+    if(sequence != NULL) {
+        if(app->terminal_screen.sequence != NULL) {
+            flipper_spi_terminal_sequence_free(app->terminal_screen.sequence);
+        }
+        app->terminal_screen.sequence = sequence;
+        printf("Loaded %zu bytes of bytecode\n", flipper_spi_terminal_sequence_get_size(sequence));
+    } else {
+        printf("%s\n", furi_string_get_cstr(error));
+    }
+    furi_string_free(error);
+}
+
+void flipper_spi_terminal_cli_command_sequence_run(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    if(app->terminal_screen.sequence == NULL) {
+        printf("No sequence loaded, see seq_load!");
+        return;
+    }
+
+    int runs;
+    if(!args_read_int_and_trim(args, &runs)) {
+        runs = 1;
+    } else if(runs < 1) {
+        printf("Invalid run count!");
+        return;
+    }
+
+    uint32_t failed = 0;
+    for(int i = 0; i < runs; i++) {
+        FlipperSPITerminalSequenceResult result;
+        if(!flipper_spi_terminal_scene_terminal_run_sequence(
+               app, app->terminal_screen.sequence, &result)) {
+            printf("Sequences need the terminal screen in master mode!");
+            return;
+        }
+
+        if(result.aborted) {
+            printf(
+                "Run %d: Aborted in instruction %lu, the bus did not respond\n",
+                i + 1,
+                result.instructions);
+            failed++;
+        } else if(result.failed_expects > 0) {
+            printf(
+                "Run %d: %lu failed expects, first in line %lu\n",
+                i + 1,
+                result.failed_expects,
+                result.first_failed_line);
+            failed++;
+        } else if(runs == 1) {
+            printf("%lu instructions, %lu bytes sent\n", result.instructions, result.bytes);
+        }
+    }
+
+    printf("%lu of %d runs passed\n", (uint32_t)runs - failed, runs);
+}
+
+// Reads the next word as decimal or 0x prefixed hex number
+static bool flipper_spi_terminal_cli_read_u32(FuriString* args, uint32_t* value) {
+    FuriString* word = furi_string_alloc();
+    bool ok = args_read_string_and_trim(args, word);
+    if(ok) {
+        char* end;
+        *value = strtoul(furi_string_get_cstr(word), &end, 0);
+        ok = *end == '\0';
+    }
+    furi_string_free(word);
+    return ok;
+}
+
+void flipper_spi_terminal_cli_command_set_trigger(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    FuriString* pattern = furi_string_alloc();
+    uint32_t pre = SPI_TERM_TRIGGER_DEFAULT_PRE;
+    uint32_t post = SPI_TERM_TRIGGER_DEFAULT_POST;
+    if(!args_read_string_and_trim(args, pattern)) {
+        printf("Missing pattern!");
+    } else if(args_length(args) > 0 && !flipper_spi_terminal_cli_read_u32(args, &pre)) {
+        printf("Invalid pre-trigger length!");
+    } else if(args_length(args) > 0 && !flipper_spi_terminal_cli_read_u32(args, &post)) {
+        printf("Invalid post-trigger length!");
+    } else {
+        FlipperSPITerminalTrigger* trigger = flipper_spi_terminal_trigger_alloc();
+        if(furi_string_equal_str(pattern, "off")) {
+            flipper_spi_terminal_scene_terminal_set_trigger(app, trigger);
+            printf("Trigger disabled");
+        } else if(flipper_spi_terminal_trigger_set(
+                      trigger, furi_string_get_cstr(pattern), pre, post)) {
+            flipper_spi_terminal_scene_terminal_set_trigger(app, trigger);
+            printf(
+                "Trigger armed, %zu bytes are kept",
+                flipper_spi_terminal_trigger_get_window(trigger));
+        } else {
+            flipper_spi_terminal_trigger_free(trigger);
+            printf(
+                "Invalid pattern, up to %d bytes are supported!", SPI_TERM_TRIGGER_MAX_LENGTH);
+        }
+    }
+    furi_string_free(pattern);
+}
+
+static uint32_t flipper_spi_terminal_cli_kib_per_second(uint32_t bytes, uint32_t duration_ms) {
+    return (uint64_t)bytes * 1000 / 1024 / MAX(duration_ms, 1UL);
+}
+
+void flipper_spi_terminal_cli_command_dump_capture(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    FuriString* format = furi_string_alloc();
+    const bool has_format = args_read_string_and_trim(args, format);
+    const bool raw = furi_string_equal_str(format, "raw");
+    const bool hex = furi_string_equal_str(format, "hex");
+    furi_string_free(format);
+    if(!has_format || (!raw && !hex)) {
+        printf("Format has to be raw or hex!");
+        return;
+    }
+
+    const size_t size = flipper_spi_terminal_dump_get_size(app);
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    if(args_length(args) > 0 && !flipper_spi_terminal_cli_read_u32(args, &offset)) {
+        printf("Invalid offset!");
+        return;
+    }
+    const bool has_length = args_length(args) > 0;
+    if(has_length && !flipper_spi_terminal_cli_read_u32(args, &length)) {
+        printf("Invalid length!");
+        return;
+    }
+    if(offset > size) {
+        printf("Offset is behind the end of the capture, which has %zu bytes!", size);
+        return;
+    }
+    if(!has_length || length > size - offset) {
+        length = size - offset;
+    }
+
+    FlipperSPITerminalDumpResult result;
+    if(raw) {
+        // Everything between these two lines is raw data
+        printf("Sending %lu bytes\n", length);
+        flipper_spi_terminal_dump_capture(
+            app, FlipperSPITerminalDumpFormatRaw, offset, length, &result);
+        printf("\n");
+    } else {
+        flipper_spi_terminal_dump_capture(
+            app, FlipperSPITerminalDumpFormatHex, offset, length, &result);
+    }
+
+    if(result.complete) {
+        printf(
+            "Dumped %lu bytes in %lu ms (%lu KiB/s)\n",
+            result.bytes,
+            result.duration_ms,
+            flipper_spi_terminal_cli_kib_per_second(result.bytes, result.duration_ms));
+    } else if(cli_cmd_interrupt_received(app->cli)) {
+        printf("Canceled after %lu bytes\n", result.bytes);
+    } else {
+        printf("Stopped after %lu bytes, the rest was dropped by new data!\n", result.bytes);
+    }
+}
+
+static FlipperSPITerminalFlash* flipper_spi_terminal_cli_flash_open(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalFlashInfo* info) {
+    if(app->terminal_screen.is_active) {
+        printf("The flash can not be accessed while terminal is active!");
+        return NULL;
+    }
+
+    FlipperSPITerminalFlash* flash =
+        flipper_spi_terminal_flash_alloc(SPI_TERM_FLASH_FAST_PRESCALER);
+    if(!flipper_spi_terminal_flash_probe(flash, info)) {
+        printf("No flash found!");
+        flipper_spi_terminal_flash_free(flash);
+        return NULL;
+    }
+
+    printf(
+        "JEDEC ID: %02X %02X %02X\nSFDP: %s\nSize: %lu bytes\n",
+        info->jedec_id[0],
+        info->jedec_id[1],
+        info->jedec_id[2],
+        info->has_sfdp ? "yes" : "no",
+        info->size);
+    return flash;
+}
+
+void flipper_spi_terminal_cli_command_print_flash_info(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    FlipperSPITerminalFlashInfo info;
+    FlipperSPITerminalFlash* flash = flipper_spi_terminal_cli_flash_open(app, &info);
+    if(flash != NULL) {
+        flipper_spi_terminal_flash_free(flash);
+    }
+}
+
+static bool
+    flipper_spi_terminal_cli_flash_usb_sink(void* context, const uint8_t* data, size_t length) {
+    FlipperSPITerminalApp* app = context;
+    if(cli_cmd_interrupt_received(app->cli)) {
+        return false;
+    }
+
+    cli_write(app->cli, data, length);
+    return true;
+}
+
+static bool
+    flipper_spi_terminal_cli_flash_file_sink(void* context, const uint8_t* data, size_t length) {
+    return storage_file_write(context, data, length) == length;
+}
+
+void flipper_spi_terminal_cli_command_dump_flash(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    FuriString* target = furi_string_alloc();
+    if(!args_read_string_and_trim(args, target)) {
+        printf("Missing target!");
+        furi_string_free(target);
+        return;
+    }
+
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    const bool has_offset = args_length(args) > 0;
+    if(has_offset && !flipper_spi_terminal_cli_read_u32(args, &offset)) {
+        printf("Invalid offset!");
+        furi_string_free(target);
+        return;
+    }
+    const bool has_length = args_length(args) > 0;
+    if(has_length && !flipper_spi_terminal_cli_read_u32(args, &length)) {
+        printf("Invalid length!");
+        furi_string_free(target);
+        return;
+    }
+
+    FlipperSPITerminalFlashInfo info;
+    FlipperSPITerminalFlash* flash = flipper_spi_terminal_cli_flash_open(app, &info);
+    if(flash == NULL) {
+        furi_string_free(target);
+        return;
+    }
+
+    if(!has_length) {
+        length = offset < info.size ? info.size - offset : 0;
+    }
+
+    // An unknown size can not be checked, explicit ranges are dumped as given then
+    FlipperSPITerminalFlashDumpResult result = {0};
+    if(info.size > 0 && has_offset && offset >= info.size) {
+        printf("The offset is beyond the end of the flash (%lu bytes)!", info.size);
+    } else if(info.size > 0 && has_length && length > info.size - offset) {
+        printf("The range does not fit into the flash (%lu bytes)!", info.size);
+    } else if(length == 0) {
+        printf("Nothing to dump, the size of the flash is unknown!");
+    } else if(furi_string_equal_str(target, "usb")) {
+        // Everything between these two lines is raw data
+        printf("Sending %lu bytes\n", length);
+        flipper_spi_terminal_flash_dump(
+            flash, offset, length, flipper_spi_terminal_cli_flash_usb_sink, app, false, &result);
+        printf("\n");
+    } else {
+        FuriString* path = furi_string_alloc_printf(
+            "%s/%s%s",
+            SPI_TERM_LAST_SETTINGS_DIR,
+            furi_string_get_cstr(target),
+            SPI_TERM_FLASH_DUMP_EXTENSION);
+
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        File* file = storage_file_alloc(storage);
+        storage_common_mkdir(storage, SPI_TERM_LAST_SETTINGS_DIR);
+        if(storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            printf("Writing %lu bytes to %s\n", length, furi_string_get_cstr(path));
+            flipper_spi_terminal_flash_dump(
+                flash,
+                offset,
+                length,
+                flipper_spi_terminal_cli_flash_file_sink,
+                file,
+                true,
+                &result);
+        } else {
+            printf("Can not open %s!\n", furi_string_get_cstr(path));
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+
+        furi_string_free(path);
+    }
+
+    flipper_spi_terminal_flash_free(flash);
+    furi_string_free(target);
+
+    if(result.bytes > 0) {
+        printf(
+            "%s %lu bytes in %lu ms (%lu KiB/s)\nCRC32: %08lX\n",
+            result.complete ? "Dumped" : "Canceled after",
+            result.bytes,
+            result.duration_ms,
+            flipper_spi_terminal_cli_kib_per_second(result.bytes, result.duration_ms),
+            result.crc32);
+    }
+}
+
+static bool
+    flipper_spi_terminal_cli_flash_file_source(void* context, uint8_t* data, size_t length) {
+    return storage_file_read(context, data, length) == length;
+}
+
+void flipper_spi_terminal_cli_command_program_flash(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    FuriString* name = furi_string_alloc();
+    uint32_t offset = 0;
+    if(!args_read_string_and_trim(args, name)) {
+        printf("Missing image name!");
+        furi_string_free(name);
+        return;
+    } else if(args_length(args) > 0 && !flipper_spi_terminal_cli_read_u32(args, &offset)) {
+        printf("Invalid offset!");
+        furi_string_free(name);
+        return;
+    } else if(offset % SPI_TERM_FLASH_SECTOR_SIZE != 0) {
+        printf("The offset has to be a multiple of %u!", SPI_TERM_FLASH_SECTOR_SIZE);
+        furi_string_free(name);
+        return;
+    }
+
+    FlipperSPITerminalFlashInfo info;
+    FlipperSPITerminalFlash* flash = flipper_spi_terminal_cli_flash_open(app, &info);
+    if(flash == NULL) {
+        furi_string_free(name);
+        return;
+    }
+
+    FuriString* path = furi_string_alloc_printf(
+        "%s/%s%s",
+        SPI_TERM_LAST_SETTINGS_DIR,
+        furi_string_get_cstr(name),
+        SPI_TERM_FLASH_DUMP_EXTENSION);
+
+    FlipperSPITerminalFlashProgramResult result = {0};
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        printf("Can not open %s!\n", furi_string_get_cstr(path));
+    } else if(storage_file_size(file) > (uint64_t)info.size - offset || offset > info.size) {
+        printf("The image does not fit into the flash!\n");
+    } else {
+        const uint32_t length = storage_file_size(file);
+        printf("Programming %lu bytes at 0x%08lX\n", length, offset);
+        flipper_spi_terminal_flash_program(
+            flash,
+            offset,
+            length,
+            flipper_spi_terminal_cli_flash_file_source,
+            file,
+            true,
+            &result);
+
+        printf(
+            "%s %lu bytes in %lu ms (%lu KiB/s)\nSectors erased: %lu, already blank: %lu\n",
+            result.complete ? "Programmed" : "Failed after",
+            result.bytes,
+            result.duration_ms,
+            flipper_spi_terminal_cli_kib_per_second(result.bytes, result.duration_ms),
+            result.sectors_erased,
+            result.sectors_skipped);
+        if(result.mismatches > 0) {
+            printf(
+                "Verify failed: %lu bytes differ, the first at 0x%08lX\n",
+                result.mismatches,
+                result.first_mismatch);
+        } else if(result.complete) {
+            printf("Verify OK\n");
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    furi_string_free(path);
+    flipper_spi_terminal_flash_free(flash);
+    furi_string_free(name);
+}
+
+static void flipper_spi_terminal_cli_print_emulator_stats(FlipperSPITerminalEmu* emu) {
+    FlipperSPITerminalEmuStats stats;
+    flipper_spi_terminal_emu_get_stats(emu, &stats);
+    printf(
+        "Transactions: %lu, reads: %lu, programs: %lu, erases: %lu, unknown: %lu\n",
+        stats.transactions,
+        stats.reads,
+        stats.programs,
+        stats.erases,
+        stats.unknown);
+}
+
+void flipper_spi_terminal_cli_command_run_emulator(FlipperSPITerminalApp* app, FuriString* args) {
+    furi_check(app);
+
+    if(app->terminal_screen.is_active) {
+        printf("The emulator can not run while terminal is active!");
+        return;
+    }
+
+    FuriString* name = furi_string_alloc();
+    if(!args_read_string_and_trim(args, name)) {
+        printf("Missing image name!");
+        furi_string_free(name);
+        return;
+    }
+    const bool save = furi_string_equal_str(args, "save");
+
+    FuriString* path = furi_string_alloc_printf(
+        "%s/%s%s",
+        SPI_TERM_LAST_SETTINGS_DIR,
+        furi_string_get_cstr(name),
+        SPI_TERM_FLASH_DUMP_EXTENSION);
+
+    // Winbond, the most common SPI NOR flash
+    static const uint8_t jedec_id[] = {0xEF, 0x40};
+    FlipperSPITerminalEmu* emu = flipper_spi_terminal_emu_alloc(jedec_id);
+    if(flipper_spi_terminal_emu_load(emu, furi_string_get_cstr(path))) {
+        printf(
+            "Emulating %zu bytes of %s, press Ctrl+C to stop\n",
+            flipper_spi_terminal_emu_get_size(emu),
+            furi_string_get_cstr(path));
+
+        flipper_spi_terminal_emu_start(emu, &app->config.spi);
+        while(!cli_cmd_interrupt_received(app->cli)) {
+            furi_delay_ms(100);
+        }
+        flipper_spi_terminal_emu_stop(emu);
+
+        flipper_spi_terminal_cli_print_emulator_stats(emu);
+        printf("Dirty sectors: %zu\n", flipper_spi_terminal_emu_get_dirty_sectors(emu));
+        if(save) {
+            const int32_t saved = flipper_spi_terminal_emu_save(emu, furi_string_get_cstr(path));
+            if(saved < 0) {
+                printf("Can not save %s!\n", furi_string_get_cstr(path));
+            } else {
+                printf("Saved %ld sectors\n", saved);
+            }
+        }
+    } else {
+        printf("Can not load %s!\n", furi_string_get_cstr(path));
+    }
+    flipper_spi_terminal_emu_free(emu);
+
+    furi_string_free(path);
+    furi_string_free(name);
+}
@@ -25,3 +25,22 @@ void flipper_spi_terminal_cli_command_debug_terminal_data(
     FuriString* data,
     bool reset_data);
 void flipper_spi_terminal_cli_command_debug_data(FlipperSPITerminalApp* app, FuriString* data);
+void flipper_spi_terminal_cli_command_debug_sim(
+    FlipperSPITerminalApp* app,
+    FuriString* args,
+    bool start);
+void flipper_spi_terminal_cli_command_debug_bench(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_print_stats(FlipperSPITerminalApp* app);
+void flipper_spi_terminal_cli_command_stream_capture(FlipperSPITerminalApp* app);
+void flipper_spi_terminal_cli_command_transmit(
+    FlipperSPITerminalApp* app,
+    FuriString* args,
+    bool repeat);
+void flipper_spi_terminal_cli_command_sequence_load(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_sequence_run(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_set_trigger(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_dump_capture(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_print_flash_info(FlipperSPITerminalApp* app);
+void flipper_spi_terminal_cli_command_dump_flash(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_program_flash(FlipperSPITerminalApp* app, FuriString* args);
+void flipper_spi_terminal_cli_command_run_emulator(FlipperSPITerminalApp* app, FuriString* args);
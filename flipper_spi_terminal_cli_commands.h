@@ -21,6 +21,65 @@ CLI_COMMAND(help,
             "Prints a list with all commands.",
             flipper_spi_terminal_cli_command_print_full_help();)
 
+CLI_COMMAND(stats,
+            NULL,
+            "Prints the receive counters of the current or last terminal session.",
+            flipper_spi_terminal_cli_command_print_stats(app);)
+
+CLI_COMMAND(stream,
+            NULL,
+            "Streams everything received by the terminal as binary frames to this CLI session, until Ctrl+C is pressed. tools/spi_stream_receiver.c stores them as capture file on a PC.",
+            flipper_spi_terminal_cli_command_stream_capture(app);)
+
+CLI_COMMAND(dump,
+            "<raw|hex> [offset] [length]",
+            "Prints [length] bytes (default all) of the terminal buffer, starting [offset] bytes after the oldest byte. raw sends them unchanged, hex as 16 bytes per line with ASCII column. Works while data is received.",
+            flipper_spi_terminal_cli_command_dump_capture(app, args);)
+
+CLI_COMMAND(tx,
+            "<hex>",
+            "(Master only) Sends the bytes <hex> once, e.g. '9F 00 00 00'. Consecutive commands are sent back to back.",
+            flipper_spi_terminal_cli_command_transmit(app, args, false);)
+CLI_COMMAND(tx_repeat,
+            "<hex>",
+            "(Master only) Sends the bytes <hex> over and over again, until tx_stop is called.",
+            flipper_spi_terminal_cli_command_transmit(app, args, true);)
+CLI_COMMAND(tx_stop,
+            NULL,
+            "(Master only) Stops sending and drops everything, which was not sent yet.",
+            flipper_spi_terminal_tx_cancel(app->terminal_screen.tx);)
+
+CLI_COMMAND(seq_load,
+            "<name>",
+            "Loads and compiles the sequence <name>.spiseq from the app data folder. Not possible while the terminal is active.",
+            flipper_spi_terminal_cli_command_sequence_load(app, args);)
+CLI_COMMAND(seq_run,
+            "[runs]",
+            "(Master only) Runs the loaded sequence [runs] times (default 1) and prints the failed expects.",
+            flipper_spi_terminal_cli_command_sequence_run(app, args);)
+
+CLI_COMMAND(trigger,
+            "<pattern|off> [pre] [post]",
+            "Stops the capture [post] bytes (default 1024) after <pattern> was received and keeps [pre] bytes (default 256) before it. <pattern> is hex without spaces, ? or X are don't-care nibbles, e.g. 9F??X0. Running it again re-arms the trigger.",
+            flipper_spi_terminal_cli_command_set_trigger(app, args);)
+
+CLI_COMMAND(flash_id,
+            NULL,
+            "Reads JEDEC ID and SFDP of a SPI NOR flash. Not possible while the terminal is active.",
+            flipper_spi_terminal_cli_command_print_flash_info(app);)
+CLI_COMMAND(flash_dump,
+            "<usb|name> [offset] [length]",
+            "Reads a SPI NOR flash at 32 MHz and sends it raw over USB or stores it as <name>.bin in the app data folder. Prints the CRC32 of the image. Not possible while the terminal is active.",
+            flipper_spi_terminal_cli_command_dump_flash(app, args);)
+CLI_COMMAND(flash_write,
+            "<name> [offset]",
+            "Programs <name>.bin from the app data folder into a SPI NOR flash and verifies it. [offset] has to be a multiple of 4096. Every touched sector is erased, unless it is blank. Not possible while the terminal is active.",
+            flipper_spi_terminal_cli_command_program_flash(app, args);)
+CLI_COMMAND(emu,
+            "<name> [save]",
+            "Emulates a SPI NOR flash with the image <name>.bin from the app data folder as slave, until Ctrl+C is pressed. Writes are stored back into the image with [save]. Not possible while the terminal is active.",
+            flipper_spi_terminal_cli_command_run_emulator(app, args);)
+
 CLI_COMMAND(dbg_term_data_set,
             "<text>",
             "(DEBUG) Sets the <text> of the terminal view",
@@ -33,10 +92,20 @@ CLI_COMMAND(dbg_term_data_clear,
             "<text>",
             "(DEBUG) Removes everything from the terminal view",
             terminal_view_reset(app->terminal_screen.view);)
-CLI_COMMAND(dbg_term_data_show,
+
+CLI_COMMAND(dbg_sim_start,
+            "<bit/s> [chunk size]",
+            "(DEBUG) Feeds a test pattern into the terminal at <bit/s>, like the RX DMA would do it. [chunk size] defaults to the DMA RX Buffer size",
+            flipper_spi_terminal_cli_command_debug_sim(app, args, true);)
+CLI_COMMAND(dbg_sim_stop,
             NULL,
-            "(DEBUG) prints the current buffer",
-            terminal_view_debug_print_buffer(app->terminal_screen.view);)
+            "(DEBUG) Stops the test pattern",
+            flipper_spi_terminal_cli_command_debug_sim(app, args, false);)
+
+CLI_COMMAND(dbg_bench,
+            "[ms per step]",
+            "(DEBUG) Measures throughput, lost bytes and latencies of the capture pipeline with the simulated DMA source. The terminal buffer is cleared afterwards",
+            flipper_spi_terminal_cli_command_debug_bench(app, args);)
 
 CLI_COMMAND(dbg_text_data_set,
             "<text>",
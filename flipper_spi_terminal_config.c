@@ -54,6 +54,34 @@ void flipper_spi_terminal_config_log(FlipperSPITerminalAppConfig* config) {
         SPI_TERM_LAST_SETTING_DEBUG_DATA_KEY, debug.debug_string, config.debug.debug_string);
 }
 
+void flipper_spi_terminal_config_to_capture(
+    const FlipperSPITerminalAppConfig* config,
+    CaptureFileHeader* header) {
+    furi_check(config);
+    furi_check(header);
+
+    uint32_t* values = header->config;
+    values[CaptureFileConfigDisplayMode] = config->display_mode;
+    values[CaptureFileConfigBufferBehaviour] = config->terminal_buffer_behaviour;
+    values[CaptureFileConfigCaptureBufferSize] = config->capture_buffer_size;
+    values[CaptureFileConfigIngestMode] = config->ingest_mode;
+    values[CaptureFileConfigRxDmaBufferSize] = config->rx_dma_buffer_size;
+    values[CaptureFileConfigRefreshInterval] = config->refresh_interval_ms;
+    values[CaptureFileConfigFramingMode] = config->framing_mode;
+    values[CaptureFileConfigRecordBufferSize] = config->record_buffer_size;
+    values[CaptureFileConfigSpiTransferDirection] = config->spi.TransferDirection;
+    values[CaptureFileConfigSpiMode] = config->spi.Mode;
+    values[CaptureFileConfigSpiDataWidth] = config->spi.DataWidth;
+    values[CaptureFileConfigSpiClockPolarity] = config->spi.ClockPolarity;
+    values[CaptureFileConfigSpiClockPhase] = config->spi.ClockPhase;
+    values[CaptureFileConfigSpiNss] = config->spi.NSS;
+    values[CaptureFileConfigSpiBaudRate] = config->spi.BaudRate;
+    values[CaptureFileConfigSpiBitOrder] = config->spi.BitOrder;
+    values[CaptureFileConfigSpiCrcCalculation] = config->spi.CRCCalculation;
+    values[CaptureFileConfigSpiCrcPoly] = config->spi.CRCPoly;
+    header->config_count = CaptureFileConfigCount;
+}
+
 static bool flipper_spi_terminal_read_config_value(
     FlipperFormat* file,
     const char* key,
@@ -30,5 +30,9 @@ void flipper_spi_terminal_config_log(FlipperSPITerminalAppConfig* config);
 void flipper_spi_terminal_config_defaults(FlipperSPITerminalAppConfig* config);
 bool flipper_spi_terminal_config_load(FlipperSPITerminalAppConfig* config);
 bool flipper_spi_terminal_config_save(FlipperSPITerminalAppConfig* config);
+// Stores the settings in the config values of a capture file header
+void flipper_spi_terminal_config_to_capture(
+    const FlipperSPITerminalAppConfig* config,
+    CaptureFileHeader* header);
 
 void flipper_spi_terminal_config_debug_print_saved();
@@ -81,6 +81,26 @@ ADD_CONFIG_ENTRY(
     (TerminalBufferBehaviourClear, TerminalBufferBehaviourKeep),
     ("Clear", "Keep"))
 
+ADD_CONFIG_ENTRY(
+    "Capture buffer",
+    FORMAT_DESCRIPTION(
+        "Sets, how much received data the Terminal Screen keeps. Oldest data is dropped, if the buffer is full. The buffer is allocated in 1 KiB chunks, when the Terminal Screen is entered.",
+        "4 KiB",
+        (FORMAT_VALUE_DESCRIPTION(
+            "4 KiB - 64 KiB",
+            "Fixed size. Reduced, if there is not enough memory.")
+             FORMAT_VALUE_DESCRIPTION(
+                 "Max",
+                 "Use all free memory, except a reserve for the rest of the app. The size is rounded down to a power of two."))),
+    capture_buffer_size,
+    size_t,
+    4096,
+    value_index_size_t,
+    capture_buffer_size,
+    6,
+    (4096, 8192, 16384, 32768, 65536, 0),
+    ("4 KiB", "8 KiB", "16 KiB", "32 KiB", "64 KiB", "Max"))
+
 ADD_CONFIG_ENTRY(
     "DMA RX Buffer size",
     FORMAT_DESCRIPTION(
@@ -97,6 +117,59 @@ ADD_CONFIG_ENTRY(
     (1, 2, 4, 8, 16, 32, 64, 128, 256),
     ("1", "2", "4", "8", "16", "32", "64", "128", "256"))
 
+ADD_CONFIG_ENTRY(
+    "Ingest mode",
+    FORMAT_DESCRIPTION(
+        "Sets, how received data is passed from the DMA buffer to the Terminal Screen.",
+        "Stream",
+        (FORMAT_VALUE_DESCRIPTION(
+            "Stream",
+            "The DMA interrupt copies every received block into a 512 byte intermediate buffer. Data is copied twice.")
+             FORMAT_VALUE_DESCRIPTION(
+                 "Direct",
+                 "The DMA interrupt only publishes how far the DMA buffer is filled. The Terminal Screen copies the data directly out of the DMA buffer. This shortens the interrupt and halves the memory bandwidth, but data is lost, if the screen falls behind more than half of the DMA RX Buffer."))),
+    ingest_mode,
+    TerminalIngestMode,
+    TerminalIngestModeStream,
+    value_index_ingest_mode,
+    ingest_mode,
+    2,
+    (TerminalIngestModeStream, TerminalIngestModeDirect),
+    ("Stream", "Direct"))
+
+ADD_CONFIG_ENTRY(
+    "Refresh interval",
+    FORMAT_DESCRIPTION(
+        "Sets the minimum time between two updates of the Terminal Screen. The screen is only updated, if new data was received. A shorter interval reduces the lag, a longer interval reduces the CPU load on a busy bus.",
+        "33 ms",
+        ("16 ms, 33 ms, 100 ms or 300 ms")),
+    refresh_interval_ms,
+    uint32_t,
+    33,
+    value_index_uint32,
+    refresh_interval_ms,
+    4,
+    (16, 33, 100, 300),
+    ("16 ms", "33 ms", "100 ms", "300 ms"))
+
+ADD_CONFIG_ENTRY(
+    "Record to SD",
+    FORMAT_DESCRIPTION(
+        "Writes everything, which is shown on the Terminal Screen, to a new capture file in apps_data/flipper_spi_terminal. The data is staged in RAM. The SD card shares the bus with the SPI, so the capture is paused for every write, once the staging buffer is half full or the bus is idle. Data, which is sent in the meantime, is lost. Those gaps are marked in the file and on the screen.",
+        "Off",
+        (FORMAT_VALUE_DESCRIPTION("Off", "Nothing is written")
+             FORMAT_VALUE_DESCRIPTION(
+                 "8 KiB - 32 KiB",
+                 "Size of the staging buffer. A bigger buffer needs less pauses on a busy bus."))),
+    record_buffer_size,
+    size_t,
+    0,
+    value_index_size_t,
+    record_buffer_size,
+    4,
+    (0, 8192, 16384, 32768),
+    ("Off", "8 KiB", "16 KiB", "32 KiB"))
+
 ADD_CONFIG_ENTRY(
     "Mode",
     FORMAT_DESCRIPTION(
@@ -231,6 +304,24 @@ ADD_CONFIG_ENTRY(
     (LL_SPI_NSS_SOFT, LL_SPI_NSS_HARD_INPUT, LL_SPI_NSS_HARD_OUTPUT),
     ("Soft", "Hard Input", "Hard Output"))
 
+ADD_CONFIG_ENTRY(
+    "CS framing",
+    FORMAT_DESCRIPTION(
+        "Splits the received data into transactions, by watching the CS pin (PA4). Works with every Non Slave Select setting.",
+        "Off",
+        (FORMAT_VALUE_DESCRIPTION("Off", "Data is shown as one continuous stream")
+             FORMAT_VALUE_DESCRIPTION(
+                 "CS",
+                 "Every deassertion (rising edge) of CS ends a transaction. Received data is passed to the Terminal Screen immediately and every transaction starts on a new row."))),
+    framing_mode,
+    TerminalFramingMode,
+    TerminalFramingModeOff,
+    value_index_framing_mode,
+    framing_mode,
+    2,
+    (TerminalFramingModeOff, TerminalFramingModeChipSelect),
+    ("Off", "CS"))
+
 ADD_CONFIG_ENTRY(
     "Baudrate prescaler",
     FORMAT_DESCRIPTION_MIN(
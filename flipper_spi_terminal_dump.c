@@ -0,0 +1,99 @@
+#include "flipper_spi_terminal_dump.h"
+#include "toolbox/hex_string.h"
+
+typedef struct {
+    Cli* cli;
+    char text[SPI_TERM_DUMP_HEX_LINES * HEX_STRING_DUMP_LINE_SIZE];
+    size_t length; // Chars in text
+} FlipperSPITerminalDumpHex;
+
+static void flipper_spi_terminal_dump_hex_write(FlipperSPITerminalDumpHex* hex) {
+    if(hex->length > 0) {
+        cli_write(hex->cli, (uint8_t*)hex->text, hex->length);
+        hex->length = 0;
+    }
+}
+
+// data starts at offset, which is a multiple of HEX_STRING_DUMP_BYTES, except for the first line
+static void flipper_spi_terminal_dump_hex_add(
+    FlipperSPITerminalDumpHex* hex,
+    size_t offset,
+    const uint8_t* data,
+    size_t length) {
+    while(length > 0) {
+        const size_t line = MIN(length, HEX_STRING_DUMP_BYTES - offset % HEX_STRING_DUMP_BYTES);
+        if(hex->length + HEX_STRING_DUMP_LINE_SIZE > sizeof(hex->text)) {
+            flipper_spi_terminal_dump_hex_write(hex);
+        }
+        hex->length += hex_string_dump_line(hex->text + hex->length, offset, data, line);
+
+        offset += line;
+        data += line;
+        length -= line;
+    }
+}
+
+size_t flipper_spi_terminal_dump_get_size(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    size_t start, end;
+    terminal_view_get_capture_range(app->terminal_screen.view, &start, &end);
+    return end - start;
+}
+
+void flipper_spi_terminal_dump_capture(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalDumpFormat format,
+    size_t offset,
+    size_t length,
+    FlipperSPITerminalDumpResult* result) {
+    furi_check(app);
+    furi_check(result);
+
+    TerminalView* view = app->terminal_screen.view;
+    uint8_t* chunk = malloc(SPI_TERM_DUMP_CHUNK_SIZE);
+    FlipperSPITerminalDumpHex* hex = NULL;
+    if(format == FlipperSPITerminalDumpFormatHex) {
+        hex = malloc(sizeof(FlipperSPITerminalDumpHex));
+        hex->cli = app->cli;
+        hex->length = 0;
+    }
+
+    // Offsets stay relative to the oldest byte at the start, even if it is dropped meanwhile
+    size_t start, end;
+    terminal_view_get_capture_range(view, &start, &end);
+    UNUSED(end);
+
+    const uint32_t start_tick = furi_get_tick();
+    result->bytes = 0;
+    result->complete = false;
+    while(!cli_cmd_interrupt_received(app->cli)) {
+        if(result->bytes == length) {
+            result->complete = true;
+            break;
+        }
+
+        const size_t read = terminal_view_read_capture(
+            view,
+            start + offset + result->bytes,
+            chunk,
+            MIN(length - result->bytes, (size_t)SPI_TERM_DUMP_CHUNK_SIZE));
+        if(read == 0) {
+            break; // Dropped by new data
+        }
+
+        if(hex != NULL) {
+            flipper_spi_terminal_dump_hex_add(hex, offset + result->bytes, chunk, read);
+        } else {
+            cli_write(app->cli, chunk, read);
+        }
+        result->bytes += read;
+    }
+
+    if(hex != NULL) {
+        flipper_spi_terminal_dump_hex_write(hex);
+        free(hex);
+    }
+    free(chunk);
+    result->duration_ms = furi_get_tick() - start_tick;
+}
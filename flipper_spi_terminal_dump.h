@@ -0,0 +1,34 @@
+#pragma once
+
+#include "flipper_spi_terminal_app.h"
+
+// Export of the capture buffer of the Terminal Screen to the CLI session. The buffer is read in
+// chronological order, from the oldest byte on. It can be exported, while data is received.
+
+// Bytes, which are copied from the capture buffer at once. Raw dumps write them in one go.
+#define SPI_TERM_DUMP_CHUNK_SIZE 2048
+// Hex dumps are collected in a text buffer of this many lines and written in one go
+#define SPI_TERM_DUMP_HEX_LINES  32
+
+typedef enum {
+    FlipperSPITerminalDumpFormatRaw,
+    FlipperSPITerminalDumpFormatHex,
+} FlipperSPITerminalDumpFormat;
+
+typedef struct {
+    uint32_t bytes; // Dumped bytes
+    uint32_t duration_ms;
+    // false, if Ctrl+C was pressed or the rest was dropped from the capture buffer meanwhile
+    bool complete;
+} FlipperSPITerminalDumpResult;
+
+// Number of bytes in the capture buffer
+size_t flipper_spi_terminal_dump_get_size(FlipperSPITerminalApp* app);
+// Dumps length bytes, starting offset bytes after the oldest byte of the capture buffer. The
+// caller checks offset and length against flipper_spi_terminal_dump_get_size.
+void flipper_spi_terminal_dump_capture(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalDumpFormat format,
+    size_t offset,
+    size_t length,
+    FlipperSPITerminalDumpResult* result);
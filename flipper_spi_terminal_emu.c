@@ -0,0 +1,562 @@
+#include "flipper_spi_terminal_emu.h"
+#include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_hw.h"
+
+#include <furi_hal_bus.h>
+#include <furi_hal_gpio.h>
+#include <storage/storage.h>
+
+// Free heap, which is left after the image was loaded
+#define SPI_TERM_EMU_HEAP_RESERVE (16 * 1024)
+// NDTR is 16 bit wide
+#define SPI_TERM_EMU_MAX_TRANSFER UINT16_MAX
+#define SPI_TERM_EMU_PAGE_SIZE    256
+
+// Write enable latch of the status register. Busy is never set, everything completes instantly.
+#define SPI_TERM_EMU_STATUS_WEL (1 << 1)
+
+typedef enum {
+    FlipperSPITerminalEmuStateIdle, // CS is deasserted
+    FlipperSPITerminalEmuStateCommand,
+    FlipperSPITerminalEmuStateAddress,
+    FlipperSPITerminalEmuStateData,
+} FlipperSPITerminalEmuState;
+
+typedef struct {
+    uint8_t address_length; // Address bytes after the command
+    bool receives; // Data phase is received into rx_page, otherwise it is dropped
+    void (*start)(FlipperSPITerminalEmu* emu); // Data phase, right after the address
+    void (*tx_complete)(FlipperSPITerminalEmu* emu); // NULL => sending stops
+    void (*end)(FlipperSPITerminalEmu* emu); // CS was deasserted
+} FlipperSPITerminalEmuOp;
+
+struct FlipperSPITerminalEmu {
+    uint8_t* storage; // One pad byte, followed by the image
+    uint8_t* image;
+    size_t size;
+    uint32_t* dirty; // One bit per sector
+    size_t sector_count;
+
+    volatile FlipperSPITerminalEmuState state;
+    const FlipperSPITerminalEmuOp* op;
+    uint8_t header[4]; // Command and address
+    uint32_t address;
+    uint32_t read_next; // Image offset after the running TX DMA transfer
+    uint32_t rx_wraps; // Full turns of rx_page during a page program
+    uint8_t rx_page[SPI_TERM_EMU_PAGE_SIZE];
+    uint8_t jedec_id[3];
+    uint8_t status;
+    uint8_t discard;
+
+    bool running;
+    LL_SPI_InitTypeDef spi;
+    FlipperSPITerminalEmuStats stats;
+};
+
+static void
+    flipper_spi_terminal_emu_rx(uint8_t* data, size_t length, bool increment, bool circular) {
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_SetMode(
+        SPI_DMA, SPI_DMA_RX_CHANNEL, circular ? LL_DMA_MODE_CIRCULAR : LL_DMA_MODE_NORMAL);
+    LL_DMA_SetMemoryIncMode(
+        SPI_DMA,
+        SPI_DMA_RX_CHANNEL,
+        increment ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT);
+    LL_DMA_SetMemoryAddress(SPI_DMA, SPI_DMA_RX_CHANNEL, (uint32_t)data);
+    LL_DMA_SetDataLength(SPI_DMA, SPI_DMA_RX_CHANNEL, length);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+}
+
+static void flipper_spi_terminal_emu_tx(const uint8_t* data, size_t length, bool circular) {
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_SetMode(
+        SPI_DMA, SPI_DMA_TX_CHANNEL, circular ? LL_DMA_MODE_CIRCULAR : LL_DMA_MODE_NORMAL);
+    LL_DMA_SetMemoryAddress(SPI_DMA, SPI_DMA_TX_CHANNEL, (uint32_t)data);
+    LL_DMA_SetDataLength(SPI_DMA, SPI_DMA_TX_CHANNEL, length);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+}
+
+static void flipper_spi_terminal_emu_mark_dirty(
+    FlipperSPITerminalEmu* emu,
+    uint32_t address,
+    size_t length) {
+    const size_t first = address / SPI_TERM_EMU_SECTOR_SIZE;
+    const size_t last = (address + length - 1) / SPI_TERM_EMU_SECTOR_SIZE;
+    for(size_t sector = first; sector <= last; sector++) {
+        emu->dirty[sector / 32] |= 1UL << (sector % 32);
+    }
+}
+
+// Sends the image from position on. lead bytes before position are sent first, the master ignores
+// them. The pad byte in front of the image makes this possible at position 0.
+static void flipper_spi_terminal_emu_read_from(
+    FlipperSPITerminalEmu* emu,
+    uint32_t position,
+    size_t lead) {
+    const size_t length = MIN(emu->size - position + lead, SPI_TERM_EMU_MAX_TRANSFER);
+    flipper_spi_terminal_emu_tx(emu->image + position - lead, length, false);
+    emu->read_next = position - lead + length;
+}
+
+static void flipper_spi_terminal_emu_read_start(FlipperSPITerminalEmu* emu) {
+    emu->stats.reads++;
+    flipper_spi_terminal_emu_read_from(emu, emu->address % emu->size, 0);
+}
+
+// The data starts during the dummy byte, which leaves a whole byte for the turnaround
+static void flipper_spi_terminal_emu_fast_read_start(FlipperSPITerminalEmu* emu) {
+    emu->stats.reads++;
+    flipper_spi_terminal_emu_read_from(emu, emu->address % emu->size, 1);
+}
+
+// Reads wrap around at the end of the image, like on a real flash
+static void flipper_spi_terminal_emu_read_continue(FlipperSPITerminalEmu* emu) {
+    flipper_spi_terminal_emu_read_from(emu, emu->read_next % emu->size, 0);
+}
+
+static void flipper_spi_terminal_emu_jedec_id_start(FlipperSPITerminalEmu* emu) {
+    flipper_spi_terminal_emu_tx(emu->jedec_id, sizeof(emu->jedec_id), false);
+}
+
+static void flipper_spi_terminal_emu_status_start(FlipperSPITerminalEmu* emu) {
+    // Repeated, until CS is deasserted
+    flipper_spi_terminal_emu_tx(&emu->status, 1, true);
+}
+
+static void flipper_spi_terminal_emu_write_enable(FlipperSPITerminalEmu* emu) {
+    emu->status |= SPI_TERM_EMU_STATUS_WEL;
+}
+
+static void flipper_spi_terminal_emu_write_disable(FlipperSPITerminalEmu* emu) {
+    emu->status &= ~SPI_TERM_EMU_STATUS_WEL;
+}
+
+// Every write clears the write enable latch
+static bool flipper_spi_terminal_emu_take_write_enable(FlipperSPITerminalEmu* emu) {
+    const bool enabled = emu->status & SPI_TERM_EMU_STATUS_WEL;
+    emu->status &= ~SPI_TERM_EMU_STATUS_WEL;
+    return enabled;
+}
+
+static void flipper_spi_terminal_emu_program_start(FlipperSPITerminalEmu* emu) {
+    emu->rx_wraps = 0;
+    flipper_spi_terminal_emu_rx(emu->rx_page, sizeof(emu->rx_page), true, true);
+}
+
+// Like a real flash, only the last page of data is kept and the address wraps within the page
+static void flipper_spi_terminal_emu_program_end(FlipperSPITerminalEmu* emu) {
+    const size_t position =
+        sizeof(emu->rx_page) - LL_DMA_GetDataLength(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    const size_t total = emu->rx_wraps * sizeof(emu->rx_page) + position;
+    if(!flipper_spi_terminal_emu_take_write_enable(emu) || total == 0) {
+        return;
+    }
+
+    const uint32_t page = (emu->address % emu->size) & ~(SPI_TERM_EMU_PAGE_SIZE - 1);
+    const size_t offset = emu->address % SPI_TERM_EMU_PAGE_SIZE;
+    const size_t count = MIN(total, sizeof(emu->rx_page));
+    for(size_t i = total - count; i < total; i++) {
+        const uint32_t target = page + (offset + i) % SPI_TERM_EMU_PAGE_SIZE;
+        if(target < emu->size) {
+            // Programming only clears bits
+            emu->image[target] &= emu->rx_page[i % sizeof(emu->rx_page)];
+        }
+    }
+
+    flipper_spi_terminal_emu_mark_dirty(emu, page, MIN(emu->size - page, SPI_TERM_EMU_PAGE_SIZE));
+    emu->stats.programs++;
+}
+
+static void flipper_spi_terminal_emu_erase(FlipperSPITerminalEmu* emu, size_t block_size) {
+    if(!flipper_spi_terminal_emu_take_write_enable(emu)) {
+        return;
+    }
+
+    const uint32_t start = (emu->address % emu->size) & ~(block_size - 1);
+    const size_t length = MIN(emu->size - start, block_size);
+    memset(emu->image + start, 0xFF, length);
+    flipper_spi_terminal_emu_mark_dirty(emu, start, length);
+    emu->stats.erases++;
+}
+
+static void flipper_spi_terminal_emu_erase_4k(FlipperSPITerminalEmu* emu) {
+    flipper_spi_terminal_emu_erase(emu, 4 * 1024);
+}
+
+static void flipper_spi_terminal_emu_erase_32k(FlipperSPITerminalEmu* emu) {
+    flipper_spi_terminal_emu_erase(emu, 32 * 1024);
+}
+
+static void flipper_spi_terminal_emu_erase_64k(FlipperSPITerminalEmu* emu) {
+    flipper_spi_terminal_emu_erase(emu, 64 * 1024);
+}
+
+static void flipper_spi_terminal_emu_erase_chip(FlipperSPITerminalEmu* emu) {
+    emu->address = 0;
+    // Every image size rounded up to a power of two
+    flipper_spi_terminal_emu_erase(emu, 1UL << (32 - __builtin_clz(emu->size)));
+}
+
+// Indexed by the command byte. Empty entries are unsupported commands.
+static const FlipperSPITerminalEmuOp flipper_spi_terminal_emu_ops[256] = {
+    [0x03] =
+        {.address_length = 3,
+         .start = flipper_spi_terminal_emu_read_start,
+         .tx_complete = flipper_spi_terminal_emu_read_continue},
+    // The dummy byte is part of the data phase, see flipper_spi_terminal_emu_fast_read_start
+    [0x0B] =
+        {.address_length = 3,
+         .start = flipper_spi_terminal_emu_fast_read_start,
+         .tx_complete = flipper_spi_terminal_emu_read_continue},
+    [0x9F] = {.start = flipper_spi_terminal_emu_jedec_id_start},
+    [0x05] = {.start = flipper_spi_terminal_emu_status_start},
+    [0x06] = {.end = flipper_spi_terminal_emu_write_enable},
+    [0x04] = {.end = flipper_spi_terminal_emu_write_disable},
+    [0x02] =
+        {.address_length = 3,
+         .receives = true,
+         .start = flipper_spi_terminal_emu_program_start,
+         .end = flipper_spi_terminal_emu_program_end},
+    [0x20] = {.address_length = 3, .end = flipper_spi_terminal_emu_erase_4k},
+    [0x52] = {.address_length = 3, .end = flipper_spi_terminal_emu_erase_32k},
+    [0xD8] = {.address_length = 3, .end = flipper_spi_terminal_emu_erase_64k},
+    [0x60] = {.end = flipper_spi_terminal_emu_erase_chip},
+    [0xC7] = {.end = flipper_spi_terminal_emu_erase_chip},
+};
+
+static void flipper_spi_terminal_emu_data_phase(FlipperSPITerminalEmu* emu) {
+    const FlipperSPITerminalEmuOp* op = emu->op;
+
+    emu->state = FlipperSPITerminalEmuStateData;
+    emu->address = (emu->header[1] << 16) | (emu->header[2] << 8) | emu->header[3];
+
+    // Sending is the time critical part
+    if(op->start != NULL) {
+        op->start(emu);
+    }
+
+    if(!op->receives) {
+        flipper_spi_terminal_emu_rx(&emu->discard, SPI_TERM_EMU_MAX_TRANSFER, false, true);
+    }
+
+    if(op->start == NULL && op->end == NULL) {
+        emu->stats.unknown++;
+    }
+}
+
+static void flipper_spi_terminal_emu_rx_isr(void* context) {
+    FlipperSPITerminalEmu* emu = context;
+
+    if(LL_DMA_IsActiveFlag_TE6(SPI_DMA)) {
+        LL_DMA_ClearFlag_TE6(SPI_DMA);
+    }
+
+    if(!LL_DMA_IsActiveFlag_TC6(SPI_DMA)) {
+        return;
+    }
+    LL_DMA_ClearFlag_TC6(SPI_DMA);
+
+    switch(emu->state) {
+    case FlipperSPITerminalEmuStateCommand:
+        emu->op = &flipper_spi_terminal_emu_ops[emu->header[0]];
+        if(emu->op->address_length > 0) {
+            emu->state = FlipperSPITerminalEmuStateAddress;
+            flipper_spi_terminal_emu_rx(emu->header + 1, emu->op->address_length, true, false);
+        } else {
+            flipper_spi_terminal_emu_data_phase(emu);
+        }
+        break;
+    case FlipperSPITerminalEmuStateAddress:
+        flipper_spi_terminal_emu_data_phase(emu);
+        break;
+    case FlipperSPITerminalEmuStateData:
+        emu->rx_wraps++;
+        break;
+    default:
+        break;
+    }
+}
+
+static void flipper_spi_terminal_emu_tx_isr(void* context) {
+    FlipperSPITerminalEmu* emu = context;
+
+    if(LL_DMA_IsActiveFlag_TE7(SPI_DMA)) {
+        LL_DMA_ClearFlag_TE7(SPI_DMA);
+    }
+
+    if(LL_DMA_IsActiveFlag_TC7(SPI_DMA)) {
+        LL_DMA_ClearFlag_TC7(SPI_DMA);
+        if(emu->state == FlipperSPITerminalEmuStateData && emu->op->tx_complete != NULL) {
+            emu->op->tx_complete(emu);
+        }
+    }
+}
+
+// Resets the SPI. This is the only way to drop the data, which is left in the TX FIFO.
+static void flipper_spi_terminal_emu_reset_spi(FlipperSPITerminalEmu* emu) {
+    furi_hal_bus_reset(FuriHalBusSPI1);
+    LL_SPI_Init(spi_terminal_spi, &emu->spi);
+    LL_SPI_SetRxFIFOThreshold(spi_terminal_spi, LL_SPI_RX_FIFO_TH_QUARTER);
+    // RX first, see RM0434 SPI DMA
+    LL_SPI_EnableDMAReq_RX(spi_terminal_spi);
+    LL_SPI_Enable(spi_terminal_spi);
+    LL_SPI_EnableDMAReq_TX(spi_terminal_spi);
+}
+
+static void flipper_spi_terminal_emu_cs_isr(void* context) {
+    FlipperSPITerminalEmu* emu = context;
+
+    if(!furi_hal_gpio_read(SPI_TERM_CS_PIN)) {
+        emu->state = FlipperSPITerminalEmuStateCommand;
+        flipper_spi_terminal_emu_rx(emu->header, 1, true, false);
+        return;
+    }
+
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+
+    if(emu->state == FlipperSPITerminalEmuStateData && emu->op->end != NULL) {
+        emu->op->end(emu);
+    }
+
+    if(emu->state != FlipperSPITerminalEmuStateIdle) {
+        emu->stats.transactions++;
+    }
+
+    emu->state = FlipperSPITerminalEmuStateIdle;
+    flipper_spi_terminal_emu_reset_spi(emu);
+}
+
+FlipperSPITerminalEmu* flipper_spi_terminal_emu_alloc(const uint8_t jedec_id[2]) {
+    FlipperSPITerminalEmu* emu = malloc(sizeof(FlipperSPITerminalEmu));
+    memset(emu, 0, sizeof(FlipperSPITerminalEmu));
+
+    emu->jedec_id[0] = jedec_id[0];
+    emu->jedec_id[1] = jedec_id[1];
+
+    return emu;
+}
+
+static void flipper_spi_terminal_emu_free_image(FlipperSPITerminalEmu* emu) {
+    free(emu->storage);
+    free(emu->dirty);
+    emu->storage = NULL;
+    emu->image = NULL;
+    emu->dirty = NULL;
+    emu->size = 0;
+    emu->sector_count = 0;
+}
+
+void flipper_spi_terminal_emu_free(FlipperSPITerminalEmu* emu) {
+    furi_check(emu);
+
+    flipper_spi_terminal_emu_stop(emu);
+    flipper_spi_terminal_emu_free_image(emu);
+    free(emu);
+}
+
+bool flipper_spi_terminal_emu_load(FlipperSPITerminalEmu* emu, const char* path) {
+    furi_check(emu);
+    furi_check(path);
+    furi_check(!emu->running);
+
+    flipper_spi_terminal_emu_free_image(emu);
+
+    bool loaded = false;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        const uint64_t size = storage_file_size(file);
+        const size_t sector_count =
+            (size + SPI_TERM_EMU_SECTOR_SIZE - 1) / SPI_TERM_EMU_SECTOR_SIZE;
+        const size_t dirty_size = (sector_count + 31) / 32 * sizeof(uint32_t);
+
+        if(size > 0 &&
+           size + 1 + dirty_size + SPI_TERM_EMU_HEAP_RESERVE <= memmgr_heap_get_max_free_block()) {
+            emu->storage = malloc(size + 1);
+            emu->dirty = malloc(dirty_size);
+            memset(emu->dirty, 0, dirty_size);
+            emu->storage[0] = 0xFF;
+            emu->image = emu->storage + 1;
+            emu->size = size;
+            emu->sector_count = sector_count;
+
+            loaded = storage_file_read(file, emu->image, size) == size;
+            if(!loaded) {
+                flipper_spi_terminal_emu_free_image(emu);
+            }
+        } else {
+            SPI_TERM_LOG_E("Image of %llu bytes does not fit into memory", size);
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(loaded) {
+        // log2 of the size, rounded up
+        emu->jedec_id[2] = emu->size > 1 ? 32 - __builtin_clz(emu->size - 1) : 0;
+    }
+
+    return loaded;
+}
+
+int32_t flipper_spi_terminal_emu_save(FlipperSPITerminalEmu* emu, const char* path) {
+    furi_check(emu);
+    furi_check(path);
+    furi_check(!emu->running);
+
+    int32_t saved = -1;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_EXISTING)) {
+        saved = 0;
+        for(size_t sector = 0; sector < emu->sector_count; sector++) {
+            if(!(emu->dirty[sector / 32] & (1UL << (sector % 32)))) {
+                continue;
+            }
+
+            const uint32_t address = sector * SPI_TERM_EMU_SECTOR_SIZE;
+            const size_t length = MIN(emu->size - address, SPI_TERM_EMU_SECTOR_SIZE);
+            if(!storage_file_seek(file, address, true) ||
+               storage_file_write(file, emu->image + address, length) != length) {
+                saved = -1;
+                break;
+            }
+
+            emu->dirty[sector / 32] &= ~(1UL << (sector % 32));
+            saved++;
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return saved;
+}
+
+size_t flipper_spi_terminal_emu_get_size(FlipperSPITerminalEmu* emu) {
+    furi_check(emu);
+    return emu->size;
+}
+
+size_t flipper_spi_terminal_emu_get_dirty_sectors(FlipperSPITerminalEmu* emu) {
+    furi_check(emu);
+
+    size_t count = 0;
+    for(size_t i = 0; i < (emu->sector_count + 31) / 32; i++) {
+        count += __builtin_popcount(emu->dirty[i]);
+    }
+    return count;
+}
+
+void flipper_spi_terminal_emu_start(FlipperSPITerminalEmu* emu, const LL_SPI_InitTypeDef* spi) {
+    furi_check(emu);
+    furi_check(spi);
+    furi_check(emu->image);
+
+    flipper_spi_terminal_emu_stop(emu);
+
+    SPI_TERM_LOG_T("Starting flash emulator");
+
+    emu->spi = *spi;
+    emu->spi.TransferDirection = LL_SPI_FULL_DUPLEX;
+    emu->spi.Mode = LL_SPI_MODE_SLAVE;
+    emu->spi.DataWidth = LL_SPI_DATAWIDTH_8BIT;
+    emu->spi.NSS = LL_SPI_NSS_SOFT;
+    emu->spi.CRCCalculation = LL_SPI_CRCCALCULATION_DISABLE;
+
+    emu->state = FlipperSPITerminalEmuStateIdle;
+    emu->status = 0;
+    memset(&emu->stats, 0, sizeof(emu->stats));
+
+    furi_hal_spi_bus_handle_init(spi_terminal_spi_bus_handle);
+    furi_hal_spi_acquire(spi_terminal_spi_bus_handle);
+
+    // The SPI is always selected. CS only marks the command boundaries.
+    furi_hal_gpio_init(SPI_TERM_CS_PIN, GpioModeInterruptRiseFall, GpioPullUp, GpioSpeedVeryHigh);
+
+    // Prepared once, commands only set address and length
+    LL_DMA_InitTypeDef rx_config = {
+        .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
+        .MemoryOrM2MDstAddress = (uint32_t)emu->header,
+        .Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY,
+        .Mode = LL_DMA_MODE_NORMAL,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
+        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
+        .NbData = 0,
+        .PeriphRequest = SPI_DMA_RX_REQ,
+        .Priority = LL_DMA_PRIORITY_VERYHIGH,
+    };
+    LL_DMA_Init(SPI_DMA, SPI_DMA_RX_CHANNEL, &rx_config);
+
+    LL_DMA_InitTypeDef tx_config = {
+        .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
+        .MemoryOrM2MDstAddress = (uint32_t)emu->image,
+        .Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+        .Mode = LL_DMA_MODE_NORMAL,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
+        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
+        .NbData = 0,
+        .PeriphRequest = SPI_DMA_TX_REQ,
+        .Priority = LL_DMA_PRIORITY_VERYHIGH,
+    };
+    LL_DMA_Init(SPI_DMA, SPI_DMA_TX_CHANNEL, &tx_config);
+
+    LL_DMA_ClearFlag_TC6(SPI_DMA);
+    LL_DMA_ClearFlag_TE6(SPI_DMA);
+    LL_DMA_ClearFlag_TC7(SPI_DMA);
+    LL_DMA_ClearFlag_TE7(SPI_DMA);
+    furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, flipper_spi_terminal_emu_rx_isr, emu);
+    furi_hal_interrupt_set_isr(SPI_DMA_TX_IRQ, flipper_spi_terminal_emu_tx_isr, emu);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_EnableIT_TE(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_EnableIT_TE(SPI_DMA, SPI_DMA_TX_CHANNEL);
+
+    flipper_spi_terminal_emu_reset_spi(emu);
+    emu->running = true;
+
+    furi_hal_gpio_add_int_callback(SPI_TERM_CS_PIN, flipper_spi_terminal_emu_cs_isr, emu);
+}
+
+void flipper_spi_terminal_emu_stop(FlipperSPITerminalEmu* emu) {
+    furi_check(emu);
+
+    if(!emu->running) {
+        return;
+    }
+
+    SPI_TERM_LOG_T("Stopping flash emulator");
+    furi_hal_gpio_remove_int_callback(SPI_TERM_CS_PIN);
+
+    LL_DMA_DisableIT_TC(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_DisableIT_TE(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_DisableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_DisableIT_TE(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, NULL, NULL);
+    furi_hal_interrupt_set_isr(SPI_DMA_TX_IRQ, NULL, NULL);
+
+    LL_SPI_DisableDMAReq_TX(spi_terminal_spi);
+    LL_SPI_DisableDMAReq_RX(spi_terminal_spi);
+    LL_DMA_DeInit(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_DeInit(SPI_DMA, SPI_DMA_TX_CHANNEL);
+
+    furi_hal_spi_release(spi_terminal_spi_bus_handle);
+    furi_hal_spi_bus_handle_deinit(spi_terminal_spi_bus_handle);
+
+    emu->running = false;
+}
+
+void flipper_spi_terminal_emu_get_stats(
+    FlipperSPITerminalEmu* emu,
+    FlipperSPITerminalEmuStats* stats) {
+    furi_check(emu);
+    furi_check(stats);
+
+    *stats = emu->stats;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_spi.h>
+
+// Slave mode SPI NOR flash emulator. Serves a memory image from RAM to a SPI master, which is
+// connected like a flash with CS on pin 4 (A4). Only usable, while the Terminal Screen is closed,
+// since it takes over the SPI and both DMA channels.
+//
+// The command byte is decoded in the RX DMA interrupt with a constant opcode table. The TX DMA
+// channel is configured in advance, only address and length are set per command. Read data starts
+// straight out of the image, fixed responses (JEDEC ID, status) are prefilled buffers.
+//
+// The first data byte has to be in the TX FIFO, before the master clocks it. FAST_READ (0x0B)
+// leaves a whole dummy byte for that. READ (0x03) and JEDEC ID (0x9F) only work, if the master
+// leaves a short pause after the address, or at low clock rates.
+//
+// Supported: READ, FAST_READ, JEDEC ID, read status, write enable/disable, page program, sector,
+// block and chip erase. Writes change the image and mark the sector as dirty.
+
+// Granularity of the dirty tracking
+#define SPI_TERM_EMU_SECTOR_SIZE 4096
+
+typedef struct FlipperSPITerminalEmu FlipperSPITerminalEmu;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t reads; // READ and FAST_READ
+    uint32_t programs; // Page programs, which changed the image
+    uint32_t erases;
+    uint32_t unknown; // Unsupported commands
+} FlipperSPITerminalEmuStats;
+
+// The capacity byte of jedec_id is ignored and derived from the image size
+FlipperSPITerminalEmu* flipper_spi_terminal_emu_alloc(const uint8_t jedec_id[2]);
+void flipper_spi_terminal_emu_free(FlipperSPITerminalEmu* emu);
+
+// Loads the whole image into RAM. Returns false, if it can not be read or does not fit.
+bool flipper_spi_terminal_emu_load(FlipperSPITerminalEmu* emu, const char* path);
+// Writes every dirty sector back into path. Returns the number of saved sectors or -1 on a error.
+int32_t flipper_spi_terminal_emu_save(FlipperSPITerminalEmu* emu, const char* path);
+size_t flipper_spi_terminal_emu_get_size(FlipperSPITerminalEmu* emu);
+size_t flipper_spi_terminal_emu_get_dirty_sectors(FlipperSPITerminalEmu* emu);
+
+// Takes the SPI bus. Polarity, phase and bit order are taken from spi, the rest is set up for a
+// slave with 8 bit frames.
+void flipper_spi_terminal_emu_start(FlipperSPITerminalEmu* emu, const LL_SPI_InitTypeDef* spi);
+// Releases the SPI bus
+void flipper_spi_terminal_emu_stop(FlipperSPITerminalEmu* emu);
+
+void flipper_spi_terminal_emu_get_stats(
+    FlipperSPITerminalEmu* emu,
+    FlipperSPITerminalEmuStats* stats);
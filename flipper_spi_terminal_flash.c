@@ -0,0 +1,745 @@
+#include "flipper_spi_terminal_flash.h"
+#include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_hw.h"
+#include "toolbox/byte_scan.h"
+#include "toolbox/crc32.h"
+
+#include <furi_hal_gpio.h>
+
+#define SPI_TERM_FLASH_CMD_READ_JEDEC_ID   0x9F
+#define SPI_TERM_FLASH_CMD_READ_SFDP       0x5A
+#define SPI_TERM_FLASH_CMD_FAST_READ       0x0B
+#define SPI_TERM_FLASH_CMD_FAST_READ_4B    0x0C
+#define SPI_TERM_FLASH_CMD_WRITE_ENABLE    0x06
+#define SPI_TERM_FLASH_CMD_READ_STATUS     0x05
+#define SPI_TERM_FLASH_CMD_PAGE_PROGRAM    0x02
+#define SPI_TERM_FLASH_CMD_PAGE_PROGRAM_4B 0x12
+#define SPI_TERM_FLASH_CMD_SECTOR_ERASE    0x20
+#define SPI_TERM_FLASH_CMD_SECTOR_ERASE_4B 0x21
+
+// Write in progress bit of the status register
+#define SPI_TERM_FLASH_STATUS_BUSY (1 << 0)
+
+// "SFDP", little endian
+#define SPI_TERM_FLASH_SFDP_SIGNATURE 0x50444653
+// Basic Flash Parameter Table, JESD216 6.3
+#define SPI_TERM_FLASH_SFDP_BASIC_ID 0xFF00
+
+// 4 MHz. SFDP is specified up to 50 MHz, but long wires are not.
+#define SPI_TERM_FLASH_PROBE_PRESCALER LL_SPI_BAUDRATEPRESCALER_DIV16
+#define SPI_TERM_FLASH_TIMEOUT_MS      1000
+// Typical flashes need up to 400 ms per sector
+#define SPI_TERM_FLASH_ERASE_TIMEOUT_MS 2000
+
+// Up to 16 MiB can be addressed with 3 bytes
+#define SPI_TERM_FLASH_3B_ADDRESS_LIMIT (16 * 1024 * 1024)
+
+// Largest batch, which is read before the bus is handed over to the SD card. A 16 MiB dump takes
+// 256 handovers instead of 2048 with the two blocks.
+#define SPI_TERM_FLASH_SD_BATCH_SIZE         (64 * 1024)
+// Free heap, which is left after the batch was allocated
+#define SPI_TERM_FLASH_SD_BATCH_HEAP_RESERVE (16 * 1024)
+
+struct FlipperSPITerminalFlash {
+    uint32_t prescaler;
+    FlipperSPITerminalFlashInfo info;
+    uint8_t* blocks[2];
+    uint8_t dummy; // Sent by the TX DMA channel during reads
+    uint8_t discard; // Received by the RX DMA channel during writes
+    uint8_t page[SPI_TERM_FLASH_PAGE_SIZE]; // Read back while programming
+};
+
+static void flipper_spi_terminal_flash_configure(uint32_t prescaler) {
+    // SPI mode 0, which is supported by every SPI NOR flash
+    LL_SPI_InitTypeDef config = {
+        .TransferDirection = LL_SPI_FULL_DUPLEX,
+        .Mode = LL_SPI_MODE_MASTER,
+        .DataWidth = LL_SPI_DATAWIDTH_8BIT,
+        .ClockPolarity = LL_SPI_POLARITY_LOW,
+        .ClockPhase = LL_SPI_PHASE_1EDGE,
+        .NSS = LL_SPI_NSS_SOFT,
+        .BaudRate = prescaler,
+        .BitOrder = LL_SPI_MSB_FIRST,
+        .CRCCalculation = LL_SPI_CRCCALCULATION_DISABLE,
+        .CRCPoly = 7,
+    };
+
+    LL_SPI_Disable(spi_terminal_spi);
+    LL_SPI_Init(spi_terminal_spi, &config);
+    LL_SPI_SetRxFIFOThreshold(spi_terminal_spi, LL_SPI_RX_FIFO_TH_QUARTER);
+    LL_SPI_Enable(spi_terminal_spi);
+}
+
+static void flipper_spi_terminal_flash_acquire(FlipperSPITerminalFlash* flash) {
+    furi_hal_spi_acquire(spi_terminal_spi_bus_handle);
+    // Overrides the configuration of the bus handle, which is applied by furi_hal_spi_acquire
+    flipper_spi_terminal_flash_configure(flash->prescaler);
+    // furi_hal_spi_acquire asserts CS
+    furi_hal_gpio_write(SPI_TERM_CS_PIN, true);
+}
+
+static void flipper_spi_terminal_flash_release(void) {
+    furi_hal_spi_release(spi_terminal_spi_bus_handle);
+}
+
+static void flipper_spi_terminal_flash_select(bool selected) {
+    furi_hal_gpio_write(SPI_TERM_CS_PIN, !selected);
+}
+
+// Polled full duplex transfer. tx == NULL sends 0xFF, rx == NULL drops the received bytes.
+static void flipper_spi_terminal_flash_transfer(const uint8_t* tx, uint8_t* rx, size_t length) {
+    for(size_t i = 0; i < length; i++) {
+        while(!LL_SPI_IsActiveFlag_TXE(spi_terminal_spi)) {
+        }
+        LL_SPI_TransmitData8(spi_terminal_spi, tx != NULL ? tx[i] : 0xFF);
+
+        while(!LL_SPI_IsActiveFlag_RXNE(spi_terminal_spi)) {
+        }
+        const uint8_t value = LL_SPI_ReceiveData8(spi_terminal_spi);
+        if(rx != NULL) {
+            rx[i] = value;
+        }
+    }
+}
+
+static void flipper_spi_terminal_flash_command(
+    const uint8_t* command,
+    size_t command_length,
+    uint8_t* data,
+    size_t length) {
+    flipper_spi_terminal_flash_select(true);
+    flipper_spi_terminal_flash_transfer(command, NULL, command_length);
+    flipper_spi_terminal_flash_transfer(NULL, data, length);
+    flipper_spi_terminal_flash_select(false);
+}
+
+// Command, address and optionally one dummy byte. Returns the header length.
+static size_t flipper_spi_terminal_flash_header(
+    uint8_t command,
+    uint32_t address,
+    bool four_byte_address,
+    bool dummy,
+    uint8_t header[6]) {
+    size_t length = 0;
+
+    header[length++] = command;
+    if(four_byte_address) {
+        header[length++] = address >> 24;
+    }
+    header[length++] = address >> 16;
+    header[length++] = address >> 8;
+    header[length++] = address;
+    if(dummy) {
+        header[length++] = 0;
+    }
+
+    return length;
+}
+
+static void flipper_spi_terminal_flash_read_sfdp(uint32_t address, uint8_t* data, size_t length) {
+    uint8_t header[6];
+    const size_t header_length = flipper_spi_terminal_flash_header(
+        SPI_TERM_FLASH_CMD_READ_SFDP, address, false, true, header);
+    flipper_spi_terminal_flash_command(header, header_length, data, length);
+}
+
+// Starts the DMA for a data phase of length bytes. tx == NULL sends 0xFF, rx == NULL drops the
+// received bytes. CS has to be asserted already.
+static void flipper_spi_terminal_flash_dma_start(
+    FlipperSPITerminalFlash* flash,
+    const uint8_t* tx,
+    uint8_t* rx,
+    size_t length) {
+    furi_check(length > 0 && length <= UINT16_MAX);
+
+    LL_DMA_InitTypeDef rx_config = {
+        .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
+        .MemoryOrM2MDstAddress = rx != NULL ? (uint32_t)rx : (uint32_t)&flash->discard,
+        .Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY,
+        .Mode = LL_DMA_MODE_NORMAL,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = rx != NULL ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT,
+        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
+        .NbData = length,
+        .PeriphRequest = SPI_DMA_RX_REQ,
+        .Priority = LL_DMA_PRIORITY_VERYHIGH,
+    };
+    LL_DMA_Init(SPI_DMA, SPI_DMA_RX_CHANNEL, &rx_config);
+
+    LL_DMA_InitTypeDef tx_config = {
+        .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
+        .MemoryOrM2MDstAddress = tx != NULL ? (uint32_t)tx : (uint32_t)&flash->dummy,
+        .Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+        .Mode = LL_DMA_MODE_NORMAL,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = tx != NULL ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT,
+        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
+        .NbData = length,
+        .PeriphRequest = SPI_DMA_TX_REQ,
+        .Priority = LL_DMA_PRIORITY_HIGH,
+    };
+    LL_DMA_Init(SPI_DMA, SPI_DMA_TX_CHANNEL, &tx_config);
+
+    LL_DMA_ClearFlag_TC6(SPI_DMA);
+    LL_DMA_ClearFlag_TE6(SPI_DMA);
+    LL_DMA_ClearFlag_TC7(SPI_DMA);
+    LL_DMA_ClearFlag_TE7(SPI_DMA);
+
+    // RX first, see RM0434 SPI DMA
+    LL_SPI_EnableDMAReq_RX(spi_terminal_spi);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_SPI_EnableDMAReq_TX(spi_terminal_spi);
+}
+
+// Sends the read command and starts the DMA for the data phase. CS stays asserted.
+static void flipper_spi_terminal_flash_read_start(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint8_t* data,
+    size_t length) {
+    uint8_t header[6];
+    const size_t header_length = flipper_spi_terminal_flash_header(
+        flash->info.four_byte_address ? SPI_TERM_FLASH_CMD_FAST_READ_4B :
+                                        SPI_TERM_FLASH_CMD_FAST_READ,
+        address,
+        flash->info.four_byte_address,
+        true,
+        header);
+
+    flipper_spi_terminal_flash_select(true);
+    // Also leaves the RX FIFO empty for the DMA
+    flipper_spi_terminal_flash_transfer(header, NULL, header_length);
+    flipper_spi_terminal_flash_dma_start(flash, NULL, data, length);
+}
+
+// Waits for the data phase started by flipper_spi_terminal_flash_dma_start and deasserts CS
+static bool flipper_spi_terminal_flash_dma_wait(void) {
+    bool ok = true;
+
+    // Every byte was received, once the RX channel is done. The bus is idle then.
+    const uint32_t start = furi_get_tick();
+    while(!LL_DMA_IsActiveFlag_TC6(SPI_DMA)) {
+        if(LL_DMA_IsActiveFlag_TE6(SPI_DMA) || LL_DMA_IsActiveFlag_TE7(SPI_DMA) ||
+           furi_get_tick() - start >= furi_ms_to_ticks(SPI_TERM_FLASH_TIMEOUT_MS)) {
+            ok = false;
+            break;
+        }
+    }
+
+    LL_SPI_DisableDMAReq_TX(spi_terminal_spi);
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_SPI_DisableDMAReq_RX(spi_terminal_spi);
+
+    flipper_spi_terminal_flash_select(false);
+    return ok;
+}
+
+FlipperSPITerminalFlash* flipper_spi_terminal_flash_alloc(uint32_t prescaler) {
+    FlipperSPITerminalFlash* flash = malloc(sizeof(FlipperSPITerminalFlash));
+    memset(flash, 0, sizeof(FlipperSPITerminalFlash));
+
+    flash->prescaler = prescaler;
+    flash->dummy = 0xFF;
+    flash->blocks[0] = malloc(SPI_TERM_FLASH_BLOCK_SIZE);
+    flash->blocks[1] = malloc(SPI_TERM_FLASH_BLOCK_SIZE);
+
+    furi_hal_spi_bus_handle_init(spi_terminal_spi_bus_handle);
+    flipper_spi_terminal_flash_acquire(flash);
+
+    return flash;
+}
+
+void flipper_spi_terminal_flash_free(FlipperSPITerminalFlash* flash) {
+    furi_check(flash);
+
+    LL_DMA_DeInit(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_DeInit(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    flipper_spi_terminal_flash_release();
+    furi_hal_spi_bus_handle_deinit(spi_terminal_spi_bus_handle);
+
+    free(flash->blocks[0]);
+    free(flash->blocks[1]);
+    free(flash);
+}
+
+static uint32_t flipper_spi_terminal_flash_read_u32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// Size from the Basic Flash Parameter Table. Returns 0, if there is no SFDP.
+static uint32_t flipper_spi_terminal_flash_sfdp_size(void) {
+    // SFDP header and the first parameter header, which is always the Basic Flash Parameter Table
+    uint8_t header[16];
+    flipper_spi_terminal_flash_read_sfdp(0, header, sizeof(header));
+    if(flipper_spi_terminal_flash_read_u32(header) != SPI_TERM_FLASH_SFDP_SIGNATURE) {
+        return 0;
+    }
+
+    const uint16_t id = header[8] | (header[15] << 8);
+    const uint8_t dwords = header[11];
+    const uint32_t pointer = header[12] | (header[13] << 8) | (header[14] << 16);
+    if(id != SPI_TERM_FLASH_SFDP_BASIC_ID || dwords < 2) {
+        return 0;
+    }
+
+    // 2nd DWORD: Density in bits
+    uint8_t table[8];
+    flipper_spi_terminal_flash_read_sfdp(pointer, table, sizeof(table));
+    const uint32_t density = flipper_spi_terminal_flash_read_u32(table + 4);
+    if(density & (1UL << 31)) {
+        // 2^N bits. Anything at or above 4 GiB can not be addressed here.
+        const uint32_t exponent = density & ~(1UL << 31);
+        return exponent >= 3 && exponent < 35 ? 1UL << (exponent - 3) : 0;
+    }
+
+    return (density + 1) / 8;
+}
+
+// Most vendors encode log2 of the size in the capacity byte of the JEDEC ID
+static uint32_t flipper_spi_terminal_flash_jedec_size(const uint8_t jedec_id[3]) {
+    const uint8_t capacity = jedec_id[2];
+    if(capacity >= 0x10 && capacity <= 0x1F) {
+        return 1UL << capacity;
+    } else if(capacity >= 0x20 && capacity <= 0x22) {
+        // Micron continues with 0x20 after 0x19
+        return 1UL << (capacity - 6);
+    }
+
+    return 0;
+}
+
+bool flipper_spi_terminal_flash_probe(
+    FlipperSPITerminalFlash* flash,
+    FlipperSPITerminalFlashInfo* info) {
+    furi_check(flash);
+    furi_check(info);
+
+    flipper_spi_terminal_flash_configure(SPI_TERM_FLASH_PROBE_PRESCALER);
+
+    memset(&flash->info, 0, sizeof(flash->info));
+    const uint8_t command = SPI_TERM_FLASH_CMD_READ_JEDEC_ID;
+    flipper_spi_terminal_flash_command(&command, 1, flash->info.jedec_id, 3);
+
+    // Floating or shorted MISO
+    const uint8_t* id = flash->info.jedec_id;
+    bool found = !(id[0] == 0x00 && id[1] == 0x00 && id[2] == 0x00) &&
+                 !(id[0] == 0xFF && id[1] == 0xFF && id[2] == 0xFF);
+
+    if(found) {
+        flash->info.size = flipper_spi_terminal_flash_sfdp_size();
+        flash->info.has_sfdp = flash->info.size > 0;
+        if(!flash->info.has_sfdp) {
+            flash->info.size = flipper_spi_terminal_flash_jedec_size(flash->info.jedec_id);
+        }
+        flash->info.four_byte_address = flash->info.size > SPI_TERM_FLASH_3B_ADDRESS_LIMIT;
+
+        SPI_TERM_LOG_D(
+            "Flash %02X %02X %02X, %lu bytes, SFDP %d",
+            id[0],
+            id[1],
+            id[2],
+            flash->info.size,
+            flash->info.has_sfdp);
+    }
+
+    flipper_spi_terminal_flash_configure(flash->prescaler);
+
+    *info = flash->info;
+    return found;
+}
+
+bool flipper_spi_terminal_flash_read(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint8_t* data,
+    size_t length) {
+    furi_check(flash);
+    furi_check(data);
+
+    while(length > 0) {
+        const size_t chunk = MIN(length, UINT16_MAX);
+        flipper_spi_terminal_flash_read_start(flash, address, data, chunk);
+        if(!flipper_spi_terminal_flash_dma_wait()) {
+            return false;
+        }
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+// Reads while the sink handles the previous block
+static uint32_t flipper_spi_terminal_flash_dump_pipelined(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSink sink,
+    void* context,
+    uint32_t* crc) {
+    uint32_t done = 0;
+    size_t current = 0;
+
+    flipper_spi_terminal_flash_read_start(
+        flash, address, flash->blocks[0], MIN(length, SPI_TERM_FLASH_BLOCK_SIZE));
+    while(done < length) {
+        const size_t block_length = MIN(length - done, SPI_TERM_FLASH_BLOCK_SIZE);
+        if(!flipper_spi_terminal_flash_dma_wait()) {
+            break;
+        }
+
+        const uint32_t next = done + block_length;
+        if(next < length) {
+            flipper_spi_terminal_flash_read_start(
+                flash,
+                address + next,
+                flash->blocks[current ^ 1],
+                MIN(length - next, SPI_TERM_FLASH_BLOCK_SIZE));
+        }
+
+        *crc = crc32_update(*crc, flash->blocks[current], block_length);
+        if(!sink(context, flash->blocks[current], block_length)) {
+            if(next < length) {
+                flipper_spi_terminal_flash_dma_wait();
+            }
+            break;
+        }
+
+        done = next;
+        current ^= 1;
+    }
+
+    return done;
+}
+
+// Whole blocks, as many as the heap allows. Returns NULL, if not more than the two blocks fit.
+static uint8_t* flipper_spi_terminal_flash_batch_alloc(size_t* size) {
+    const size_t free_block = memmgr_heap_get_max_free_block();
+    *size = 0;
+    if(free_block > SPI_TERM_FLASH_SD_BATCH_HEAP_RESERVE) {
+        *size = MIN(
+            free_block - SPI_TERM_FLASH_SD_BATCH_HEAP_RESERVE, SPI_TERM_FLASH_SD_BATCH_SIZE);
+        *size -= *size % SPI_TERM_FLASH_BLOCK_SIZE;
+    }
+
+    if(*size <= 2 * SPI_TERM_FLASH_BLOCK_SIZE) {
+        *size = 0;
+        return NULL;
+    }
+
+    return malloc(*size);
+}
+
+// Fills a large batch buffer or both blocks, before the bus is handed over to the SD card. Every
+// handover pauses the flash, so the batches are as large as the heap allows.
+static uint32_t flipper_spi_terminal_flash_dump_batched(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSink sink,
+    void* context,
+    uint32_t* crc) {
+    uint32_t done = 0;
+
+    size_t buffer_size;
+    uint8_t* buffer = flipper_spi_terminal_flash_batch_alloc(&buffer_size);
+    uint8_t* buffers[COUNT_OF(flash->blocks)] = {flash->blocks[0], flash->blocks[1]};
+    size_t buffer_count = COUNT_OF(flash->blocks);
+    if(buffer != NULL) {
+        buffers[0] = buffer;
+        buffer_count = 1;
+    } else {
+        buffer_size = SPI_TERM_FLASH_BLOCK_SIZE;
+    }
+
+    while(done < length) {
+        size_t buffer_lengths[COUNT_OF(flash->blocks)] = {0};
+        uint32_t batch = 0;
+        bool ok = true;
+
+        for(size_t i = 0; ok && i < buffer_count && done + batch < length; i++) {
+            buffer_lengths[i] = MIN(length - done - batch, buffer_size);
+            // One read command per block
+            for(size_t offset = 0; ok && offset < buffer_lengths[i];
+                offset += SPI_TERM_FLASH_BLOCK_SIZE) {
+                ok = flipper_spi_terminal_flash_read(
+                    flash,
+                    address + done + batch + offset,
+                    buffers[i] + offset,
+                    MIN(buffer_lengths[i] - offset, SPI_TERM_FLASH_BLOCK_SIZE));
+            }
+            batch += buffer_lengths[i];
+        }
+
+        if(!ok) {
+            break;
+        }
+
+        flipper_spi_terminal_flash_release();
+        for(size_t i = 0; ok && i < buffer_count && buffer_lengths[i] > 0; i++) {
+            *crc = crc32_update(*crc, buffers[i], buffer_lengths[i]);
+            ok = sink(context, buffers[i], buffer_lengths[i]);
+            if(ok) {
+                done += buffer_lengths[i];
+            }
+        }
+        flipper_spi_terminal_flash_acquire(flash);
+
+        if(!ok) {
+            break;
+        }
+    }
+
+    free(buffer);
+    return done;
+}
+
+void flipper_spi_terminal_flash_dump(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSink sink,
+    void* context,
+    bool sink_uses_sd,
+    FlipperSPITerminalFlashDumpResult* result) {
+    furi_check(flash);
+    furi_check(sink);
+    furi_check(result);
+
+    memset(result, 0, sizeof(FlipperSPITerminalFlashDumpResult));
+    const uint32_t start = furi_get_tick();
+
+    if(length > 0) {
+        result->bytes =
+            sink_uses_sd ?
+                flipper_spi_terminal_flash_dump_batched(
+                    flash, address, length, sink, context, &result->crc32) :
+                flipper_spi_terminal_flash_dump_pipelined(
+                    flash, address, length, sink, context, &result->crc32);
+    }
+
+    result->duration_ms = furi_get_tick() - start;
+    result->complete = result->bytes == length;
+}
+
+static bool flipper_spi_terminal_flash_is_blank(const uint8_t* data, size_t length) {
+    return byte_scan_find_not(data, length, 0xFF) == length;
+}
+
+static bool flipper_spi_terminal_flash_is_blank_sector(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address) {
+    for(size_t offset = 0; offset < SPI_TERM_FLASH_SECTOR_SIZE; offset += sizeof(flash->page)) {
+        if(!flipper_spi_terminal_flash_read(
+               flash, address + offset, flash->page, sizeof(flash->page))) {
+            return false;
+        }
+
+        if(!flipper_spi_terminal_flash_is_blank(flash->page, sizeof(flash->page))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void flipper_spi_terminal_flash_write_enable(void) {
+    const uint8_t command = SPI_TERM_FLASH_CMD_WRITE_ENABLE;
+    flipper_spi_terminal_flash_command(&command, 1, NULL, 0);
+}
+
+static bool flipper_spi_terminal_flash_wait_ready(uint32_t timeout_ms) {
+    const uint8_t command = SPI_TERM_FLASH_CMD_READ_STATUS;
+    const uint32_t start = furi_get_tick();
+
+    do {
+        uint8_t status;
+        flipper_spi_terminal_flash_command(&command, 1, &status, 1);
+        if(!(status & SPI_TERM_FLASH_STATUS_BUSY)) {
+            return true;
+        }
+    } while(furi_get_tick() - start < furi_ms_to_ticks(timeout_ms));
+
+    return false;
+}
+
+// Only starts the erase, see flipper_spi_terminal_flash_wait_ready
+static void
+    flipper_spi_terminal_flash_erase_start(FlipperSPITerminalFlash* flash, uint32_t address) {
+    uint8_t header[6];
+    const size_t header_length = flipper_spi_terminal_flash_header(
+        flash->info.four_byte_address ? SPI_TERM_FLASH_CMD_SECTOR_ERASE_4B :
+                                        SPI_TERM_FLASH_CMD_SECTOR_ERASE,
+        address,
+        flash->info.four_byte_address,
+        false,
+        header);
+
+    flipper_spi_terminal_flash_write_enable();
+    flipper_spi_terminal_flash_command(header, header_length, NULL, 0);
+}
+
+// Only starts programming, see flipper_spi_terminal_flash_wait_ready. data may not cross a page.
+static bool flipper_spi_terminal_flash_program_start(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    const uint8_t* data,
+    size_t length) {
+    uint8_t header[6];
+    const size_t header_length = flipper_spi_terminal_flash_header(
+        flash->info.four_byte_address ? SPI_TERM_FLASH_CMD_PAGE_PROGRAM_4B :
+                                        SPI_TERM_FLASH_CMD_PAGE_PROGRAM,
+        address,
+        flash->info.four_byte_address,
+        false,
+        header);
+
+    flipper_spi_terminal_flash_write_enable();
+    flipper_spi_terminal_flash_select(true);
+    flipper_spi_terminal_flash_transfer(header, NULL, header_length);
+    flipper_spi_terminal_flash_dma_start(flash, data, NULL, length);
+    // The page is programmed after CS was deasserted
+    return flipper_spi_terminal_flash_dma_wait();
+}
+
+// Loads the sector after the one, which is programmed right now
+typedef struct {
+    FlipperSPITerminalFlash* flash;
+    FlipperSPITerminalFlashSource source;
+    void* context;
+    bool source_uses_sd;
+    bool ok;
+
+    uint8_t* data;
+    size_t length;
+    size_t loaded;
+} FlipperSPITerminalFlashLoader;
+
+static void flipper_spi_terminal_flash_load(FlipperSPITerminalFlashLoader* loader, size_t max) {
+    const size_t length = MIN(max, loader->length - loader->loaded);
+    if(length == 0 || !loader->ok) {
+        return;
+    }
+
+    if(loader->source_uses_sd) {
+        flipper_spi_terminal_flash_release();
+    }
+    loader->ok = loader->source(loader->context, loader->data + loader->loaded, length);
+    if(loader->source_uses_sd) {
+        flipper_spi_terminal_flash_acquire(loader->flash);
+    }
+
+    loader->loaded += length;
+}
+
+// Compares the sector at address with data in page sized reads. Returns false on a bus error.
+static bool flipper_spi_terminal_flash_verify(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    const uint8_t* data,
+    size_t length,
+    FlipperSPITerminalFlashProgramResult* result) {
+    for(size_t offset = 0; offset < length; offset += sizeof(flash->page)) {
+        const size_t chunk = MIN(length - offset, sizeof(flash->page));
+        if(!flipper_spi_terminal_flash_read(flash, address + offset, flash->page, chunk)) {
+            return false;
+        }
+
+        // Skips over the matching runs
+        size_t i = byte_scan_match_length(flash->page, data + offset, chunk);
+        while(i < chunk) {
+            if(result->mismatches++ == 0) {
+                result->first_mismatch = address + offset + i;
+            }
+            i++;
+            i += byte_scan_match_length(flash->page + i, data + offset + i, chunk - i);
+        }
+    }
+
+    return true;
+}
+
+void flipper_spi_terminal_flash_program(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSource source,
+    void* context,
+    bool source_uses_sd,
+    FlipperSPITerminalFlashProgramResult* result) {
+    furi_check(flash);
+    furi_check(source);
+    furi_check(result);
+    furi_check(address % SPI_TERM_FLASH_SECTOR_SIZE == 0);
+
+    memset(result, 0, sizeof(FlipperSPITerminalFlashProgramResult));
+    const uint32_t start = furi_get_tick();
+
+    FlipperSPITerminalFlashLoader loader = {
+        .flash = flash,
+        .source = source,
+        .context = context,
+        .source_uses_sd = source_uses_sd,
+        .ok = true,
+        .data = flash->blocks[0],
+        .length = MIN(length, SPI_TERM_FLASH_SECTOR_SIZE),
+        .loaded = 0,
+    };
+    flipper_spi_terminal_flash_load(&loader, SIZE_MAX);
+
+    bool ok = loader.ok;
+    uint32_t done = 0;
+    size_t current = 0;
+    while(ok && done < length) {
+        const uint32_t sector = address + done;
+        const size_t sector_length = MIN(length - done, SPI_TERM_FLASH_SECTOR_SIZE);
+        const uint8_t* data = flash->blocks[current];
+
+        loader.data = flash->blocks[current ^ 1];
+        loader.length = MIN(length - done - sector_length, SPI_TERM_FLASH_SECTOR_SIZE);
+        loader.loaded = 0;
+
+        const bool blank = flipper_spi_terminal_flash_is_blank_sector(flash, sector);
+        if(blank) {
+            result->sectors_skipped++;
+        } else {
+            flipper_spi_terminal_flash_erase_start(flash, sector);
+            flipper_spi_terminal_flash_load(&loader, SIZE_MAX);
+            ok = flipper_spi_terminal_flash_wait_ready(SPI_TERM_FLASH_ERASE_TIMEOUT_MS);
+            result->sectors_erased++;
+        }
+
+        for(size_t offset = 0; ok && offset < sector_length; offset += SPI_TERM_FLASH_PAGE_SIZE) {
+            const size_t page_length = MIN(sector_length - offset, SPI_TERM_FLASH_PAGE_SIZE);
+            // Blank pages are already erased
+            if(flipper_spi_terminal_flash_is_blank(data + offset, page_length)) {
+                continue;
+            }
+
+            ok = flipper_spi_terminal_flash_program_start(
+                flash, sector + offset, data + offset, page_length);
+            flipper_spi_terminal_flash_load(&loader, SPI_TERM_FLASH_PAGE_SIZE);
+            ok = ok && flipper_spi_terminal_flash_wait_ready(SPI_TERM_FLASH_TIMEOUT_MS);
+        }
+
+        // Whatever was not loaded while the flash was busy
+        flipper_spi_terminal_flash_load(&loader, SIZE_MAX);
+        ok = ok && loader.ok &&
+             flipper_spi_terminal_flash_verify(flash, sector, data, sector_length, result);
+
+        if(ok) {
+            done += sector_length;
+            current ^= 1;
+        }
+    }
+
+    result->bytes = done;
+    result->duration_ms = furi_get_tick() - start;
+    result->complete = done == length;
+}
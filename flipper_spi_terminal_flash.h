@@ -0,0 +1,97 @@
+#pragma once
+
+#include <furi.h>
+
+// SPI NOR flash access in master mode. The flash is connected like any other SPI device, with CS
+// on pin 4 (A4). Only usable, while the Terminal Screen is closed, since it takes over the SPI and
+// both DMA channels.
+//
+// The size is detected with SFDP (JESD216). Flashes without SFDP are sized by the capacity byte of
+// the JEDEC ID. Reads use FAST_READ with 3 byte or, above 16 MiB, 4 byte addresses. The data
+// phase of every read is a single DMA transfer, the CPU only sends the command.
+
+// Smallest erasable unit (command 0x20) and largest programmable unit of common SPI NOR flashes
+#define SPI_TERM_FLASH_SECTOR_SIZE 4096
+#define SPI_TERM_FLASH_PAGE_SIZE   256
+// Bytes per read command. Two blocks are buffered while dumping, dumps to the SD card use a larger
+// batch, if the heap allows it. Each block holds one sector while programming.
+#define SPI_TERM_FLASH_BLOCK_SIZE SPI_TERM_FLASH_SECTOR_SIZE
+// 32 MHz, the fastest clock of the SPI
+#define SPI_TERM_FLASH_FAST_PRESCALER LL_SPI_BAUDRATEPRESCALER_DIV2
+// Dumps are stored with this extension in SPI_TERM_LAST_SETTINGS_DIR
+#define SPI_TERM_FLASH_DUMP_EXTENSION ".bin"
+
+typedef struct FlipperSPITerminalFlash FlipperSPITerminalFlash;
+
+typedef struct {
+    uint8_t jedec_id[3]; // Manufacturer, memory type, capacity
+    bool has_sfdp;
+    uint32_t size; // Bytes
+    bool four_byte_address;
+} FlipperSPITerminalFlashInfo;
+
+// Receives the dumped data in order. Returns false to cancel the dump.
+typedef bool (*FlipperSPITerminalFlashSink)(void* context, const uint8_t* data, size_t length);
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t crc32; // Over every dumped byte, see toolbox/crc32.h
+    uint32_t duration_ms;
+    bool complete; // false => canceled by the sink or the flash did not respond
+} FlipperSPITerminalFlashDumpResult;
+
+// Supplies the image while programming. Has to fill data completely, returns false on a error.
+typedef bool (*FlipperSPITerminalFlashSource)(void* context, uint8_t* data, size_t length);
+
+typedef struct {
+    uint32_t bytes; // Programmed and verified
+    uint32_t sectors_erased;
+    uint32_t sectors_skipped; // Were already blank
+    uint32_t mismatches; // Bytes, which differ from the image after programming
+    uint32_t first_mismatch; // Address, only valid if mismatches > 0
+    uint32_t duration_ms;
+    bool complete; // false => the source failed or the flash did not respond
+} FlipperSPITerminalFlashProgramResult;
+
+// Takes the SPI bus. prescaler is used for reads, probing always uses a safe speed.
+FlipperSPITerminalFlash* flipper_spi_terminal_flash_alloc(uint32_t prescaler);
+// Releases the SPI bus
+void flipper_spi_terminal_flash_free(FlipperSPITerminalFlash* flash);
+
+// Reads JEDEC ID and SFDP. Returns false, if no flash answered.
+bool flipper_spi_terminal_flash_probe(
+    FlipperSPITerminalFlash* flash,
+    FlipperSPITerminalFlashInfo* info);
+
+// Reads length bytes at address. Needs a successful probe.
+bool flipper_spi_terminal_flash_read(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint8_t* data,
+    size_t length);
+
+// Reads length bytes at address and passes them to sink in blocks. The next block is read by the
+// DMA, while sink handles the previous one. If sink_uses_sd is set, the bus is released around
+// every call of sink, since the SD card shares the SPI. sink gets batches of up to 64 KiB then.
+void flipper_spi_terminal_flash_dump(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSink sink,
+    void* context,
+    bool sink_uses_sd,
+    FlipperSPITerminalFlashDumpResult* result);
+
+// Programs length bytes from source at address, which has to be sector aligned. Every touched
+// sector is erased completely, unless it is blank already. While the flash is busy with an erase
+// or a page, the next data is loaded from source. Every sector is read back and compared with the
+// image right after it was programmed. If source_uses_sd is set, the bus is released around every
+// call of source.
+void flipper_spi_terminal_flash_program(
+    FlipperSPITerminalFlash* flash,
+    uint32_t address,
+    uint32_t length,
+    FlipperSPITerminalFlashSource source,
+    void* context,
+    bool source_uses_sd,
+    FlipperSPITerminalFlashProgramResult* result);
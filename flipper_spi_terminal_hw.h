@@ -0,0 +1,27 @@
+#pragma once
+
+#include <furi_hal_interrupt.h>
+#include <furi_hal_spi.h>
+
+#include <stm32wbxx_ll_dma.h>
+#include <stm32wbxx_ll_spi.h>
+
+#define spi_terminal_spi_bus_handle &furi_hal_spi_bus_handle_external
+#define spi_terminal_spi_bus        furi_hal_spi_bus_handle_external.bus
+#define spi_terminal_spi            SPI1
+
+// CS of the external SPI bus, see scene_about.c
+#define SPI_TERM_CS_PIN (&gpio_ext_pa4)
+
+// Copy&Paste from furi_hal_spi.c
+#define SPI_DMA            DMA2
+#define SPI_DMA_RX_REQ     LL_DMAMUX_REQ_SPI1_RX
+#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_6
+#define SPI_DMA_RX_IRQ     FuriHalInterruptIdDma2Ch6
+// NVIC line of SPI_DMA_RX_IRQ, e.g. to run its handler from software
+#define SPI_DMA_RX_IRQN    DMA2_Channel6_IRQn
+#define SPI_DMA_TX_REQ     LL_DMAMUX_REQ_SPI1_TX
+#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_7
+#define SPI_DMA_TX_IRQ     FuriHalInterruptIdDma2Ch7
+// NVIC line of SPI_DMA_TX_IRQ, e.g. to run its handler from software
+#define SPI_DMA_TX_IRQN    DMA2_Channel7_IRQn
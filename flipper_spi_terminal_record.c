@@ -0,0 +1,248 @@
+#include "flipper_spi_terminal_record.h"
+#include "flipper_spi_terminal.h"
+
+#include <storage/storage.h>
+
+#define SPI_TERM_RECORD_FILE_NAME "capture"
+// Most bytes, one call of the writer adds to the staging buffer
+#define SPI_TERM_RECORD_MAX_OUTPUT CAPTURE_FILE_WRITER_MAX_OUTPUT(SPI_TERM_RECORD_CHUNK_SIZE)
+// Free heap, which is left after the staging buffer was allocated
+#define SPI_TERM_RECORD_HEAP_RESERVE (16 * 1024)
+
+struct FlipperSPITerminalRecord {
+    Storage* storage;
+    File* file;
+    CaptureFileWriter* writer; // NULL => not open
+    uint8_t* buffer;
+    size_t buffer_size;
+    size_t length; // Staged bytes
+    bool direct; // The writer writes into the file. Only while opening and closing.
+    bool gap_pending; // Marked with the next frame end, once there is room
+    bool failed; // The file ends at a failed write
+    FlipperSPITerminalRecordStats stats;
+};
+
+static size_t
+    flipper_spi_terminal_record_io_write(void* context, const void* data, size_t length) {
+    FlipperSPITerminalRecord* record = context;
+
+    if(record->direct) {
+        return storage_file_write(record->file, data, length);
+    }
+
+    // Every writer call is checked against SPI_TERM_RECORD_MAX_OUTPUT first
+    furi_check(length <= record->buffer_size - record->length);
+    memcpy(record->buffer + record->length, data, length);
+    record->length += length;
+    return length;
+}
+
+// The next writer call fits into the staging buffer
+static bool flipper_spi_terminal_record_has_room(FlipperSPITerminalRecord* record) {
+    return record->buffer_size - record->length >= SPI_TERM_RECORD_MAX_OUTPUT;
+}
+
+static void flipper_spi_terminal_record_write_gap(FlipperSPITerminalRecord* record) {
+    capture_file_writer_end_frame(record->writer, true);
+    record->gap_pending = false;
+    record->stats.gaps++;
+}
+
+FlipperSPITerminalRecord* flipper_spi_terminal_record_alloc(size_t buffer_size) {
+    furi_check(buffer_size >= 2 * SPI_TERM_RECORD_MAX_OUTPUT);
+
+    if(buffer_size + SPI_TERM_RECORD_HEAP_RESERVE > memmgr_heap_get_max_free_block()) {
+        SPI_TERM_LOG_E("Staging buffer of %zu bytes does not fit into memory", buffer_size);
+        return NULL;
+    }
+
+    FlipperSPITerminalRecord* record = malloc(sizeof(FlipperSPITerminalRecord));
+    memset(record, 0, sizeof(FlipperSPITerminalRecord));
+    record->buffer = malloc(buffer_size);
+    record->buffer_size = buffer_size;
+
+    return record;
+}
+
+void flipper_spi_terminal_record_free(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+
+    flipper_spi_terminal_record_close(record);
+    free(record->buffer);
+    free(record);
+}
+
+bool flipper_spi_terminal_record_open(
+    FlipperSPITerminalRecord* record,
+    const CaptureFileHeader* header) {
+    furi_check(record);
+    furi_check(header);
+    furi_check(record->writer == NULL);
+
+    record->storage = furi_record_open(RECORD_STORAGE);
+    storage_common_mkdir(record->storage, SPI_TERM_LAST_SETTINGS_DIR);
+
+    FuriString* name = furi_string_alloc();
+    storage_get_next_filename(
+        record->storage,
+        SPI_TERM_LAST_SETTINGS_DIR,
+        SPI_TERM_RECORD_FILE_NAME,
+        SPI_TERM_RECORD_EXTENSION,
+        name,
+        255);
+    FuriString* path = furi_string_alloc_printf(
+        "%s/%s%s",
+        SPI_TERM_LAST_SETTINGS_DIR,
+        furi_string_get_cstr(name),
+        SPI_TERM_RECORD_EXTENSION);
+
+    record->length = 0;
+    record->gap_pending = false;
+    record->failed = false;
+    memset(&record->stats, 0, sizeof(record->stats));
+
+    record->file = storage_file_alloc(record->storage);
+    if(storage_file_open(record->file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_NEW)) {
+        const CaptureFileIo io = {
+            .context = record,
+            .write = flipper_spi_terminal_record_io_write,
+        };
+        record->direct = true;
+        record->writer = capture_file_writer_alloc(&io, header);
+        record->direct = false;
+    }
+
+    if(record->writer != NULL) {
+        SPI_TERM_LOG_I("Recording to %s", furi_string_get_cstr(path));
+    } else {
+        SPI_TERM_LOG_E("Can not create %s", furi_string_get_cstr(path));
+        storage_file_free(record->file);
+        record->file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        record->storage = NULL;
+    }
+
+    furi_string_free(path);
+    furi_string_free(name);
+
+    return record->writer != NULL;
+}
+
+void flipper_spi_terminal_record_close(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+
+    if(record->writer == NULL) {
+        return;
+    }
+
+    // The rest of the file is small, it is written directly
+    flipper_spi_terminal_record_flush(record);
+    if(!record->failed) {
+        record->direct = true;
+        if(!capture_file_writer_finish(record->writer)) {
+            SPI_TERM_LOG_E("Finishing the file failed");
+        }
+    }
+    capture_file_writer_free(record->writer);
+    record->writer = NULL;
+
+    storage_file_close(record->file);
+    storage_file_free(record->file);
+    record->file = NULL;
+    furi_record_close(RECORD_STORAGE);
+    record->storage = NULL;
+}
+
+bool flipper_spi_terminal_record_is_open(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+    return record->writer != NULL;
+}
+
+void flipper_spi_terminal_record_write(
+    FlipperSPITerminalRecord* record,
+    const uint8_t* data,
+    size_t length) {
+    furi_check(record);
+    furi_check(record->writer);
+
+    while(length > 0) {
+        if(!flipper_spi_terminal_record_has_room(record)) {
+            record->stats.bytes_dropped += length;
+            record->gap_pending = true;
+            return;
+        }
+
+        if(record->gap_pending) {
+            flipper_spi_terminal_record_write_gap(record);
+            continue;
+        }
+
+        const size_t part = MIN(length, (size_t)SPI_TERM_RECORD_CHUNK_SIZE);
+        capture_file_writer_write(record->writer, data, part);
+        data += part;
+        length -= part;
+    }
+}
+
+void flipper_spi_terminal_record_end_frame(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+    furi_check(record->writer);
+
+    // Without room, the data of the next frame is dropped anyway
+    if(!flipper_spi_terminal_record_has_room(record)) {
+        return;
+    }
+
+    if(record->gap_pending) {
+        flipper_spi_terminal_record_write_gap(record);
+    } else {
+        capture_file_writer_end_frame(record->writer, false);
+    }
+}
+
+void flipper_spi_terminal_record_mark_gap(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+
+    // Written with the next data. A gap at the end of the file does not matter.
+    record->gap_pending = true;
+}
+
+size_t flipper_spi_terminal_record_get_pending(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+    return record->length;
+}
+
+bool flipper_spi_terminal_record_is_high(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+    return record->length >= record->buffer_size / 2;
+}
+
+bool flipper_spi_terminal_record_flush(FlipperSPITerminalRecord* record) {
+    furi_check(record);
+
+    if(record->writer == NULL || record->length == 0) {
+        return !record->failed;
+    }
+
+    if(!record->failed) {
+        if(storage_file_write(record->file, record->buffer, record->length) == record->length) {
+            record->stats.bytes_written += record->length;
+            record->stats.flushes++;
+        } else {
+            SPI_TERM_LOG_E("Writing %zu bytes failed", record->length);
+            record->failed = true;
+        }
+    }
+
+    record->length = 0;
+    return !record->failed;
+}
+
+void flipper_spi_terminal_record_get_stats(
+    FlipperSPITerminalRecord* record,
+    FlipperSPITerminalRecordStats* stats) {
+    furi_check(record);
+    furi_check(stats);
+
+    *stats = record->stats;
+}
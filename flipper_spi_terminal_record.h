@@ -0,0 +1,59 @@
+#pragma once
+
+#include <furi.h>
+
+#include "toolbox/capture_file.h"
+
+// Records the capture of the Terminal Screen to the SD card as capture file, see
+// toolbox/capture_file.h. The file is written into a RAM buffer first and copied to the SD card in
+// large blocks. The SD card shares the SPI with the capture, so the capture has to be paused for
+// every copy. Everything, which is received in the meantime, is lost.
+
+#define SPI_TERM_RECORD_EXTENSION CAPTURE_FILE_EXTENSION
+// Bytes per data record of the file. A few records fit into the smallest staging buffer.
+#define SPI_TERM_RECORD_CHUNK_SIZE 1024
+
+typedef struct FlipperSPITerminalRecord FlipperSPITerminalRecord;
+
+typedef struct {
+    uint32_t bytes_written; // To the SD card
+    uint32_t flushes;
+    uint32_t gaps;
+    uint32_t bytes_dropped; // The staging buffer was full
+} FlipperSPITerminalRecordStats;
+
+// buffer_size has to hold at least two records and their index. Returns NULL, if the staging
+// buffer does not fit into memory.
+FlipperSPITerminalRecord* flipper_spi_terminal_record_alloc(size_t buffer_size);
+// Closes the file first
+void flipper_spi_terminal_record_free(FlipperSPITerminalRecord* record);
+
+// Creates the next free capture file in SPI_TERM_LAST_SETTINGS_DIR. Needs the SD card.
+bool flipper_spi_terminal_record_open(
+    FlipperSPITerminalRecord* record,
+    const CaptureFileHeader* header);
+// Writes the staged data, finishes the file and closes it. Needs the SD card.
+void flipper_spi_terminal_record_close(FlipperSPITerminalRecord* record);
+bool flipper_spi_terminal_record_is_open(FlipperSPITerminalRecord* record);
+
+// Stages data. Bytes, which do not fit, are dropped and marked as gap.
+void flipper_spi_terminal_record_write(
+    FlipperSPITerminalRecord* record,
+    const uint8_t* data,
+    size_t length);
+// The current frame ends, e.g. at a CS deassertion
+void flipper_spi_terminal_record_end_frame(FlipperSPITerminalRecord* record);
+// The next byte does not follow the previous one
+void flipper_spi_terminal_record_mark_gap(FlipperSPITerminalRecord* record);
+
+// Staged bytes
+size_t flipper_spi_terminal_record_get_pending(FlipperSPITerminalRecord* record);
+// The staging buffer is at least half full
+bool flipper_spi_terminal_record_is_high(FlipperSPITerminalRecord* record);
+// Copies the staged data to the SD card. Needs the SD card. Returns false on a write error. The
+// file ends there and nothing is written anymore.
+bool flipper_spi_terminal_record_flush(FlipperSPITerminalRecord* record);
+
+void flipper_spi_terminal_record_get_stats(
+    FlipperSPITerminalRecord* record,
+    FlipperSPITerminalRecordStats* stats);
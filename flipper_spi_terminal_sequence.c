@@ -0,0 +1,480 @@
+#include "flipper_spi_terminal_sequence.h"
+#include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_config.h"
+#include "toolbox/hex_string.h"
+
+#include <furi_hal_cortex.h>
+#include <storage/storage.h>
+
+#include <stdlib.h>
+
+#define SPI_TERM_SEQUENCE_MAX_CODE_SIZE 4096
+#define SPI_TERM_SEQUENCE_MAX_FILE_SIZE 8192
+#define SPI_TERM_SEQUENCE_MAX_LINE_SIZE 256
+#define SPI_TERM_SEQUENCE_MAX_DEPTH     4
+
+// Multi byte operands are stored little endian
+typedef enum {
+    SequenceOpEnd,
+    SequenceOpTransfer, // u16 length, data
+    SequenceOpFill, // u16 length, u8 fill byte
+    SequenceOpCsAssert,
+    SequenceOpCsDeassert,
+    SequenceOpDelay, // u32 microseconds
+    SequenceOpRepeat, // u16 count
+    SequenceOpLoop, // u16 offset of the first instruction after the matching repeat
+    SequenceOpExpect, // u16 line, u16 length, value, mask
+} SequenceOp;
+
+// Set on Transfer and Fill, if the received data is checked by a expect
+#define SEQUENCE_OP_CHECKED 0x80
+
+struct FlipperSPITerminalSequence {
+    uint8_t* code;
+    size_t size;
+};
+
+typedef struct {
+    uint8_t code[SPI_TERM_SEQUENCE_MAX_CODE_SIZE];
+    size_t size;
+    size_t loops[SPI_TERM_SEQUENCE_MAX_DEPTH]; // Offsets after the open repeats
+    size_t depth;
+    size_t last_transfer; // Offset of the last tx or read, SIZE_MAX => none
+    size_t last_transfer_length;
+    FuriString* error;
+    uint32_t line;
+} SequenceCompiler;
+
+static bool sequence_compiler_error(SequenceCompiler* compiler, const char* message) {
+    furi_string_printf(compiler->error, "Line %lu: %s", compiler->line, message);
+    return false;
+}
+
+static bool sequence_compiler_emit(SequenceCompiler* compiler, const void* data, size_t length) {
+    if(compiler->size + length > SPI_TERM_SEQUENCE_MAX_CODE_SIZE) {
+        return sequence_compiler_error(compiler, "Sequence is too long");
+    }
+
+    memcpy(compiler->code + compiler->size, data, length);
+    compiler->size += length;
+    return true;
+}
+
+static bool sequence_compiler_emit_u8(SequenceCompiler* compiler, uint8_t value) {
+    return sequence_compiler_emit(compiler, &value, sizeof(value));
+}
+
+static bool sequence_compiler_emit_u16(SequenceCompiler* compiler, uint16_t value) {
+    const uint8_t data[] = {value, value >> 8};
+    return sequence_compiler_emit(compiler, data, sizeof(data));
+}
+
+static bool sequence_compiler_emit_u32(SequenceCompiler* compiler, uint32_t value) {
+    const uint8_t data[] = {value, value >> 8, value >> 16, value >> 24};
+    return sequence_compiler_emit(compiler, data, sizeof(data));
+}
+
+static bool sequence_parse_number(const char* str, uint32_t min, uint32_t max, uint32_t* value) {
+    char* end;
+    const unsigned long number = strtoul(str, &end, 0);
+    while(*end == ' ' || *end == '\t') {
+        end++;
+    }
+
+    if(end == str || *end != '\0' || number < min || number > max) {
+        return false;
+    }
+
+    *value = number;
+    return true;
+}
+
+static bool sequence_compile_transfer(SequenceCompiler* compiler, const char* args) {
+    uint8_t data[SPI_TERM_SEQUENCE_MAX_LINE_SIZE / 2];
+    const int length = hex_string_decode(args, data, sizeof(data));
+    if(length <= 0) {
+        return sequence_compiler_error(compiler, "Invalid hex data");
+    }
+
+    compiler->last_transfer = compiler->size;
+    compiler->last_transfer_length = length;
+    return sequence_compiler_emit_u8(compiler, SequenceOpTransfer) &&
+           sequence_compiler_emit_u16(compiler, length) &&
+           sequence_compiler_emit(compiler, data, length);
+}
+
+static bool sequence_compile_read(SequenceCompiler* compiler, char* args) {
+    uint8_t fill = 0xFF;
+    char* fill_str = strchr(args, ' ');
+    if(fill_str != NULL) {
+        *fill_str++ = '\0';
+        if(hex_string_decode(fill_str, &fill, sizeof(fill)) != 1) {
+            return sequence_compiler_error(compiler, "Invalid fill byte");
+        }
+    }
+
+    uint32_t length;
+    if(!sequence_parse_number(args, 1, UINT16_MAX, &length)) {
+        return sequence_compiler_error(compiler, "Invalid count");
+    }
+
+    compiler->last_transfer = compiler->size;
+    compiler->last_transfer_length = length;
+    return sequence_compiler_emit_u8(compiler, SequenceOpFill) &&
+           sequence_compiler_emit_u16(compiler, length) &&
+           sequence_compiler_emit_u8(compiler, fill);
+}
+
+static bool sequence_compile_expect(SequenceCompiler* compiler, char* args) {
+    if(compiler->last_transfer == SIZE_MAX) {
+        return sequence_compiler_error(compiler, "expect needs a tx or read before it");
+    }
+
+    uint8_t value[SPI_TERM_SEQUENCE_MAX_LINE_SIZE / 2];
+    uint8_t mask[SPI_TERM_SEQUENCE_MAX_LINE_SIZE / 2];
+
+    char* mask_str = strstr(args, "mask");
+    if(mask_str != NULL) {
+        *mask_str = '\0';
+        mask_str += strlen("mask");
+    }
+
+    const int length = hex_string_decode(args, value, sizeof(value));
+    if(length <= 0) {
+        return sequence_compiler_error(compiler, "Invalid hex data");
+    }
+
+    if(mask_str == NULL) {
+        memset(mask, 0xFF, length);
+    } else if(hex_string_decode(mask_str, mask, sizeof(mask)) != length) {
+        return sequence_compiler_error(compiler, "Mask needs to be as long as the value");
+    }
+
+    if((size_t)length > compiler->last_transfer_length) {
+        return sequence_compiler_error(compiler, "expect is longer than the tx or read");
+    }
+
+    if(compiler->last_transfer_length > SPI_TERM_SEQUENCE_MAX_CHECKED_LENGTH) {
+        return sequence_compiler_error(compiler, "tx or read is too long for a expect");
+    }
+
+    compiler->code[compiler->last_transfer] |= SEQUENCE_OP_CHECKED;
+    return sequence_compiler_emit_u8(compiler, SequenceOpExpect) &&
+           sequence_compiler_emit_u16(compiler, compiler->line) &&
+           sequence_compiler_emit_u16(compiler, length) &&
+           sequence_compiler_emit(compiler, value, length) &&
+           sequence_compiler_emit(compiler, mask, length);
+}
+
+static bool sequence_compile_line(SequenceCompiler* compiler, char* line) {
+    // Comments and trailing white space
+    char* comment = strchr(line, '#');
+    if(comment != NULL) {
+        *comment = '\0';
+    }
+
+    size_t length = strlen(line);
+    while(length > 0 && strchr(" \t\r", line[length - 1]) != NULL) {
+        line[--length] = '\0';
+    }
+
+    while(*line == ' ' || *line == '\t') {
+        line++;
+    }
+
+    if(*line == '\0') {
+        return true;
+    }
+
+    // Instruction and arguments
+    char* args = line + strcspn(line, " \t");
+    if(*args != '\0') {
+        *args++ = '\0';
+        while(*args == ' ' || *args == '\t') {
+            args++;
+        }
+    }
+
+    uint32_t value;
+    if(strcmp(line, "tx") == 0) {
+        return sequence_compile_transfer(compiler, args);
+    } else if(strcmp(line, "read") == 0) {
+        return sequence_compile_read(compiler, args);
+    } else if(strcmp(line, "expect") == 0) {
+        return sequence_compile_expect(compiler, args);
+    } else if(strcmp(line, "cs") == 0) {
+        if(strcmp(args, "low") == 0) {
+            return sequence_compiler_emit_u8(compiler, SequenceOpCsAssert);
+        } else if(strcmp(args, "high") == 0) {
+            return sequence_compiler_emit_u8(compiler, SequenceOpCsDeassert);
+        }
+        return sequence_compiler_error(compiler, "cs needs low or high");
+    } else if(strcmp(line, "delay") == 0) {
+        if(!sequence_parse_number(args, 0, UINT32_MAX, &value)) {
+            return sequence_compiler_error(compiler, "Invalid delay");
+        }
+        return sequence_compiler_emit_u8(compiler, SequenceOpDelay) &&
+               sequence_compiler_emit_u32(compiler, value);
+    } else if(strcmp(line, "repeat") == 0) {
+        if(!sequence_parse_number(args, 1, UINT16_MAX, &value)) {
+            return sequence_compiler_error(compiler, "Invalid count");
+        }
+        if(compiler->depth == SPI_TERM_SEQUENCE_MAX_DEPTH) {
+            return sequence_compiler_error(compiler, "Too many nested repeats");
+        }
+        if(!sequence_compiler_emit_u8(compiler, SequenceOpRepeat) ||
+           !sequence_compiler_emit_u16(compiler, value)) {
+            return false;
+        }
+        compiler->loops[compiler->depth++] = compiler->size;
+        compiler->last_transfer = SIZE_MAX;
+        return true;
+    } else if(strcmp(line, "end") == 0) {
+        if(compiler->depth == 0) {
+            return sequence_compiler_error(compiler, "end without repeat");
+        }
+        compiler->last_transfer = SIZE_MAX;
+        return sequence_compiler_emit_u8(compiler, SequenceOpLoop) &&
+               sequence_compiler_emit_u16(compiler, compiler->loops[--compiler->depth]);
+    }
+
+    return sequence_compiler_error(compiler, "Unknown instruction");
+}
+
+FlipperSPITerminalSequence*
+    flipper_spi_terminal_sequence_compile(const char* text, FuriString* error) {
+    furi_check(text);
+    furi_check(error);
+
+    SequenceCompiler* compiler = malloc(sizeof(SequenceCompiler));
+    compiler->size = 0;
+    compiler->depth = 0;
+    compiler->last_transfer = SIZE_MAX;
+    compiler->error = error;
+    compiler->line = 0;
+
+    bool ok = true;
+    char line[SPI_TERM_SEQUENCE_MAX_LINE_SIZE];
+    while(ok && *text != '\0') {
+        compiler->line++;
+
+        const size_t length = strcspn(text, "\n");
+        if(length >= sizeof(line)) {
+            ok = sequence_compiler_error(compiler, "Line is too long");
+            break;
+        }
+
+        memcpy(line, text, length);
+        line[length] = '\0';
+        text += length;
+        if(*text == '\n') {
+            text++;
+        }
+
+        ok = sequence_compile_line(compiler, line);
+    }
+
+    if(ok && compiler->depth > 0) {
+        ok = sequence_compiler_error(compiler, "repeat without end");
+    }
+
+    if(ok) {
+        ok = sequence_compiler_emit_u8(compiler, SequenceOpEnd);
+    }
+
+    FlipperSPITerminalSequence* sequence = NULL;
+    if(ok) {
+        sequence = malloc(sizeof(FlipperSPITerminalSequence));
+        sequence->size = compiler->size;
+        sequence->code = malloc(compiler->size);
+        memcpy(sequence->code, compiler->code, compiler->size);
+    }
+
+    free(compiler);
+    return sequence;
+}
+
+FlipperSPITerminalSequence*
+    flipper_spi_terminal_sequence_load(const char* name, FuriString* error) {
+    furi_check(name);
+    furi_check(error);
+
+    FuriString* path = furi_string_alloc_printf(
+        "%s/%s%s", SPI_TERM_LAST_SETTINGS_DIR, name, SPI_TERM_SEQUENCE_EXTENSION);
+    SPI_TERM_LOG_D("Loading sequence %s", furi_string_get_cstr(path));
+
+    FlipperSPITerminalSequence* sequence = NULL;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        const uint64_t size = storage_file_size(file);
+        if(size <= SPI_TERM_SEQUENCE_MAX_FILE_SIZE) {
+            char* text = malloc(size + 1);
+            text[storage_file_read(file, text, size)] = '\0';
+            sequence = flipper_spi_terminal_sequence_compile(text, error);
+            free(text);
+        } else {
+            furi_string_set_str(error, "File is too large");
+        }
+    } else {
+        furi_string_printf(error, "Can not open %s", furi_string_get_cstr(path));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    furi_string_free(path);
+    return sequence;
+}
+
+void flipper_spi_terminal_sequence_free(FlipperSPITerminalSequence* sequence) {
+    furi_check(sequence);
+
+    free(sequence->code);
+    free(sequence);
+}
+
+size_t flipper_spi_terminal_sequence_get_size(const FlipperSPITerminalSequence* sequence) {
+    furi_check(sequence);
+    return sequence->size;
+}
+
+static uint16_t sequence_read_u16(const uint8_t* code, size_t* pc) {
+    const uint16_t value = code[*pc] | (code[*pc + 1] << 8);
+    *pc += 2;
+    return value;
+}
+
+static uint32_t sequence_read_u32(const uint8_t* code, size_t* pc) {
+    const uint32_t value = code[*pc] | (code[*pc + 1] << 8) | (code[*pc + 2] << 16) |
+                           ((uint32_t)code[*pc + 3] << 24);
+    *pc += 4;
+    return value;
+}
+
+static bool sequence_fill(const FlipperSPITerminalSequenceBus* bus, size_t length, uint8_t fill) {
+    uint8_t data[64];
+    memset(data, fill, sizeof(data));
+
+    while(length > 0) {
+        const size_t chunk = MIN(length, sizeof(data));
+        if(!bus->transfer(bus->context, data, chunk)) {
+            return false;
+        }
+        length -= chunk;
+    }
+
+    return true;
+}
+
+static void sequence_delay_us(uint32_t delay) {
+    if(delay >= 1000) {
+        furi_delay_ms(delay / 1000);
+    }
+    furi_hal_cortex_delay_us(delay % 1000);
+}
+
+void flipper_spi_terminal_sequence_run(
+    const FlipperSPITerminalSequence* sequence,
+    const FlipperSPITerminalSequenceBus* bus,
+    FlipperSPITerminalSequenceResult* result) {
+    furi_check(sequence);
+    furi_check(bus);
+    furi_check(result);
+
+    memset(result, 0, sizeof(FlipperSPITerminalSequenceResult));
+
+    struct {
+        size_t start;
+        uint16_t remaining;
+    } loops[SPI_TERM_SEQUENCE_MAX_DEPTH];
+    size_t depth = 0;
+
+    uint8_t* received = malloc(SPI_TERM_SEQUENCE_MAX_CHECKED_LENGTH);
+    const uint8_t* code = sequence->code;
+    size_t pc = 0;
+    bool cs_asserted = false;
+    bool ok = true;
+
+    while(ok) {
+        const uint8_t op = code[pc++];
+        if(op == SequenceOpEnd) {
+            break;
+        }
+
+        result->instructions++;
+        switch(op & ~SEQUENCE_OP_CHECKED) {
+        case SequenceOpTransfer:
+        case SequenceOpFill: {
+            const uint16_t length = sequence_read_u16(code, &pc);
+            if((op & ~SEQUENCE_OP_CHECKED) == SequenceOpTransfer) {
+                ok = bus->transfer(bus->context, code + pc, length);
+                pc += length;
+            } else {
+                ok = sequence_fill(bus, length, code[pc++]);
+            }
+            result->bytes += length;
+
+            if(ok && (op & SEQUENCE_OP_CHECKED)) {
+                ok = bus->receive(bus->context, received, length);
+            }
+            break;
+        }
+        case SequenceOpCsAssert:
+        case SequenceOpCsDeassert:
+            ok = bus->wait_idle(bus->context);
+            cs_asserted = op == SequenceOpCsAssert;
+            bus->set_cs(bus->context, cs_asserted);
+            break;
+        case SequenceOpDelay: {
+            const uint32_t delay = sequence_read_u32(code, &pc);
+            ok = bus->wait_idle(bus->context);
+            sequence_delay_us(delay);
+            break;
+        }
+        case SequenceOpRepeat:
+            loops[depth].remaining = sequence_read_u16(code, &pc);
+            loops[depth].start = pc;
+            depth++;
+            break;
+        case SequenceOpLoop: {
+            const uint16_t start = sequence_read_u16(code, &pc);
+            if(--loops[depth - 1].remaining > 0) {
+                pc = start;
+            } else {
+                depth--;
+            }
+            break;
+        }
+        case SequenceOpExpect: {
+            const uint16_t line = sequence_read_u16(code, &pc);
+            const uint16_t length = sequence_read_u16(code, &pc);
+            const uint8_t* value = code + pc;
+            const uint8_t* mask = value + length;
+            pc += length * 2;
+
+            for(size_t i = 0; i < length; i++) {
+                if((received[i] & mask[i]) != (value[i] & mask[i])) {
+                    if(result->failed_expects++ == 0) {
+                        result->first_failed_line = line;
+                    }
+                    break;
+                }
+            }
+            break;
+        }
+        default:
+            furi_crash("Bad sequence op!");
+        }
+    }
+
+    if(!ok) {
+        result->aborted = true;
+        // Do not leave the device selected
+        if(cs_asserted) {
+            bus->set_cs(bus->context, false);
+        }
+    }
+
+    free(received);
+}
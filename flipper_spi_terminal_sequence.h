@@ -0,0 +1,59 @@
+#pragma once
+
+#include <furi.h>
+
+// Master mode transaction sequences. A sequence file is a text file with one instruction per line.
+// It is compiled once into a compact bytecode, which runs without any parsing at bus speed.
+//
+//   # Comment
+//   cs low|high               Asserts or deasserts CS
+//   tx <hex>                  Sends the bytes <hex>, e.g. "tx 9F" or "tx 03 00 10 00"
+//   read <count> [fill]       Sends <count> fill bytes (default FF) to read <count> bytes
+//   delay <us>                Waits <us> microseconds after everything was sent
+//   repeat <count> ... end    Runs the enclosed instructions <count> times
+//   expect <hex> [mask <hex>] Compares the first received bytes of the previous tx or read
+//
+// Transfers are queued back to back. Only instructions, which depend on the bus state (cs, delay
+// and expect), wait until the transfers before them are done.
+
+#define SPI_TERM_SEQUENCE_EXTENSION ".spiseq"
+
+// Longest tx, read or expect, which is checked by an expect
+#define SPI_TERM_SEQUENCE_MAX_CHECKED_LENGTH 256
+
+typedef struct FlipperSPITerminalSequence FlipperSPITerminalSequence;
+
+// Access to the bus while a sequence is running
+typedef struct {
+    void* context;
+    // Queues data for sending. Returns false, if not everything was queued.
+    bool (*transfer)(void* context, const uint8_t* data, size_t length);
+    // Waits until every queued byte was sent. Returns false on a timeout.
+    bool (*wait_idle)(void* context);
+    void (*set_cs)(void* context, bool asserted);
+    // Returns the received bytes of the last length transferred bytes
+    bool (*receive)(void* context, uint8_t* data, size_t length);
+} FlipperSPITerminalSequenceBus;
+
+typedef struct {
+    uint32_t instructions;
+    uint32_t bytes;
+    uint32_t failed_expects;
+    uint32_t first_failed_line; // 0 => every expect matched
+    bool aborted; // A bus operation failed
+} FlipperSPITerminalSequenceResult;
+
+// Returns NULL on a error. error describes the error including the line number.
+FlipperSPITerminalSequence*
+    flipper_spi_terminal_sequence_compile(const char* text, FuriString* error);
+// Loads and compiles name from SPI_TERM_LAST_SETTINGS_DIR
+FlipperSPITerminalSequence*
+    flipper_spi_terminal_sequence_load(const char* name, FuriString* error);
+void flipper_spi_terminal_sequence_free(FlipperSPITerminalSequence* sequence);
+// Size of the bytecode
+size_t flipper_spi_terminal_sequence_get_size(const FlipperSPITerminalSequence* sequence);
+
+void flipper_spi_terminal_sequence_run(
+    const FlipperSPITerminalSequence* sequence,
+    const FlipperSPITerminalSequenceBus* bus,
+    FlipperSPITerminalSequenceResult* result);
@@ -0,0 +1,141 @@
+#include "flipper_spi_terminal_sim.h"
+#include "flipper_spi_terminal.h"
+
+#define SPI_TERM_SIM_FLAG_STOP (1 << 0)
+
+struct FlipperSPITerminalSim {
+    FuriThread* thread;
+    FlipperSPITerminalSimChunkCallback callback;
+    void* context;
+
+    uint32_t bit_rate;
+    size_t chunk_size;
+    uint8_t* dma_buffer; // Two halves of chunk_size, just like the real RX DMA buffer
+    uint8_t pattern;
+
+    FlipperSPITerminalSimStats stats;
+};
+
+static void flipper_spi_terminal_sim_fill_half(FlipperSPITerminalSim* sim, uint8_t* half) {
+    // Incrementing bytes. This covers every value and makes lost bytes easy to spot.
+    for(size_t i = 0; i < sim->chunk_size; i++) {
+        half[i] = sim->pattern++;
+    }
+}
+
+static int32_t flipper_spi_terminal_sim_thread(void* context) {
+    furi_check(context);
+    FlipperSPITerminalSim* sim = context;
+
+    const uint64_t bytes_per_second = sim->bit_rate / 8;
+    const uint32_t start = furi_get_tick();
+    const uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    uint64_t bytes_generated = 0;
+    size_t half = 0;
+
+    while(true) {
+        const uint64_t elapsed = furi_get_tick() - start;
+        const uint64_t bytes_due = elapsed * bytes_per_second / tick_frequency;
+
+        while(bytes_generated + sim->chunk_size <= bytes_due) {
+            uint8_t* data = sim->dma_buffer + (half * sim->chunk_size);
+            flipper_spi_terminal_sim_fill_half(sim, data);
+
+            size_t accepted = sim->callback(sim->context, data, sim->chunk_size);
+
+            bytes_generated += sim->chunk_size;
+            sim->stats.bytes_generated += sim->chunk_size;
+            sim->stats.bytes_accepted += accepted;
+            sim->stats.chunks++;
+
+            half ^= 1;
+
+            if(furi_thread_flags_get() & SPI_TERM_SIM_FLAG_STOP) {
+                break;
+            }
+        }
+
+        // Wait for the next tick or a stop request
+        uint32_t flags = furi_thread_flags_wait(SPI_TERM_SIM_FLAG_STOP, FuriFlagWaitAny, 1);
+        if(!(flags & FuriFlagError) && (flags & SPI_TERM_SIM_FLAG_STOP)) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+FlipperSPITerminalSim*
+    flipper_spi_terminal_sim_alloc(FlipperSPITerminalSimChunkCallback callback, void* context) {
+    furi_check(callback);
+
+    FlipperSPITerminalSim* sim = malloc(sizeof(FlipperSPITerminalSim));
+    memset(sim, 0, sizeof(FlipperSPITerminalSim));
+
+    sim->callback = callback;
+    sim->context = context;
+
+    return sim;
+}
+
+void flipper_spi_terminal_sim_free(FlipperSPITerminalSim* sim) {
+    furi_check(sim);
+
+    flipper_spi_terminal_sim_stop(sim);
+
+    free(sim);
+}
+
+void flipper_spi_terminal_sim_start(
+    FlipperSPITerminalSim* sim,
+    uint32_t bit_rate,
+    size_t chunk_size) {
+    furi_check(sim);
+    furi_check(chunk_size >= 1);
+    furi_check(bit_rate >= 8);
+
+    flipper_spi_terminal_sim_stop(sim);
+
+    SPI_TERM_LOG_D("Starting simulation with %lu bit/s in %zu byte chunks", bit_rate, chunk_size);
+
+    sim->bit_rate = bit_rate;
+    sim->chunk_size = chunk_size;
+    sim->dma_buffer = malloc(chunk_size * 2);
+    sim->pattern = 0;
+    memset(&sim->stats, 0, sizeof(sim->stats));
+
+    sim->thread = furi_thread_alloc_ex("SpiTermSim", 1024, flipper_spi_terminal_sim_thread, sim);
+    furi_thread_start(sim->thread);
+}
+
+void flipper_spi_terminal_sim_stop(FlipperSPITerminalSim* sim) {
+    furi_check(sim);
+
+    if(sim->thread == NULL) {
+        return;
+    }
+
+    SPI_TERM_LOG_D("Stopping simulation");
+
+    furi_thread_flags_set(furi_thread_get_id(sim->thread), SPI_TERM_SIM_FLAG_STOP);
+    furi_thread_join(sim->thread);
+    furi_thread_free(sim->thread);
+    sim->thread = NULL;
+
+    free(sim->dma_buffer);
+    sim->dma_buffer = NULL;
+}
+
+bool flipper_spi_terminal_sim_is_running(FlipperSPITerminalSim* sim) {
+    furi_check(sim);
+    return sim->thread != NULL;
+}
+
+void flipper_spi_terminal_sim_get_stats(
+    FlipperSPITerminalSim* sim,
+    FlipperSPITerminalSimStats* stats) {
+    furi_check(sim);
+    furi_check(stats);
+
+    *stats = sim->stats;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <furi.h>
+
+// Simulated DMA source. Emulates a circular RX DMA buffer, which is filled with a test pattern at
+// a fixed bit rate. Every completed half is passed to a callback, like the DMA half/full transfer
+// interrupt does. This allows the capture path to be tested without a external SPI device.
+
+typedef struct FlipperSPITerminalSim FlipperSPITerminalSim;
+
+// Called for every completed half of the simulated DMA buffer. Returns the accepted byte count.
+typedef size_t (*FlipperSPITerminalSimChunkCallback)(
+    void* context,
+    const uint8_t* data,
+    size_t length);
+
+typedef struct {
+    uint64_t bytes_generated;
+    uint64_t bytes_accepted;
+    uint32_t chunks;
+} FlipperSPITerminalSimStats;
+
+FlipperSPITerminalSim*
+    flipper_spi_terminal_sim_alloc(FlipperSPITerminalSimChunkCallback callback, void* context);
+void flipper_spi_terminal_sim_free(FlipperSPITerminalSim* sim);
+
+void flipper_spi_terminal_sim_start(
+    FlipperSPITerminalSim* sim,
+    uint32_t bit_rate,
+    size_t chunk_size);
+void flipper_spi_terminal_sim_stop(FlipperSPITerminalSim* sim);
+bool flipper_spi_terminal_sim_is_running(FlipperSPITerminalSim* sim);
+
+void flipper_spi_terminal_sim_get_stats(
+    FlipperSPITerminalSim* sim,
+    FlipperSPITerminalSimStats* stats);
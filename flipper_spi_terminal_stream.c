@@ -0,0 +1,170 @@
+#include "flipper_spi_terminal_stream.h"
+#include "flipper_spi_terminal.h"
+#include "toolbox/stream_frame.h"
+
+#include <furi_hal_cortex.h>
+
+typedef struct {
+    FlipperSPITerminalApp* app;
+    uint8_t batch[SPI_TERM_STREAM_BATCH_SIZE];
+    size_t length; // Bytes in batch
+    uint32_t sequence;
+    FlipperSPITerminalStreamStats* stats;
+} FlipperSPITerminalStream;
+
+static void flipper_spi_terminal_stream_write(FlipperSPITerminalStream* stream) {
+    if(stream->length > 0) {
+        cli_write(stream->app->cli, stream->batch, stream->length);
+        stream->length = 0;
+        stream->stats->writes++;
+    }
+}
+
+// Payload of a new frame, which is added to the batch with flipper_spi_terminal_stream_end
+static uint8_t* flipper_spi_terminal_stream_begin(
+    FlipperSPITerminalStream* stream,
+    StreamFrameType type,
+    uint64_t timestamp,
+    size_t length) {
+    if(stream->length + STREAM_FRAME_OVERHEAD + length > SPI_TERM_STREAM_BATCH_SIZE) {
+        flipper_spi_terminal_stream_write(stream);
+    }
+
+    return stream_frame_begin(
+        stream->batch + stream->length, type, stream->sequence++, timestamp, length);
+}
+
+static void flipper_spi_terminal_stream_end(FlipperSPITerminalStream* stream) {
+    stream->length += stream_frame_end(stream->batch + stream->length);
+    stream->stats->frames++;
+}
+
+// Frame with count u32 values as payload
+static void flipper_spi_terminal_stream_add_values(
+    FlipperSPITerminalStream* stream,
+    StreamFrameType type,
+    uint64_t timestamp,
+    const uint32_t* values,
+    size_t count) {
+    uint8_t* payload = flipper_spi_terminal_stream_begin(stream, type, timestamp, count * 4);
+    for(size_t i = 0; i < count; i++) {
+        stream_frame_put_u32(payload + i * 4, values[i]);
+    }
+    flipper_spi_terminal_stream_end(stream);
+}
+
+static void flipper_spi_terminal_stream_add_overrun(
+    FlipperSPITerminalStream* stream,
+    uint64_t timestamp,
+    uint32_t bytes) {
+    flipper_spi_terminal_stream_add_values(stream, StreamFrameTypeOverrun, timestamp, &bytes, 1);
+    stream->stats->overruns++;
+}
+
+static void
+    flipper_spi_terminal_stream_add_start(FlipperSPITerminalStream* stream, uint64_t timestamp) {
+    FlipperSPITerminalApp* app = stream->app;
+
+    CaptureFileHeader header = {
+        .frame_size = app->terminal_screen.frame_size,
+        .clock_hz = furi_hal_cortex_instructions_per_microsecond() * 1000000,
+    };
+    flipper_spi_terminal_config_to_capture(&app->config, &header);
+
+    uint8_t* payload = flipper_spi_terminal_stream_begin(
+        stream, StreamFrameTypeStart, timestamp, (3 + header.config_count) * 4);
+    stream_frame_put_u32(payload, header.clock_hz);
+    stream_frame_put_u32(payload + 4, header.frame_size);
+    stream_frame_put_u32(payload + 8, header.config_count);
+    for(uint32_t i = 0; i < header.config_count; i++) {
+        stream_frame_put_u32(payload + 12 + i * 4, header.config[i]);
+    }
+    flipper_spi_terminal_stream_end(stream);
+}
+
+// Moves length bytes from the tap into Data frames
+static void flipper_spi_terminal_stream_add_data(
+    FlipperSPITerminalStream* stream,
+    SpscRing* tap,
+    size_t length,
+    uint64_t timestamp) {
+    while(length > 0) {
+        SpscRingSpan spans[2];
+        const size_t part =
+            spsc_ring_peek_span(tap, 0, MIN(length, (size_t)SPI_TERM_STREAM_PAYLOAD_SIZE), spans);
+
+        uint8_t* payload =
+            flipper_spi_terminal_stream_begin(stream, StreamFrameTypeData, timestamp, part);
+        memcpy(payload, spans[0].data, spans[0].length);
+        memcpy(payload + spans[0].length, spans[1].data, spans[1].length);
+        flipper_spi_terminal_stream_end(stream);
+
+        spsc_ring_consume(tap, part);
+        stream->stats->bytes_sent += part;
+        length -= part;
+    }
+}
+
+bool flipper_spi_terminal_stream_run(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalStreamStats* stats) {
+    furi_check(app);
+    furi_check(stats);
+
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    memset(stats, 0, sizeof(FlipperSPITerminalStreamStats));
+    if(!terminal->is_active || terminal->rx_tap != NULL) {
+        return false;
+    }
+
+    FlipperSPITerminalStream* stream = malloc(sizeof(FlipperSPITerminalStream));
+    stream->app = app;
+    stream->length = 0;
+    stream->sequence = 0;
+    stream->stats = stats;
+
+    SpscRing* tap = spsc_ring_alloc(SPI_TERM_STREAM_TAP_SIZE);
+    terminal->rx_tap_dropped = 0;
+    terminal->rx_tap = tap;
+
+    flipper_spi_terminal_stream_add_start(stream, cycle_clock_now(&terminal->clock));
+    flipper_spi_terminal_stream_write(stream);
+
+    uint32_t dropped = 0; // Reported by Overrun frames
+    while(!cli_cmd_interrupt_received(app->cli) && terminal->is_active) {
+        // Bytes are only dropped, while the tap is full. All of them follow the bytes, which are
+        // in the tap now. Bytes after the drop need room, which is made after this.
+        const uint32_t tap_dropped = terminal->rx_tap_dropped;
+        const size_t length = spsc_ring_size(tap);
+        const uint64_t timestamp = cycle_clock_now(&terminal->clock);
+
+        flipper_spi_terminal_stream_add_data(stream, tap, length, timestamp);
+        if(tap_dropped != dropped) {
+            flipper_spi_terminal_stream_add_overrun(stream, timestamp, tap_dropped - dropped);
+            dropped = tap_dropped;
+        }
+
+        if(length > 0 || stream->length > 0) {
+            flipper_spi_terminal_stream_write(stream);
+        } else {
+            furi_delay_tick(1);
+        }
+    }
+
+    // The DMA ISR can not be in the middle of a write, once this thread runs again
+    terminal->rx_tap = NULL;
+    stats->bytes_dropped = terminal->rx_tap_dropped;
+    const uint64_t timestamp = cycle_clock_now(&terminal->clock);
+    flipper_spi_terminal_stream_add_data(stream, tap, spsc_ring_size(tap), timestamp);
+    if(stats->bytes_dropped != dropped) {
+        flipper_spi_terminal_stream_add_overrun(stream, timestamp, stats->bytes_dropped - dropped);
+    }
+    const uint32_t totals[] = {stats->bytes_sent, stats->bytes_dropped};
+    flipper_spi_terminal_stream_add_values(
+        stream, StreamFrameTypeEnd, timestamp, totals, COUNT_OF(totals));
+    flipper_spi_terminal_stream_write(stream);
+
+    spsc_ring_free(tap);
+    free(stream);
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "flipper_spi_terminal_app.h"
+
+// Live streaming of the capture to the CLI session, see toolbox/stream_frame.h for the protocol.
+// The data is copied with the receive tap of the Terminal Screen, like a running sequence does it.
+// A recording pauses its flushes meanwhile.
+
+// Received bytes, which are not sent yet. Bytes, which do not fit, are reported as overrun.
+#define SPI_TERM_STREAM_TAP_SIZE     8192
+// Frames are collected and written in one go, once the tap is empty or the batch is full
+#define SPI_TERM_STREAM_BATCH_SIZE   2048
+#define SPI_TERM_STREAM_PAYLOAD_SIZE 512
+
+typedef struct {
+    uint32_t bytes_sent; // Payload of Data frames
+    uint32_t bytes_dropped;
+    uint32_t frames;
+    uint32_t writes; // Batches written to the CLI session
+    uint32_t overruns; // Overrun frames
+} FlipperSPITerminalStreamStats;
+
+// Streams everything, which is received by the Terminal Screen, until Ctrl+C is pressed or the
+// Terminal Screen is left. Returns false, if the Terminal Screen is not active or its receive tap
+// is used by a sequence.
+bool flipper_spi_terminal_stream_run(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalStreamStats* stats);
@@ -0,0 +1,149 @@
+#include "flipper_spi_terminal_trigger.h"
+#include "toolbox/byte_scan.h"
+#include "toolbox/hex_string.h"
+
+#include <stdatomic.h>
+
+struct FlipperSPITerminalTrigger {
+    // Bit i is set, if the byte matches the byte i of the pattern
+    uint32_t table[256];
+    uint32_t match_bit; // Bit of the last byte of the pattern
+    size_t length;
+    size_t pre;
+    size_t post;
+    bool first_exact; // The first byte of the pattern has no don't-care nibble
+    uint8_t first;
+
+    // Only the ISR changes the state, while it is not Off. The configuration above is only
+    // changed, while it is Off.
+    _Atomic FlipperSPITerminalTriggerState state;
+    uint32_t match; // Shift-and state, bit i => the last i + 1 bytes matched
+    size_t remaining; // Post-trigger bytes, which are missing
+};
+
+FlipperSPITerminalTrigger* flipper_spi_terminal_trigger_alloc(void) {
+    FlipperSPITerminalTrigger* trigger = malloc(sizeof(FlipperSPITerminalTrigger));
+    memset(trigger, 0, sizeof(FlipperSPITerminalTrigger));
+    atomic_init(&trigger->state, FlipperSPITerminalTriggerStateOff);
+    return trigger;
+}
+
+void flipper_spi_terminal_trigger_free(FlipperSPITerminalTrigger* trigger) {
+    furi_check(trigger);
+    free(trigger);
+}
+
+bool flipper_spi_terminal_trigger_set(
+    FlipperSPITerminalTrigger* trigger,
+    const char* pattern,
+    size_t pre,
+    size_t post) {
+    furi_check(trigger);
+    furi_check(pattern);
+
+    uint8_t value[SPI_TERM_TRIGGER_MAX_LENGTH];
+    uint8_t mask[SPI_TERM_TRIGGER_MAX_LENGTH];
+    const int length = hex_string_decode_masked(pattern, value, mask, sizeof(value));
+    if(length <= 0) {
+        return false;
+    }
+
+    flipper_spi_terminal_trigger_disable(trigger);
+
+    memset(trigger->table, 0, sizeof(trigger->table));
+    for(size_t byte = 0; byte < COUNT_OF(trigger->table); byte++) {
+        for(int i = 0; i < length; i++) {
+            if((byte & mask[i]) == value[i]) {
+                trigger->table[byte] |= 1UL << i;
+            }
+        }
+    }
+    trigger->match_bit = 1UL << (length - 1);
+    trigger->first_exact = mask[0] == 0xFF;
+    trigger->first = value[0];
+    trigger->length = length;
+    trigger->pre = pre;
+    trigger->post = post;
+
+    flipper_spi_terminal_trigger_arm(trigger);
+    return true;
+}
+
+void flipper_spi_terminal_trigger_arm(FlipperSPITerminalTrigger* trigger) {
+    furi_check(trigger);
+
+    if(trigger->length == 0) {
+        return; // No pattern yet
+    }
+
+    atomic_store_explicit(
+        &trigger->state, FlipperSPITerminalTriggerStateOff, memory_order_release);
+    trigger->match = 0;
+    trigger->remaining = trigger->post;
+    atomic_store_explicit(
+        &trigger->state, FlipperSPITerminalTriggerStateArmed, memory_order_release);
+}
+
+void flipper_spi_terminal_trigger_disable(FlipperSPITerminalTrigger* trigger) {
+    furi_check(trigger);
+    atomic_store_explicit(
+        &trigger->state, FlipperSPITerminalTriggerStateOff, memory_order_release);
+}
+
+size_t flipper_spi_terminal_trigger_feed(
+    FlipperSPITerminalTrigger* trigger,
+    const uint8_t* data,
+    size_t length) {
+    FlipperSPITerminalTriggerState state =
+        atomic_load_explicit(&trigger->state, memory_order_acquire);
+    size_t captured = 0;
+
+    if(state == FlipperSPITerminalTriggerStateArmed) {
+        const uint32_t* table = trigger->table;
+        const uint32_t match_bit = trigger->match_bit;
+        uint32_t match = trigger->match;
+
+        while(captured < length) {
+            // Nothing can match before the next occurrence of the first byte
+            if(match == 0 && trigger->first_exact) {
+                captured += byte_scan_find(data + captured, length - captured, trigger->first);
+                if(captured == length) {
+                    break;
+                }
+            }
+
+            match = ((match << 1) | 1) & table[data[captured++]];
+            if(match & match_bit) {
+                state = FlipperSPITerminalTriggerStateTriggered;
+                break;
+            }
+        }
+
+        trigger->match = match;
+    } else if(state == FlipperSPITerminalTriggerStateOff) {
+        return length;
+    }
+
+    if(state == FlipperSPITerminalTriggerStateTriggered) {
+        const size_t post = MIN(length - captured, trigger->remaining);
+        trigger->remaining -= post;
+        captured += post;
+        if(trigger->remaining == 0) {
+            state = FlipperSPITerminalTriggerStateStopped;
+        }
+    }
+
+    atomic_store_explicit(&trigger->state, state, memory_order_release);
+    return captured;
+}
+
+FlipperSPITerminalTriggerState
+    flipper_spi_terminal_trigger_get_state(FlipperSPITerminalTrigger* trigger) {
+    furi_check(trigger);
+    return atomic_load_explicit(&trigger->state, memory_order_acquire);
+}
+
+size_t flipper_spi_terminal_trigger_get_window(FlipperSPITerminalTrigger* trigger) {
+    furi_check(trigger);
+    return trigger->pre + trigger->length + trigger->post;
+}
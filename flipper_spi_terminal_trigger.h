@@ -0,0 +1,51 @@
+#pragma once
+
+#include <furi.h>
+
+// Logic analyzer like trigger for the capture. A byte pattern with don't-care nibbles is searched
+// in the received data. Once it was found, post more bytes are captured and the capture stops.
+// The pre bytes before the pattern are kept as pre-trigger window.
+//
+// The pattern is matched with shift-and: Every byte is one table lookup, a shift and an and. The
+// match state is kept between calls, so a pattern can span multiple DMA chunks.
+
+// Longest pattern, one bit of the match state per byte
+#define SPI_TERM_TRIGGER_MAX_LENGTH 32
+// Window around the pattern, if none is given
+#define SPI_TERM_TRIGGER_DEFAULT_PRE  256
+#define SPI_TERM_TRIGGER_DEFAULT_POST 1024
+
+typedef enum {
+    FlipperSPITerminalTriggerStateOff, // Everything is captured
+    FlipperSPITerminalTriggerStateArmed, // Searching for the pattern
+    FlipperSPITerminalTriggerStateTriggered, // Capturing the post-trigger bytes
+    FlipperSPITerminalTriggerStateStopped, // Nothing is captured anymore
+} FlipperSPITerminalTriggerState;
+
+typedef struct FlipperSPITerminalTrigger FlipperSPITerminalTrigger;
+
+FlipperSPITerminalTrigger* flipper_spi_terminal_trigger_alloc(void);
+void flipper_spi_terminal_trigger_free(FlipperSPITerminalTrigger* trigger);
+
+// Sets the pattern, e.g. "9F ?? X0", and arms the trigger. Returns false on a invalid pattern.
+// Can be called, while flipper_spi_terminal_trigger_feed is running in a ISR.
+bool flipper_spi_terminal_trigger_set(
+    FlipperSPITerminalTrigger* trigger,
+    const char* pattern,
+    size_t pre,
+    size_t post);
+// Starts a new search with the current pattern
+void flipper_spi_terminal_trigger_arm(FlipperSPITerminalTrigger* trigger);
+void flipper_spi_terminal_trigger_disable(FlipperSPITerminalTrigger* trigger);
+
+// Checks length received bytes. Returns the number of bytes from the start of data, which belong
+// to the capture. Can be called from a ISR.
+size_t flipper_spi_terminal_trigger_feed(
+    FlipperSPITerminalTrigger* trigger,
+    const uint8_t* data,
+    size_t length);
+
+FlipperSPITerminalTriggerState
+    flipper_spi_terminal_trigger_get_state(FlipperSPITerminalTrigger* trigger);
+// Bytes of a stopped capture, which are kept: pre-trigger window, pattern and post-trigger bytes
+size_t flipper_spi_terminal_trigger_get_window(FlipperSPITerminalTrigger* trigger);
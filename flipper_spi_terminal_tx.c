@@ -0,0 +1,279 @@
+#include "flipper_spi_terminal_tx.h"
+#include "flipper_spi_terminal.h"
+#include "flipper_spi_terminal_hw.h"
+#include "toolbox/spsc_ring.h"
+
+// NDTR is 16 bit wide
+#define SPI_TERM_TX_MAX_FRAMES_PER_TRANSFER UINT16_MAX
+
+struct FlipperSPITerminalTx {
+    SpscRing* queue; // Written by a thread, read by the TX DMA ISR
+    size_t frame_size;
+    bool running;
+
+    volatile size_t in_flight; // Bytes of the running DMA transfer, 0 => idle
+    uint8_t* pattern; // Repeated circular, NULL => queue mode
+
+    FlipperSPITerminalTxStats stats;
+};
+
+static void flipper_spi_terminal_tx_dma_transfer(
+    FlipperSPITerminalTx* tx,
+    const uint8_t* data,
+    size_t length,
+    uint32_t mode) {
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_SetMode(SPI_DMA, SPI_DMA_TX_CHANNEL, mode);
+    LL_DMA_SetMemoryAddress(SPI_DMA, SPI_DMA_TX_CHANNEL, (uint32_t)data);
+    LL_DMA_SetDataLength(SPI_DMA, SPI_DMA_TX_CHANNEL, length / tx->frame_size);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+}
+
+// ISR only. Sends the next contiguous part of the queue.
+static void flipper_spi_terminal_tx_start_next(FlipperSPITerminalTx* tx) {
+    SpscRingSpan spans[2];
+    spsc_ring_peek_span(tx->queue, 0, spsc_ring_capacity(tx->queue), spans);
+
+    const size_t max_length = SPI_TERM_TX_MAX_FRAMES_PER_TRANSFER * tx->frame_size;
+    const size_t length = MIN(spans[0].length, max_length) / tx->frame_size * tx->frame_size;
+    if(length == 0) {
+        return;
+    }
+
+    tx->in_flight = length;
+    flipper_spi_terminal_tx_dma_transfer(tx, spans[0].data, length, LL_DMA_MODE_NORMAL);
+}
+
+static void flipper_spi_terminal_tx_dma_isr(void* context) {
+    furi_check(context);
+    FlipperSPITerminalTx* tx = context;
+
+    if(LL_DMA_IsActiveFlag_TC7(SPI_DMA)) {
+        LL_DMA_ClearFlag_TC7(SPI_DMA);
+        if(tx->in_flight > 0) {
+            spsc_ring_consume(tx->queue, tx->in_flight);
+            tx->stats.bytes_sent += tx->in_flight;
+            tx->stats.transfers++;
+            tx->in_flight = 0;
+        }
+    }
+
+    if(LL_DMA_IsActiveFlag_TE7(SPI_DMA)) {
+        LL_DMA_ClearFlag_TE7(SPI_DMA);
+        // The channel is disabled by the hardware. The transfer is dropped.
+        tx->stats.errors++;
+        if(tx->in_flight > 0) {
+            spsc_ring_consume(tx->queue, tx->in_flight);
+            tx->in_flight = 0;
+        }
+    }
+
+    // Also reached by flipper_spi_terminal_tx_kick
+    if(tx->pattern == NULL && tx->in_flight == 0) {
+        flipper_spi_terminal_tx_start_next(tx);
+    }
+}
+
+// Starts a transfer, if the engine is idle. The ISR does this, so only one context ever starts
+// transfers.
+static void flipper_spi_terminal_tx_kick(void) {
+    NVIC_SetPendingIRQ(SPI_DMA_TX_IRQN);
+}
+
+FlipperSPITerminalTx* flipper_spi_terminal_tx_alloc(size_t queue_size) {
+    FlipperSPITerminalTx* tx = malloc(sizeof(FlipperSPITerminalTx));
+    memset(tx, 0, sizeof(FlipperSPITerminalTx));
+
+    tx->queue = spsc_ring_alloc(queue_size);
+    tx->frame_size = 1;
+
+    return tx;
+}
+
+void flipper_spi_terminal_tx_free(FlipperSPITerminalTx* tx) {
+    furi_check(tx);
+
+    flipper_spi_terminal_tx_stop(tx);
+
+    spsc_ring_free(tx->queue);
+    free(tx);
+}
+
+void flipper_spi_terminal_tx_start(FlipperSPITerminalTx* tx, size_t frame_size) {
+    furi_check(tx);
+    furi_check(frame_size == 1 || frame_size == 2);
+
+    flipper_spi_terminal_tx_stop(tx);
+
+    SPI_TERM_LOG_T("Starting TX engine");
+
+    tx->frame_size = frame_size;
+    tx->in_flight = 0;
+    spsc_ring_reset(tx->queue);
+    memset(&tx->stats, 0, sizeof(tx->stats));
+
+    // Same data width as the RX channel
+    const bool half_word = frame_size == 2;
+    LL_DMA_InitTypeDef dma_config = {
+        .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
+        .MemoryOrM2MDstAddress = 0,
+        .Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+        .Mode = LL_DMA_MODE_NORMAL,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
+        .PeriphOrM2MSrcDataSize = half_word ? LL_DMA_PDATAALIGN_HALFWORD : LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = half_word ? LL_DMA_MDATAALIGN_HALFWORD : LL_DMA_MDATAALIGN_BYTE,
+        .NbData = 0,
+        .PeriphRequest = SPI_DMA_TX_REQ,
+        .Priority = LL_DMA_PRIORITY_MEDIUM,
+    };
+    LL_DMA_Init(SPI_DMA, SPI_DMA_TX_CHANNEL, &dma_config);
+
+    LL_DMA_ClearFlag_TC7(SPI_DMA);
+    LL_DMA_ClearFlag_TE7(SPI_DMA);
+    furi_hal_interrupt_set_isr(SPI_DMA_TX_IRQ, flipper_spi_terminal_tx_dma_isr, tx);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_EnableIT_TE(SPI_DMA, SPI_DMA_TX_CHANNEL);
+
+    // Has to be enabled after the RX DMA request, see RM0434 SPI DMA
+    LL_SPI_EnableDMAReq_TX(spi_terminal_spi);
+
+    tx->running = true;
+}
+
+void flipper_spi_terminal_tx_stop(FlipperSPITerminalTx* tx) {
+    furi_check(tx);
+
+    if(!tx->running) {
+        return;
+    }
+
+    SPI_TERM_LOG_T("Stopping TX engine");
+
+    flipper_spi_terminal_tx_cancel(tx);
+
+    LL_DMA_DisableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_DisableIT_TE(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    furi_hal_interrupt_set_isr(SPI_DMA_TX_IRQ, NULL, NULL);
+    LL_SPI_DisableDMAReq_TX(spi_terminal_spi);
+    LL_DMA_DeInit(SPI_DMA, SPI_DMA_TX_CHANNEL);
+
+    tx->running = false;
+}
+
+bool flipper_spi_terminal_tx_is_running(FlipperSPITerminalTx* tx) {
+    furi_check(tx);
+    return tx->running;
+}
+
+size_t flipper_spi_terminal_tx_write(
+    FlipperSPITerminalTx* tx,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    furi_check(tx);
+    furi_check(data || length == 0);
+
+    if(!tx->running) {
+        return 0;
+    }
+
+    const uint8_t* src = data;
+    length = length / tx->frame_size * tx->frame_size;
+
+    const uint32_t start = furi_get_tick();
+    size_t written = 0;
+    while(written < length && tx->running) {
+        // Whole frames only, the ISR must never see half a frame
+        const size_t free_space =
+            spsc_ring_free_space(tx->queue) / tx->frame_size * tx->frame_size;
+        written += spsc_ring_write(tx->queue, src + written, MIN(length - written, free_space));
+        flipper_spi_terminal_tx_kick();
+
+        if(written < length) {
+            if(furi_get_tick() - start >= timeout) {
+                break;
+            }
+            furi_delay_tick(1);
+        }
+    }
+
+    return written;
+}
+
+bool flipper_spi_terminal_tx_is_idle(FlipperSPITerminalTx* tx) {
+    furi_check(tx);
+
+    if(!tx->running) {
+        return true;
+    }
+
+    return spsc_ring_size(tx->queue) == 0 &&
+           LL_SPI_GetTxFIFOLevel(spi_terminal_spi) == LL_SPI_TX_FIFO_EMPTY &&
+           !LL_SPI_IsActiveFlag_BSY(spi_terminal_spi);
+}
+
+bool flipper_spi_terminal_tx_flush(FlipperSPITerminalTx* tx, uint32_t timeout) {
+    furi_check(tx);
+
+    const uint32_t start = furi_get_tick();
+    while(!flipper_spi_terminal_tx_is_idle(tx)) {
+        if(furi_get_tick() - start >= timeout) {
+            return false;
+        }
+        furi_delay_tick(1);
+    }
+
+    return true;
+}
+
+void flipper_spi_terminal_tx_repeat(FlipperSPITerminalTx* tx, const void* data, size_t length) {
+    furi_check(tx);
+    furi_check(data);
+
+    length = length / tx->frame_size * tx->frame_size;
+    if(!tx->running || length == 0) {
+        return;
+    }
+
+    flipper_spi_terminal_tx_cancel(tx);
+
+    uint8_t* pattern = malloc(length);
+    memcpy(pattern, data, length);
+
+    // No interrupts, the transfer never completes
+    FURI_CRITICAL_ENTER();
+    tx->pattern = pattern;
+    LL_DMA_DisableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    flipper_spi_terminal_tx_dma_transfer(tx, pattern, length, LL_DMA_MODE_CIRCULAR);
+    FURI_CRITICAL_EXIT();
+}
+
+void flipper_spi_terminal_tx_cancel(FlipperSPITerminalTx* tx) {
+    furi_check(tx);
+
+    if(!tx->running) {
+        return;
+    }
+
+    FURI_CRITICAL_ENTER();
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_ClearFlag_TC7(SPI_DMA);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    uint8_t* pattern = tx->pattern;
+    tx->pattern = NULL;
+    tx->in_flight = 0;
+    spsc_ring_reset(tx->queue);
+    FURI_CRITICAL_EXIT();
+
+    free(pattern);
+}
+
+void flipper_spi_terminal_tx_get_stats(
+    FlipperSPITerminalTx* tx,
+    FlipperSPITerminalTxStats* stats) {
+    furi_check(tx);
+    furi_check(stats);
+
+    *stats = tx->stats;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <furi.h>
+
+// Master mode transmit engine. Drives the TX DMA channel, while the Terminal Screen keeps
+// receiving with the RX DMA channel. In full duplex, every sent frame clocks in one frame.
+//
+// Written data is queued in a ring and sent straight out of it. While one part of the ring is on
+// the bus, the next one can be filled. The next DMA transfer is started from the transfer
+// complete interrupt, which fires as soon as the last frame moved into the 32 bit TX FIFO. The
+// FIFO keeps the clock running in the meantime, so consecutive writes are sent back to back.
+// A repeated pattern uses a circular DMA transfer and needs no CPU at all.
+
+typedef struct FlipperSPITerminalTx FlipperSPITerminalTx;
+
+typedef struct {
+    uint32_t bytes_sent; // Queued bytes only, repeated patterns are not counted
+    uint32_t transfers;
+    uint32_t errors;
+} FlipperSPITerminalTxStats;
+
+// queue_size has to be a power of two
+FlipperSPITerminalTx* flipper_spi_terminal_tx_alloc(size_t queue_size);
+void flipper_spi_terminal_tx_free(FlipperSPITerminalTx* tx);
+
+// SPI has to be initialized in master mode. frame_size is 1 or 2 bytes.
+void flipper_spi_terminal_tx_start(FlipperSPITerminalTx* tx, size_t frame_size);
+void flipper_spi_terminal_tx_stop(FlipperSPITerminalTx* tx);
+bool flipper_spi_terminal_tx_is_running(FlipperSPITerminalTx* tx);
+
+// Queues up to length bytes and waits up to timeout ticks for free space. Returns the number of
+// queued bytes. Incomplete frames are not queued.
+size_t flipper_spi_terminal_tx_write(
+    FlipperSPITerminalTx* tx,
+    const void* data,
+    size_t length,
+    uint32_t timeout);
+// Waits up to timeout ticks until every queued frame left the SPI
+bool flipper_spi_terminal_tx_flush(FlipperSPITerminalTx* tx, uint32_t timeout);
+// Returns true, if every queued frame left the SPI. Can be polled for short waits.
+bool flipper_spi_terminal_tx_is_idle(FlipperSPITerminalTx* tx);
+// Drops queued data and sends data repeatedly until flipper_spi_terminal_tx_cancel is called
+void flipper_spi_terminal_tx_repeat(FlipperSPITerminalTx* tx, const void* data, size_t length);
+// Stops the current transfer and drops everything, which was not sent yet
+void flipper_spi_terminal_tx_cancel(FlipperSPITerminalTx* tx);
+
+void flipper_spi_terminal_tx_get_stats(
+    FlipperSPITerminalTx* tx,
+    FlipperSPITerminalTxStats* stats);
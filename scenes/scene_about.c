@@ -23,8 +23,14 @@ const char* about_text =
     "\n"
     "=== Terminal View ===\n"
     "Use the 'Up' and 'Down' keys to scroll.\n"
+    "Press 'OK' to show/hide the receive statistics.\n"
     "Press 'Back' to navigate to the main menu.\n"
-    "Hold 'Back' to clear the screen buffer.";
+    "Hold 'Back' to clear the screen buffer.\n"
+    "\n"
+    "=== Capture Viewer ===\n"
+    "Select 'Open capture' in the config to view a recorded file.\n"
+    "Use 'Left' and 'Right' to jump through the file.\n"
+    "Hold 'Left' or 'Right' to jump to the start or the end.";
 
 void flipper_spi_terminal_scene_about_alloc(FlipperSPITerminalApp* app) {
     app->about_screen = text_box_alloc();
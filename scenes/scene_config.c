@@ -49,9 +49,18 @@ const char* const flipper_spi_terminal_scene_config_help_strings[] = {
 #undef ADD_CONFIG_ENTRY
 };
 
+// Item after the config values, which opens the capture file viewer
+#define SPI_TERM_VIEWER_ITEM_INDEX \
+    (SPI_TERM_HELP_TEXT_INDEX_OFFSET + COUNT_OF(flipper_spi_terminal_scene_config_help_strings))
+
 static void flipper_spi_terminal_scene_config_on_center_button(void* context, uint32_t index) {
     SPI_TERM_CONTEXT_TO_APP(context);
 
+    if(index == SPI_TERM_VIEWER_ITEM_INDEX) {
+        scene_manager_next_scene(app->scene_manager, FlipperSPITerminalAppSceneViewer);
+        return;
+    }
+
     if(index < SPI_TERM_HELP_TEXT_INDEX_OFFSET ||
        index >= SPI_TERM_HELP_TEXT_INDEX_OFFSET +
                     COUNT_OF(flipper_spi_terminal_scene_config_help_strings)) {
@@ -83,6 +92,9 @@ void flipper_spi_terminal_scene_config_alloc(FlipperSPITerminalApp* app) {
     // Add all auto generated Config values
     flipper_spi_terminal_scene_config_alloc_spi_config_items(app);
 
+    // Index SPI_TERM_VIEWER_ITEM_INDEX
+    variable_item_list_add(app->config_screen.view, "Open capture", 0, NULL, NULL);
+
     variable_item_list_set_enter_callback(
         app->config_screen.view, flipper_spi_terminal_scene_config_on_center_button, app);
 }
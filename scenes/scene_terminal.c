@@ -1,29 +1,525 @@
 #include "../flipper_spi_terminal.h"
+#include "../flipper_spi_terminal_dump.h"
+#include "../flipper_spi_terminal_flash.h"
+#include "../flipper_spi_terminal_hw.h"
+#include "../flipper_spi_terminal_stream.h"
+#include "../toolbox/hex_string.h"
 #include "scenes.h"
 
-#include <furi_hal_interrupt.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_gpio.h>
 
 #include <stm32wbxx_ll_cortex.h>
-#include <stm32wbxx_ll_dma.h>
-#include <stm32wbxx_ll_spi.h>
+#include <stm32wbxx_ll_exti.h>
+#include <stm32wbxx_ll_system.h>
 #include <stm32wbxx_ll_utils.h>
 
-#define spi_terminal_spi_bus_handle &furi_hal_spi_bus_handle_external
-#define spi_terminal_spi_bus        furi_hal_spi_bus_handle_external.bus
-#define spi_terminal_spi            SPI1
+// Partially filled DMA halves are flushed, if no byte was received for this time
+#define SPI_TERM_DMA_IDLE_FLUSH_MS 10
 
-// Copy&Paste from furi_hal_spi.c
-#define SPI_DMA            DMA2
-#define SPI_DMA_RX_REQ     LL_DMAMUX_REQ_SPI1_RX
-#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_6
-#define SPI_DMA_RX_IRQ     FuriHalInterruptIdDma2Ch6
-#define SPI_DMA_TX_REQ     LL_DMAMUX_REQ_SPI1_TX
-#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_7
-#define SPI_DMA_TX_IRQ     FuriHalInterruptIdDma2Ch7
+#define SPI_TERM_NOTIFY_FLAG_DATA  (1 << 0)
+#define SPI_TERM_NOTIFY_FLAG_STOP  (1 << 1)
+#define SPI_TERM_NOTIFY_FLAG_WATCH (1 << 2) // (Re)arms the flush timer
 
-void flipper_spi_terminal_scene_terminal_process_receive_timer(void* context) {
+// EXTI line of SPI_TERM_CS_PIN
+#define SPI_TERM_CS_EXTI_LINE LL_EXTI_LINE_4
+
+// Transaction ends, which were not processed by the GUI thread yet
+#define SPI_TERM_TRANSACTION_RING_SIZE (64 * sizeof(uint32_t))
+// Timestamps, which were not processed by the GUI thread yet. About 4 bytes per entry.
+#define SPI_TERM_TIMESTAMP_INDEX_SIZE 1024
+// Data, which was queued for sending, but is not sent yet
+#define SPI_TERM_TX_QUEUE_SIZE 2048
+// Injected data, which was not moved to rx_buffer_ring by the DMA ISR yet
+#define SPI_TERM_INJECT_RING_SIZE 1024
+// Received data, which was not checked by a running sequence yet. Needs to hold the TX queue and
+// the longest checked transfer.
+#define SPI_TERM_SEQUENCE_RX_TAP_SIZE 4096
+// Longest time, a sequence waits for the bus
+#define SPI_TERM_SEQUENCE_TIMEOUT_MS 1000
+// Staged recording data is written, if no byte was received for this time
+#define SPI_TERM_RECORD_IDLE_MS 100
+// Heap, which is allocated during a session after the capture buffer took the rest on "Max": The
+// receive tap of a sequence next to the buffers of a CLI dump or flash command, or a stream.
+#define SPI_TERM_SESSION_CLI_HEAP                                                       \
+    MAX(SPI_TERM_DUMP_CHUNK_SIZE + SPI_TERM_DUMP_HEX_LINES * HEX_STRING_DUMP_LINE_SIZE, \
+        2 * SPI_TERM_FLASH_BLOCK_SIZE)
+#define SPI_TERM_SESSION_HEAP_RESERVE                              \
+    MAX(SPI_TERM_SEQUENCE_RX_TAP_SIZE + SPI_TERM_SESSION_CLI_HEAP, \
+        SPI_TERM_STREAM_TAP_SIZE + SPI_TERM_STREAM_BATCH_SIZE)
+
+static void flipper_spi_terminal_scene_terminal_update_overlay(FlipperSPITerminalApp* app) {
+    const FlipperSPITerminalAppTerminalStats* stats = &app->terminal_screen.stats;
+    const FlipperSPITerminalAppTerminalTiming* timing = &app->terminal_screen.timing;
+    const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+
+    char text[192];
+    snprintf(
+        text,
+        sizeof(text),
+        "RX/Drop: %lu/%lu\nDMA HT/TC: %lu/%lu\nFlush/Err: %lu/%lu\nCS: %lu\nGap: %lu us\n"
+        "Burst: %lu us\nSeq ok/fail: %lu/%lu",
+        stats->bytes_received,
+        stats->bytes_dropped,
+        stats->dma_half_events,
+        stats->dma_full_events,
+        stats->dma_flush_events,
+        stats->transfer_errors,
+        stats->transactions,
+        timing->last_gap / cycles_per_us,
+        timing->last_burst / cycles_per_us,
+        stats->sequence_runs - stats->sequence_failures,
+        stats->sequence_failures);
+
+    FlipperSPITerminalRecord* record = app->terminal_screen.record;
+    if(app->terminal_screen.record_failed) {
+        const size_t length = strlen(text);
+        snprintf(text + length, sizeof(text) - length, "\nRec: Failed");
+    } else if(record != NULL) {
+        FlipperSPITerminalRecordStats record_stats;
+        flipper_spi_terminal_record_get_stats(record, &record_stats);
+        const size_t length = strlen(text);
+        snprintf(
+            text + length,
+            sizeof(text) - length,
+            "\nRec/Gap: %lu/%lu",
+            record_stats.bytes_written,
+            record_stats.gaps);
+    }
+
+    terminal_view_set_overlay_text(app->terminal_screen.view, text);
+
+    static const char* const trigger_states[] = {
+        [FlipperSPITerminalTriggerStateOff] = "",
+        [FlipperSPITerminalTriggerStateArmed] = "Armed",
+        [FlipperSPITerminalTriggerStateTriggered] = "Trig",
+        [FlipperSPITerminalTriggerStateStopped] = "Stop",
+    };
+    const char* status =
+        trigger_states[flipper_spi_terminal_trigger_get_state(app->terminal_screen.trigger)];
+    if(status[0] == '\0' && record != NULL) {
+        status = "Rec";
+    }
+    terminal_view_set_status(app->terminal_screen.view, status);
+}
+
+static void flipper_spi_terminal_scene_terminal_set_notify_flags(
+    FlipperSPITerminalApp* app,
+    uint32_t flags) {
+    // Only running, while the Terminal Screen is active
+    FuriThreadId thread_id = furi_thread_get_id(app->terminal_screen.notify_thread);
+    if(thread_id != NULL) {
+        furi_thread_flags_set(thread_id, flags);
+    }
+}
+
+void flipper_spi_terminal_scene_terminal_notify(FlipperSPITerminalApp* app) {
+    flipper_spi_terminal_scene_terminal_set_notify_flags(app, SPI_TERM_NOTIFY_FLAG_DATA);
+}
+
+void flipper_spi_terminal_scene_terminal_watch(FlipperSPITerminalApp* app) {
+    flipper_spi_terminal_scene_terminal_set_notify_flags(app, SPI_TERM_NOTIFY_FLAG_WATCH);
+}
+
+// Timers can not be started from a ISR. Data notifications and watch requests arm it from the
+// notify thread instead.
+static void flipper_spi_terminal_scene_terminal_arm_flush_timer(FlipperSPITerminalApp* app) {
+    // A stale start after stop_capture only runs the callback once, which checks this again
+    if(app->terminal_screen.rx_dma_running) {
+        furi_timer_start(
+            app->terminal_screen.flush_timer, furi_ms_to_ticks(SPI_TERM_DMA_IDLE_FLUSH_MS));
+    }
+}
+
+// Turns data notifications into custom events for the GUI thread. Multiple notifications are
+// merged into one event and events are sent at most once per refresh interval.
+static int32_t flipper_spi_terminal_scene_terminal_notify_thread(void* context) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+
+    const uint32_t refresh_interval = furi_ms_to_ticks(app->config.refresh_interval_ms);
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            SPI_TERM_NOTIFY_FLAG_DATA | SPI_TERM_NOTIFY_FLAG_STOP | SPI_TERM_NOTIFY_FLAG_WATCH,
+            FuriFlagWaitAny,
+            FuriWaitForever);
+        if(flags & FuriFlagError) {
+            continue;
+        }
+        if(flags & SPI_TERM_NOTIFY_FLAG_STOP) {
+            break;
+        }
+
+        // The last event was not processed yet. It is going to pick up the new data, too. The
+        // exchange pairs with the store of the GUI thread, so no clear is lost in between.
+        if((flags & SPI_TERM_NOTIFY_FLAG_DATA) &&
+           !atomic_exchange(&app->terminal_screen.event_pending, true)) {
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, FlipperSPITerminalEventReceivedData);
+        }
+
+        // New data can end in a partially filled half
+        flipper_spi_terminal_scene_terminal_arm_flush_timer(app);
+
+        // Notifications during this time stay set and are handled in the next round. The flush
+        // timer keeps running meanwhile.
+        const uint32_t start = furi_get_tick();
+        uint32_t elapsed = 0;
+        bool stop = false;
+        while(!stop && elapsed < refresh_interval) {
+            flags = furi_thread_flags_wait(
+                SPI_TERM_NOTIFY_FLAG_STOP | SPI_TERM_NOTIFY_FLAG_WATCH,
+                FuriFlagWaitAny,
+                refresh_interval - elapsed);
+            if(!(flags & FuriFlagError)) {
+                stop = flags & SPI_TERM_NOTIFY_FLAG_STOP;
+                if(flags & SPI_TERM_NOTIFY_FLAG_WATCH) {
+                    flipper_spi_terminal_scene_terminal_arm_flush_timer(app);
+                }
+            }
+            elapsed = furi_get_tick() - start;
+        }
+        if(stop) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static size_t flipper_spi_terminal_scene_terminal_add_data(
+    FlipperSPITerminalApp* app,
+    const void* data,
+    size_t length) {
+    const uint32_t start = DWT->CYCCNT;
+
+    size_t sent = spsc_ring_write(app->terminal_screen.rx_buffer_ring, data, length);
+
+    app->terminal_screen.stats.bytes_received += length;
+    app->terminal_screen.stats.bytes_dropped += length - sent;
+
+    if(app->terminal_screen.profile.enabled) {
+        latency_histogram_add(&app->terminal_screen.profile.rx, DWT->CYCCNT - start);
+    }
+
+    flipper_spi_terminal_scene_terminal_notify(app);
+
+    return sent;
+}
+
+size_t flipper_spi_terminal_scene_terminal_inject(
+    FlipperSPITerminalApp* app,
+    const void* data,
+    size_t length) {
+    furi_check(app);
+    furi_check(data || length == 0);
+
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    furi_mutex_acquire(terminal->inject_lock, FuriWaitForever);
+    const size_t queued = spsc_ring_write(terminal->inject_ring, data, length);
+    furi_mutex_release(terminal->inject_lock);
+
+    // Without a running DMA, the ISR is not installed. on_enter drops the queue.
+    if(queued > 0 && terminal->rx_dma_running) {
+        NVIC_SetPendingIRQ(SPI_DMA_RX_IRQN);
+    }
+
+    return queued;
+}
+
+// Moves injected data to rx_buffer_ring. Stops, once it is full. The GUI thread raises the IRQ
+// again after making room. Only called by the DMA ISR or while it is not installed.
+static void flipper_spi_terminal_scene_terminal_drain_inject(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    SpscRing* inject = terminal->inject_ring;
+
+    SpscRingSpan spans[2];
+    const size_t length = spsc_ring_peek_span(
+        inject, 0, spsc_ring_free_space(terminal->rx_buffer_ring), spans);
+    for(size_t i = 0; i < COUNT_OF(spans); i++) {
+        if(spans[i].length > 0) {
+            flipper_spi_terminal_scene_terminal_add_data(app, spans[i].data, spans[i].length);
+        }
+    }
+    spsc_ring_consume(inject, length);
+}
+
+static size_t flipper_spi_terminal_scene_terminal_sim_chunk(
+    void* context,
+    const uint8_t* data,
+    size_t length) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+    return flipper_spi_terminal_scene_terminal_inject(app, data, length);
+}
+
+// Offset in rx_dma_buffer, which is written by the DMA next
+static size_t flipper_spi_terminal_scene_terminal_dma_rx_position(FlipperSPITerminalApp* app) {
+    const size_t size = app->terminal_screen.rx_dma_half_size * 2;
+    const size_t remaining = LL_DMA_GetDataLength(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    return (size - remaining * app->terminal_screen.frame_size) % size;
+}
+
+// End of the delivered data. Transaction ends and timestamps refer to this position.
+static uint32_t flipper_spi_terminal_scene_terminal_stream_position(FlipperSPITerminalApp* app) {
+    if(app->config.ingest_mode == TerminalIngestModeDirect) {
+        return app->terminal_screen.rx_dma_write_count;
+    } else {
+        return spsc_ring_end_position(app->terminal_screen.rx_buffer_ring);
+    }
+}
+
+static void flipper_spi_terminal_scene_terminal_add_timestamp(
+    FlipperSPITerminalApp* app,
+    TimestampIndexKind kind,
+    uint64_t cycles) {
+    const TimestampIndexEntry entry = {
+        .kind = kind,
+        .position = flipper_spi_terminal_scene_terminal_stream_position(app),
+        .cycles = cycles,
+    };
+
+    // Lost entries only affect the timing measurements
+    timestamp_index_add(app->terminal_screen.timestamps, &entry);
+}
+
+// Passes the bytes between the offsets from and to of rx_dma_buffer to the terminal screen
+static void flipper_spi_terminal_scene_terminal_dma_rx_deliver(
+    FlipperSPITerminalApp* app,
+    size_t from,
+    size_t to) {
+    if(to <= from) {
+        return;
+    }
+
+    const size_t length = to - from;
+
+    SpscRing* rx_tap = app->terminal_screen.rx_tap;
+    if(rx_tap != NULL) {
+        const size_t written =
+            spsc_ring_write(rx_tap, app->terminal_screen.rx_dma_buffer + from, length);
+        app->terminal_screen.rx_tap_dropped += length - written;
+    }
+
+    // Bytes after the end of a trigger capture are not captured
+    FlipperSPITerminalTrigger* trigger = app->terminal_screen.trigger;
+    const bool capturing = flipper_spi_terminal_trigger_get_state(trigger) !=
+                           FlipperSPITerminalTriggerStateStopped;
+    const size_t captured = flipper_spi_terminal_trigger_feed(
+        trigger, app->terminal_screen.rx_dma_buffer + from, length);
+    const bool stopped = capturing && flipper_spi_terminal_trigger_get_state(trigger) ==
+                                          FlipperSPITerminalTriggerStateStopped;
+
+    if(app->config.ingest_mode == TerminalIngestModeDirect) {
+        if(stopped) {
+            app->terminal_screen.rx_dma_capture_end =
+                app->terminal_screen.rx_dma_write_count + captured;
+        }
+        // Hand the data over to the GUI thread. No copy in here. The write count has to follow the
+        // DMA, uncaptured bytes are skipped by the GUI thread.
+        app->terminal_screen.rx_dma_write_count += length;
+        app->terminal_screen.stats.bytes_received += length;
+        flipper_spi_terminal_scene_terminal_notify(app);
+    } else {
+        app->terminal_screen.stats.bytes_received += length - captured;
+        if(captured > 0) {
+            flipper_spi_terminal_scene_terminal_add_data(
+                app, app->terminal_screen.rx_dma_buffer + from, captured);
+        }
+    }
+
+    app->terminal_screen.rx_dma_position = to % (app->terminal_screen.rx_dma_half_size * 2);
+
+    flipper_spi_terminal_scene_terminal_add_timestamp(
+        app, TimestampIndexKindChunk, cycle_clock_now(&app->terminal_screen.clock));
+}
+
+void flipper_spi_terminal_scene_terminal_flush(FlipperSPITerminalApp* app) {
+    app->terminal_screen.rx_dma_flush_requested = true;
+    NVIC_SetPendingIRQ(SPI_DMA_RX_IRQN);
+}
+
+static void flipper_spi_terminal_scene_terminal_start_transaction(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    flipper_spi_terminal_scene_terminal_add_timestamp(
+        app,
+        TimestampIndexKindFrameStart,
+        cycle_clock_extend(&terminal->clock, terminal->cs_start_cycles));
+}
+
+// Publishes the end of a transaction at the current end of the delivered data
+static void flipper_spi_terminal_scene_terminal_end_transaction(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    flipper_spi_terminal_scene_terminal_add_timestamp(
+        app,
+        TimestampIndexKindFrameEnd,
+        cycle_clock_extend(&terminal->clock, terminal->cs_end_cycles));
+
+    const uint32_t end = flipper_spi_terminal_scene_terminal_stream_position(app);
+
+    // On overflow, the transaction is merged with the next one
+    if(spsc_ring_free_space(terminal->transaction_ring) >= sizeof(end)) {
+        spsc_ring_write(terminal->transaction_ring, &end, sizeof(end));
+    }
+
+    flipper_spi_terminal_scene_terminal_notify(app);
+}
+
+// EXTI callback of both CS edges. Every edge flushes the received data, so a short transfer is
+// shown without waiting for the flush timer. With CS framing, a deassertion also ends the
+// transaction. Edges are timestamped here and processed by the DMA ISR.
+static void flipper_spi_terminal_scene_terminal_cs_isr(void* context) {
+    const uint32_t cycles = DWT->CYCCNT;
     SPI_TERM_CONTEXT_TO_APP(context);
-    view_dispatcher_send_custom_event(app->view_dispatcher, FlipperSPITerminalEventReceivedData);
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    if(app->config.framing_mode == TerminalFramingModeChipSelect) {
+        if(furi_hal_gpio_read(SPI_TERM_CS_PIN)) {
+            terminal->stats.transactions++;
+            terminal->cs_end_cycles = cycles;
+            terminal->rx_dma_transaction_ended = true;
+        } else {
+            terminal->cs_start_cycles = cycles;
+            terminal->rx_dma_transaction_started = true;
+        }
+    }
+
+    flipper_spi_terminal_scene_terminal_flush(app);
+}
+
+// One-shot. Armed by the notify thread after data was delivered and re-armed from here, as long
+// as the DMA moves. Once the DMA stood still for a whole period, the partially filled half is
+// flushed and the timer stops. Nothing runs on a idle bus.
+static void flipper_spi_terminal_scene_terminal_flush_timer(void* context) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    if(!terminal->rx_dma_running) {
+        return;
+    }
+
+    const size_t position = flipper_spi_terminal_scene_terminal_dma_rx_position(app);
+    bool watch = false;
+    if(position != terminal->rx_dma_idle_position) {
+        terminal->rx_dma_idle_ticks = 0;
+        watch = true;
+    } else if(position != terminal->rx_dma_position) {
+        // The delivery notifies and arms the timer once more, to see the bus stay idle
+        flipper_spi_terminal_scene_terminal_flush(app);
+    } else if(terminal->record != NULL && !terminal->record_idle) {
+        // A idle bus is the best time to pause the capture for writing the recording
+        if(++terminal->rx_dma_idle_ticks ==
+           SPI_TERM_RECORD_IDLE_MS / SPI_TERM_DMA_IDLE_FLUSH_MS) {
+            terminal->record_idle = true;
+            flipper_spi_terminal_scene_terminal_notify(app);
+        } else {
+            watch = true;
+        }
+    }
+    terminal->rx_dma_idle_position = position;
+
+    if(watch) {
+        flipper_spi_terminal_scene_terminal_watch(app);
+    }
+}
+
+// Appends received data to the terminal view and the recording
+static void flipper_spi_terminal_scene_terminal_append_data(
+    FlipperSPITerminalApp* app,
+    const uint8_t* data,
+    size_t length) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    terminal_view_append_data(terminal->view, data, length);
+
+    if(terminal->record != NULL) {
+        // Dropped bytes are missing before this data
+        if(terminal->stats.bytes_dropped != terminal->record_dropped) {
+            terminal->record_dropped = terminal->stats.bytes_dropped;
+            flipper_spi_terminal_record_mark_gap(terminal->record);
+        }
+        flipper_spi_terminal_record_write(terminal->record, data, length);
+    }
+}
+
+// Appends up to length bytes from rx_buffer_ring to the terminal view and the recording
+static void flipper_spi_terminal_scene_terminal_append_from_ring(
+    FlipperSPITerminalApp* app,
+    size_t length) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    SpscRing* ring = terminal->rx_buffer_ring;
+
+    if(terminal->record == NULL) {
+        terminal_view_append_data_from_ring(terminal->view, ring, length);
+    } else {
+        length = MIN(length, spsc_ring_size(ring));
+        while(length > 0) {
+            SpscRingSpan spans[2];
+            const size_t peeked = spsc_ring_peek_span(ring, 0, length, spans);
+            for(size_t i = 0; i < COUNT_OF(spans); i++) {
+                if(spans[i].length > 0) {
+                    flipper_spi_terminal_scene_terminal_append_data(
+                        app, spans[i].data, spans[i].length);
+                }
+            }
+            spsc_ring_consume(ring, peeked);
+            length -= peeked;
+        }
+    }
+
+    // Injected data, which did not fit, waits for the room made here
+    if(spsc_ring_size(terminal->inject_ring) > 0 && terminal->rx_dma_running) {
+        NVIC_SetPendingIRQ(SPI_DMA_RX_IRQN);
+    }
+}
+
+// Replaces the trigger with the pending one. Only called by the GUI thread or while the Terminal
+// Screen is not active.
+static void flipper_spi_terminal_scene_terminal_install_trigger(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    FlipperSPITerminalTrigger* trigger = atomic_exchange(&terminal->trigger_pending, NULL);
+    if(trigger == NULL) {
+        return;
+    }
+
+    // The DMA ISR can not be in the middle of a chunk, once this thread runs again
+    FlipperSPITerminalTrigger* replaced = terminal->trigger;
+    terminal->trigger = trigger;
+    flipper_spi_terminal_trigger_free(replaced);
+
+    // Starts a new capture. Bytes, which were received but not shown yet, are dropped.
+    terminal->rx_dma_read_count = terminal->rx_dma_write_count;
+    terminal->trigger_trimmed = false;
+    if(terminal->record != NULL) {
+        flipper_spi_terminal_record_mark_gap(terminal->record);
+    }
+    if(flipper_spi_terminal_trigger_get_state(trigger) != FlipperSPITerminalTriggerStateOff) {
+        terminal_view_reset(terminal->view);
+    }
+
+    flipper_spi_terminal_scene_terminal_update_overlay(app);
+}
+
+void flipper_spi_terminal_scene_terminal_set_trigger(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalTrigger* trigger) {
+    furi_check(app);
+    furi_check(trigger);
+
+    FlipperSPITerminalTrigger* replaced =
+        atomic_exchange(&app->terminal_screen.trigger_pending, trigger);
+    if(replaced != NULL) {
+        flipper_spi_terminal_trigger_free(replaced);
+    }
+
+    if(app->terminal_screen.is_active) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, FlipperSPITerminalEventTriggerChanged);
+    } else {
+        flipper_spi_terminal_scene_terminal_install_trigger(app);
+    }
 }
 
 void flipper_spi_terminal_scene_terminal_alloc(FlipperSPITerminalApp* app) {
@@ -33,13 +529,34 @@ void flipper_spi_terminal_scene_terminal_alloc(FlipperSPITerminalApp* app) {
     // Main View
     app->terminal_screen.view = terminal_view_alloc();
     app->terminal_screen.is_active = false;
+    app->terminal_screen.rx_dma_running = false;
 
     // Buffer for transfer from DMA to screen
-    app->terminal_screen.rx_buffer_stream = furi_stream_buffer_alloc(512, 512);
+    app->terminal_screen.rx_buffer_ring = spsc_ring_alloc(512);
+    app->terminal_screen.inject_ring = spsc_ring_alloc(SPI_TERM_INJECT_RING_SIZE);
+    app->terminal_screen.inject_lock = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->terminal_screen.transaction_ring = spsc_ring_alloc(SPI_TERM_TRANSACTION_RING_SIZE);
+    app->terminal_screen.timestamps = timestamp_index_alloc(SPI_TERM_TIMESTAMP_INDEX_SIZE);
 
-    // Timer for data read from RX buffer. I tried a lot of things. This is the only reliable solution.
-    app->terminal_screen.recv_timer = furi_timer_alloc(
-        flipper_spi_terminal_scene_terminal_process_receive_timer, FuriTimerTypePeriodic, app);
+    // Flushes partially filled DMA halves on a idle bus
+    app->terminal_screen.flush_timer = furi_timer_alloc(
+        flipper_spi_terminal_scene_terminal_flush_timer, FuriTimerTypeOnce, app);
+
+    // Wakes the GUI thread, if new data was received
+    app->terminal_screen.notify_thread = furi_thread_alloc_ex(
+        "SpiTermNotify", 1024, flipper_spi_terminal_scene_terminal_notify_thread, app);
+    atomic_init(&app->terminal_screen.event_pending, false);
+
+    // Captures everything, until a pattern is set
+    app->terminal_screen.trigger = flipper_spi_terminal_trigger_alloc();
+    atomic_init(&app->terminal_screen.trigger_pending, NULL);
+
+    // Master mode transmit engine
+    app->terminal_screen.tx = flipper_spi_terminal_tx_alloc(SPI_TERM_TX_QUEUE_SIZE);
+
+    // Simulated DMA source. Only used for debugging.
+    app->terminal_screen.sim =
+        flipper_spi_terminal_sim_alloc(flipper_spi_terminal_scene_terminal_sim_chunk, app);
 
     view_dispatcher_add_view(
         app->view_dispatcher,
@@ -55,21 +572,36 @@ void flipper_spi_terminal_scene_terminal_free(FlipperSPITerminalApp* app) {
 
     view_dispatcher_remove_view(app->view_dispatcher, FlipperSPITerminalAppSceneTerminal);
 
-    furi_stream_buffer_free(app->terminal_screen.rx_buffer_stream);
+    flipper_spi_terminal_sim_free(app->terminal_screen.sim);
+
+    flipper_spi_terminal_tx_free(app->terminal_screen.tx);
+    flipper_spi_terminal_trigger_free(app->terminal_screen.trigger);
+    FlipperSPITerminalTrigger* trigger_pending =
+        atomic_exchange(&app->terminal_screen.trigger_pending, NULL);
+    if(trigger_pending != NULL) {
+        flipper_spi_terminal_trigger_free(trigger_pending);
+    }
+    if(app->terminal_screen.sequence != NULL) {
+        flipper_spi_terminal_sequence_free(app->terminal_screen.sequence);
+    }
+
+    furi_thread_free(app->terminal_screen.notify_thread);
+
+    furi_timer_free(app->terminal_screen.flush_timer);
+
+    spsc_ring_free(app->terminal_screen.rx_buffer_ring);
+    spsc_ring_free(app->terminal_screen.inject_ring);
+    furi_mutex_free(app->terminal_screen.inject_lock);
+    spsc_ring_free(app->terminal_screen.transaction_ring);
+    timestamp_index_free(app->terminal_screen.timestamps);
 
     terminal_view_free(app->terminal_screen.view);
     SPI_TERM_LOG_T("Freeing terminal screen done!");
 }
 
-static void flipper_spi_terminal_scene_terminal_add_data(
-    FlipperSPITerminalApp* app,
-    const void* data,
-    size_t length) {
-    furi_stream_buffer_send(app->terminal_screen.rx_buffer_stream, data, length, 0);
-}
-
 static void flipper_spi_terminal_scene_terminal_dma_rx_isr(void* context) {
     SPI_TERM_CONTEXT_TO_APP(context);
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
 
     if(!LL_DMA_IsEnabledIT_TC(SPI_DMA, SPI_DMA_RX_CHANNEL) &&
        !LL_DMA_IsEnabledIT_HT(SPI_DMA, SPI_DMA_RX_CHANNEL) &&
@@ -77,22 +609,112 @@ static void flipper_spi_terminal_scene_terminal_dma_rx_isr(void* context) {
         return;
     }
 
-    uint8_t* startOfData = NULL;
+    // Flags are cleared first, a event during the processing is handled in the next call.
+    // Everything since the last delivered offset is passed on, which might be less than a half
+    // after a flush.
+    const size_t half = terminal->rx_dma_half_size;
+    if(LL_DMA_IsActiveFlag_HT6(SPI_DMA)) { // First half
+        LL_DMA_ClearFlag_HT6(SPI_DMA);
+        terminal->stats.dma_half_events++;
+        if(terminal->rx_dma_position < half) {
+            flipper_spi_terminal_scene_terminal_dma_rx_deliver(
+                app, terminal->rx_dma_position, half);
+        }
+    }
+
     if(LL_DMA_IsActiveFlag_TC6(SPI_DMA)) { // Second half
-        startOfData = app->terminal_screen.rx_dma_buffer + app->config.rx_dma_buffer_size;
-    } else if(LL_DMA_IsActiveFlag_HT6(SPI_DMA)) { // First half
-        startOfData = app->terminal_screen.rx_dma_buffer;
-    } else if(LL_DMA_IsActiveFlag_TE6(SPI_DMA)) { // Error
+        LL_DMA_ClearFlag_TC6(SPI_DMA);
+        terminal->stats.dma_full_events++;
+        flipper_spi_terminal_scene_terminal_dma_rx_deliver(
+            app, terminal->rx_dma_position, half * 2);
     }
 
-    if(startOfData != NULL) {
-        flipper_spi_terminal_scene_terminal_add_data(
-            app, startOfData, app->config.rx_dma_buffer_size);
+    if(LL_DMA_IsActiveFlag_TE6(SPI_DMA)) { // Error
+        LL_DMA_ClearFlag_TE6(SPI_DMA);
+        // The channel is disabled by the hardware. Everything after this is lost.
+        terminal->stats.transfer_errors++;
+        flipper_spi_terminal_scene_terminal_notify(app);
     }
 
-    LL_DMA_ClearFlag_HT6(SPI_DMA);
-    LL_DMA_ClearFlag_TC6(SPI_DMA);
-    LL_DMA_ClearFlag_TE6(SPI_DMA);
+    // Software triggered: Deliver a partially filled half without stopping the transfer. If the
+    // DMA wrapped around in the meantime, TC is pending and handles the data.
+    if(terminal->rx_dma_flush_requested) {
+        terminal->rx_dma_flush_requested = false;
+
+        const size_t position = flipper_spi_terminal_scene_terminal_dma_rx_position(app);
+        if(position > terminal->rx_dma_position) {
+            terminal->stats.dma_flush_events++;
+            flipper_spi_terminal_scene_terminal_dma_rx_deliver(
+                app, terminal->rx_dma_position, position);
+        }
+
+        // Both edges can be pending. A start before the end belongs to the ended transaction.
+        bool started = terminal->rx_dma_transaction_started;
+        const bool ended = terminal->rx_dma_transaction_ended;
+        terminal->rx_dma_transaction_started = false;
+        terminal->rx_dma_transaction_ended = false;
+        if(started &&
+           (!ended || (int32_t)(terminal->cs_end_cycles - terminal->cs_start_cycles) > 0)) {
+            flipper_spi_terminal_scene_terminal_start_transaction(app);
+            started = false;
+        }
+        if(ended) {
+            flipper_spi_terminal_scene_terminal_end_transaction(app);
+        }
+        if(started) {
+            flipper_spi_terminal_scene_terminal_start_transaction(app);
+        }
+    }
+
+    // Debug data and the simulated DMA, see flipper_spi_terminal_scene_terminal_inject
+    flipper_spi_terminal_scene_terminal_drain_inject(app);
+}
+
+// Consumer side of TerminalIngestModeDirect. Copies everything the ISR published up to the write
+// count write straight from the DMA buffer into the terminal view.
+static void flipper_spi_terminal_scene_terminal_read_dma_buffer(
+    FlipperSPITerminalApp* app,
+    uint32_t write) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    // Buffer sizes are a power of two. The modulo stays correct, if the counters overflow.
+    const uint32_t half = terminal->rx_dma_half_size;
+    const uint32_t size = half * 2;
+
+    uint32_t read = terminal->rx_dma_read_count;
+
+    // Nothing after the end of a stopped trigger capture is shown
+    const uint32_t received = write;
+    if(flipper_spi_terminal_trigger_get_state(terminal->trigger) ==
+       FlipperSPITerminalTriggerStateStopped) {
+        const uint32_t capture_end = terminal->rx_dma_capture_end;
+        if((int32_t)(write - capture_end) > 0) {
+            write = (int32_t)(capture_end - read) > 0 ? capture_end : read;
+        }
+    }
+
+    // The DMA is at most one half ahead of the write index. Anything older than one half is gone.
+    if(write - read > half) {
+        terminal->stats.bytes_dropped += write - read - half;
+        read = write - half;
+    }
+
+    const uint32_t start = read;
+    while(read != write) {
+        const uint32_t offset = read % size;
+        const uint32_t length = MIN(write - read, size - offset);
+        flipper_spi_terminal_scene_terminal_append_data(
+            app, terminal->rx_dma_buffer + offset, length);
+        read += length;
+    }
+
+    // Bytes, which were overwritten by the DMA while they were copied
+    const uint32_t valid_after_copy = terminal->rx_dma_write_count - half;
+    if((int32_t)(valid_after_copy - start) > 0) {
+        terminal->stats.bytes_dropped += MIN(valid_after_copy, write) - start;
+    }
+
+    // Skipped bytes count as read
+    terminal->rx_dma_read_count = received;
 }
 
 static void flipper_spi_terminal_scene_terminal_init_spi_dma(FlipperSPITerminalApp* app) {
@@ -109,9 +731,15 @@ static void flipper_spi_terminal_scene_terminal_init_spi_dma(FlipperSPITerminalA
     SPI_TERM_LOG_T("Init SPI-Settings");
     LL_SPI_Disable(spi_terminal_spi);
     LL_SPI_Init(spi_terminal_spi, &app->config.spi);
+    // RXNE (and with it the DMA request) has to fire on a full frame
+    LL_SPI_SetRxFIFOThreshold(
+        spi_terminal_spi,
+        app->terminal_screen.frame_size == 2 ? LL_SPI_RX_FIFO_TH_HALF : LL_SPI_RX_FIFO_TH_QUARTER);
     LL_SPI_Enable(spi_terminal_spi);
 
     SPI_TERM_LOG_T("Init DMA");
+    // Frames of more than 8 bit are moved as half-words. Those are stored little endian.
+    const bool half_word = app->terminal_screen.frame_size == 2;
     LL_DMA_InitTypeDef dma_config = {
         .PeriphOrM2MSrcAddress = (uint32_t)&spi_terminal_spi->DR,
         .MemoryOrM2MDstAddress = (uint32_t)app->terminal_screen.rx_dma_buffer,
@@ -119,9 +747,9 @@ static void flipper_spi_terminal_scene_terminal_init_spi_dma(FlipperSPITerminalA
         .Mode = LL_DMA_MODE_CIRCULAR,
         .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
         .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
-        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
-        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
-        .NbData = app->config.rx_dma_buffer_size * 2,
+        .PeriphOrM2MSrcDataSize = half_word ? LL_DMA_PDATAALIGN_HALFWORD : LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = half_word ? LL_DMA_MDATAALIGN_HALFWORD : LL_DMA_MDATAALIGN_BYTE,
+        .NbData = app->terminal_screen.rx_dma_half_size * 2 / app->terminal_screen.frame_size,
         .PeriphRequest = SPI_DMA_RX_REQ,
         .Priority = LL_DMA_PRIORITY_MEDIUM,
     };
@@ -150,6 +778,36 @@ static void flipper_spi_terminal_scene_terminal_init_spi_dma(FlipperSPITerminalA
     LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
 }
 
+// CS edges frame transactions and wake the capture in every framing mode
+static void flipper_spi_terminal_scene_terminal_init_cs(FlipperSPITerminalApp* app) {
+    SPI_TERM_LOG_T("Enabling CS interrupt");
+    furi_hal_gpio_add_int_callback(
+        SPI_TERM_CS_PIN, flipper_spi_terminal_scene_terminal_cs_isr, app);
+
+    if(app->config.spi.NSS == LL_SPI_NSS_SOFT && app->config.spi.Mode == LL_SPI_MODE_SLAVE) {
+        // CS is not used by the SPI peripheral and can be a plain input
+        furi_hal_gpio_init(
+            SPI_TERM_CS_PIN, GpioModeInterruptRiseFall, GpioPullUp, GpioSpeedVeryHigh);
+    } else {
+        // The pin is owned by the SPI peripheral or driven by a sequence. EXTI still sees the
+        // level of the pin.
+        LL_SYSCFG_SetEXTISource(LL_SYSCFG_EXTI_PORTA, LL_SYSCFG_EXTI_LINE4);
+        LL_EXTI_EnableRisingTrig_0_31(SPI_TERM_CS_EXTI_LINE);
+        LL_EXTI_EnableFallingTrig_0_31(SPI_TERM_CS_EXTI_LINE);
+        LL_EXTI_EnableIT_0_31(SPI_TERM_CS_EXTI_LINE);
+    }
+}
+
+static void flipper_spi_terminal_scene_terminal_deinit_cs(FlipperSPITerminalApp* app) {
+    UNUSED(app);
+    SPI_TERM_LOG_T("Disabling CS interrupt");
+    // The pin itself is reset by furi_hal_spi_bus_handle_deinit
+    LL_EXTI_DisableIT_0_31(SPI_TERM_CS_EXTI_LINE);
+    LL_EXTI_DisableRisingTrig_0_31(SPI_TERM_CS_EXTI_LINE);
+    LL_EXTI_DisableFallingTrig_0_31(SPI_TERM_CS_EXTI_LINE);
+    furi_hal_gpio_remove_int_callback(SPI_TERM_CS_PIN);
+}
+
 static void flipper_spi_terminal_scene_terminal_deinit_spi_dma(FlipperSPITerminalApp* app) {
     furi_check(app);
 
@@ -167,6 +825,18 @@ static void flipper_spi_terminal_scene_terminal_deinit_spi_dma(FlipperSPITermina
     // Clear interrupt
     furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, NULL, NULL);
 
+    // Delivers, what was received since the last interrupt. The DMA might have wrapped around.
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    const size_t position = flipper_spi_terminal_scene_terminal_dma_rx_position(app);
+    if(LL_DMA_IsActiveFlag_TC6(SPI_DMA) || position < terminal->rx_dma_position) {
+        flipper_spi_terminal_scene_terminal_dma_rx_deliver(
+            app, terminal->rx_dma_position, terminal->rx_dma_half_size * 2);
+    }
+    flipper_spi_terminal_scene_terminal_dma_rx_deliver(app, terminal->rx_dma_position, position);
+    LL_DMA_ClearFlag_HT6(SPI_DMA);
+    LL_DMA_ClearFlag_TC6(SPI_DMA);
+    flipper_spi_terminal_scene_terminal_drain_inject(app);
+
     // Disable SPI to DMA
     LL_SPI_DisableDMAReq_RX(spi_terminal_spi);
 
@@ -178,19 +848,161 @@ static void flipper_spi_terminal_scene_terminal_deinit_spi_dma(FlipperSPITermina
     furi_hal_spi_bus_handle_deinit(spi_terminal_spi_bus_handle);
 }
 
+// Appends everything, which was received before the transaction end end, to the terminal view
+static void flipper_spi_terminal_scene_terminal_append_transaction(
+    FlipperSPITerminalApp* app,
+    uint32_t end) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    // end might already be consumed, if data was dropped
+    if(app->config.ingest_mode == TerminalIngestModeDirect) {
+        if((int32_t)(end - terminal->rx_dma_read_count) > 0) {
+            flipper_spi_terminal_scene_terminal_read_dma_buffer(app, end);
+        }
+    } else {
+        const uint32_t position = spsc_ring_position(terminal->rx_buffer_ring);
+        if((int32_t)(end - position) > 0) {
+            flipper_spi_terminal_scene_terminal_append_from_ring(app, end - position);
+        }
+    }
+}
+
+static uint32_t flipper_spi_terminal_scene_terminal_duration(uint64_t from, uint64_t to) {
+    return MIN(to - from, UINT32_MAX);
+}
+
+// Measures the CS transaction timing from the timestamp index
+static void flipper_spi_terminal_scene_terminal_read_timestamps(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppTerminalTiming* timing = &app->terminal_screen.timing;
+
+    TimestampIndexEntry entry;
+    while(timestamp_index_read(app->terminal_screen.timestamps, &entry)) {
+        switch(entry.kind) {
+        case TimestampIndexKindFrameStart:
+            if(timing->end != 0 && entry.cycles > timing->end) {
+                timing->last_gap =
+                    flipper_spi_terminal_scene_terminal_duration(timing->end, entry.cycles);
+                latency_histogram_add(&timing->gap, timing->last_gap);
+            }
+            timing->start = entry.cycles;
+            break;
+        case TimestampIndexKindFrameEnd:
+            if(timing->start != 0 && entry.cycles > timing->start) {
+                timing->last_burst =
+                    flipper_spi_terminal_scene_terminal_duration(timing->start, entry.cycles);
+                latency_histogram_add(&timing->burst, timing->last_burst);
+            }
+            timing->start = 0;
+            timing->end = entry.cycles;
+            break;
+        case TimestampIndexKindChunk:
+            break;
+        }
+    }
+}
+
+// Locks the bus and starts receiving
+static void flipper_spi_terminal_scene_terminal_start_capture(FlipperSPITerminalApp* app) {
+    flipper_spi_terminal_scene_terminal_init_spi_dma(app);
+    flipper_spi_terminal_scene_terminal_init_cs(app);
+
+    // Only a master can send on its own. Received frames are captured like in slave mode.
+    if(app->config.spi.Mode == LL_SPI_MODE_MASTER &&
+       app->config.spi.TransferDirection != LL_SPI_SIMPLEX_RX &&
+       app->config.spi.TransferDirection != LL_SPI_HALF_DUPLEX_RX) {
+        flipper_spi_terminal_tx_start(app->terminal_screen.tx, app->terminal_screen.frame_size);
+    }
+
+    // Catches a transfer, which was already running
+    app->terminal_screen.rx_dma_running = true;
+    flipper_spi_terminal_scene_terminal_arm_flush_timer(app);
+}
+
+// Stops receiving and releases the bus. Everything, which was received, is delivered.
+static void flipper_spi_terminal_scene_terminal_stop_capture(FlipperSPITerminalApp* app) {
+    app->terminal_screen.rx_dma_running = false;
+    furi_timer_stop(app->terminal_screen.flush_timer);
+    flipper_spi_terminal_tx_stop(app->terminal_screen.tx);
+    flipper_spi_terminal_scene_terminal_deinit_cs(app);
+    flipper_spi_terminal_scene_terminal_deinit_spi_dma(app);
+}
+
 void flipper_spi_terminal_scene_terminal_on_enter(void* context) {
     SPI_TERM_LOG_T("Enter Terminal");
     SPI_TERM_CONTEXT_TO_APP(context);
 
     terminal_view_set_display_mode(app->terminal_screen.view, app->config.display_mode);
 
-    furi_stream_buffer_reset(app->terminal_screen.rx_buffer_stream);
+    app->terminal_screen.frame_size =
+        (app->config.spi.DataWidth > LL_SPI_DATAWIDTH_8BIT) ? sizeof(uint16_t) : sizeof(uint8_t);
+    terminal_view_set_frame_size(app->terminal_screen.view, app->terminal_screen.frame_size);
 
-    // Minimum of 2 bytes for rx buffer
+    // The staging buffer is allocated before the capture buffer takes the rest of the heap on
+    // "Max". The SD card is on the same bus. The file has to be created before the bus is locked.
+    app->terminal_screen.record = NULL;
+    app->terminal_screen.record_failed = false;
+    app->terminal_screen.record_dropped = 0;
+    app->terminal_screen.record_idle = false;
+    app->terminal_screen.rx_dma_idle_ticks = 0;
+    if(app->config.record_buffer_size > 0) {
+        CaptureFileHeader header = {
+            .chunk_size = SPI_TERM_RECORD_CHUNK_SIZE,
+            .frame_size = app->terminal_screen.frame_size,
+            .clock_hz = 0, // No timestamps
+        };
+        flipper_spi_terminal_config_to_capture(&app->config, &header);
+
+        // Recording is turned off for this session on an error
+        app->terminal_screen.record =
+            flipper_spi_terminal_record_alloc(app->config.record_buffer_size);
+        if(app->terminal_screen.record != NULL &&
+           !flipper_spi_terminal_record_open(app->terminal_screen.record, &header)) {
+            flipper_spi_terminal_record_free(app->terminal_screen.record);
+            app->terminal_screen.record = NULL;
+        }
+        app->terminal_screen.record_failed = app->terminal_screen.record == NULL;
+    }
+
+    // Minimum of 2 bytes for rx buffer. Every half needs to hold at least one frame.
     furi_check(app->config.rx_dma_buffer_size >= 1);
-    app->terminal_screen.rx_dma_buffer = malloc(app->config.rx_dma_buffer_size * 2);
+    app->terminal_screen.rx_dma_half_size =
+        MAX(app->config.rx_dma_buffer_size, app->terminal_screen.frame_size);
+    app->terminal_screen.rx_dma_buffer = malloc(app->terminal_screen.rx_dma_half_size * 2);
 
-    flipper_spi_terminal_scene_terminal_init_spi_dma(app);
+    // Sized after the session buffers, "Max" takes the rest of the heap. Reallocation drops the
+    // content. Is skipped, if the size did not change.
+    terminal_view_set_capture_size(
+        app->terminal_screen.view, app->config.capture_buffer_size, SPI_TERM_SESSION_HEAP_RESERVE);
+
+    spsc_ring_reset(app->terminal_screen.rx_buffer_ring);
+    spsc_ring_reset(app->terminal_screen.inject_ring);
+    spsc_ring_reset(app->terminal_screen.transaction_ring);
+    timestamp_index_reset(app->terminal_screen.timestamps);
+    cycle_clock_reset(&app->terminal_screen.clock);
+
+    // Every session starts a new search
+    flipper_spi_terminal_scene_terminal_install_trigger(app);
+    flipper_spi_terminal_trigger_arm(app->terminal_screen.trigger);
+    app->terminal_screen.trigger_trimmed = false;
+
+    memset(&app->terminal_screen.stats, 0, sizeof(app->terminal_screen.stats));
+    memset(&app->terminal_screen.timing, 0, sizeof(app->terminal_screen.timing));
+    flipper_spi_terminal_scene_terminal_update_overlay(app);
+
+    app->terminal_screen.rx_dma_write_count = 0;
+    app->terminal_screen.rx_dma_read_count = 0;
+    app->terminal_screen.rx_dma_position = 0;
+    app->terminal_screen.rx_dma_idle_position = 0;
+    app->terminal_screen.rx_dma_flush_requested = false;
+    app->terminal_screen.rx_dma_transaction_started = false;
+    app->terminal_screen.rx_dma_transaction_ended = false;
+    app->terminal_screen.rx_dma_capture_end = 0;
+
+    // Needs to run before the first byte is received
+    atomic_store(&app->terminal_screen.event_pending, false);
+    furi_thread_start(app->terminal_screen.notify_thread);
+
+    flipper_spi_terminal_scene_terminal_start_capture(app);
 
     view_dispatcher_switch_to_view(app->view_dispatcher, FlipperSPITerminalAppSceneTerminal);
     app->terminal_screen.is_active = true;
@@ -199,24 +1011,223 @@ void flipper_spi_terminal_scene_terminal_on_enter(void* context) {
         terminal_view_reset(app->terminal_screen.view);
     }
 
-    furi_timer_start(app->terminal_screen.recv_timer, 300);
-
     if(!furi_string_empty(app->config.debug.debug_terminal_data)) {
         const char* data = furi_string_get_cstr(app->config.debug.debug_terminal_data);
         size_t length = furi_string_size(app->config.debug.debug_terminal_data);
 
         terminal_view_reset(app->terminal_screen.view);
-        flipper_spi_terminal_scene_terminal_add_data(app, data, length);
+        flipper_spi_terminal_scene_terminal_inject(app, data, length);
+    }
+}
+
+typedef struct {
+    FlipperSPITerminalApp* app;
+    SpscRing* rx_tap;
+    size_t rx_pending; // Sent bytes, which were not taken from rx_tap yet
+    uint32_t rx_dropped; // rx_tap_dropped at the start of the last transfer
+} FlipperSPITerminalSceneTerminalSequenceBus;
+
+static bool flipper_spi_terminal_scene_terminal_sequence_transfer(
+    void* context,
+    const uint8_t* data,
+    size_t length) {
+    FlipperSPITerminalSceneTerminalSequenceBus* bus = context;
+    FlipperSPITerminalAppScreenTerminal* terminal = &bus->app->terminal_screen;
+
+    // Everything received up to now belongs to earlier transfers. Dropped bytes never arrive.
+    const size_t dropped = terminal->rx_tap_dropped - bus->rx_dropped;
+    bus->rx_pending -= MIN(dropped, bus->rx_pending);
+    const size_t received = MIN(spsc_ring_size(bus->rx_tap), bus->rx_pending);
+    spsc_ring_consume(bus->rx_tap, received);
+    bus->rx_pending = bus->rx_pending - received + length;
+    bus->rx_dropped = terminal->rx_tap_dropped;
+
+    return flipper_spi_terminal_tx_write(
+               terminal->tx, data, length, furi_ms_to_ticks(SPI_TERM_SEQUENCE_TIMEOUT_MS)) ==
+           length;
+}
+
+static bool flipper_spi_terminal_scene_terminal_sequence_wait_idle(void* context) {
+    FlipperSPITerminalSceneTerminalSequenceBus* bus = context;
+    return flipper_spi_terminal_tx_flush(
+        bus->app->terminal_screen.tx, furi_ms_to_ticks(SPI_TERM_SEQUENCE_TIMEOUT_MS));
+}
+
+static void flipper_spi_terminal_scene_terminal_sequence_set_cs(void* context, bool asserted) {
+    UNUSED(context);
+    // Active low. furi_hal_spi_bus_handle_init configures the pin as output. With a hardware NSS,
+    // the pin is owned by the SPI peripheral and this has no effect.
+    furi_hal_gpio_write(SPI_TERM_CS_PIN, !asserted);
+}
+
+static bool flipper_spi_terminal_scene_terminal_sequence_receive(
+    void* context,
+    uint8_t* data,
+    size_t length) {
+    FlipperSPITerminalSceneTerminalSequenceBus* bus = context;
+    FlipperSPITerminalApp* app = bus->app;
+
+    if(!flipper_spi_terminal_scene_terminal_sequence_wait_idle(context)) {
+        return false;
+    }
+
+    // The last bytes are still in the partially filled DMA half
+    flipper_spi_terminal_scene_terminal_flush(app);
+
+    const uint32_t start = furi_get_tick();
+    while(spsc_ring_size(bus->rx_tap) < bus->rx_pending) {
+        if(app->terminal_screen.rx_tap_dropped != bus->rx_dropped ||
+           furi_get_tick() - start >= furi_ms_to_ticks(SPI_TERM_SEQUENCE_TIMEOUT_MS)) {
+            return false;
+        }
+        furi_delay_tick(1);
+    }
+
+    // The checked bytes are the last ones of the transfer
+    spsc_ring_consume(bus->rx_tap, bus->rx_pending - length);
+    spsc_ring_read(bus->rx_tap, data, length);
+    bus->rx_pending = 0;
+    return true;
+}
+
+bool flipper_spi_terminal_scene_terminal_run_sequence(
+    FlipperSPITerminalApp* app,
+    const FlipperSPITerminalSequence* sequence,
+    FlipperSPITerminalSequenceResult* result) {
+    furi_check(app);
+    furi_check(sequence);
+    furi_check(result);
+
+    if(!app->terminal_screen.is_active ||
+       !flipper_spi_terminal_tx_is_running(app->terminal_screen.tx)) {
+        return false;
+    }
+
+    FlipperSPITerminalSceneTerminalSequenceBus context = {
+        .app = app,
+        .rx_tap = spsc_ring_alloc(SPI_TERM_SEQUENCE_RX_TAP_SIZE),
+        .rx_pending = 0,
+        .rx_dropped = 0,
+    };
+    const FlipperSPITerminalSequenceBus bus = {
+        .context = &context,
+        .transfer = flipper_spi_terminal_scene_terminal_sequence_transfer,
+        .wait_idle = flipper_spi_terminal_scene_terminal_sequence_wait_idle,
+        .set_cs = flipper_spi_terminal_scene_terminal_sequence_set_cs,
+        .receive = flipper_spi_terminal_scene_terminal_sequence_receive,
+    };
+
+    app->terminal_screen.rx_tap_dropped = 0;
+    app->terminal_screen.rx_tap = context.rx_tap;
+    flipper_spi_terminal_sequence_run(sequence, &bus, result);
+    // The DMA ISR can not be in the middle of a write, once this thread runs again
+    app->terminal_screen.rx_tap = NULL;
+    spsc_ring_free(context.rx_tap);
+
+    app->terminal_screen.stats.sequence_runs++;
+    if(result->aborted || result->failed_expects > 0) {
+        app->terminal_screen.stats.sequence_failures++;
+    }
+
+    return true;
+}
+
+// Moves everything, which was received, to the terminal view and the recording
+static void flipper_spi_terminal_scene_terminal_process(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+
+    const uint32_t start = DWT->CYCCNT;
+
+    // Everything up to the end of the capture is delivered, once the trigger stopped
+    const bool stopped = flipper_spi_terminal_trigger_get_state(terminal->trigger) ==
+                         FlipperSPITerminalTriggerStateStopped;
+
+    // Data up to every transaction end first, so the view can split the rows
+    uint32_t end;
+    while(spsc_ring_size(terminal->transaction_ring) >= sizeof(end)) {
+        spsc_ring_read(terminal->transaction_ring, &end, sizeof(end));
+        flipper_spi_terminal_scene_terminal_append_transaction(app, end);
+        terminal_view_end_transaction(terminal->view);
+        if(terminal->record != NULL) {
+            flipper_spi_terminal_record_end_frame(terminal->record);
+        }
+    }
+
+    // Debug data and the simulated DMA always use the ring
+    flipper_spi_terminal_scene_terminal_append_from_ring(
+        app, spsc_ring_capacity(terminal->rx_buffer_ring));
+
+    if(app->config.ingest_mode == TerminalIngestModeDirect) {
+        flipper_spi_terminal_scene_terminal_read_dma_buffer(app, terminal->rx_dma_write_count);
+    }
+
+    if(stopped && !terminal->trigger_trimmed) {
+        terminal_view_keep_last(
+            terminal->view, flipper_spi_terminal_trigger_get_window(terminal->trigger));
+        terminal->trigger_trimmed = true;
+    }
+
+    if(terminal->profile.enabled) {
+        latency_histogram_add(&terminal->profile.append, DWT->CYCCNT - start);
     }
 }
 
+// Writes the staged recording to the SD card, once the staging buffer is half full or the bus is
+// idle. The SD card shares the bus, so the capture is paused meanwhile. Everything, which is
+// received during the pause, is lost and marked as gap.
+static void flipper_spi_terminal_scene_terminal_write_record(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenTerminal* terminal = &app->terminal_screen;
+    FlipperSPITerminalRecord* record = terminal->record;
+
+    if(record == NULL || flipper_spi_terminal_record_get_pending(record) == 0) {
+        terminal->record_idle = false;
+        return;
+    }
+    if(!terminal->record_idle && !flipper_spi_terminal_record_is_high(record)) {
+        return;
+    }
+    // Sent data and running sequences would be cut
+    if(terminal->rx_tap != NULL || (flipper_spi_terminal_tx_is_running(terminal->tx) &&
+                                    !flipper_spi_terminal_tx_is_idle(terminal->tx))) {
+        return;
+    }
+    terminal->record_idle = false;
+
+    flipper_spi_terminal_scene_terminal_stop_capture(app);
+    flipper_spi_terminal_scene_terminal_process(app);
+
+    flipper_spi_terminal_record_flush(record);
+    flipper_spi_terminal_record_mark_gap(record);
+    terminal_view_end_transaction(terminal->view);
+
+    // The DMA starts at the begin of the buffer again. Everything was read.
+    const uint32_t size = terminal->rx_dma_half_size * 2;
+    terminal->rx_dma_write_count += (size - terminal->rx_dma_write_count % size) % size;
+    terminal->rx_dma_read_count = terminal->rx_dma_write_count;
+    terminal->rx_dma_position = 0;
+    terminal->rx_dma_idle_position = 0;
+    terminal->rx_dma_idle_ticks = 0;
+    terminal->rx_dma_transaction_started = false;
+    terminal->rx_dma_transaction_ended = false;
+
+    flipper_spi_terminal_scene_terminal_start_capture(app);
+}
+
 bool flipper_spi_terminal_scene_terminal_on_event(void* context, SceneManagerEvent event) {
     SPI_TERM_CONTEXT_TO_APP(context);
 
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == FlipperSPITerminalEventReceivedData) {
-            terminal_view_append_data_from_stream(
-                app->terminal_screen.view, app->terminal_screen.rx_buffer_stream);
+            // Cleared before reading. Data, which is received from now on, sends a new event.
+            atomic_store(&app->terminal_screen.event_pending, false);
+
+            flipper_spi_terminal_scene_terminal_process(app);
+            flipper_spi_terminal_scene_terminal_write_record(app);
+            flipper_spi_terminal_scene_terminal_read_timestamps(app);
+            flipper_spi_terminal_scene_terminal_update_overlay(app);
+            return true;
+        } else if(event.event == FlipperSPITerminalEventTriggerChanged) {
+            flipper_spi_terminal_scene_terminal_install_trigger(app);
             return true;
         }
     }
@@ -230,9 +1241,20 @@ void flipper_spi_terminal_scene_terminal_on_exit(void* context) {
 
     app->terminal_screen.is_active = false;
 
-    flipper_spi_terminal_scene_terminal_deinit_spi_dma(app);
+    flipper_spi_terminal_sim_stop(app->terminal_screen.sim);
+
+    flipper_spi_terminal_scene_terminal_stop_capture(app);
 
-    furi_timer_stop(app->terminal_screen.recv_timer);
+    furi_thread_flags_set(
+        furi_thread_get_id(app->terminal_screen.notify_thread), SPI_TERM_NOTIFY_FLAG_STOP);
+    furi_thread_join(app->terminal_screen.notify_thread);
+
+    // The bus is released. Everything, which was received up to now, is still written.
+    if(app->terminal_screen.record != NULL) {
+        flipper_spi_terminal_scene_terminal_process(app);
+        flipper_spi_terminal_record_free(app->terminal_screen.record);
+        app->terminal_screen.record = NULL;
+    }
 
     free(app->terminal_screen.rx_dma_buffer);
     app->terminal_screen.rx_dma_buffer = NULL;
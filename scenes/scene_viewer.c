@@ -0,0 +1,185 @@
+#include "scenes.h"
+#include "../flipper_spi_terminal.h"
+
+#include <dialogs/dialogs.h>
+#include <toolbox/path.h>
+
+// 4 KiB of pages. One page covers many screens of every display mode.
+#define SPI_TERM_VIEWER_PAGE_SIZE  512
+#define SPI_TERM_VIEWER_PAGE_COUNT 8
+
+static size_t flipper_spi_terminal_scene_viewer_io_read(void* context, void* data, size_t length) {
+    return storage_file_read(context, data, length);
+}
+
+static bool flipper_spi_terminal_scene_viewer_io_seek(void* context, uint64_t offset) {
+    return offset <= UINT32_MAX && storage_file_seek(context, offset, true);
+}
+
+static uint64_t flipper_spi_terminal_scene_viewer_io_size(void* context) {
+    return storage_file_size(context);
+}
+
+static size_t flipper_spi_terminal_scene_viewer_page_read(
+    void* context,
+    uint64_t offset,
+    void* data,
+    size_t length) {
+    return capture_file_reader_read(context, offset, data, length);
+}
+
+// Asks for a capture file. Returns false, if none was selected.
+static bool flipper_spi_terminal_scene_viewer_select(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenViewer* viewer = &app->viewer_screen;
+
+    if(furi_string_empty(viewer->path)) {
+        furi_string_set_str(viewer->path, SPI_TERM_LAST_SETTINGS_DIR);
+    }
+
+    DialogsFileBrowserOptions options;
+    dialog_file_browser_set_basic_options(&options, SPI_TERM_RECORD_EXTENSION, NULL);
+    options.base_path = SPI_TERM_LAST_SETTINGS_DIR;
+
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    const bool selected = dialog_file_browser_show(dialogs, viewer->path, viewer->path, &options);
+    furi_record_close(RECORD_DIALOGS);
+
+    return selected;
+}
+
+static bool flipper_spi_terminal_scene_viewer_open(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenViewer* viewer = &app->viewer_screen;
+    const char* path = furi_string_get_cstr(viewer->path);
+
+    viewer->storage = furi_record_open(RECORD_STORAGE);
+    viewer->file = storage_file_alloc(viewer->storage);
+    if(storage_file_open(viewer->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        const CaptureFileIo io = {
+            .context = viewer->file,
+            .read = flipper_spi_terminal_scene_viewer_io_read,
+            .seek = flipper_spi_terminal_scene_viewer_io_seek,
+            .size = flipper_spi_terminal_scene_viewer_io_size,
+        };
+        viewer->reader = capture_file_reader_alloc(&io);
+    }
+
+    if(viewer->reader == NULL) {
+        SPI_TERM_LOG_E("Can not open %s", path);
+        storage_file_free(viewer->file);
+        viewer->file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        viewer->storage = NULL;
+        return false;
+    }
+
+    SPI_TERM_LOG_I("Viewing %s", path);
+    return true;
+}
+
+static void flipper_spi_terminal_scene_viewer_close(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenViewer* viewer = &app->viewer_screen;
+
+    if(viewer->reader == NULL) {
+        return;
+    }
+
+    terminal_view_set_pages(viewer->view, NULL);
+    SPI_TERM_LOG_D("Page cache: %lu hits, %lu misses", viewer->pages.hits, viewer->pages.misses);
+    page_cache_deinit(&viewer->pages);
+
+    capture_file_reader_free(viewer->reader);
+    viewer->reader = NULL;
+    storage_file_close(viewer->file);
+    storage_file_free(viewer->file);
+    viewer->file = NULL;
+    furi_record_close(RECORD_STORAGE);
+    viewer->storage = NULL;
+}
+
+static void flipper_spi_terminal_scene_viewer_show(FlipperSPITerminalApp* app) {
+    FlipperSPITerminalAppScreenViewer* viewer = &app->viewer_screen;
+    CaptureFileReader* reader = viewer->reader;
+    const CaptureFileHeader* header = capture_file_reader_get_header(reader);
+
+    page_cache_init(
+        &viewer->pages,
+        SPI_TERM_VIEWER_PAGE_SIZE,
+        SPI_TERM_VIEWER_PAGE_COUNT,
+        capture_file_reader_get_length(reader),
+        flipper_spi_terminal_scene_viewer_page_read,
+        reader);
+
+    terminal_view_set_display_mode(viewer->view, app->config.display_mode);
+    terminal_view_set_frame_size(viewer->view, header->frame_size == 2 ? 2 : 1);
+    terminal_view_set_pages(viewer->view, &viewer->pages);
+    terminal_view_scroll_to(viewer->view, 0);
+
+    FuriString* name = furi_string_alloc();
+    path_extract_filename(viewer->path, name, true);
+    char text[128];
+    snprintf(
+        text,
+        sizeof(text),
+        "%s\nBytes: %llu\nFrames: %llu\n%s",
+        furi_string_get_cstr(name),
+        capture_file_reader_get_length(reader),
+        capture_file_reader_get_frame_count(reader),
+        capture_file_reader_is_complete(reader) ? "Complete" : "Recovered");
+    terminal_view_set_overlay_text(viewer->view, text);
+    terminal_view_set_status(viewer->view, "");
+    furi_string_free(name);
+}
+
+void flipper_spi_terminal_scene_viewer_alloc(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    app->viewer_screen.view = terminal_view_alloc();
+    app->viewer_screen.path = furi_string_alloc();
+    app->viewer_screen.reader = NULL;
+
+    view_dispatcher_add_view(
+        app->view_dispatcher,
+        FlipperSPITerminalAppSceneViewer,
+        terminal_view_get_view(app->viewer_screen.view));
+}
+
+void flipper_spi_terminal_scene_viewer_free(FlipperSPITerminalApp* app) {
+    furi_check(app);
+
+    view_dispatcher_remove_view(app->view_dispatcher, FlipperSPITerminalAppSceneViewer);
+    terminal_view_free(app->viewer_screen.view);
+    furi_string_free(app->viewer_screen.path);
+}
+
+void flipper_spi_terminal_scene_viewer_on_enter(void* context) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+
+    if(!flipper_spi_terminal_scene_viewer_select(app)) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, FlipperSPITerminalEventViewerClosed);
+    } else if(flipper_spi_terminal_scene_viewer_open(app)) {
+        flipper_spi_terminal_scene_viewer_show(app);
+    } else {
+        terminal_view_set_status(app->viewer_screen.view, "Bad file");
+    }
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, FlipperSPITerminalAppSceneViewer);
+}
+
+bool flipper_spi_terminal_scene_viewer_on_event(void* context, SceneManagerEvent event) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+
+    if(event.type == SceneManagerEventTypeCustom &&
+       event.event == FlipperSPITerminalEventViewerClosed) {
+        scene_manager_previous_scene(app->scene_manager);
+        return true;
+    }
+
+    return false;
+}
+
+void flipper_spi_terminal_scene_viewer_on_exit(void* context) {
+    SPI_TERM_CONTEXT_TO_APP(context);
+
+    flipper_spi_terminal_scene_viewer_close(app);
+}
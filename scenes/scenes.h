@@ -42,3 +42,29 @@ extern const SceneManagerHandlers flipper_spi_terminal_scene_handlers;
 
 void flipper_spi_terminal_scenes_alloc(FlipperSPITerminalApp* app);
 void flipper_spi_terminal_scenes_free(FlipperSPITerminalApp* app);
+
+// Wakes the Terminal Screen after new data was received. Can be called from a ISR.
+void flipper_spi_terminal_scene_terminal_notify(FlipperSPITerminalApp* app);
+// Watches the RX DMA, until a partially filled half was delivered, e.g. after sending in master
+// mode. Can be called from a ISR.
+void flipper_spi_terminal_scene_terminal_watch(FlipperSPITerminalApp* app);
+// Delivers the partially filled half of the RX DMA buffer. Can be called from a ISR.
+void flipper_spi_terminal_scene_terminal_flush(FlipperSPITerminalApp* app);
+// Queues data for the capture like received data, e.g. debug data. Returns the number of queued
+// bytes, which is less than length, if the queue is full. Can be called from any thread, but not
+// from a ISR.
+size_t flipper_spi_terminal_scene_terminal_inject(
+    FlipperSPITerminalApp* app,
+    const void* data,
+    size_t length);
+// Runs sequence once on the SPI of the active Terminal Screen. Returns false, if the Terminal
+// Screen is not active or can not send.
+// Replaces the trigger of the capture. Takes the ownership of trigger. Can be called from any
+// thread.
+void flipper_spi_terminal_scene_terminal_set_trigger(
+    FlipperSPITerminalApp* app,
+    FlipperSPITerminalTrigger* trigger);
+bool flipper_spi_terminal_scene_terminal_run_sequence(
+    FlipperSPITerminalApp* app,
+    const FlipperSPITerminalSequence* sequence,
+    FlipperSPITerminalSequenceResult* result);
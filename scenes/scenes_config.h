@@ -6,4 +6,5 @@ ADD_SCENE(flipper_spi_terminal, main, Main)
 ADD_SCENE(flipper_spi_terminal, config, Config)
 ADD_SCENE(flipper_spi_terminal, config_help, ConfigHelp)
 ADD_SCENE(flipper_spi_terminal, terminal, Terminal)
+ADD_SCENE(flipper_spi_terminal, viewer, Viewer)
 ADD_SCENE(flipper_spi_terminal, about, About)
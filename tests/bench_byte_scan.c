@@ -0,0 +1,158 @@
+// Host benchmark of toolbox/byte_scan.c. Times both variants against plain byte loops on the same
+// idle bus data as `spi dbg_bench`: Everything is FF, except the last byte.
+//
+//   bench_byte_scan [passes]
+//
+// The SIMD variant runs USUB8 and SEL from host/include/arm_acle.h, its numbers only show the
+// number of steps. Use `spi dbg_bench` for the cycles on a Flipper Zero.
+
+#include <byte_scan.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// See byte_scan_simd.c
+size_t byte_scan_simd_find(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_find_not(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_count(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_match_length(const uint8_t* a, const uint8_t* b, size_t length);
+
+#define BENCH_SIZE        4096
+#define BENCH_PASSES      4096
+#define BENCH_COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    size_t (*find)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*find_not)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*count)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*match_length)(const uint8_t* a, const uint8_t* b, size_t length);
+} BenchByteScan;
+
+static size_t bench_loop_find(const uint8_t* data, size_t length, uint8_t value) {
+    size_t i = 0;
+    while(i < length && data[i] != value) {
+        i++;
+    }
+    return i;
+}
+
+static size_t bench_loop_find_not(const uint8_t* data, size_t length, uint8_t value) {
+    size_t i = 0;
+    while(i < length && data[i] == value) {
+        i++;
+    }
+    return i;
+}
+
+static size_t bench_loop_count(const uint8_t* data, size_t length, uint8_t value) {
+    size_t count = 0;
+    for(size_t i = 0; i < length; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+static size_t bench_loop_match_length(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    while(i < length && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+static const BenchByteScan bench_variants[] = {
+    {bench_loop_find, bench_loop_find_not, bench_loop_count, bench_loop_match_length},
+    {byte_scan_find, byte_scan_find_not, byte_scan_count, byte_scan_match_length},
+    {byte_scan_simd_find,
+     byte_scan_simd_find_not,
+     byte_scan_simd_count,
+     byte_scan_simd_match_length},
+};
+
+typedef enum {
+    BenchKernelFind,
+    BenchKernelFindNot,
+    BenchKernelCount,
+    BenchKernelMatchLength,
+
+    BenchKernelMax,
+} BenchKernel;
+
+static const char* const bench_kernel_names[] = {
+    [BenchKernelFind] = "Find",
+    [BenchKernelFindNot] = "Find not",
+    [BenchKernelCount] = "Count",
+    [BenchKernelMatchLength] = "Compare",
+};
+
+static uint64_t bench_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// The sum of the results keeps the calls from being dropped
+static volatile size_t bench_sink;
+
+// Nanoseconds per 100 bytes
+static uint32_t bench_run(
+    const BenchByteScan* variant,
+    BenchKernel kernel,
+    const uint8_t* a,
+    const uint8_t* b,
+    size_t passes) {
+    size_t sink = 0;
+    const uint64_t start = bench_time_ns();
+    for(size_t pass = 0; pass < passes; pass++) {
+        switch(kernel) {
+        case BenchKernelFind:
+            sink += variant->find(a, BENCH_SIZE, 0x00);
+            break;
+        case BenchKernelFindNot:
+            sink += variant->find_not(a, BENCH_SIZE, 0xFF);
+            break;
+        case BenchKernelCount:
+            sink += variant->count(a, BENCH_SIZE, 0xFF);
+            break;
+        case BenchKernelMatchLength:
+            sink += variant->match_length(a, b, BENCH_SIZE);
+            break;
+        case BenchKernelMax:
+            break;
+        }
+    }
+    const uint64_t elapsed = bench_time_ns() - start;
+    bench_sink += sink;
+
+    return elapsed * 100 / ((uint64_t)BENCH_SIZE * passes);
+}
+
+int main(int argc, char** argv) {
+    const size_t passes = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_PASSES;
+    if(passes == 0) {
+        fprintf(stderr, "usage: %s [passes]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t* a = malloc(BENCH_SIZE);
+    uint8_t* b = malloc(BENCH_SIZE);
+    memset(a, 0xFF, BENCH_SIZE);
+    memset(b, 0xFF, BENCH_SIZE);
+    a[BENCH_SIZE - 1] = 0x00;
+
+    printf("=== Byte scanning (ns per 100 bytes, loop/portable/simd) ===\n");
+    for(size_t kernel = 0; kernel < BenchKernelMax; kernel++) {
+        uint32_t results[BENCH_COUNT_OF(bench_variants)];
+        for(size_t i = 0; i < BENCH_COUNT_OF(bench_variants); i++) {
+            results[i] = bench_run(&bench_variants[i], kernel, a, b, passes);
+        }
+        printf(
+            "%s: %u/%u/%u\n", bench_kernel_names[kernel], results[0], results[1], results[2]);
+    }
+
+    free(b);
+    free(a);
+    return EXIT_SUCCESS;
+}
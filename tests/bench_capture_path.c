@@ -0,0 +1,170 @@
+// Host benchmark of the capture path. A bus thread clocks data into the simulated DMA engine at
+// every bus speed, while the test thread acts as the GUI thread and redraws the terminal view.
+// Runs every DMA RX Buffer size in every display mode.
+//
+//   bench_capture_path [ms per step]
+//
+// The numbers come from the host CPU. They compare changes of the capture path, use
+// `spi dbg_bench` for the numbers of a Flipper Zero.
+
+#include "test_app.h"
+
+#include <furi_hal_cortex.h>
+#include <stdio.h>
+
+// Same bus speeds as `spi dbg_bench`. The last one is the maximum slave speed of the STM32WB55.
+static const uint32_t bench_bit_rates[] = {
+    8000,
+    64000,
+    256000,
+    1000000,
+    4000000,
+    8000000,
+    16000000,
+    24000000,
+};
+
+#define BENCH_STEP_MS     100
+#define BENCH_BURST_SIZE  4096 // Most bytes per host_spi_receive, if the bus thread fell behind
+#define BENCH_DRAIN_MS    200
+#define BENCH_LINE_LENGTH 32
+
+typedef struct {
+    uint32_t bit_rate;
+    atomic_bool stop;
+    uint64_t generated;
+    uint64_t accepted; // Written to memory by the RX DMA
+} BenchBus;
+
+// Printable lines, so every display mode has something to render
+static void bench_fill_pattern(uint8_t* data, size_t length) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] = (i + 1) % BENCH_LINE_LENGTH == 0 ? '\n' : ' ' + i % ('~' - ' ');
+    }
+}
+
+static int32_t bench_bus_thread(void* context) {
+    BenchBus* bus = context;
+    static uint8_t data[BENCH_BURST_SIZE];
+    bench_fill_pattern(data, sizeof(data));
+
+    const uint64_t start = host_time_ns();
+    while(!atomic_load(&bus->stop)) {
+        const uint64_t due = (host_time_ns() - start) * bus->bit_rate / 8 / 1000000000ULL;
+        if(due <= bus->generated) {
+            furi_delay_us(50);
+            continue;
+        }
+
+        const size_t length = MIN(due - bus->generated, sizeof(data));
+        bus->accepted += host_spi_receive(data, length);
+        bus->generated += length;
+    }
+    return 0;
+}
+
+static void bench_print_histogram(const char* name, const LatencyHistogram* histogram) {
+    printf(
+        " %s p50/p90/p99/max: %lu/%lu/%lu/%lu",
+        name,
+        latency_histogram_percentile(histogram, 50),
+        latency_histogram_percentile(histogram, 90),
+        latency_histogram_percentile(histogram, 99),
+        histogram->max);
+}
+
+// Dispatches the custom events and redraws the view once per refresh interval, like the GUI
+// thread of the Flipper
+static void bench_run_gui(FlipperSPITerminalApp* app, Canvas* canvas, uint32_t duration_ms) {
+    View* view = terminal_view_get_view(app->terminal_screen.view);
+    const uint64_t refresh_ns = app->config.refresh_interval_ms * 1000000ULL;
+    const uint64_t end = host_time_ns() + duration_ms * 1000000ULL;
+    uint64_t next_draw = 0;
+    for(uint64_t now = host_time_ns(); now < end; now = host_time_ns()) {
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+        if(now >= next_draw) {
+            host_view_draw(view, canvas);
+            next_draw = now + refresh_ns;
+        }
+    }
+}
+
+static void bench_step(
+    FlipperSPITerminalApp* app,
+    Canvas* canvas,
+    const char* display_mode,
+    uint32_t bit_rate,
+    uint32_t step_ms) {
+    FlipperSPITerminalAppTerminalProfile* profile = &app->terminal_screen.profile;
+    latency_histogram_reset(&profile->rx);
+    latency_histogram_reset(&profile->append);
+    latency_histogram_reset(&profile->draw);
+    const uint32_t received = app->terminal_screen.stats.bytes_received;
+    const uint32_t dropped = app->terminal_screen.stats.bytes_dropped;
+    host_spi_reset_stats();
+
+    BenchBus bus = {.bit_rate = bit_rate};
+    atomic_init(&bus.stop, false);
+    FuriThread* thread = furi_thread_alloc_ex("BenchBus", 2048, bench_bus_thread, &bus);
+    profile->enabled = true;
+    const uint64_t start = host_time_ns();
+    furi_thread_start(thread);
+    bench_run_gui(app, canvas, step_ms);
+    atomic_store(&bus.stop, true);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    const uint64_t elapsed_ms = MAX((host_time_ns() - start) / 1000000ULL, 1ULL);
+
+    // The rest of the last half is delivered by the flush timer
+    bench_run_gui(app, canvas, BENCH_DRAIN_MS);
+    profile->enabled = false;
+
+    HostSpiStats spi;
+    host_spi_get_stats(&spi);
+    const uint32_t ring_dropped = app->terminal_screen.stats.bytes_dropped - dropped;
+    const uint32_t delivered = app->terminal_screen.stats.bytes_received - received;
+    printf(
+        "DMA %3zu B, %-6s @ %8lu bit/s: generated %lu B/s, sustained %lu B/s, dropped %lu B"
+        " (%lu by the DMA, %lu by rx_buffer_ring);",
+        app->config.rx_dma_buffer_size,
+        display_mode,
+        bit_rate,
+        (uint32_t)(bus.generated * 1000 / elapsed_ms),
+        (uint32_t)((delivered - ring_dropped) * 1000ULL / elapsed_ms),
+        (uint32_t)(spi.frames_lost + ring_dropped),
+        (uint32_t)spi.frames_lost,
+        ring_dropped);
+    bench_print_histogram("isr", &profile->rx);
+    bench_print_histogram("view", &profile->append);
+    bench_print_histogram("draw", &profile->draw);
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    const uint32_t step_ms = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_STEP_MS;
+    printf("=== Capture path (latencies in CPU cycles at %u Hz) ===\n", HOST_CPU_FREQUENCY);
+
+    Canvas* canvas = host_canvas_alloc();
+    for(size_t i = 0; i < COUNT_OF(spi_config_rx_dma_buffer_size_values); i++) {
+        for(size_t j = 0; j < COUNT_OF(spi_config_display_mode_values); j++) {
+            FlipperSPITerminalApp* app = test_app_alloc();
+            app->config.rx_dma_buffer_size = spi_config_rx_dma_buffer_size_values[i];
+            app->config.display_mode = spi_config_display_mode_values[j];
+            flipper_spi_terminal_scene_terminal_on_enter(app);
+            terminal_view_set_draw_profile(
+                app->terminal_screen.view, &app->terminal_screen.profile.draw);
+
+            for(size_t k = 0; k < COUNT_OF(bench_bit_rates); k++) {
+                bench_step(
+                    app, canvas, spi_config_display_mode_strings[j], bench_bit_rates[k], step_ms);
+            }
+
+            terminal_view_set_draw_profile(app->terminal_screen.view, NULL);
+            flipper_spi_terminal_scene_terminal_on_exit(app);
+            test_app_free(app);
+        }
+    }
+    host_canvas_free(canvas);
+
+    return EXIT_SUCCESS;
+}
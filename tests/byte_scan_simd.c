@@ -0,0 +1,11 @@
+// byte_scan.c as built for the Cortex-M4, with USUB8 and SEL from host/include/arm_acle.h. The
+// functions are renamed, so both variants can be linked into one test.
+
+#define __ARM_FEATURE_SIMD32 1
+
+#define byte_scan_find         byte_scan_simd_find
+#define byte_scan_find_not     byte_scan_simd_find_not
+#define byte_scan_count        byte_scan_simd_count
+#define byte_scan_match_length byte_scan_simd_match_length
+
+#include "../toolbox/byte_scan.c"
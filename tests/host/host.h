@@ -0,0 +1,79 @@
+#pragma once
+
+// Control side of the host harness. The app code only sees the furi and HAL stand-ins in
+// include/, tests drive them with these functions.
+//
+// Interrupts: There is a single simulated core. NVIC_SetPendingIRQ, a DMA event or a CS edge
+// marks the interrupt as pending. It runs on the thread, which raised it, as soon as no other
+// ISR and no FURI_CRITICAL section is active. Until then, every other thread, which raises an
+// interrupt or enters a critical section, blocks.
+
+#include <furi.h>
+#include <furi_hal_gpio.h>
+#include <gui/canvas.h>
+#include <gui/view.h>
+#include <gui/view_dispatcher.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Time
+
+// Nanoseconds since the start of the process, including skipped time
+uint64_t host_time_ns(void);
+// Moves the tick count and the cycle counter forward, e.g. to test counter wraps. Timers, which
+// become due, run immediately.
+void host_time_skip_ms(uint32_t milliseconds);
+
+// SPI bus and DMA engine
+
+typedef struct {
+    uint64_t frames_received; // Written to memory by the RX DMA
+    uint64_t frames_lost; // RX DMA disabled, stopped or not requested by the SPI
+    uint64_t frames_sent; // Read from memory by the TX DMA
+} HostSpiStats;
+
+// Returns the frame, the peer sends back for frame in master mode
+typedef uint16_t (*HostSpiPeerCallback)(void* context, uint16_t frame);
+
+// Slave mode: A master clocks in length bytes. Frames of more than 8 bit are taken as little
+// endian pairs. DMA interrupts run, as soon as their flag is set. Returns the number of bytes,
+// which were written to memory by the DMA.
+size_t host_spi_receive(const void* data, size_t length);
+// Master mode: Clocks up to frames frames out of the TX DMA. The answer of the peer is received
+// like in slave mode. Returns the number of sent frames, which is less if the TX DMA ran out.
+size_t host_spi_clock(size_t frames);
+// NULL loops MOSI back to MISO
+void host_spi_set_peer(HostSpiPeerCallback callback, void* context);
+void host_spi_get_stats(HostSpiStats* stats);
+void host_spi_reset_stats(void);
+
+// GPIO
+
+// Drives an input. Edges call the interrupt callback of the pin, if its EXTI line is enabled.
+void host_gpio_set(const GpioPin* gpio, bool level);
+
+// GUI
+
+Canvas* host_canvas_alloc(void);
+void host_canvas_free(Canvas* canvas);
+// Every string drawn since the last clear, one per line
+const char* host_canvas_get_text(const Canvas* canvas);
+// Clears the canvas and calls the draw callback of view
+void host_view_draw(View* view, Canvas* canvas);
+bool host_view_input(View* view, InputKey key, InputType type);
+// Runs the custom event callback for the next queued event. Returns false, if none was sent
+// within timeout.
+bool host_view_dispatcher_dispatch(ViewDispatcher* view_dispatcher, uint32_t timeout_ms);
+// Number of custom events, which were sent but not dispatched yet
+size_t host_view_dispatcher_get_pending(ViewDispatcher* view_dispatcher);
+
+// Storage
+
+// Directory, which replaces /ext. A new temporary directory per process.
+const char* host_storage_root(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,744 @@
+#define _GNU_SOURCE
+#include "host.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// All allocations stay in the main heap below 4 GiB. The app passes buffers to the DMA as 32 bit
+// addresses, like on the device.
+__attribute__((constructor)) static void host_furi_init_heap(void) {
+    mallopt(M_ARENA_MAX, 1);
+    mallopt(M_MMAP_MAX, 0);
+    void* probe = malloc(1);
+    furi_check((uintptr_t)probe <= UINT32_MAX);
+    free(probe);
+}
+
+_Noreturn void host_crash(const char* file, int line, const char* message) {
+    fprintf(stderr, "furi_check failed: %s:%d: %s\n", file, line, message);
+    fflush(stderr);
+    abort();
+}
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    static int max_level = -1;
+    if(max_level < 0) {
+        const char* env = getenv("HOST_LOG_LEVEL");
+        max_level = env != NULL ? atoi(env) : FuriLogLevelWarn;
+    }
+    if((int)level > max_level) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%s] ", tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// Time
+
+static atomic_uint_least64_t host_time_skipped_ns;
+
+static uint64_t host_time_real_ns(void) {
+    static uint64_t start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    if(start == 0) {
+        start = ns - 1;
+    }
+    return ns - start;
+}
+
+static void host_time_to_timespec(uint32_t milliseconds, struct timespec* deadline) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += milliseconds / 1000;
+    deadline->tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if(deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+static void host_cond_init(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Waits on cond, until the deadline passed. false on a timeout.
+static bool host_cond_wait(
+    pthread_cond_t* cond,
+    pthread_mutex_t* mutex,
+    uint32_t timeout,
+    const struct timespec* deadline) {
+    if(timeout == FuriWaitForever) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, deadline) != ETIMEDOUT;
+}
+
+uint64_t host_time_ns(void) {
+    return host_time_real_ns() + atomic_load(&host_time_skipped_ns);
+}
+
+static void host_timer_wake_daemon(void);
+
+void host_time_skip_ms(uint32_t milliseconds) {
+    atomic_fetch_add(&host_time_skipped_ns, (uint64_t)milliseconds * 1000000ULL);
+    host_timer_wake_daemon();
+}
+
+uint32_t furi_get_tick(void) {
+    return host_time_ns() / 1000000ULL;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+bool furi_kernel_is_irq_or_masked(void) {
+    return host_irq_is_active();
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    furi_delay_ms(ticks);
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    furi_check(!furi_kernel_is_irq_or_masked());
+    usleep(milliseconds * 1000);
+}
+
+void furi_delay_us(uint32_t microseconds) {
+    usleep(microseconds);
+}
+
+// Threads
+
+struct FuriThread {
+    char* name;
+    FuriThreadCallback callback;
+    void* context;
+    pthread_t pthread;
+    bool started;
+    atomic_bool running;
+    int32_t result;
+
+    pthread_mutex_t flags_mutex;
+    pthread_cond_t flags_cond;
+    uint32_t flags;
+};
+
+static _Thread_local FuriThread* host_thread_current;
+
+static FuriThread* host_thread_alloc(const char* name) {
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    thread->name = strdup(name);
+    pthread_mutex_init(&thread->flags_mutex, NULL);
+    host_cond_init(&thread->flags_cond);
+    return thread;
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    UNUSED(stack_size);
+    furi_check(callback);
+
+    FuriThread* thread = host_thread_alloc(name);
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_check(thread);
+    furi_check(!thread->started);
+
+    pthread_mutex_destroy(&thread->flags_mutex);
+    pthread_cond_destroy(&thread->flags_cond);
+    free(thread->name);
+    free(thread);
+}
+
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority) {
+    UNUSED(thread);
+    UNUSED(priority);
+}
+
+static void* host_thread_body(void* context) {
+    FuriThread* thread = context;
+    host_thread_current = thread;
+    pthread_setname_np(pthread_self(), thread->name);
+
+    thread->result = thread->callback(thread->context);
+
+    atomic_store(&thread->running, false);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    furi_check(thread);
+    furi_check(!thread->started);
+
+    // A new task starts without notifications
+    thread->flags = 0;
+    thread->started = true;
+    atomic_store(&thread->running, true);
+    furi_check(pthread_create(&thread->pthread, NULL, host_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    furi_check(thread);
+    furi_check(thread->started);
+    furi_check(thread != host_thread_current);
+
+    pthread_join(thread->pthread, NULL);
+    thread->started = false;
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    furi_check(thread);
+    return atomic_load(&thread->running) ? thread : NULL;
+}
+
+FuriThreadId furi_thread_get_current_id(void) {
+    // Threads, which were not started by furi, e.g. the one running main
+    if(host_thread_current == NULL) {
+        host_thread_current = host_thread_alloc("host");
+        atomic_store(&host_thread_current->running, true);
+    }
+    return host_thread_current;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    FuriThread* thread = thread_id;
+    if(thread == NULL || (flags & FuriFlagError)) {
+        return FuriFlagErrorParameter;
+    }
+
+    pthread_mutex_lock(&thread->flags_mutex);
+    thread->flags |= flags;
+    const uint32_t result = thread->flags;
+    pthread_cond_broadcast(&thread->flags_cond);
+    pthread_mutex_unlock(&thread->flags_mutex);
+
+    return result;
+}
+
+uint32_t furi_thread_flags_clear(uint32_t flags) {
+    FuriThread* thread = furi_thread_get_current_id();
+
+    pthread_mutex_lock(&thread->flags_mutex);
+    const uint32_t result = thread->flags;
+    thread->flags &= ~flags;
+    pthread_mutex_unlock(&thread->flags_mutex);
+
+    return result;
+}
+
+uint32_t furi_thread_flags_get(void) {
+    FuriThread* thread = furi_thread_get_current_id();
+
+    pthread_mutex_lock(&thread->flags_mutex);
+    const uint32_t result = thread->flags;
+    pthread_mutex_unlock(&thread->flags_mutex);
+
+    return result;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    furi_check(!furi_kernel_is_irq_or_masked());
+    FuriThread* thread = furi_thread_get_current_id();
+
+    struct timespec deadline;
+    host_time_to_timespec(timeout, &deadline);
+
+    pthread_mutex_lock(&thread->flags_mutex);
+    uint32_t result;
+    while(true) {
+        const uint32_t matched = thread->flags & flags;
+        const bool done = (options & FuriFlagWaitAll) ? matched == flags : matched != 0;
+        if(done) {
+            result = thread->flags;
+            if(!(options & FuriFlagNoClear)) {
+                thread->flags &= ~flags;
+            }
+            break;
+        }
+        if(timeout == 0) {
+            result = FuriFlagErrorResource;
+            break;
+        }
+        if(!host_cond_wait(&thread->flags_cond, &thread->flags_mutex, timeout, &deadline)) {
+            result = FuriFlagErrorTimeout;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&thread->flags_mutex);
+
+    return result;
+}
+
+// Timers
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    void* context;
+    FuriTimerType type;
+    uint32_t period;
+    uint32_t due; // Tick
+    bool active;
+    FuriTimer* next;
+};
+
+static pthread_mutex_t host_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_timer_cond;
+static pthread_t host_timer_daemon;
+static bool host_timer_daemon_started;
+static FuriTimer* host_timer_list;
+static FuriTimer* host_timer_running; // Callback in progress
+
+static void* host_timer_daemon_body(void* context) {
+    UNUSED(context);
+    pthread_setname_np(pthread_self(), "HostTimers");
+    host_thread_current = host_thread_alloc("HostTimers");
+    atomic_store(&host_thread_current->running, true);
+
+    pthread_mutex_lock(&host_timer_mutex);
+    while(true) {
+        const uint32_t now = furi_get_tick();
+        FuriTimer* next = NULL;
+        for(FuriTimer* timer = host_timer_list; timer != NULL; timer = timer->next) {
+            if(timer->active &&
+               (next == NULL || (int32_t)(timer->due - next->due) < 0)) {
+                next = timer;
+            }
+        }
+
+        if(next == NULL) {
+            pthread_cond_wait(&host_timer_cond, &host_timer_mutex);
+            continue;
+        }
+        if((int32_t)(next->due - now) > 0) {
+            struct timespec deadline;
+            host_time_to_timespec(next->due - now, &deadline);
+            pthread_cond_timedwait(&host_timer_cond, &host_timer_mutex, &deadline);
+            continue;
+        }
+
+        if(next->type == FuriTimerTypePeriodic) {
+            next->due += next->period;
+            // Missed periods are skipped, like the FreeRTOS timer task does after a long stall
+            if((int32_t)(now - next->due) > 0) {
+                next->due = now + next->period;
+            }
+        } else {
+            next->active = false;
+        }
+
+        host_timer_running = next;
+        pthread_mutex_unlock(&host_timer_mutex);
+        next->callback(next->context);
+        pthread_mutex_lock(&host_timer_mutex);
+        host_timer_running = NULL;
+        pthread_cond_broadcast(&host_timer_cond);
+    }
+
+    return NULL;
+}
+
+static void host_timer_wake_daemon(void) {
+    pthread_mutex_lock(&host_timer_mutex);
+    pthread_cond_broadcast(&host_timer_cond);
+    pthread_mutex_unlock(&host_timer_mutex);
+}
+
+// Waits for the callback of timer, unless this is the daemon itself
+static void host_timer_wait_callback(FuriTimer* timer) {
+    if(pthread_equal(pthread_self(), host_timer_daemon)) {
+        return;
+    }
+    while(host_timer_running == timer) {
+        pthread_cond_wait(&host_timer_cond, &host_timer_mutex);
+    }
+}
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void* context) {
+    furi_check(callback);
+    furi_check(!furi_kernel_is_irq_or_masked());
+
+    FuriTimer* timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = callback;
+    timer->context = context;
+    timer->type = type;
+
+    pthread_mutex_lock(&host_timer_mutex);
+    if(!host_timer_daemon_started) {
+        host_cond_init(&host_timer_cond);
+        furi_check(pthread_create(&host_timer_daemon, NULL, host_timer_daemon_body, NULL) == 0);
+        host_timer_daemon_started = true;
+    }
+    timer->next = host_timer_list;
+    host_timer_list = timer;
+    pthread_mutex_unlock(&host_timer_mutex);
+
+    return timer;
+}
+
+void furi_timer_free(FuriTimer* timer) {
+    furi_check(timer);
+    furi_check(!furi_kernel_is_irq_or_masked());
+
+    pthread_mutex_lock(&host_timer_mutex);
+    timer->active = false;
+    host_timer_wait_callback(timer);
+    for(FuriTimer** link = &host_timer_list; *link != NULL; link = &(*link)->next) {
+        if(*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_timer_mutex);
+
+    free(timer);
+}
+
+FuriStatus furi_timer_start(FuriTimer* timer, uint32_t ticks) {
+    furi_check(timer);
+    // Like on the device, the timer task is only reachable from threads
+    furi_check(!furi_kernel_is_irq_or_masked());
+    furi_check(ticks > 0);
+
+    pthread_mutex_lock(&host_timer_mutex);
+    timer->period = ticks;
+    timer->due = furi_get_tick() + ticks;
+    timer->active = true;
+    pthread_cond_broadcast(&host_timer_cond);
+    pthread_mutex_unlock(&host_timer_mutex);
+
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* timer) {
+    furi_check(timer);
+    furi_check(!furi_kernel_is_irq_or_masked());
+
+    pthread_mutex_lock(&host_timer_mutex);
+    timer->active = false;
+    host_timer_wait_callback(timer);
+    pthread_mutex_unlock(&host_timer_mutex);
+
+    return FuriStatusOk;
+}
+
+bool furi_timer_is_running(FuriTimer* timer) {
+    furi_check(timer);
+
+    pthread_mutex_lock(&host_timer_mutex);
+    const bool active = timer->active;
+    pthread_mutex_unlock(&host_timer_mutex);
+
+    return active;
+}
+
+// Mutex
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(
+        &attr,
+        type == FuriMutexTypeRecursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(&mutex->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    furi_check(mutex);
+    furi_check(pthread_mutex_destroy(&mutex->mutex) == 0);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    furi_check(mutex);
+    furi_check(!furi_kernel_is_irq_or_masked());
+
+    int result;
+    if(timeout == FuriWaitForever) {
+        result = pthread_mutex_lock(&mutex->mutex);
+    } else if(timeout == 0) {
+        result = pthread_mutex_trylock(&mutex->mutex);
+    } else {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        result = pthread_mutex_timedlock(&mutex->mutex, &deadline);
+    }
+    // A normal mutex may not be taken twice by the same thread
+    furi_check(result != EDEADLK);
+
+    return result == 0 ? FuriStatusOk : FuriStatusErrorTimeout;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    furi_check(mutex);
+    return pthread_mutex_unlock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusErrorResource;
+}
+
+// Semaphore
+
+struct FuriSemaphore {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t max_count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    furi_check(max_count > 0 && initial_count <= max_count);
+
+    FuriSemaphore* semaphore = malloc(sizeof(FuriSemaphore));
+    pthread_mutex_init(&semaphore->mutex, NULL);
+    host_cond_init(&semaphore->cond);
+    semaphore->count = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+void furi_semaphore_free(FuriSemaphore* semaphore) {
+    furi_check(semaphore);
+    pthread_mutex_destroy(&semaphore->mutex);
+    pthread_cond_destroy(&semaphore->cond);
+    free(semaphore);
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, uint32_t timeout) {
+    furi_check(semaphore);
+
+    struct timespec deadline;
+    host_time_to_timespec(timeout, &deadline);
+
+    FuriStatus status = FuriStatusOk;
+    pthread_mutex_lock(&semaphore->mutex);
+    while(semaphore->count == 0) {
+        if(timeout == 0 ||
+           !host_cond_wait(&semaphore->cond, &semaphore->mutex, timeout, &deadline)) {
+            status = FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        semaphore->count--;
+    }
+    pthread_mutex_unlock(&semaphore->mutex);
+
+    return status;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* semaphore) {
+    furi_check(semaphore);
+
+    FuriStatus status = FuriStatusOk;
+    pthread_mutex_lock(&semaphore->mutex);
+    if(semaphore->count < semaphore->max_count) {
+        semaphore->count++;
+        pthread_cond_broadcast(&semaphore->cond);
+    } else {
+        status = FuriStatusErrorResource;
+    }
+    pthread_mutex_unlock(&semaphore->mutex);
+
+    return status;
+}
+
+// Stream buffer
+
+struct FuriStreamBuffer {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t* data;
+    size_t size;
+    size_t trigger_level;
+    size_t head; // Total number of sent bytes
+    size_t tail; // Total number of received bytes
+};
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    furi_check(size > 0);
+
+    FuriStreamBuffer* stream_buffer = calloc(1, sizeof(FuriStreamBuffer));
+    pthread_mutex_init(&stream_buffer->mutex, NULL);
+    host_cond_init(&stream_buffer->cond);
+    stream_buffer->data = malloc(size);
+    stream_buffer->size = size;
+    stream_buffer->trigger_level = MAX(trigger_level, 1U);
+    return stream_buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer) {
+    furi_check(stream_buffer);
+    pthread_mutex_destroy(&stream_buffer->mutex);
+    pthread_cond_destroy(&stream_buffer->cond);
+    free(stream_buffer->data);
+    free(stream_buffer);
+}
+
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    furi_check(stream_buffer);
+    if(furi_kernel_is_irq_or_masked()) {
+        timeout = 0;
+    }
+
+    struct timespec deadline;
+    host_time_to_timespec(timeout, &deadline);
+
+    const uint8_t* src = data;
+    size_t sent = 0;
+    pthread_mutex_lock(&stream_buffer->mutex);
+    while(sent < length) {
+        const size_t free_space =
+            stream_buffer->size - (stream_buffer->head - stream_buffer->tail);
+        if(free_space == 0) {
+            if(timeout == 0) {
+                break;
+            }
+            if(!host_cond_wait(&stream_buffer->cond, &stream_buffer->mutex, timeout, &deadline)) {
+                break;
+            }
+            continue;
+        }
+        const size_t part = MIN(length - sent, free_space);
+        for(size_t i = 0; i < part; i++) {
+            stream_buffer->data[(stream_buffer->head + i) % stream_buffer->size] = src[sent + i];
+        }
+        stream_buffer->head += part;
+        sent += part;
+        pthread_cond_broadcast(&stream_buffer->cond);
+    }
+    pthread_mutex_unlock(&stream_buffer->mutex);
+
+    return sent;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    furi_check(stream_buffer);
+
+    struct timespec deadline;
+    host_time_to_timespec(timeout, &deadline);
+
+    uint8_t* dst = data;
+    pthread_mutex_lock(&stream_buffer->mutex);
+    // Wakes up at the trigger level or with everything, which is there on a timeout
+    while(stream_buffer->head - stream_buffer->tail < MIN(stream_buffer->trigger_level, length)) {
+        if(timeout == 0 ||
+           !host_cond_wait(&stream_buffer->cond, &stream_buffer->mutex, timeout, &deadline)) {
+            break;
+        }
+    }
+    const size_t received = MIN(length, stream_buffer->head - stream_buffer->tail);
+    for(size_t i = 0; i < received; i++) {
+        dst[i] = stream_buffer->data[(stream_buffer->tail + i) % stream_buffer->size];
+    }
+    stream_buffer->tail += received;
+    pthread_cond_broadcast(&stream_buffer->cond);
+    pthread_mutex_unlock(&stream_buffer->mutex);
+
+    return received;
+}
+
+size_t furi_stream_buffer_bytes_available(FuriStreamBuffer* stream_buffer) {
+    furi_check(stream_buffer);
+    pthread_mutex_lock(&stream_buffer->mutex);
+    const size_t available = stream_buffer->head - stream_buffer->tail;
+    pthread_mutex_unlock(&stream_buffer->mutex);
+    return available;
+}
+
+size_t furi_stream_buffer_spaces_available(FuriStreamBuffer* stream_buffer) {
+    return stream_buffer->size - furi_stream_buffer_bytes_available(stream_buffer);
+}
+
+bool furi_stream_buffer_is_empty(FuriStreamBuffer* stream_buffer) {
+    return furi_stream_buffer_bytes_available(stream_buffer) == 0;
+}
+
+FuriStatus furi_stream_buffer_reset(FuriStreamBuffer* stream_buffer) {
+    furi_check(stream_buffer);
+    pthread_mutex_lock(&stream_buffer->mutex);
+    stream_buffer->head = 0;
+    stream_buffer->tail = 0;
+    pthread_cond_broadcast(&stream_buffer->cond);
+    pthread_mutex_unlock(&stream_buffer->mutex);
+    return FuriStatusOk;
+}
+
+// Records. Services are only handles, their state lives in the stand-ins.
+
+void* furi_record_open(const char* name) {
+    furi_check(name);
+    return (void*)name;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// Memory
+
+// Heap of a Flipper Zero with a running GUI, CLI and this app
+#define HOST_FREE_HEAP (96 * 1024)
+
+size_t memmgr_get_free_heap(void) {
+    return HOST_FREE_HEAP;
+}
+
+size_t memmgr_heap_get_max_free_block(void) {
+    return HOST_FREE_HEAP;
+}
+
+void* aligned_malloc(size_t size, size_t alignment) {
+    void* pointer = NULL;
+    furi_check(posix_memalign(&pointer, MAX(alignment, sizeof(void*)), size) == 0);
+    return pointer;
+}
+
+void aligned_free(void* pointer) {
+    free(pointer);
+}
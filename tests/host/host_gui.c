@@ -0,0 +1,421 @@
+#include "host.h"
+
+#include <gui/elements.h>
+
+#include <pthread.h>
+#include <time.h>
+
+// Canvas
+
+#define HOST_CANVAS_WIDTH       128
+#define HOST_CANVAS_HEIGHT      64
+#define HOST_CANVAS_FONT_HEIGHT 8
+#define HOST_CANVAS_FONT_WIDTH  6
+
+struct Canvas {
+    FuriString* text;
+};
+
+Canvas* host_canvas_alloc(void) {
+    Canvas* canvas = malloc(sizeof(Canvas));
+    canvas->text = furi_string_alloc();
+    return canvas;
+}
+
+void host_canvas_free(Canvas* canvas) {
+    furi_check(canvas);
+    furi_string_free(canvas->text);
+    free(canvas);
+}
+
+const char* host_canvas_get_text(const Canvas* canvas) {
+    furi_check(canvas);
+    return furi_string_get_cstr(canvas->text);
+}
+
+size_t canvas_width(const Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_CANVAS_WIDTH;
+}
+
+size_t canvas_height(const Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_CANVAS_HEIGHT;
+}
+
+size_t canvas_current_font_height(const Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_CANVAS_FONT_HEIGHT;
+}
+
+size_t canvas_current_font_width(const Canvas* canvas) {
+    UNUSED(canvas);
+    return HOST_CANVAS_FONT_WIDTH;
+}
+
+void canvas_clear(Canvas* canvas) {
+    furi_check(canvas);
+    furi_string_reset(canvas->text);
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(canvas);
+    UNUSED(color);
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    furi_check(font < FontTotalNumber);
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    UNUSED(x);
+    UNUSED(y);
+    furi_check(canvas);
+    furi_string_cat_printf(canvas->text, "%s\n", str);
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    canvas_draw_str(canvas, x, y, str);
+}
+
+uint16_t canvas_string_width(Canvas* canvas, const char* str) {
+    UNUSED(canvas);
+    return strlen(str) * HOST_CANVAS_FONT_WIDTH;
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    canvas_draw_box(canvas, x, y, width, height);
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    UNUSED(canvas);
+    UNUSED(x1);
+    UNUSED(y1);
+    UNUSED(x2);
+    UNUSED(y2);
+}
+
+void canvas_draw_rbox(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height,
+    size_t radius) {
+    UNUSED(radius);
+    canvas_draw_box(canvas, x, y, width, height);
+}
+
+void canvas_draw_rframe(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height,
+    size_t radius) {
+    UNUSED(radius);
+    canvas_draw_box(canvas, x, y, width, height);
+}
+
+void elements_scrollbar(Canvas* canvas, size_t pos, size_t total) {
+    UNUSED(canvas);
+    furi_check(total == 0 || pos < total);
+}
+
+void elements_slightly_rounded_frame(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height) {
+    canvas_draw_box(canvas, x, y, width, height);
+}
+
+void elements_slightly_rounded_box(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height) {
+    canvas_draw_box(canvas, x, y, width, height);
+}
+
+// View
+
+struct View {
+    ViewDrawCallback draw_callback;
+    ViewInputCallback input_callback;
+    void* context;
+    ViewModelType model_type;
+    void* model;
+    FuriMutex* model_mutex;
+};
+
+View* view_alloc(void) {
+    View* view = calloc(1, sizeof(View));
+    furi_check(view);
+    return view;
+}
+
+void view_free(View* view) {
+    furi_check(view);
+    view_free_model(view);
+    free(view);
+}
+
+void view_set_context(View* view, void* context) {
+    furi_check(view);
+    view->context = context;
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    furi_check(view);
+    view->draw_callback = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    furi_check(view);
+    view->input_callback = callback;
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    furi_check(view);
+    furi_check(view->model_type == ViewModelTypeNone);
+    view->model_type = type;
+    view->model = calloc(1, size);
+    furi_check(view->model);
+    if(type == ViewModelTypeLocking) {
+        view->model_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    }
+}
+
+void view_free_model(View* view) {
+    furi_check(view);
+    if(view->model_mutex != NULL) {
+        furi_mutex_free(view->model_mutex);
+        view->model_mutex = NULL;
+    }
+    free(view->model);
+    view->model = NULL;
+    view->model_type = ViewModelTypeNone;
+}
+
+void* view_get_model(View* view) {
+    furi_check(view);
+    if(view->model_mutex != NULL) {
+        furi_check(furi_mutex_acquire(view->model_mutex, FuriWaitForever) == FuriStatusOk);
+    }
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    UNUSED(update);
+    furi_check(view);
+    if(view->model_mutex != NULL) {
+        furi_check(furi_mutex_release(view->model_mutex) == FuriStatusOk);
+    }
+}
+
+void host_view_draw(View* view, Canvas* canvas) {
+    furi_check(view);
+    canvas_clear(canvas);
+    if(view->draw_callback == NULL) {
+        return;
+    }
+
+    void* model = view_get_model(view);
+    view->draw_callback(canvas, model);
+    view_commit_model(view, false);
+}
+
+bool host_view_input(View* view, InputKey key, InputType type) {
+    furi_check(view);
+    if(view->input_callback == NULL) {
+        return false;
+    }
+
+    static uint32_t sequence;
+    InputEvent event = {.sequence = ++sequence, .key = key, .type = type};
+    return view->input_callback(&event, view->context);
+}
+
+// View dispatcher
+
+#define HOST_VIEW_DISPATCHER_VIEWS  16
+#define HOST_VIEW_DISPATCHER_EVENTS 64
+
+struct ViewDispatcher {
+    View* views[HOST_VIEW_DISPATCHER_VIEWS];
+    uint32_t current_view;
+
+    void* context;
+    ViewDispatcherCustomEventCallback custom_event_callback;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t events[HOST_VIEW_DISPATCHER_EVENTS];
+    size_t event_head;
+    size_t event_count;
+};
+
+ViewDispatcher* view_dispatcher_alloc(void) {
+    ViewDispatcher* view_dispatcher = calloc(1, sizeof(ViewDispatcher));
+    furi_check(view_dispatcher);
+    view_dispatcher->current_view = UINT32_MAX;
+
+    pthread_mutex_init(&view_dispatcher->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&view_dispatcher->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    return view_dispatcher;
+}
+
+void view_dispatcher_free(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    for(size_t i = 0; i < HOST_VIEW_DISPATCHER_VIEWS; i++) {
+        // Like the firmware: Every view has to be removed first
+        furi_check(view_dispatcher->views[i] == NULL);
+    }
+    pthread_cond_destroy(&view_dispatcher->cond);
+    pthread_mutex_destroy(&view_dispatcher->mutex);
+    free(view_dispatcher);
+}
+
+void view_dispatcher_set_event_callback_context(ViewDispatcher* view_dispatcher, void* context) {
+    furi_check(view_dispatcher);
+    view_dispatcher->context = context;
+}
+
+void view_dispatcher_set_custom_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherCustomEventCallback callback) {
+    furi_check(view_dispatcher);
+    view_dispatcher->custom_event_callback = callback;
+}
+
+void view_dispatcher_set_navigation_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherNavigationEventCallback callback) {
+    furi_check(view_dispatcher);
+    UNUSED(callback);
+}
+
+void view_dispatcher_set_tick_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherTickEventCallback callback,
+    uint32_t tick_period) {
+    furi_check(view_dispatcher);
+    UNUSED(callback);
+    UNUSED(tick_period);
+}
+
+void view_dispatcher_attach_to_gui(
+    ViewDispatcher* view_dispatcher,
+    Gui* gui,
+    ViewDispatcherType type) {
+    furi_check(view_dispatcher);
+    UNUSED(gui);
+    UNUSED(type);
+}
+
+void view_dispatcher_add_view(ViewDispatcher* view_dispatcher, uint32_t view_id, View* view) {
+    furi_check(view_dispatcher);
+    furi_check(view_id < HOST_VIEW_DISPATCHER_VIEWS);
+    furi_check(view_dispatcher->views[view_id] == NULL);
+    view_dispatcher->views[view_id] = view;
+}
+
+void view_dispatcher_remove_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    furi_check(view_dispatcher);
+    furi_check(view_id < HOST_VIEW_DISPATCHER_VIEWS);
+    furi_check(view_dispatcher->views[view_id] != NULL);
+    view_dispatcher->views[view_id] = NULL;
+    if(view_dispatcher->current_view == view_id) {
+        view_dispatcher->current_view = UINT32_MAX;
+    }
+}
+
+void view_dispatcher_switch_to_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    furi_check(view_dispatcher);
+    furi_check(view_id < HOST_VIEW_DISPATCHER_VIEWS);
+    furi_check(view_dispatcher->views[view_id] != NULL);
+    view_dispatcher->current_view = view_id;
+}
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event) {
+    furi_check(view_dispatcher);
+    // The firmware uses a message queue, which must not be used from an ISR either
+    furi_check(!host_irq_is_active());
+
+    pthread_mutex_lock(&view_dispatcher->mutex);
+    furi_check(view_dispatcher->event_count < HOST_VIEW_DISPATCHER_EVENTS);
+    const size_t index =
+        (view_dispatcher->event_head + view_dispatcher->event_count) % HOST_VIEW_DISPATCHER_EVENTS;
+    view_dispatcher->events[index] = event;
+    view_dispatcher->event_count++;
+    pthread_cond_signal(&view_dispatcher->cond);
+    pthread_mutex_unlock(&view_dispatcher->mutex);
+}
+
+bool host_view_dispatcher_dispatch(ViewDispatcher* view_dispatcher, uint32_t timeout_ms) {
+    furi_check(view_dispatcher);
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&view_dispatcher->mutex);
+    while(view_dispatcher->event_count == 0) {
+        if(pthread_cond_timedwait(&view_dispatcher->cond, &view_dispatcher->mutex, &deadline) !=
+           0) {
+            break;
+        }
+    }
+    const bool received = view_dispatcher->event_count > 0;
+    uint32_t event = 0;
+    if(received) {
+        event = view_dispatcher->events[view_dispatcher->event_head];
+        view_dispatcher->event_head = (view_dispatcher->event_head + 1) %
+                                      HOST_VIEW_DISPATCHER_EVENTS;
+        view_dispatcher->event_count--;
+    }
+    pthread_mutex_unlock(&view_dispatcher->mutex);
+
+    if(received && view_dispatcher->custom_event_callback != NULL) {
+        view_dispatcher->custom_event_callback(view_dispatcher->context, event);
+    }
+    return received;
+}
+
+size_t host_view_dispatcher_get_pending(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    pthread_mutex_lock(&view_dispatcher->mutex);
+    const size_t count = view_dispatcher->event_count;
+    pthread_mutex_unlock(&view_dispatcher->mutex);
+    return count;
+}
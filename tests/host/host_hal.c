@@ -0,0 +1,653 @@
+#define _GNU_SOURCE
+#include "host.h"
+
+#include <furi_hal.h>
+#include <stm32wbxx_ll_dma.h>
+#include <stm32wbxx_ll_exti.h>
+#include <stm32wbxx_ll_spi.h>
+#include <stm32wbxx_ll_system.h>
+
+#include <pthread.h>
+
+_Thread_local uint32_t host_acle_ge;
+
+// Interrupts
+
+typedef enum {
+    HostIrqDma2Ch6,
+    HostIrqDma2Ch7,
+    HostIrqExti4,
+
+    HostIrqCount,
+} HostIrq;
+
+typedef struct {
+    void (*isr)(void* context);
+    void* context;
+} HostIrqHandler;
+
+static pthread_mutex_t host_irq_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+// Critical sections and ISRs of the calling thread. Interrupts only run at 0.
+static _Thread_local uint32_t host_irq_depth;
+static uint32_t host_irq_pending;
+static HostIrqHandler host_irq_handlers[HostIrqCount];
+
+static void host_irq_run_pending(void) {
+    while(host_irq_pending != 0) {
+        const HostIrq irq = __builtin_ctz(host_irq_pending);
+        host_irq_pending &= ~(1U << irq);
+
+        const HostIrqHandler handler = host_irq_handlers[irq];
+        if(handler.isr != NULL) {
+            host_irq_depth++;
+            handler.isr(handler.context);
+            host_irq_depth--;
+        }
+    }
+}
+
+void host_irq_lock(void) {
+    pthread_mutex_lock(&host_irq_mutex);
+    host_irq_depth++;
+}
+
+void host_irq_unlock(void) {
+    furi_check(host_irq_depth > 0);
+    if(--host_irq_depth == 0) {
+        host_irq_run_pending();
+    }
+    pthread_mutex_unlock(&host_irq_mutex);
+}
+
+bool host_irq_is_active(void) {
+    return host_irq_depth > 0;
+}
+
+// Caller holds the lock. Runs, once the lock is released.
+static void host_irq_pend(HostIrq irq) {
+    host_irq_pending |= 1U << irq;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq) {
+    host_irq_lock();
+    switch(irq) {
+    case DMA2_Channel6_IRQn:
+        host_irq_pend(HostIrqDma2Ch6);
+        break;
+    case DMA2_Channel7_IRQn:
+        host_irq_pend(HostIrqDma2Ch7);
+        break;
+    case EXTI4_IRQn:
+        host_irq_pend(HostIrqExti4);
+        break;
+    }
+    host_irq_unlock();
+}
+
+void furi_hal_interrupt_set_isr(FuriHalInterruptId index, FuriHalInterruptISR isr, void* context) {
+    furi_check(index < FuriHalInterruptIdMax);
+
+    host_irq_lock();
+    const HostIrq irq = index == FuriHalInterruptIdDma2Ch6 ? HostIrqDma2Ch6 : HostIrqDma2Ch7;
+    // Like furi_hal_interrupt: Set only once, cleared with NULL
+    furi_check(isr == NULL || host_irq_handlers[irq].isr == NULL);
+    host_irq_handlers[irq] = (HostIrqHandler){.isr = isr, .context = context};
+    host_irq_pending &= ~(1U << irq);
+    host_irq_unlock();
+}
+
+// Core
+
+DWT_Type* host_dwt(void) {
+    static _Thread_local DWT_Type dwt;
+    dwt.CYCCNT = host_time_ns() * (HOST_CPU_FREQUENCY / 1000000U) / 1000U;
+    return &dwt;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return HOST_CPU_FREQUENCY / 1000000U;
+}
+
+void furi_hal_cortex_delay_us(uint32_t microseconds) {
+    const uint64_t end = host_time_ns() + microseconds * 1000ULL;
+    while(host_time_ns() < end) {
+    }
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    return (FuriHalCortexTimer){
+        .start = DWT->CYCCNT,
+        .value = timeout_us * furi_hal_cortex_instructions_per_microsecond(),
+    };
+}
+
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer) {
+    return DWT->CYCCNT - cortex_timer.start >= cortex_timer.value;
+}
+
+void furi_hal_bus_reset(FuriHalBus bus) {
+    UNUSED(bus);
+}
+
+// GPIO and EXTI. Only PA4 (CS) has a EXTI line, the other pins are plain inputs and outputs.
+
+typedef struct {
+    const GpioPin* pin;
+    bool level;
+    GpioExtiCallback callback;
+    void* context;
+} HostGpio;
+
+const GpioPin gpio_ext_pa4 = {.port = NULL, .pin = 1 << 4};
+const GpioPin gpio_ext_pa6 = {.port = NULL, .pin = 1 << 6};
+const GpioPin gpio_ext_pa7 = {.port = NULL, .pin = 1 << 7};
+const GpioPin gpio_ext_pb3 = {.port = NULL, .pin = 1 << 3};
+
+static HostGpio host_gpios[] = {
+    {.pin = &gpio_ext_pa4, .level = true},
+    {.pin = &gpio_ext_pa6, .level = true},
+    {.pin = &gpio_ext_pa7, .level = true},
+    {.pin = &gpio_ext_pb3, .level = true},
+};
+
+static uint32_t host_exti_it;
+static uint32_t host_exti_rising;
+static uint32_t host_exti_falling;
+
+static HostGpio* host_gpio_get(const GpioPin* pin) {
+    for(size_t i = 0; i < COUNT_OF(host_gpios); i++) {
+        if(host_gpios[i].pin == pin) {
+            return &host_gpios[i];
+        }
+    }
+    furi_crash("Unknown pin");
+}
+
+static void host_exti_isr(void* context) {
+    HostGpio* gpio = context;
+    if(gpio->callback != NULL) {
+        gpio->callback(gpio->context);
+    }
+}
+
+void host_gpio_set(const GpioPin* pin, bool level) {
+    HostGpio* gpio = host_gpio_get(pin);
+
+    host_irq_lock();
+    if(gpio->level != level) {
+        gpio->level = level;
+        const uint32_t line = pin == &gpio_ext_pa4 ? LL_EXTI_LINE_4 : 0;
+        const uint32_t trigger = level ? host_exti_rising : host_exti_falling;
+        if(line & host_exti_it & trigger) {
+            host_irq_handlers[HostIrqExti4] =
+                (HostIrqHandler){.isr = host_exti_isr, .context = gpio};
+            host_irq_pend(HostIrqExti4);
+        }
+    }
+    host_irq_unlock();
+}
+
+void furi_hal_gpio_init(const GpioPin* pin, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(speed);
+    HostGpio* gpio = host_gpio_get(pin);
+    if(pin != &gpio_ext_pa4) {
+        return;
+    }
+
+    host_irq_lock();
+    const bool rise = mode == GpioModeInterruptRise || mode == GpioModeInterruptRiseFall;
+    const bool fall = mode == GpioModeInterruptFall || mode == GpioModeInterruptRiseFall;
+    host_exti_rising = rise ? LL_EXTI_LINE_4 : 0;
+    host_exti_falling = fall ? LL_EXTI_LINE_4 : 0;
+    host_exti_it = (rise || fall) ? LL_EXTI_LINE_4 : 0;
+    if(pull == GpioPullUp) {
+        gpio->level = true;
+    }
+    host_irq_unlock();
+}
+
+void furi_hal_gpio_init_simple(const GpioPin* pin, GpioMode mode) {
+    furi_hal_gpio_init(pin, mode, GpioPullNo, GpioSpeedLow);
+}
+
+void furi_hal_gpio_write(const GpioPin* pin, bool state) {
+    host_gpio_set(pin, state);
+}
+
+bool furi_hal_gpio_read(const GpioPin* pin) {
+    return host_gpio_get(pin)->level;
+}
+
+void furi_hal_gpio_add_int_callback(const GpioPin* pin, GpioExtiCallback callback, void* context) {
+    HostGpio* gpio = host_gpio_get(pin);
+    host_irq_lock();
+    furi_check(gpio->callback == NULL);
+    gpio->callback = callback;
+    gpio->context = context;
+    host_irq_unlock();
+}
+
+void furi_hal_gpio_remove_int_callback(const GpioPin* pin) {
+    HostGpio* gpio = host_gpio_get(pin);
+    host_irq_lock();
+    gpio->callback = NULL;
+    gpio->context = NULL;
+    host_irq_unlock();
+}
+
+void furi_hal_gpio_enable_int_callback(const GpioPin* pin) {
+    UNUSED(pin);
+}
+
+void furi_hal_gpio_disable_int_callback(const GpioPin* pin) {
+    UNUSED(pin);
+}
+
+#define HOST_EXTI_SET(name, field, value) \
+    void name(uint32_t lines) {           \
+        host_irq_lock();                  \
+        field = value;                    \
+        host_irq_unlock();                \
+    }
+HOST_EXTI_SET(LL_EXTI_EnableIT_0_31, host_exti_it, host_exti_it | lines)
+HOST_EXTI_SET(LL_EXTI_DisableIT_0_31, host_exti_it, host_exti_it & ~lines)
+HOST_EXTI_SET(LL_EXTI_EnableRisingTrig_0_31, host_exti_rising, host_exti_rising | lines)
+HOST_EXTI_SET(LL_EXTI_DisableRisingTrig_0_31, host_exti_rising, host_exti_rising & ~lines)
+HOST_EXTI_SET(LL_EXTI_EnableFallingTrig_0_31, host_exti_falling, host_exti_falling | lines)
+HOST_EXTI_SET(LL_EXTI_DisableFallingTrig_0_31, host_exti_falling, host_exti_falling & ~lines)
+#undef HOST_EXTI_SET
+
+void LL_SYSCFG_SetEXTISource(uint32_t port, uint32_t line) {
+    furi_check(port == LL_SYSCFG_EXTI_PORTA && line == LL_SYSCFG_EXTI_LINE4);
+}
+
+// SPI
+
+SPI_TypeDef host_spi1;
+DMA_TypeDef host_dma2;
+
+static FuriHalSpiBus host_spi_bus_external = {.spi = SPI1};
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_external = {.bus = &host_spi_bus_external};
+
+typedef struct {
+    LL_SPI_InitTypeDef config;
+    bool enabled;
+    bool rx_dma;
+    bool tx_dma;
+    bool acquired;
+    HostSpiPeerCallback peer;
+    void* peer_context;
+    HostSpiStats stats;
+} HostSpi;
+
+static HostSpi host_spi;
+
+void furi_hal_spi_bus_handle_init(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    // CS is a output and deasserted
+    furi_hal_gpio_init(&gpio_ext_pa4, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+    host_gpio_set(&gpio_ext_pa4, true);
+}
+
+void furi_hal_spi_bus_handle_deinit(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    furi_hal_gpio_init(&gpio_ext_pa4, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+}
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    furi_check(!host_spi.acquired);
+    host_spi.acquired = true;
+}
+
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    furi_check(host_spi.acquired);
+    host_spi.acquired = false;
+}
+
+uint32_t LL_SPI_Init(SPI_TypeDef* spi, LL_SPI_InitTypeDef* init) {
+    furi_check(spi == SPI1);
+    furi_check(!host_spi.enabled);
+    host_spi.config = *init;
+    return 0;
+}
+
+#define HOST_SPI_SET(name, field, value) \
+    void name(SPI_TypeDef* spi) {        \
+        furi_check(spi == SPI1);         \
+        host_irq_lock();                 \
+        host_spi.field = value;          \
+        host_irq_unlock();               \
+    }
+HOST_SPI_SET(LL_SPI_Enable, enabled, true)
+HOST_SPI_SET(LL_SPI_Disable, enabled, false)
+HOST_SPI_SET(LL_SPI_EnableDMAReq_RX, rx_dma, true)
+HOST_SPI_SET(LL_SPI_DisableDMAReq_RX, rx_dma, false)
+HOST_SPI_SET(LL_SPI_EnableDMAReq_TX, tx_dma, true)
+HOST_SPI_SET(LL_SPI_DisableDMAReq_TX, tx_dma, false)
+#undef HOST_SPI_SET
+
+uint32_t LL_SPI_IsEnabled(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return host_spi.enabled;
+}
+
+void LL_SPI_SetRxFIFOThreshold(SPI_TypeDef* spi, uint32_t threshold) {
+    furi_check(spi == SPI1);
+    UNUSED(threshold);
+}
+
+// Frames move through the FIFOs instantly
+uint32_t LL_SPI_GetTxFIFOLevel(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return LL_SPI_TX_FIFO_EMPTY;
+}
+
+uint32_t LL_SPI_GetRxFIFOLevel(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return LL_SPI_RX_FIFO_EMPTY;
+}
+
+uint32_t LL_SPI_IsActiveFlag_BSY(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return 0;
+}
+
+uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return 0;
+}
+
+uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return 1;
+}
+
+uint32_t LL_SPI_IsActiveFlag_OVR(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return 0;
+}
+
+void LL_SPI_ClearFlag_OVR(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+}
+
+uint8_t LL_SPI_ReceiveData8(SPI_TypeDef* spi) {
+    furi_check(spi == SPI1);
+    return 0xFF;
+}
+
+void LL_SPI_TransmitData8(SPI_TypeDef* spi, uint8_t data) {
+    furi_check(spi == SPI1);
+    UNUSED(data);
+}
+
+// DMA engine. One frame is moved at a time. A flag with its interrupt enabled pends the IRQ of
+// the channel, which runs before the next frame is moved.
+
+#define HOST_DMA_FLAG_TC (1U << 0)
+#define HOST_DMA_FLAG_HT (1U << 1)
+#define HOST_DMA_FLAG_TE (1U << 2)
+
+typedef struct {
+    bool enabled;
+    uint32_t mode;
+    uint32_t memory; // 32 bit address, like CMAR
+    bool memory_increment;
+    size_t frame_size; // Memory data size in bytes
+    uint32_t length; // Programmed NDTR, reloaded in circular mode
+    uint32_t remaining; // NDTR
+    uint32_t it; // HOST_DMA_FLAG_*
+    uint32_t flags; // HOST_DMA_FLAG_*
+    HostIrq irq;
+} HostDmaChannel;
+
+static HostDmaChannel host_dma_channels[] = {
+    {.irq = HostIrqDma2Ch6, .frame_size = 1},
+    {.irq = HostIrqDma2Ch7, .frame_size = 1},
+};
+
+static HostDmaChannel* host_dma_get(DMA_TypeDef* dma, uint32_t channel) {
+    furi_check(dma == DMA2);
+    furi_check(channel == LL_DMA_CHANNEL_6 || channel == LL_DMA_CHANNEL_7);
+    return &host_dma_channels[channel - LL_DMA_CHANNEL_6];
+}
+
+static uint8_t* host_dma_pointer(const HostDmaChannel* channel) {
+    const size_t index = channel->memory_increment ? channel->length - channel->remaining : 0;
+    return (uint8_t*)(uintptr_t)channel->memory + index * channel->frame_size;
+}
+
+// Counts one moved frame. Caller holds the interrupt lock.
+static void host_dma_advance(HostDmaChannel* channel) {
+    channel->remaining--;
+    uint32_t flags = 0;
+    if(channel->remaining == channel->length - channel->length / 2) {
+        flags |= HOST_DMA_FLAG_HT;
+    }
+    if(channel->remaining == 0) {
+        flags |= HOST_DMA_FLAG_TC;
+        if(channel->mode == LL_DMA_MODE_CIRCULAR) {
+            channel->remaining = channel->length;
+        }
+    }
+    channel->flags |= flags;
+    if(flags & channel->it) {
+        host_irq_pend(channel->irq);
+    }
+}
+
+// Caller holds the interrupt lock
+static bool host_dma_receive_frame(uint16_t frame) {
+    HostDmaChannel* channel = &host_dma_channels[0];
+    if(!host_spi.enabled || !host_spi.rx_dma || !channel->enabled || channel->remaining == 0) {
+        host_spi.stats.frames_lost++;
+        return false;
+    }
+
+    uint8_t* destination = host_dma_pointer(channel);
+    destination[0] = frame;
+    if(channel->frame_size == 2) {
+        destination[1] = frame >> 8;
+    }
+    host_spi.stats.frames_received++;
+    host_dma_advance(channel);
+    return true;
+}
+
+size_t host_spi_receive(const void* data, size_t length) {
+    const uint8_t* bytes = data;
+    size_t accepted = 0;
+
+    host_irq_lock();
+    const size_t frame_size = host_dma_channels[0].frame_size;
+    for(size_t i = 0; i + frame_size <= length; i += frame_size) {
+        const uint16_t frame = frame_size == 2 ? bytes[i] | (bytes[i + 1] << 8) : bytes[i];
+        if(host_dma_receive_frame(frame)) {
+            accepted += frame_size;
+        }
+        // Lets the ISRs run, while the bus goes on
+        if(host_irq_pending != 0) {
+            host_irq_unlock();
+            host_irq_lock();
+        }
+    }
+    host_irq_unlock();
+
+    return accepted;
+}
+
+size_t host_spi_clock(size_t frames) {
+    size_t sent = 0;
+
+    host_irq_lock();
+    HostDmaChannel* channel = &host_dma_channels[1];
+    while(sent < frames) {
+        if(!host_spi.enabled || !host_spi.tx_dma || !channel->enabled ||
+           channel->remaining == 0) {
+            break;
+        }
+
+        const uint8_t* source = host_dma_pointer(channel);
+        const uint16_t mosi = channel->frame_size == 2 ? source[0] | (source[1] << 8) : source[0];
+        host_spi.stats.frames_sent++;
+        host_dma_advance(channel);
+
+        const uint16_t miso =
+            host_spi.peer != NULL ? host_spi.peer(host_spi.peer_context, mosi) : mosi;
+        host_dma_receive_frame(miso);
+        sent++;
+
+        if(host_irq_pending != 0) {
+            host_irq_unlock();
+            host_irq_lock();
+        }
+    }
+    host_irq_unlock();
+
+    return sent;
+}
+
+void host_spi_set_peer(HostSpiPeerCallback callback, void* context) {
+    host_irq_lock();
+    host_spi.peer = callback;
+    host_spi.peer_context = context;
+    host_irq_unlock();
+}
+
+void host_spi_get_stats(HostSpiStats* stats) {
+    host_irq_lock();
+    *stats = host_spi.stats;
+    host_irq_unlock();
+}
+
+void host_spi_reset_stats(void) {
+    host_irq_lock();
+    memset(&host_spi.stats, 0, sizeof(host_spi.stats));
+    host_irq_unlock();
+}
+
+uint32_t LL_DMA_Init(DMA_TypeDef* dma, uint32_t channel_id, LL_DMA_InitTypeDef* init) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    furi_check(init->PeriphOrM2MSrcAddress == (uint32_t)(uintptr_t)&SPI1->DR);
+
+    host_irq_lock();
+    channel->enabled = false;
+    channel->mode = init->Mode;
+    channel->memory = init->MemoryOrM2MDstAddress;
+    channel->memory_increment = init->MemoryOrM2MDstIncMode == LL_DMA_MEMORY_INCREMENT;
+    channel->frame_size = init->MemoryOrM2MDstDataSize == LL_DMA_MDATAALIGN_HALFWORD ? 2 : 1;
+    channel->length = init->NbData;
+    channel->remaining = init->NbData;
+    host_irq_unlock();
+
+    return 0;
+}
+
+uint32_t LL_DMA_DeInit(DMA_TypeDef* dma, uint32_t channel_id) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+
+    host_irq_lock();
+    const HostIrq irq = channel->irq;
+    *channel = (HostDmaChannel){.irq = irq, .frame_size = 1};
+    host_irq_unlock();
+
+    return 0;
+}
+
+void LL_DMA_EnableChannel(DMA_TypeDef* dma, uint32_t channel_id) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    // The memory has to be reachable with a 32 bit address
+    furi_check(channel->memory != 0 || channel->length == 0);
+    host_irq_lock();
+    channel->enabled = true;
+    host_irq_unlock();
+}
+
+void LL_DMA_DisableChannel(DMA_TypeDef* dma, uint32_t channel_id) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    host_irq_lock();
+    channel->enabled = false;
+    host_irq_unlock();
+}
+
+uint32_t LL_DMA_IsEnabledChannel(DMA_TypeDef* dma, uint32_t channel_id) {
+    return host_dma_get(dma, channel_id)->enabled;
+}
+
+void LL_DMA_SetMode(DMA_TypeDef* dma, uint32_t channel_id, uint32_t mode) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    furi_check(!channel->enabled);
+    channel->mode = mode;
+}
+
+void LL_DMA_SetMemoryAddress(DMA_TypeDef* dma, uint32_t channel_id, uint32_t address) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    furi_check(!channel->enabled);
+    channel->memory = address;
+}
+
+void LL_DMA_SetMemoryIncMode(DMA_TypeDef* dma, uint32_t channel_id, uint32_t mode) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    furi_check(!channel->enabled);
+    channel->memory_increment = mode == LL_DMA_MEMORY_INCREMENT;
+}
+
+void LL_DMA_SetDataLength(DMA_TypeDef* dma, uint32_t channel_id, uint32_t length) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    furi_check(!channel->enabled);
+    furi_check(length <= UINT16_MAX);
+    channel->length = length;
+    channel->remaining = length;
+}
+
+uint32_t LL_DMA_GetDataLength(DMA_TypeDef* dma, uint32_t channel_id) {
+    HostDmaChannel* channel = host_dma_get(dma, channel_id);
+    host_irq_lock();
+    const uint32_t remaining = channel->remaining;
+    host_irq_unlock();
+    return remaining;
+}
+
+#define HOST_DMA_IT(name, flag)                                                 \
+    void LL_DMA_EnableIT_##name(DMA_TypeDef* dma, uint32_t channel_id) {        \
+        HostDmaChannel* channel = host_dma_get(dma, channel_id);                \
+        host_irq_lock();                                                        \
+        channel->it |= flag;                                                    \
+        host_irq_unlock();                                                      \
+    }                                                                           \
+    void LL_DMA_DisableIT_##name(DMA_TypeDef* dma, uint32_t channel_id) {       \
+        HostDmaChannel* channel = host_dma_get(dma, channel_id);                \
+        host_irq_lock();                                                        \
+        channel->it &= ~flag;                                                   \
+        host_irq_unlock();                                                      \
+    }                                                                           \
+    uint32_t LL_DMA_IsEnabledIT_##name(DMA_TypeDef* dma, uint32_t channel_id) { \
+        return (host_dma_get(dma, channel_id)->it & flag) != 0;                 \
+    }
+HOST_DMA_IT(TC, HOST_DMA_FLAG_TC)
+HOST_DMA_IT(HT, HOST_DMA_FLAG_HT)
+HOST_DMA_IT(TE, HOST_DMA_FLAG_TE)
+#undef HOST_DMA_IT
+
+#define HOST_DMA_FLAG(name, channel_id, flag)                      \
+    uint32_t LL_DMA_IsActiveFlag_##name(DMA_TypeDef* dma) {        \
+        return (host_dma_get(dma, channel_id)->flags & flag) != 0; \
+    }                                                              \
+    void LL_DMA_ClearFlag_##name(DMA_TypeDef* dma) {               \
+        HostDmaChannel* channel = host_dma_get(dma, channel_id);   \
+        host_irq_lock();                                           \
+        channel->flags &= ~flag;                                   \
+        host_irq_unlock();                                         \
+    }
+#define HOST_DMA_FLAG_ALL (HOST_DMA_FLAG_TC | HOST_DMA_FLAG_HT | HOST_DMA_FLAG_TE)
+HOST_DMA_FLAG(GI6, LL_DMA_CHANNEL_6, HOST_DMA_FLAG_ALL)
+HOST_DMA_FLAG(TC6, LL_DMA_CHANNEL_6, HOST_DMA_FLAG_TC)
+HOST_DMA_FLAG(HT6, LL_DMA_CHANNEL_6, HOST_DMA_FLAG_HT)
+HOST_DMA_FLAG(TE6, LL_DMA_CHANNEL_6, HOST_DMA_FLAG_TE)
+HOST_DMA_FLAG(GI7, LL_DMA_CHANNEL_7, HOST_DMA_FLAG_ALL)
+HOST_DMA_FLAG(TC7, LL_DMA_CHANNEL_7, HOST_DMA_FLAG_TC)
+HOST_DMA_FLAG(HT7, LL_DMA_CHANNEL_7, HOST_DMA_FLAG_HT)
+HOST_DMA_FLAG(TE7, LL_DMA_CHANNEL_7, HOST_DMA_FLAG_TE)
+#undef HOST_DMA_FLAG
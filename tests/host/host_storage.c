@@ -0,0 +1,340 @@
+#define _GNU_SOURCE
+#include "host.h"
+
+#include <lib/flipper_format/flipper_format.h>
+#include <lib/toolbox/value_index.h>
+#include <storage/storage.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Storage
+
+struct File {
+    FILE* stream;
+    FS_Error error;
+};
+
+static char host_storage_directory[] = "/tmp/spi_terminal_XXXXXX";
+static pthread_once_t host_storage_once = PTHREAD_ONCE_INIT;
+
+static void host_storage_init(void) {
+    furi_check(mkdtemp(host_storage_directory) != NULL);
+}
+
+const char* host_storage_root(void) {
+    pthread_once(&host_storage_once, host_storage_init);
+    return host_storage_directory;
+}
+
+// Maps /ext to the temporary directory. Other paths do not exist on the host.
+static FuriString* host_storage_path(const char* path) {
+    const char* ext = "/ext";
+    const size_t ext_length = strlen(ext);
+    if(strncmp(path, ext, ext_length) != 0 ||
+       (path[ext_length] != '\0' && path[ext_length] != '/')) {
+        return NULL;
+    }
+    return furi_string_alloc_printf("%s%s", host_storage_root(), path + ext_length);
+}
+
+static FS_Error host_storage_error(int error) {
+    switch(error) {
+    case 0:
+        return FSE_OK;
+    case EEXIST:
+        return FSE_EXIST;
+    case ENOENT:
+        return FSE_NOT_EXIST;
+    case EACCES:
+        return FSE_DENIED;
+    case EINVAL:
+        return FSE_INVALID_PARAMETER;
+    default:
+        return FSE_INTERNAL;
+    }
+}
+
+FS_Error storage_sd_status(Storage* storage) {
+    UNUSED(storage);
+    return FSE_OK;
+}
+
+FS_Error storage_common_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    FuriString* host_path = host_storage_path(path);
+    if(host_path == NULL) {
+        return FSE_INVALID_NAME;
+    }
+
+    const int result = mkdir(furi_string_get_cstr(host_path), 0777);
+    furi_string_free(host_path);
+    return result == 0 ? FSE_OK : host_storage_error(errno);
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    FuriString* host_path = host_storage_path(path);
+    if(host_path == NULL) {
+        return false;
+    }
+
+    struct stat info;
+    const bool exists = stat(furi_string_get_cstr(host_path), &info) == 0 &&
+                        S_ISREG(info.st_mode);
+    furi_string_free(host_path);
+    return exists;
+}
+
+// Like the firmware: The name without the extension, numbered from 1 if it exists already
+void storage_get_next_filename(
+    Storage* storage,
+    const char* dirname,
+    const char* filename,
+    const char* fileextension,
+    FuriString* nextfilename,
+    uint8_t max_len) {
+    FuriString* path = furi_string_alloc_printf("%s/%s%s", dirname, filename, fileextension);
+    furi_string_set_str(nextfilename, filename);
+    for(uint32_t number = 1; storage_file_exists(storage, furi_string_get_cstr(path)); number++) {
+        furi_string_printf(nextfilename, "%s%lu", filename, (unsigned long)number);
+        furi_string_printf(
+            path, "%s/%s%s", dirname, furi_string_get_cstr(nextfilename), fileextension);
+    }
+    furi_string_free(path);
+    furi_check(furi_string_size(nextfilename) <= max_len);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = calloc(1, sizeof(File));
+    furi_check(file);
+    return file;
+}
+
+void storage_file_free(File* file) {
+    furi_check(file);
+    if(file->stream != NULL) {
+        storage_file_close(file);
+    }
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access, FS_OpenMode mode) {
+    furi_check(file);
+    furi_check(file->stream == NULL);
+
+    FuriString* host_path = host_storage_path(path);
+    if(host_path == NULL) {
+        file->error = FSE_INVALID_NAME;
+        return false;
+    }
+
+    int flags = access == FSAM_READ_WRITE ? O_RDWR : (access == FSAM_WRITE ? O_WRONLY : O_RDONLY);
+    switch(mode) {
+    case FSOM_OPEN_EXISTING:
+        break;
+    case FSOM_OPEN_ALWAYS:
+    case FSOM_OPEN_APPEND:
+        flags |= O_CREAT;
+        break;
+    case FSOM_CREATE_NEW:
+        flags |= O_CREAT | O_EXCL;
+        break;
+    case FSOM_CREATE_ALWAYS:
+        flags |= O_CREAT | O_TRUNC;
+        break;
+    }
+
+    const int fd = open(furi_string_get_cstr(host_path), flags, 0666);
+    furi_string_free(host_path);
+    if(fd < 0) {
+        file->error = host_storage_error(errno);
+        return false;
+    }
+
+    // fdopen never truncates, the mode only has to match the access
+    const char* stream_mode = access == FSAM_READ ? "rb" : (access == FSAM_WRITE ? "wb" : "r+b");
+    if(mode == FSOM_OPEN_APPEND) {
+        stream_mode = access == FSAM_WRITE ? "ab" : "a+b";
+    }
+    file->stream = fdopen(fd, stream_mode);
+    furi_check(file->stream);
+    file->error = FSE_OK;
+    return true;
+}
+
+bool storage_file_close(File* file) {
+    furi_check(file);
+    if(file->stream == NULL) {
+        return false;
+    }
+    fclose(file->stream);
+    file->stream = NULL;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    furi_check(file);
+    return file->stream != NULL;
+}
+
+size_t storage_file_read(File* file, void* buffer, size_t length) {
+    furi_check(file);
+    furi_check(file->stream);
+    const size_t read = fread(buffer, 1, length, file->stream);
+    file->error = ferror(file->stream) ? FSE_INTERNAL : FSE_OK;
+    clearerr(file->stream);
+    return read;
+}
+
+size_t storage_file_write(File* file, const void* buffer, size_t length) {
+    furi_check(file);
+    furi_check(file->stream);
+    const size_t written = fwrite(buffer, 1, length, file->stream);
+    file->error = written == length ? FSE_OK : FSE_INTERNAL;
+    return written;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    furi_check(file);
+    furi_check(file->stream);
+    const bool ok = fseek(file->stream, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+    file->error = ok ? FSE_OK : FSE_INVALID_PARAMETER;
+    return ok;
+}
+
+uint64_t storage_file_tell(File* file) {
+    furi_check(file);
+    furi_check(file->stream);
+    return ftell(file->stream);
+}
+
+uint64_t storage_file_size(File* file) {
+    furi_check(file);
+    furi_check(file->stream);
+    fflush(file->stream);
+    struct stat info;
+    furi_check(fstat(fileno(file->stream), &info) == 0);
+    return info.st_size;
+}
+
+bool storage_file_sync(File* file) {
+    furi_check(file);
+    furi_check(file->stream);
+    return fflush(file->stream) == 0;
+}
+
+bool storage_file_eof(File* file) {
+    return storage_file_tell(file) >= storage_file_size(file);
+}
+
+FS_Error storage_file_get_error(File* file) {
+    furi_check(file);
+    return file->error;
+}
+
+// Flipper format. There are no settings files on the host.
+
+struct FlipperFormat {
+    Storage* storage;
+};
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage) {
+    FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
+    furi_check(flipper_format);
+    flipper_format->storage = storage;
+    return flipper_format;
+}
+
+void flipper_format_free(FlipperFormat* flipper_format) {
+    furi_check(flipper_format);
+    free(flipper_format);
+}
+
+bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path) {
+    UNUSED(flipper_format);
+    UNUSED(path);
+    return false;
+}
+
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
+    UNUSED(flipper_format);
+    UNUSED(path);
+    return false;
+}
+
+bool flipper_format_file_close(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    return true;
+}
+
+bool flipper_format_rewind(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    return false;
+}
+
+bool flipper_format_read_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    uint32_t* version) {
+    UNUSED(flipper_format);
+    UNUSED(filetype);
+    UNUSED(version);
+    return false;
+}
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data) {
+    UNUSED(flipper_format);
+    UNUSED(key);
+    UNUSED(data);
+    return false;
+}
+
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version) {
+    UNUSED(flipper_format);
+    UNUSED(filetype);
+    UNUSED(version);
+    return false;
+}
+
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data) {
+    UNUSED(flipper_format);
+    UNUSED(key);
+    UNUSED(data);
+    return false;
+}
+
+bool flipper_format_write_comment(FlipperFormat* flipper_format, FuriString* data) {
+    UNUSED(flipper_format);
+    UNUSED(data);
+    return false;
+}
+
+bool flipper_format_write_empty_line(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    return false;
+}
+
+// Toolbox
+
+size_t value_index_uint32(const uint32_t value, const uint32_t values[], size_t values_count) {
+    size_t index = 0;
+    for(size_t i = 0; i < values_count; i++) {
+        if(value == values[i]) {
+            index = i;
+            break;
+        }
+    }
+    return index;
+}
@@ -0,0 +1,216 @@
+#include <furi.h>
+
+struct FuriString {
+    char* data;
+    size_t size; // Without the terminator
+    size_t capacity; // With the terminator
+};
+
+void furi_string_reserve(FuriString* string, size_t size) {
+    furi_check(string);
+    if(size + 1 <= string->capacity) {
+        return;
+    }
+    string->capacity = MAX(size + 1, string->capacity * 2);
+    string->data = realloc(string->data, string->capacity);
+    furi_check(string->data);
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    furi_string_reserve(string, 15);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString* furi_string_alloc_set(const FuriString* source) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set(string, source);
+    return string;
+}
+
+FuriString* furi_string_alloc_set_str(const char* cstr) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, cstr);
+    return string;
+}
+
+static int furi_string_vcat_printf(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    const int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    furi_check(length >= 0);
+
+    furi_string_reserve(string, string->size + length);
+    vsnprintf(string->data + string->size, length + 1, format, args);
+    string->size += length;
+    return length;
+}
+
+FuriString* furi_string_alloc_printf(const char* format, ...) {
+    FuriString* string = furi_string_alloc();
+    va_list args;
+    va_start(args, format);
+    furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    furi_check(string);
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    furi_check(string);
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_set_strn(FuriString* string, const char* cstr, size_t length) {
+    furi_check(string);
+    furi_check(cstr || length == 0);
+    furi_string_reserve(string, length);
+    memmove(string->data, cstr, length);
+    string->size = length;
+    string->data[length] = '\0';
+}
+
+void furi_string_set(FuriString* string, const FuriString* source) {
+    furi_check(source);
+    furi_string_set_strn(string, source->data, source->size);
+}
+
+void furi_string_set_str(FuriString* string, const char* cstr) {
+    furi_string_set_strn(string, cstr, strlen(cstr));
+}
+
+bool furi_string_empty(const FuriString* string) {
+    furi_check(string);
+    return string->size == 0;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    furi_check(string);
+    return string->size;
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    furi_check(string);
+    return string->data;
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    furi_check(string);
+    furi_check(index < string->size);
+    return string->data[index];
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_check(string);
+    furi_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+static void furi_string_cat_strn(FuriString* string, const char* cstr, size_t length) {
+    furi_check(string);
+    furi_string_reserve(string, string->size + length);
+    memmove(string->data + string->size, cstr, length);
+    string->size += length;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_cat(FuriString* string, const FuriString* source) {
+    furi_check(source);
+    furi_string_cat_strn(string, source->data, source->size);
+}
+
+void furi_string_cat_str(FuriString* string, const char* cstr) {
+    furi_string_cat_strn(string, cstr, strlen(cstr));
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    furi_check(string);
+    va_list args;
+    va_start(args, format);
+    const int length = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return length;
+}
+
+int furi_string_printf(FuriString* string, const char* format, ...) {
+    furi_string_reset(string);
+    va_list args;
+    va_start(args, format);
+    const int length = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return length;
+}
+
+bool furi_string_equal(const FuriString* a, const FuriString* b) {
+    furi_check(a);
+    furi_check(b);
+    return a->size == b->size && memcmp(a->data, b->data, a->size) == 0;
+}
+
+bool furi_string_equal_str(const FuriString* string, const char* cstr) {
+    furi_check(string);
+    return strcmp(string->data, cstr) == 0;
+}
+
+bool furi_string_start_with_str(const FuriString* string, const char* cstr) {
+    furi_check(string);
+    return strncmp(string->data, cstr, strlen(cstr)) == 0;
+}
+
+bool furi_string_end_with_str(const FuriString* string, const char* cstr) {
+    furi_check(string);
+    const size_t length = strlen(cstr);
+    return length <= string->size &&
+           memcmp(string->data + string->size - length, cstr, length) == 0;
+}
+
+size_t furi_string_search_char(const FuriString* string, char c, size_t start) {
+    furi_check(string);
+    for(size_t i = start; i < string->size; i++) {
+        if(string->data[i] == c) {
+            return i;
+        }
+    }
+    return FURI_STRING_FAILURE;
+}
+
+void furi_string_left(FuriString* string, size_t length) {
+    furi_check(string);
+    if(length < string->size) {
+        string->size = length;
+        string->data[length] = '\0';
+    }
+}
+
+void furi_string_right(FuriString* string, size_t start) {
+    furi_check(string);
+    start = MIN(start, string->size);
+    furi_string_set_strn(string, string->data + start, string->size - start);
+}
+
+void furi_string_mid(FuriString* string, size_t start, size_t length) {
+    furi_string_right(string, start);
+    furi_string_left(string, length);
+}
+
+void furi_string_trim(FuriString* string, const char* chars) {
+    furi_check(string);
+    size_t start = 0;
+    while(start < string->size && strchr(chars, string->data[start]) != NULL) {
+        start++;
+    }
+    size_t end = string->size;
+    while(end > start && strchr(chars, string->data[end - 1]) != NULL) {
+        end--;
+    }
+    furi_string_mid(string, start, end - start);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Host emulation of the ACLE SIMD intrinsics. __usub8 sets the GE flags of the calling thread,
+// __sel reads them, just like the instructions USUB8 and SEL do on the Cortex-M4.
+
+#include <stdint.h>
+
+extern _Thread_local uint32_t host_acle_ge;
+
+static inline uint32_t __usub8(uint32_t a, uint32_t b) {
+    uint32_t result = 0;
+    host_acle_ge = 0;
+    for(unsigned lane = 0; lane < 4; lane++) {
+        const uint32_t x = (a >> (lane * 8)) & 0xFF;
+        const uint32_t y = (b >> (lane * 8)) & 0xFF;
+        result |= ((x - y) & 0xFF) << (lane * 8);
+        if(x >= y) {
+            host_acle_ge |= 1U << lane;
+        }
+    }
+    return result;
+}
+
+static inline uint32_t __sel(uint32_t a, uint32_t b) {
+    uint32_t result = 0;
+    for(unsigned lane = 0; lane < 4; lane++) {
+        const uint32_t mask = 0xFFU << (lane * 8);
+        result |= (host_acle_ge & (1U << lane)) ? (a & mask) : (b & mask);
+    }
+    return result;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi.h>
+
+#define RECORD_CLI "cli"
+
+typedef struct Cli Cli;
@@ -0,0 +1,52 @@
+#pragma once
+
+// Host stand-in for FuriString. A plain growing heap buffer, always '\0' terminated.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FURI_STRING_FAILURE ((size_t)-1)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set(const FuriString* source);
+FuriString* furi_string_alloc_set_str(const char* cstr);
+FuriString* furi_string_alloc_printf(const char* format, ...)
+    __attribute__((format(printf, 1, 2)));
+void furi_string_free(FuriString* string);
+void furi_string_reserve(FuriString* string, size_t size);
+void furi_string_reset(FuriString* string);
+void furi_string_set(FuriString* string, const FuriString* source);
+void furi_string_set_str(FuriString* string, const char* cstr);
+void furi_string_set_strn(FuriString* string, const char* cstr, size_t length);
+bool furi_string_empty(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+char furi_string_get_char(const FuriString* string, size_t index);
+void furi_string_push_back(FuriString* string, char c);
+void furi_string_cat(FuriString* string, const FuriString* source);
+void furi_string_cat_str(FuriString* string, const char* cstr);
+int furi_string_cat_printf(FuriString* string, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+int furi_string_printf(FuriString* string, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+bool furi_string_equal(const FuriString* a, const FuriString* b);
+bool furi_string_equal_str(const FuriString* string, const char* cstr);
+bool furi_string_start_with_str(const FuriString* string, const char* cstr);
+bool furi_string_end_with_str(const FuriString* string, const char* cstr);
+size_t furi_string_search_char(const FuriString* string, char c, size_t start);
+// Keeps the first length characters
+void furi_string_left(FuriString* string, size_t length);
+// Drops the first start characters
+void furi_string_right(FuriString* string, size_t start);
+void furi_string_mid(FuriString* string, size_t start, size_t length);
+void furi_string_trim(FuriString* string, const char* chars);
+
+#ifdef __cplusplus
+}
+#endif
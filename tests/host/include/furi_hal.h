@@ -0,0 +1,8 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_gpio.h>
+#include <furi_hal_interrupt.h>
+#include <furi_hal_spi.h>
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FuriHalBusSPI1,
+} FuriHalBus;
+
+void furi_hal_bus_reset(FuriHalBus bus);
+
+#ifdef __cplusplus
+}
+#endif
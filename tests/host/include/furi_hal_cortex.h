@@ -0,0 +1,25 @@
+#pragma once
+
+#include <furi.h>
+#include <stm32wbxx.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The simulated core runs at 64 MHz like the STM32WB55
+#define HOST_CPU_FREQUENCY 64000000U
+
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+void furi_hal_cortex_delay_us(uint32_t microseconds);
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer);
+
+#ifdef __cplusplus
+}
+#endif
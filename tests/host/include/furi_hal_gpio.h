@@ -0,0 +1,62 @@
+#pragma once
+
+// Host stand-in for the GPIO HAL. Input levels are set with host_gpio_set, see host.h.
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    void* port;
+    uint16_t pin;
+} GpioPin;
+
+typedef enum {
+    GpioModeInput,
+    GpioModeOutputPushPull,
+    GpioModeOutputOpenDrain,
+    GpioModeAltFunctionPushPull,
+    GpioModeAltFunctionOpenDrain,
+    GpioModeAnalog,
+    GpioModeInterruptRise,
+    GpioModeInterruptFall,
+    GpioModeInterruptRiseFall,
+    GpioModeEventRise,
+    GpioModeEventFall,
+    GpioModeEventRiseFall,
+} GpioMode;
+
+typedef enum {
+    GpioPullNo,
+    GpioPullUp,
+    GpioPullDown,
+} GpioPull;
+
+typedef enum {
+    GpioSpeedLow,
+    GpioSpeedMedium,
+    GpioSpeedHigh,
+    GpioSpeedVeryHigh,
+} GpioSpeed;
+
+typedef void (*GpioExtiCallback)(void* context);
+
+extern const GpioPin gpio_ext_pa4;
+extern const GpioPin gpio_ext_pa6;
+extern const GpioPin gpio_ext_pa7;
+extern const GpioPin gpio_ext_pb3;
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed);
+void furi_hal_gpio_init_simple(const GpioPin* gpio, GpioMode mode);
+void furi_hal_gpio_write(const GpioPin* gpio, bool state);
+bool furi_hal_gpio_read(const GpioPin* gpio);
+void furi_hal_gpio_add_int_callback(const GpioPin* gpio, GpioExtiCallback callback, void* context);
+void furi_hal_gpio_remove_int_callback(const GpioPin* gpio);
+void furi_hal_gpio_enable_int_callback(const GpioPin* gpio);
+void furi_hal_gpio_disable_int_callback(const GpioPin* gpio);
+
+#ifdef __cplusplus
+}
+#endif
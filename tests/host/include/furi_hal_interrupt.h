@@ -0,0 +1,23 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FuriHalInterruptIdDma2Ch6,
+    FuriHalInterruptIdDma2Ch7,
+
+    FuriHalInterruptIdMax,
+} FuriHalInterruptId;
+
+typedef void (*FuriHalInterruptISR)(void* context);
+
+// Runs from the context, which raised the interrupt, while all other interrupts are masked
+void furi_hal_interrupt_set_isr(FuriHalInterruptId index, FuriHalInterruptISR isr, void* context);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <furi_hal_spi_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void furi_hal_spi_bus_handle_init(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_bus_handle_deinit(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle);
+
+#ifdef __cplusplus
+}
+#endif
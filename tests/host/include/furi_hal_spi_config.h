@@ -0,0 +1,13 @@
+#pragma once
+
+#include <furi_hal_spi_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_external;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <furi.h>
+#include <stm32wbxx_ll_spi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    SPI_TypeDef* spi;
+} FuriHalSpiBus;
+
+typedef struct {
+    FuriHalSpiBus* bus;
+} FuriHalSpiBusHandle;
+
+#ifdef __cplusplus
+}
+#endif
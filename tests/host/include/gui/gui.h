@@ -0,0 +1,7 @@
+#pragma once
+
+#include <gui/canvas.h>
+
+#define RECORD_GUI "gui"
+
+typedef struct Gui Gui;
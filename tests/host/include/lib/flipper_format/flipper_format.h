@@ -0,0 +1,38 @@
+#pragma once
+
+// Host stand-in for flipper_format. There are no settings files on the host, every open fails
+// and the app keeps its defaults.
+
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FlipperFormat FlipperFormat;
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage);
+void flipper_format_free(FlipperFormat* flipper_format);
+bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path);
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path);
+bool flipper_format_file_close(FlipperFormat* flipper_format);
+bool flipper_format_rewind(FlipperFormat* flipper_format);
+bool flipper_format_read_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    uint32_t* version);
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version);
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data);
+bool flipper_format_write_comment(FlipperFormat* flipper_format, FuriString* data);
+bool flipper_format_write_empty_line(FlipperFormat* flipper_format);
+
+#ifdef __cplusplus
+}
+#endif
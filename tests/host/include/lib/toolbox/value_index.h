@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t value_index_uint32(const uint32_t value, const uint32_t values[], size_t values_count);
+
+#ifdef __cplusplus
+}
+#endif
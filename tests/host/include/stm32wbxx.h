@@ -0,0 +1,56 @@
+#pragma once
+
+// Host stand-in for the CMSIS device header. The peripherals are plain structs, which are driven
+// by the simulated DMA engine in host_hal.c. DWT->CYCCNT follows the host clock at 64 MHz.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    volatile uint32_t CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR;
+} SPI_TypeDef;
+
+typedef struct {
+    volatile uint32_t ISR, IFCR;
+} DMA_TypeDef;
+
+typedef struct {
+    volatile uint32_t CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef enum {
+    EXTI4_IRQn = 10,
+    DMA2_Channel6_IRQn = 60,
+    DMA2_Channel7_IRQn = 61,
+} IRQn_Type;
+
+extern SPI_TypeDef host_spi1;
+extern DMA_TypeDef host_dma2;
+DWT_Type* host_dwt(void);
+
+#define SPI1 (&host_spi1)
+#define DMA2 (&host_dma2)
+// Every access samples the host clock
+#define DWT  (host_dwt())
+
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+
+static inline void __DSB(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __DMB(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+// Host stand-in for the LL DMA driver. Only DMA2 channel 6 (SPI1 RX) and 7 (SPI1 TX) exist.
+// Transfers are executed by the simulated DMA engine, see host.h.
+
+#include <stm32wbxx.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LL_DMA_CHANNEL_6 0x00000005U
+#define LL_DMA_CHANNEL_7 0x00000006U
+
+#define LL_DMAMUX_REQ_SPI1_RX 0x00000006U
+#define LL_DMAMUX_REQ_SPI1_TX 0x00000007U
+
+#define LL_DMA_DIRECTION_PERIPH_TO_MEMORY 0x00000000U
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH 0x00000010U
+
+#define LL_DMA_MODE_NORMAL   0x00000000U
+#define LL_DMA_MODE_CIRCULAR 0x00000020U
+
+#define LL_DMA_PERIPH_NOINCREMENT 0x00000000U
+#define LL_DMA_PERIPH_INCREMENT   0x00000040U
+#define LL_DMA_MEMORY_NOINCREMENT 0x00000000U
+#define LL_DMA_MEMORY_INCREMENT   0x00000080U
+
+#define LL_DMA_PDATAALIGN_BYTE     0x00000000U
+#define LL_DMA_PDATAALIGN_HALFWORD 0x00000100U
+#define LL_DMA_MDATAALIGN_BYTE     0x00000000U
+#define LL_DMA_MDATAALIGN_HALFWORD 0x00000400U
+
+#define LL_DMA_PRIORITY_LOW      0x00000000U
+#define LL_DMA_PRIORITY_MEDIUM   0x00001000U
+#define LL_DMA_PRIORITY_HIGH     0x00002000U
+#define LL_DMA_PRIORITY_VERYHIGH 0x00003000U
+
+typedef struct {
+    uint32_t PeriphOrM2MSrcAddress;
+    uint32_t MemoryOrM2MDstAddress;
+    uint32_t Direction;
+    uint32_t Mode;
+    uint32_t PeriphOrM2MSrcIncMode;
+    uint32_t MemoryOrM2MDstIncMode;
+    uint32_t PeriphOrM2MSrcDataSize;
+    uint32_t MemoryOrM2MDstDataSize;
+    uint32_t NbData;
+    uint32_t PeriphRequest;
+    uint32_t Priority;
+} LL_DMA_InitTypeDef;
+
+uint32_t LL_DMA_Init(DMA_TypeDef* dma, uint32_t channel, LL_DMA_InitTypeDef* init);
+uint32_t LL_DMA_DeInit(DMA_TypeDef* dma, uint32_t channel);
+void LL_DMA_EnableChannel(DMA_TypeDef* dma, uint32_t channel);
+void LL_DMA_DisableChannel(DMA_TypeDef* dma, uint32_t channel);
+uint32_t LL_DMA_IsEnabledChannel(DMA_TypeDef* dma, uint32_t channel);
+void LL_DMA_SetMode(DMA_TypeDef* dma, uint32_t channel, uint32_t mode);
+void LL_DMA_SetMemoryAddress(DMA_TypeDef* dma, uint32_t channel, uint32_t address);
+void LL_DMA_SetMemoryIncMode(DMA_TypeDef* dma, uint32_t channel, uint32_t mode);
+void LL_DMA_SetDataLength(DMA_TypeDef* dma, uint32_t channel, uint32_t length);
+// NDTR, the remaining frames of the transfer
+uint32_t LL_DMA_GetDataLength(DMA_TypeDef* dma, uint32_t channel);
+
+#define HOST_LL_DMA_IT(name)                                                  \
+    void LL_DMA_EnableIT_##name(DMA_TypeDef* dma, uint32_t channel);          \
+    void LL_DMA_DisableIT_##name(DMA_TypeDef* dma, uint32_t channel);         \
+    uint32_t LL_DMA_IsEnabledIT_##name(DMA_TypeDef* dma, uint32_t channel);
+HOST_LL_DMA_IT(TC)
+HOST_LL_DMA_IT(HT)
+HOST_LL_DMA_IT(TE)
+#undef HOST_LL_DMA_IT
+
+#define HOST_LL_DMA_FLAG(name)                            \
+    uint32_t LL_DMA_IsActiveFlag_##name(DMA_TypeDef* dma); \
+    void LL_DMA_ClearFlag_##name(DMA_TypeDef* dma);
+HOST_LL_DMA_FLAG(GI6)
+HOST_LL_DMA_FLAG(TC6)
+HOST_LL_DMA_FLAG(HT6)
+HOST_LL_DMA_FLAG(TE6)
+HOST_LL_DMA_FLAG(GI7)
+HOST_LL_DMA_FLAG(TC7)
+HOST_LL_DMA_FLAG(HT7)
+HOST_LL_DMA_FLAG(TE7)
+#undef HOST_LL_DMA_FLAG
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in for the LL EXTI driver. Edges of a pin are passed to its GPIO interrupt callback,
+// if the line is enabled here or by furi_hal_gpio_init.
+
+#include <stm32wbxx.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LL_EXTI_LINE_4 0x00000010U
+
+void LL_EXTI_EnableIT_0_31(uint32_t lines);
+void LL_EXTI_DisableIT_0_31(uint32_t lines);
+void LL_EXTI_EnableRisingTrig_0_31(uint32_t lines);
+void LL_EXTI_DisableRisingTrig_0_31(uint32_t lines);
+void LL_EXTI_EnableFallingTrig_0_31(uint32_t lines);
+void LL_EXTI_DisableFallingTrig_0_31(uint32_t lines);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+// Host stand-in for the LL SPI driver. The configuration is only stored, data is moved by the
+// simulated DMA engine.
+
+#include <stm32wbxx.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LL_SPI_MODE_MASTER 0x00000104U
+#define LL_SPI_MODE_SLAVE  0x00000000U
+
+#define LL_SPI_FULL_DUPLEX    0x00000000U
+#define LL_SPI_SIMPLEX_RX     0x00000400U
+#define LL_SPI_HALF_DUPLEX_RX 0x00008000U
+#define LL_SPI_HALF_DUPLEX_TX 0x0000C000U
+
+#define LL_SPI_DATAWIDTH_4BIT  0x00000300U
+#define LL_SPI_DATAWIDTH_5BIT  0x00000400U
+#define LL_SPI_DATAWIDTH_6BIT  0x00000500U
+#define LL_SPI_DATAWIDTH_7BIT  0x00000600U
+#define LL_SPI_DATAWIDTH_8BIT  0x00000700U
+#define LL_SPI_DATAWIDTH_9BIT  0x00000800U
+#define LL_SPI_DATAWIDTH_10BIT 0x00000900U
+#define LL_SPI_DATAWIDTH_11BIT 0x00000A00U
+#define LL_SPI_DATAWIDTH_12BIT 0x00000B00U
+#define LL_SPI_DATAWIDTH_13BIT 0x00000C00U
+#define LL_SPI_DATAWIDTH_14BIT 0x00000D00U
+#define LL_SPI_DATAWIDTH_15BIT 0x00000E00U
+#define LL_SPI_DATAWIDTH_16BIT 0x00000F00U
+
+#define LL_SPI_POLARITY_LOW  0x00000000U
+#define LL_SPI_POLARITY_HIGH 0x00000002U
+
+#define LL_SPI_PHASE_1EDGE 0x00000000U
+#define LL_SPI_PHASE_2EDGE 0x00000001U
+
+#define LL_SPI_NSS_SOFT         0x00000200U
+#define LL_SPI_NSS_HARD_INPUT   0x00000000U
+#define LL_SPI_NSS_HARD_OUTPUT  0x00040000U
+
+#define LL_SPI_BAUDRATEPRESCALER_DIV2   0x00000000U
+#define LL_SPI_BAUDRATEPRESCALER_DIV4   0x00000008U
+#define LL_SPI_BAUDRATEPRESCALER_DIV8   0x00000010U
+#define LL_SPI_BAUDRATEPRESCALER_DIV16  0x00000018U
+#define LL_SPI_BAUDRATEPRESCALER_DIV32  0x00000020U
+#define LL_SPI_BAUDRATEPRESCALER_DIV64  0x00000028U
+#define LL_SPI_BAUDRATEPRESCALER_DIV128 0x00000030U
+#define LL_SPI_BAUDRATEPRESCALER_DIV256 0x00000038U
+
+#define LL_SPI_MSB_FIRST 0x00000000U
+#define LL_SPI_LSB_FIRST 0x00000080U
+
+#define LL_SPI_CRCCALCULATION_DISABLE 0x00000000U
+#define LL_SPI_CRCCALCULATION_ENABLE  0x00002000U
+
+#define LL_SPI_RX_FIFO_TH_HALF    0x00000000U
+#define LL_SPI_RX_FIFO_TH_QUARTER 0x00001000U
+
+#define LL_SPI_TX_FIFO_EMPTY 0x00000000U
+#define LL_SPI_RX_FIFO_EMPTY 0x00000000U
+
+typedef struct {
+    uint32_t TransferDirection;
+    uint32_t Mode;
+    uint32_t DataWidth;
+    uint32_t ClockPolarity;
+    uint32_t ClockPhase;
+    uint32_t NSS;
+    uint32_t BaudRate;
+    uint32_t BitOrder;
+    uint32_t CRCCalculation;
+    uint32_t CRCPoly;
+} LL_SPI_InitTypeDef;
+
+uint32_t LL_SPI_Init(SPI_TypeDef* spi, LL_SPI_InitTypeDef* init);
+void LL_SPI_Enable(SPI_TypeDef* spi);
+void LL_SPI_Disable(SPI_TypeDef* spi);
+uint32_t LL_SPI_IsEnabled(SPI_TypeDef* spi);
+void LL_SPI_SetRxFIFOThreshold(SPI_TypeDef* spi, uint32_t threshold);
+void LL_SPI_EnableDMAReq_RX(SPI_TypeDef* spi);
+void LL_SPI_DisableDMAReq_RX(SPI_TypeDef* spi);
+void LL_SPI_EnableDMAReq_TX(SPI_TypeDef* spi);
+void LL_SPI_DisableDMAReq_TX(SPI_TypeDef* spi);
+uint32_t LL_SPI_GetTxFIFOLevel(SPI_TypeDef* spi);
+uint32_t LL_SPI_GetRxFIFOLevel(SPI_TypeDef* spi);
+uint32_t LL_SPI_IsActiveFlag_BSY(SPI_TypeDef* spi);
+uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef* spi);
+uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef* spi);
+uint32_t LL_SPI_IsActiveFlag_OVR(SPI_TypeDef* spi);
+void LL_SPI_ClearFlag_OVR(SPI_TypeDef* spi);
+uint8_t LL_SPI_ReceiveData8(SPI_TypeDef* spi);
+void LL_SPI_TransmitData8(SPI_TypeDef* spi, uint8_t data);
+
+#ifdef __cplusplus
+}
+#endif
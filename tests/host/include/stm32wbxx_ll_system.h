@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stm32wbxx.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LL_SYSCFG_EXTI_PORTA 0U
+#define LL_SYSCFG_EXTI_LINE4 4U
+
+void LL_SYSCFG_SetEXTISource(uint32_t port, uint32_t line);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+// Minimal test framework of the host tests. A failed CHECK prints the location and ends the
+// test with a non-zero exit code.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if(!(condition)) {                                                                 \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            exit(EXIT_FAILURE);                                                            \
+        }                                                                                  \
+    } while(0)
+
+#define CHECK_EQ(actual, expected)                                                  \
+    do {                                                                            \
+        const long long check_actual = (long long)(actual);                         \
+        const long long check_expected = (long long)(expected);                     \
+        if(check_actual != check_expected) {                                        \
+            fprintf(                                                                \
+                stderr,                                                             \
+                "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n",                   \
+                __FILE__,                                                           \
+                __LINE__,                                                           \
+                #actual,                                                            \
+                #expected,                                                          \
+                check_actual,                                                       \
+                check_expected);                                                    \
+            exit(EXIT_FAILURE);                                                     \
+        }                                                                           \
+    } while(0)
+
+#define CHECK_MEM(actual, expected, length) CHECK(memcmp(actual, expected, length) == 0)
+
+#define RUN_TEST(test)                       \
+    do {                                     \
+        printf("%s\n", #test);               \
+        test();                              \
+    } while(0)
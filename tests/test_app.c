@@ -0,0 +1,62 @@
+#include "test_app.h"
+
+static bool test_app_custom_event_callback(void* context, uint32_t event) {
+    return flipper_spi_terminal_scene_terminal_on_event(
+        context, (SceneManagerEvent){.type = SceneManagerEventTypeCustom, .event = event});
+}
+
+FlipperSPITerminalApp* test_app_alloc(void) {
+    FlipperSPITerminalApp* app = calloc(1, sizeof(FlipperSPITerminalApp));
+    furi_check(app);
+
+    app->view_dispatcher = view_dispatcher_alloc();
+    view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
+    view_dispatcher_set_custom_event_callback(
+        app->view_dispatcher, test_app_custom_event_callback);
+
+    app->config.debug.debug_terminal_data = furi_string_alloc();
+    flipper_spi_terminal_config_defaults(&app->config);
+
+    flipper_spi_terminal_scene_terminal_alloc(app);
+    return app;
+}
+
+void test_app_free(FlipperSPITerminalApp* app) {
+    furi_check(app);
+    flipper_spi_terminal_scene_terminal_free(app);
+    furi_string_free(app->config.debug.debug_terminal_data);
+    view_dispatcher_free(app->view_dispatcher);
+    free(app);
+}
+
+static size_t test_app_capture_size(FlipperSPITerminalApp* app) {
+    size_t start;
+    size_t end;
+    terminal_view_get_capture_range(app->terminal_screen.view, &start, &end);
+    return end - start;
+}
+
+size_t test_app_wait_capture(FlipperSPITerminalApp* app, size_t length, uint32_t timeout_ms) {
+    const uint64_t deadline = host_time_ns() + timeout_ms * 1000000ULL;
+    while(test_app_capture_size(app) < length && host_time_ns() < deadline) {
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+    }
+    return test_app_capture_size(app);
+}
+
+size_t test_app_read_capture(FlipperSPITerminalApp* app, uint8_t* data, size_t length) {
+    size_t start;
+    size_t end;
+    terminal_view_get_capture_range(app->terminal_screen.view, &start, &end);
+
+    size_t read = 0;
+    while(start + read < end && read < length) {
+        const size_t copied = terminal_view_read_capture(
+            app->terminal_screen.view, start + read, data + read, length - read);
+        if(copied == 0) {
+            break;
+        }
+        read += copied;
+    }
+    return read;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// App fixture of the host tests. Only the Terminal Screen is allocated, the test thread acts as
+// the GUI thread and dispatches its custom events.
+
+#include "host.h"
+
+#include "../flipper_spi_terminal.h"
+#include "../flipper_spi_terminal_hw.h"
+#include "../scenes/scenes.h"
+
+FlipperSPITerminalApp* test_app_alloc(void);
+void test_app_free(FlipperSPITerminalApp* app);
+
+// Dispatches custom events, until the capture buffer of the Terminal Screen holds length bytes or
+// timeout_ms passed. Returns the number of bytes in the capture buffer.
+size_t test_app_wait_capture(FlipperSPITerminalApp* app, size_t length, uint32_t timeout_ms);
+// Copies the whole capture buffer to data. Returns the number of copied bytes.
+size_t test_app_read_capture(FlipperSPITerminalApp* app, uint8_t* data, size_t length);
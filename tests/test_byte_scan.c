@@ -0,0 +1,180 @@
+// Both variants of byte_scan against a byte by byte reference
+
+#include "test.h"
+
+#include <byte_scan.h>
+
+#include <stdbool.h>
+
+// See byte_scan_simd.c
+size_t byte_scan_simd_find(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_find_not(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_count(const uint8_t* data, size_t length, uint8_t value);
+size_t byte_scan_simd_match_length(const uint8_t* a, const uint8_t* b, size_t length);
+
+typedef struct {
+    size_t (*find)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*find_not)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*count)(const uint8_t* data, size_t length, uint8_t value);
+    size_t (*match_length)(const uint8_t* a, const uint8_t* b, size_t length);
+} TestByteScan;
+
+static const TestByteScan test_variants[] = {
+    {byte_scan_find, byte_scan_find_not, byte_scan_count, byte_scan_match_length},
+    {byte_scan_simd_find,
+     byte_scan_simd_find_not,
+     byte_scan_simd_count,
+     byte_scan_simd_match_length},
+};
+
+// Values with and without the high bit, next to each other and at the lane borders
+static const uint8_t test_values[] = {0x00, 0x01, 0x7F, 0x80, 0x81, 0xFE, 0xFF, 0x55};
+
+#define TEST_COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+#define TEST_MAX_LENGTH  70
+// Longer than the 255 words, after which the SIMD counters are flushed
+#define TEST_COUNT_LENGTH 3000
+
+static uint32_t test_seed = 1;
+
+static uint8_t test_random(void) {
+    test_seed = test_seed * 1103515245 + 12345;
+    return test_seed >> 16;
+}
+
+static size_t reference_find(const uint8_t* data, size_t length, uint8_t value, bool equal) {
+    size_t i = 0;
+    while(i < length && (data[i] == value) != equal) {
+        i++;
+    }
+    return i;
+}
+
+static size_t reference_count(const uint8_t* data, size_t length, uint8_t value) {
+    size_t count = 0;
+    for(size_t i = 0; i < length; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+static size_t reference_match_length(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    while(i < length && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+// Fills data with values, which are mostly the background and sometimes one of test_values
+static void test_fill(uint8_t* data, size_t length, uint8_t background) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] = (test_random() & 7) ? background : test_values[test_random() % 8];
+    }
+}
+
+// Every start alignment and length, with sparse and dense matches
+static void test_find(void) {
+    static uint8_t data[TEST_MAX_LENGTH + 3];
+    for(size_t v = 0; v < TEST_COUNT_OF(test_variants); v++) {
+        const TestByteScan* scan = &test_variants[v];
+        for(size_t round = 0; round < 200; round++) {
+            const uint8_t background = test_values[round % TEST_COUNT_OF(test_values)];
+            test_fill(data, sizeof(data), background);
+            for(size_t offset = 0; offset < 4; offset++) {
+                for(size_t length = 0; length + offset <= sizeof(data); length++) {
+                    const uint8_t* start = data + offset;
+                    for(size_t i = 0; i < TEST_COUNT_OF(test_values); i++) {
+                        const uint8_t value = test_values[i];
+                        CHECK_EQ(
+                            scan->find(start, length, value),
+                            reference_find(start, length, value, true));
+                        CHECK_EQ(
+                            scan->find_not(start, length, value),
+                            reference_find(start, length, value, false));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// A single different byte at every position
+static void test_find_single(void) {
+    static uint8_t data[TEST_MAX_LENGTH];
+    for(size_t v = 0; v < TEST_COUNT_OF(test_variants); v++) {
+        const TestByteScan* scan = &test_variants[v];
+        for(size_t i = 0; i < TEST_COUNT_OF(test_values); i++) {
+            const uint8_t value = test_values[i];
+            const uint8_t other = value ^ 0x80;
+            for(size_t position = 0; position < sizeof(data); position++) {
+                memset(data, other, sizeof(data));
+                data[position] = value;
+                CHECK_EQ(scan->find(data, sizeof(data), value), position);
+                CHECK_EQ(scan->find_not(data, sizeof(data), other), position);
+            }
+            memset(data, other, sizeof(data));
+            CHECK_EQ(scan->find(data, sizeof(data), value), sizeof(data));
+            CHECK_EQ(scan->find_not(data, sizeof(data), other), sizeof(data));
+        }
+    }
+}
+
+static void test_count(void) {
+    static uint8_t data[TEST_COUNT_LENGTH + 3];
+    for(size_t v = 0; v < TEST_COUNT_OF(test_variants); v++) {
+        const TestByteScan* scan = &test_variants[v];
+        for(size_t round = 0; round < 20; round++) {
+            const uint8_t background = test_values[round % TEST_COUNT_OF(test_values)];
+            test_fill(data, sizeof(data), background);
+            static const size_t lengths[] = {0, 1, 3, 4, 5, 63, 1020, 1021, 1024, 2047, 3000};
+            for(size_t offset = 0; offset < 4; offset++) {
+                for(size_t l = 0; l < TEST_COUNT_OF(lengths); l++) {
+                    for(size_t i = 0; i < TEST_COUNT_OF(test_values); i++) {
+                        const uint8_t value = test_values[i];
+                        CHECK_EQ(
+                            scan->count(data + offset, lengths[l], value),
+                            reference_count(data + offset, lengths[l], value));
+                    }
+                }
+            }
+        }
+
+        // Every lane counts to its limit
+        memset(data, 0xFF, sizeof(data));
+        CHECK_EQ(scan->count(data, TEST_COUNT_LENGTH, 0xFF), TEST_COUNT_LENGTH);
+        CHECK_EQ(scan->count(data, TEST_COUNT_LENGTH, 0x7F), 0);
+    }
+}
+
+static void test_match_length(void) {
+    static uint8_t a[TEST_MAX_LENGTH + 3];
+    static uint8_t b[TEST_MAX_LENGTH + 3];
+    for(size_t v = 0; v < TEST_COUNT_OF(test_variants); v++) {
+        const TestByteScan* scan = &test_variants[v];
+        for(size_t round = 0; round < 50; round++) {
+            test_fill(a, sizeof(a), test_values[round % TEST_COUNT_OF(test_values)]);
+            for(size_t position = 0; position <= TEST_MAX_LENGTH; position++) {
+                memcpy(b, a, sizeof(b));
+                if(position < TEST_MAX_LENGTH) {
+                    b[position] ^= test_values[round % 7 + 1];
+                }
+                for(size_t offset = 0; offset < 4; offset++) {
+                    for(size_t length = 0; length + offset <= sizeof(a); length += 5) {
+                        CHECK_EQ(
+                            scan->match_length(a + offset, b + offset, length),
+                            reference_match_length(a + offset, b + offset, length));
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_find);
+    RUN_TEST(test_find_single);
+    RUN_TEST(test_count);
+    RUN_TEST(test_match_length);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+// Capture files in memory: round trip, recovery of cut off files and frame gaps
+
+#include "test.h"
+
+#include <capture_file.h>
+
+#define TEST_CHUNK_SIZE   256
+#define TEST_STREAM_SIZE  (100 * 1024) // More than one segment
+#define TEST_MAX_FRAMES   4096
+#define TEST_MAX_STAMPS   1024
+#define TEST_MAX_FILE     (2 * TEST_STREAM_SIZE)
+#define TEST_COUNT_OF(a)  (sizeof(a) / sizeof((a)[0]))
+#define TEST_MIN(a, b)    ((a) < (b) ? (a) : (b))
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t position;
+} TestFile;
+
+static size_t test_file_read(void* context, void* data, size_t length) {
+    TestFile* file = context;
+    length = TEST_MIN(length, file->size - TEST_MIN(file->position, file->size));
+    memcpy(data, file->data + file->position, length);
+    file->position += length;
+    return length;
+}
+
+static size_t test_file_write(void* context, const void* data, size_t length) {
+    TestFile* file = context;
+    CHECK(file->size + length <= TEST_MAX_FILE);
+    memcpy(file->data + file->size, data, length);
+    file->size += length;
+    return length;
+}
+
+static bool test_file_seek(void* context, uint64_t offset) {
+    TestFile* file = context;
+    file->position = offset;
+    return offset <= file->size;
+}
+
+static uint64_t test_file_size(void* context) {
+    TestFile* file = context;
+    return file->size;
+}
+
+static CaptureFileIo test_file_io(TestFile* file) {
+    CaptureFileIo io = {
+        .context = file,
+        .read = test_file_read,
+        .write = test_file_write,
+        .seek = test_file_seek,
+        .size = test_file_size,
+    };
+    return io;
+}
+
+// What was written, as the reader has to return it
+typedef struct {
+    uint8_t data[TEST_STREAM_SIZE];
+    size_t length;
+    CaptureFileFrame frames[TEST_MAX_FRAMES];
+    size_t frame_count;
+    bool gap; // Before the next frame
+    CaptureFileTimestamp timestamps[TEST_MAX_STAMPS];
+    size_t timestamp_count;
+} TestCapture;
+
+static uint32_t test_seed = 1;
+
+static uint32_t test_random(uint32_t range) {
+    test_seed = test_seed * 1103515245 + 12345;
+    return (test_seed >> 8) % range;
+}
+
+// Same merging of empty frames as the writer: A gap at the position marks the last frame
+static void test_end_frame(CaptureFileWriter* writer, TestCapture* capture, bool gap) {
+    CHECK(capture_file_writer_end_frame(writer, gap));
+    const uint64_t start =
+        capture->frame_count > 0 ? capture->frames[capture->frame_count - 1].end : 0;
+    if(capture->length == start) {
+        capture->gap |= capture->frame_count > 0 && gap;
+        return;
+    }
+
+    CHECK(capture->frame_count < TEST_MAX_FRAMES);
+    CaptureFileFrame* frame = &capture->frames[capture->frame_count++];
+    frame->start = start;
+    frame->end = capture->length;
+    frame->gap = capture->gap;
+    capture->gap = gap;
+}
+
+static void test_write_capture(TestFile* file, TestCapture* capture) {
+    CaptureFileHeader header = {
+        .chunk_size = TEST_CHUNK_SIZE,
+        .frame_size = 1,
+        .clock_hz = 64000000,
+        .config_count = 3,
+        .config = {1, 2, 3},
+    };
+    const CaptureFileIo io = test_file_io(file);
+    CaptureFileWriter* writer = capture_file_writer_alloc(&io, &header);
+    CHECK(writer != NULL);
+
+    memset(capture, 0, sizeof(TestCapture));
+    while(capture->length < TEST_STREAM_SIZE) {
+        const size_t part = 1 + test_random(300);
+        const size_t length = TEST_MIN(part, TEST_STREAM_SIZE - capture->length);
+        for(size_t i = 0; i < length; i++) {
+            capture->data[capture->length + i] = test_random(256);
+        }
+        CHECK(capture_file_writer_write(writer, capture->data + capture->length, length));
+        capture->length += length;
+        CHECK_EQ(capture_file_writer_get_position(writer), capture->length);
+
+        test_end_frame(writer, capture, test_random(8) == 0);
+        if(test_random(16) == 0) {
+            test_end_frame(writer, capture, true); // Empty
+        }
+        if(capture->timestamp_count < TEST_MAX_STAMPS && test_random(2) == 0) {
+            CaptureFileTimestamp* timestamp = &capture->timestamps[capture->timestamp_count++];
+            timestamp->position = capture->length;
+            timestamp->time = capture->length * 3 + 7;
+            CHECK(capture_file_writer_add_timestamp(writer, timestamp->position, timestamp->time));
+        }
+    }
+
+    CHECK(capture_file_writer_finish(writer));
+    capture_file_writer_free(writer);
+}
+
+static void test_check_reader(CaptureFileReader* reader, const TestCapture* capture) {
+    const uint64_t length = capture_file_reader_get_length(reader);
+    CHECK(length <= capture->length);
+
+    static uint8_t data[TEST_STREAM_SIZE];
+    CHECK_EQ(capture_file_reader_read(reader, 0, data, length), length);
+    CHECK_MEM(data, capture->data, length);
+    for(size_t i = 0; i < 200 && length > 0; i++) {
+        const uint64_t offset = test_random(length);
+        const size_t part = test_random(2 * TEST_CHUNK_SIZE + 1);
+        const size_t expected = TEST_MIN(part, length - offset);
+        CHECK_EQ(capture_file_reader_read(reader, offset, data, part), expected);
+        CHECK_MEM(data, capture->data + offset, expected);
+    }
+    CHECK_EQ(capture_file_reader_read(reader, length, data, 1), 0);
+
+    // Frames and timestamps, which are there, are the written ones
+    const uint64_t frame_count = capture_file_reader_get_frame_count(reader);
+    CHECK(frame_count <= capture->frame_count);
+    for(uint64_t i = 0; i < frame_count; i++) {
+        CaptureFileFrame frame;
+        CHECK(capture_file_reader_get_frame(reader, i, &frame));
+        CHECK_EQ(frame.start, TEST_MIN(capture->frames[i].start, length));
+        CHECK_EQ(frame.end, TEST_MIN(capture->frames[i].end, length));
+        CHECK_EQ(frame.gap, capture->frames[i].gap);
+    }
+    CaptureFileFrame frame;
+    CHECK(!capture_file_reader_get_frame(reader, frame_count, &frame));
+
+    const uint64_t timestamp_count = capture_file_reader_get_timestamp_count(reader);
+    CHECK(timestamp_count <= capture->timestamp_count);
+    for(uint64_t i = 0; i < timestamp_count; i++) {
+        CaptureFileTimestamp timestamp;
+        CHECK(capture_file_reader_get_timestamp(reader, i, &timestamp));
+        CHECK_EQ(timestamp.position, capture->timestamps[i].position);
+        CHECK_EQ(timestamp.time, capture->timestamps[i].time);
+    }
+}
+
+static TestCapture test_capture;
+static uint8_t test_file_data[TEST_MAX_FILE];
+
+static void test_round_trip(void) {
+    TestFile file = {.data = test_file_data};
+    test_write_capture(&file, &test_capture);
+
+    const CaptureFileIo io = test_file_io(&file);
+    CaptureFileReader* reader = capture_file_reader_alloc(&io);
+    CHECK(reader != NULL);
+    CHECK(capture_file_reader_is_complete(reader));
+
+    const CaptureFileHeader* header = capture_file_reader_get_header(reader);
+    CHECK_EQ(header->chunk_size, TEST_CHUNK_SIZE);
+    CHECK_EQ(header->frame_size, 1);
+    CHECK_EQ(header->clock_hz, 64000000);
+    CHECK_EQ(header->config_count, 3);
+    CHECK_EQ(header->config[2], 3);
+
+    CHECK_EQ(capture_file_reader_get_length(reader), test_capture.length);
+    CHECK_EQ(capture_file_reader_get_frame_count(reader), test_capture.frame_count);
+    CHECK_EQ(capture_file_reader_get_timestamp_count(reader), test_capture.timestamp_count);
+    test_check_reader(reader, &test_capture);
+    capture_file_reader_free(reader);
+}
+
+// A file without trailer, e.g. after a power loss, keeps everything up to the cut
+static void test_truncated_recovery(void) {
+    TestFile file = {.data = test_file_data};
+    test_write_capture(&file, &test_capture);
+    const size_t size = file.size;
+
+    uint64_t previous_length = 0;
+    for(size_t cut = size - 1; cut > size / 2; cut -= 1 + test_random(997)) {
+        file.size = cut;
+        const CaptureFileIo io = test_file_io(&file);
+        CaptureFileReader* reader = capture_file_reader_alloc(&io);
+        CHECK(reader != NULL);
+        CHECK(!capture_file_reader_is_complete(reader));
+        test_check_reader(reader, &test_capture);
+
+        // The table follows the last data record
+        const uint64_t length = capture_file_reader_get_length(reader);
+        if(cut == size - 1) {
+            CHECK_EQ(length, test_capture.length);
+        }
+        CHECK(previous_length == 0 || length <= previous_length);
+        CHECK(length > 0);
+        previous_length = length;
+        capture_file_reader_free(reader);
+    }
+
+    // Only the header
+    file.size = 24 + 3 * 4;
+    const CaptureFileIo io = test_file_io(&file);
+    CaptureFileReader* reader = capture_file_reader_alloc(&io);
+    CHECK(reader != NULL);
+    CHECK_EQ(capture_file_reader_get_length(reader), 0);
+    CHECK_EQ(capture_file_reader_get_frame_count(reader), 0);
+    capture_file_reader_free(reader);
+
+    // No capture file
+    file.size = 10;
+    CHECK(capture_file_reader_alloc(&io) == NULL);
+}
+
+// Gaps mark the start of the next frame. Empty frames only add their gap.
+static void test_frame_gaps(void) {
+    TestFile file = {.data = test_file_data};
+    const CaptureFileHeader header = {.chunk_size = TEST_CHUNK_SIZE, .frame_size = 1};
+    const CaptureFileIo io = test_file_io(&file);
+    CaptureFileWriter* writer = capture_file_writer_alloc(&io, &header);
+    CHECK(writer != NULL);
+
+    const uint8_t data[10] = {0};
+    CHECK(capture_file_writer_end_frame(writer, true)); // Nothing to mark at the start
+    CHECK(capture_file_writer_write(writer, data, 4));
+    CHECK(capture_file_writer_end_frame(writer, false));
+    CHECK(capture_file_writer_end_frame(writer, true)); // Empty, marks the end of the first
+    CHECK(capture_file_writer_write(writer, data, 3));
+    CHECK(capture_file_writer_end_frame(writer, false));
+    CHECK(capture_file_writer_write(writer, data, 2));
+    CHECK(capture_file_writer_end_frame(writer, true));
+    CHECK(capture_file_writer_write(writer, data, 1)); // Ended by finish
+    CHECK(capture_file_writer_finish(writer));
+    capture_file_writer_free(writer);
+
+    CaptureFileReader* reader = capture_file_reader_alloc(&io);
+    CHECK(reader != NULL);
+    static const CaptureFileFrame expected[] = {
+        {.start = 0, .end = 4, .gap = false},
+        {.start = 4, .end = 7, .gap = true},
+        {.start = 7, .end = 9, .gap = false},
+        {.start = 9, .end = 10, .gap = true},
+    };
+    CHECK_EQ(capture_file_reader_get_frame_count(reader), TEST_COUNT_OF(expected));
+    for(size_t i = 0; i < TEST_COUNT_OF(expected); i++) {
+        CaptureFileFrame frame;
+        CHECK(capture_file_reader_get_frame(reader, i, &frame));
+        CHECK_EQ(frame.start, expected[i].start);
+        CHECK_EQ(frame.end, expected[i].end);
+        CHECK_EQ(frame.gap, expected[i].gap);
+    }
+    capture_file_reader_free(reader);
+}
+
+int main(void) {
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_truncated_recovery);
+    RUN_TEST(test_frame_gaps);
+    return EXIT_SUCCESS;
+}
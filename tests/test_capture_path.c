@@ -0,0 +1,433 @@
+// Runs the capture path from the RX DMA to the terminal view on the simulated DMA engine
+
+#include "test.h"
+#include "test_app.h"
+
+#define TEST_TIMEOUT_MS 2000
+
+static void test_fill_pattern(uint8_t* data, size_t length, uint32_t seed) {
+    for(size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+}
+
+static FlipperSPITerminalApp* test_enter(void (*configure)(FlipperSPITerminalAppConfig* config)) {
+    FlipperSPITerminalApp* app = test_app_alloc();
+    app->config.refresh_interval_ms = 1;
+    if(configure != NULL) {
+        configure(&app->config);
+    }
+    flipper_spi_terminal_scene_terminal_on_enter(app);
+    host_spi_reset_stats();
+    return app;
+}
+
+static void test_exit(FlipperSPITerminalApp* app) {
+    flipper_spi_terminal_scene_terminal_on_exit(app);
+    test_app_free(app);
+}
+
+// Sends length bytes in chunks and checks, that all of them arrive in the capture buffer
+static void test_receive(FlipperSPITerminalApp* app, size_t length, size_t chunk) {
+    uint8_t* sent = malloc(length);
+    uint8_t* captured = malloc(length);
+    test_fill_pattern(sent, length, length);
+
+    for(size_t offset = 0; offset < length; offset += chunk) {
+        const size_t part = MIN(chunk, length - offset);
+        CHECK_EQ(host_spi_receive(sent + offset, part), part);
+        CHECK_EQ(test_app_wait_capture(app, offset + part, TEST_TIMEOUT_MS), offset + part);
+    }
+
+    CHECK_EQ(test_app_read_capture(app, captured, length), length);
+    CHECK_MEM(captured, sent, length);
+    CHECK_EQ(app->terminal_screen.stats.bytes_received, length);
+    CHECK_EQ(app->terminal_screen.stats.bytes_dropped, 0);
+
+    HostSpiStats stats;
+    host_spi_get_stats(&stats);
+    CHECK_EQ(stats.frames_lost, 0);
+
+    free(captured);
+    free(sent);
+}
+
+static size_t test_rx_dma_buffer_size;
+
+static void test_configure_rx_dma_buffer_size(FlipperSPITerminalAppConfig* config) {
+    config->rx_dma_buffer_size = test_rx_dma_buffer_size;
+}
+
+// Every buffer size delivers complete halves from HT/TC and the rest with the idle flush
+static void test_stream_every_buffer_size(void) {
+    for(size_t i = 0; i < COUNT_OF(spi_config_rx_dma_buffer_size_values); i++) {
+        test_rx_dma_buffer_size = spi_config_rx_dma_buffer_size_values[i];
+        FlipperSPITerminalApp* app = test_enter(test_configure_rx_dma_buffer_size);
+        test_receive(app, 3000, 100);
+        test_exit(app);
+    }
+}
+
+static void test_configure_flush(FlipperSPITerminalAppConfig* config) {
+    config->display_mode = TerminalDisplayModeText;
+    config->rx_dma_buffer_size = 64;
+}
+
+// Returns false, if the flush timer still runs after timeout_ms
+static bool test_wait_flush_timer_stopped(FlipperSPITerminalApp* app, uint32_t timeout_ms) {
+    const uint64_t deadline = host_time_ns() + timeout_ms * 1000000ULL;
+    while(furi_timer_is_running(app->terminal_screen.flush_timer)) {
+        if(host_time_ns() >= deadline) {
+            return false;
+        }
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+    }
+    return true;
+}
+
+// The rest after the last DMA interrupt is delivered by the flush timer. Afterwards, the timer
+// stops on the idle bus.
+static void test_partial_half_is_flushed(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_flush);
+    CHECK(test_wait_flush_timer_stopped(app, TEST_TIMEOUT_MS));
+
+    uint8_t sent[100];
+    test_fill_pattern(sent, sizeof(sent), 1);
+    CHECK_EQ(host_spi_receive(sent, sizeof(sent)), sizeof(sent));
+    CHECK_EQ(test_app_wait_capture(app, sizeof(sent), TEST_TIMEOUT_MS), sizeof(sent));
+    CHECK_EQ(app->terminal_screen.stats.dma_half_events, 1);
+    CHECK(app->terminal_screen.stats.dma_flush_events > 0);
+
+    uint8_t captured[sizeof(sent)];
+    CHECK_EQ(test_app_read_capture(app, captured, sizeof(captured)), sizeof(sent));
+    CHECK_MEM(captured, sent, sizeof(sent));
+
+    CHECK(test_wait_flush_timer_stopped(app, TEST_TIMEOUT_MS));
+    furi_delay_ms(50);
+    CHECK(!furi_timer_is_running(app->terminal_screen.flush_timer));
+
+    test_exit(app);
+}
+
+// Less than a half never raises a DMA interrupt. A CS edge delivers it, also without CS framing.
+static void test_chip_select_wakes_idle_bus(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_flush);
+    CHECK(test_wait_flush_timer_stopped(app, TEST_TIMEOUT_MS));
+
+    const char* data = "Hello, DMA!";
+    host_gpio_set(SPI_TERM_CS_PIN, false);
+    CHECK_EQ(host_spi_receive(data, strlen(data)), strlen(data));
+    host_gpio_set(SPI_TERM_CS_PIN, true);
+    CHECK_EQ(test_app_wait_capture(app, strlen(data), TEST_TIMEOUT_MS), strlen(data));
+    CHECK_EQ(app->terminal_screen.stats.dma_half_events, 0);
+    CHECK_EQ(app->terminal_screen.stats.transactions, 0);
+
+    Canvas* canvas = host_canvas_alloc();
+    host_view_draw(terminal_view_get_view(app->terminal_screen.view), canvas);
+    CHECK(strstr(host_canvas_get_text(canvas), "Hello, DMA!") != NULL);
+    host_canvas_free(canvas);
+
+    test_exit(app);
+}
+
+static void test_configure_text(FlipperSPITerminalAppConfig* config) {
+    config->display_mode = TerminalDisplayModeText;
+}
+
+// A partial row is padded to the width of a full one, also without a separator between frames
+static void test_partial_row_width(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_text);
+    uint8_t sent[100];
+    memset(sent, 'A', sizeof(sent));
+    CHECK_EQ(host_spi_receive(sent, sizeof(sent)), sizeof(sent));
+    CHECK_EQ(test_app_wait_capture(app, sizeof(sent), TEST_TIMEOUT_MS), sizeof(sent));
+
+    Canvas* canvas = host_canvas_alloc();
+    host_view_draw(terminal_view_get_view(app->terminal_screen.view), canvas);
+    const char* text = host_canvas_get_text(canvas);
+    const size_t width = strcspn(text, "\n");
+    size_t rows = 0;
+    for(const char* line = text; *line != '\0'; rows++) {
+        const size_t length = strcspn(line, "\n");
+        CHECK_EQ(length, width);
+        line += length + (line[length] == '\n');
+    }
+    CHECK_EQ(rows, (sizeof(sent) + width - 1) / width);
+    host_canvas_free(canvas);
+    test_exit(app);
+}
+
+static void test_configure_huge_record(FlipperSPITerminalAppConfig* config) {
+    config->record_buffer_size = 1024 * 1024;
+}
+
+// A staging buffer, which does not fit into memory, turns recording off. The capture goes on.
+static void test_record_without_memory(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_huge_record);
+    CHECK(app->terminal_screen.record == NULL);
+    CHECK(app->terminal_screen.record_failed);
+    test_receive(app, 1000, 100);
+    test_exit(app);
+}
+
+static void test_configure_direct(FlipperSPITerminalAppConfig* config) {
+    config->ingest_mode = TerminalIngestModeDirect;
+    config->rx_dma_buffer_size = 256;
+}
+
+// The GUI thread copies straight out of the DMA buffer
+static void test_direct_ingest(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_direct);
+    test_receive(app, 3000, 200);
+    test_exit(app);
+}
+
+static void test_configure_half_word(FlipperSPITerminalAppConfig* config) {
+    config->spi.DataWidth = LL_SPI_DATAWIDTH_16BIT;
+    config->rx_dma_buffer_size = 16;
+}
+
+// Frames of 16 bit are moved as half-words and stored little endian
+static void test_half_word_frames(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_half_word);
+    CHECK_EQ(app->terminal_screen.frame_size, 2);
+    test_receive(app, 1000, 50);
+    test_exit(app);
+}
+
+static void test_configure_chip_select(FlipperSPITerminalAppConfig* config) {
+    config->framing_mode = TerminalFramingModeChipSelect;
+    config->spi.NSS = LL_SPI_NSS_SOFT;
+    config->display_mode = TerminalDisplayModeText;
+    config->rx_dma_buffer_size = 64;
+}
+
+// Every CS deassertion delivers the transaction right away and starts a new row
+static void test_chip_select_framing(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_chip_select);
+
+    host_gpio_set(SPI_TERM_CS_PIN, false);
+    host_spi_receive("first", 5);
+    host_gpio_set(SPI_TERM_CS_PIN, true);
+    host_gpio_set(SPI_TERM_CS_PIN, false);
+    host_spi_receive("second", 6);
+    host_gpio_set(SPI_TERM_CS_PIN, true);
+
+    CHECK_EQ(test_app_wait_capture(app, 11, TEST_TIMEOUT_MS), 11);
+    CHECK_EQ(app->terminal_screen.stats.transactions, 2);
+
+    Canvas* canvas = host_canvas_alloc();
+    host_view_draw(terminal_view_get_view(app->terminal_screen.view), canvas);
+    const char* text = host_canvas_get_text(canvas);
+    const char* first = strstr(text, "first");
+    CHECK(first != NULL);
+    CHECK(strstr(first, "\nsecond") != NULL);
+    host_canvas_free(canvas);
+
+    test_exit(app);
+}
+
+static void test_configure_master(FlipperSPITerminalAppConfig* config) {
+    config->spi.Mode = LL_SPI_MODE_MASTER;
+    config->spi.TransferDirection = LL_SPI_FULL_DUPLEX;
+    config->rx_dma_buffer_size = 8;
+}
+
+// In master mode, the TX DMA clocks in one frame per sent frame. The peer loops them back.
+static void test_master_loopback(void) {
+    FlipperSPITerminalApp* app = test_enter(test_configure_master);
+    CHECK(flipper_spi_terminal_tx_is_running(app->terminal_screen.tx));
+
+    uint8_t sent[300];
+    test_fill_pattern(sent, sizeof(sent), 7);
+    CHECK_EQ(flipper_spi_terminal_tx_write(app->terminal_screen.tx, sent, sizeof(sent), 100), 300);
+    while(host_spi_clock(64) > 0) {
+    }
+    CHECK(flipper_spi_terminal_tx_is_idle(app->terminal_screen.tx));
+
+    uint8_t captured[sizeof(sent)];
+    CHECK_EQ(test_app_wait_capture(app, sizeof(sent), TEST_TIMEOUT_MS), sizeof(sent));
+    CHECK_EQ(test_app_read_capture(app, captured, sizeof(captured)), sizeof(sent));
+    CHECK_MEM(captured, sent, sizeof(sent));
+
+    test_exit(app);
+}
+
+// Nothing is received, while the Terminal Screen is not active
+static void test_inactive_loses_frames(void) {
+    FlipperSPITerminalApp* app = test_app_alloc();
+    host_spi_reset_stats();
+    CHECK_EQ(host_spi_receive("lost", 4), 0);
+
+    HostSpiStats stats;
+    host_spi_get_stats(&stats);
+    CHECK_EQ(stats.frames_lost, 4);
+    test_app_free(app);
+}
+
+// A reset in the middle of a transaction must not leave its start behind the emptied buffer
+static void test_reset_with_open_transaction(void) {
+    TerminalView* view = terminal_view_alloc();
+    terminal_view_set_capture_size(view, 4096, 0);
+    terminal_view_set_display_mode(view, TerminalDisplayModeText);
+
+    terminal_view_append_data(view, (const uint8_t*)"abcdef", 6);
+    terminal_view_end_transaction(view);
+    terminal_view_append_data(view, (const uint8_t*)"gh", 2);
+    terminal_view_reset(view);
+    terminal_view_append_data(view, (const uint8_t*)"ij", 2);
+    terminal_view_end_transaction(view);
+    terminal_view_append_data(view, (const uint8_t*)"kl", 2);
+
+    Canvas* canvas = host_canvas_alloc();
+    host_view_draw(terminal_view_get_view(view), canvas);
+    const char* text = host_canvas_get_text(canvas);
+    CHECK(strstr(text, "abcdef") == NULL);
+    const char* first = strstr(text, "ij");
+    CHECK(first != NULL);
+    CHECK(strstr(first, "\nkl") != NULL);
+    host_canvas_free(canvas);
+
+    terminal_view_free(view);
+}
+
+// Injected data is moved to the capture by the DMA ISR. More than fits into both rings at once
+// arrives, since the GUI thread raises the IRQ again after making room.
+static void test_inject(void) {
+    FlipperSPITerminalApp* app = test_enter(NULL);
+    uint8_t sent[3000];
+    uint8_t captured[sizeof(sent)];
+    test_fill_pattern(sent, sizeof(sent), 7);
+
+    const uint64_t deadline = host_time_ns() + TEST_TIMEOUT_MS * 1000000ULL;
+    size_t offset = 0;
+    while(offset < sizeof(sent) && host_time_ns() < deadline) {
+        offset += flipper_spi_terminal_scene_terminal_inject(
+            app, sent + offset, sizeof(sent) - offset);
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+    }
+
+    CHECK_EQ(test_app_wait_capture(app, sizeof(sent), TEST_TIMEOUT_MS), sizeof(sent));
+    CHECK_EQ(test_app_read_capture(app, captured, sizeof(captured)), sizeof(sent));
+    CHECK_MEM(captured, sent, sizeof(sent));
+    CHECK_EQ(app->terminal_screen.stats.bytes_dropped, 0);
+    test_exit(app);
+}
+
+typedef struct {
+    FlipperSPITerminalApp* app;
+    size_t length;
+} TestInjectContext;
+
+static int32_t test_inject_thread(void* context) {
+    TestInjectContext* inject = context;
+    uint8_t data[64];
+    memset(data, 'i', sizeof(data));
+    const uint64_t deadline = host_time_ns() + TEST_TIMEOUT_MS * 1000000ULL;
+    for(size_t offset = 0; offset < inject->length && host_time_ns() < deadline;) {
+        const size_t queued = flipper_spi_terminal_scene_terminal_inject(
+            inject->app, data, MIN(sizeof(data), inject->length - offset));
+        offset += queued;
+        if(queued == 0) {
+            furi_delay_ms(1);
+        }
+    }
+    return 0;
+}
+
+// Received and injected data meet in the DMA ISR. Every byte is counted once, as captured or as
+// dropped.
+static void test_inject_while_receiving(void) {
+    FlipperSPITerminalApp* app = test_enter(NULL);
+    TestInjectContext inject = {.app = app, .length = 2000};
+    FuriThread* thread = furi_thread_alloc_ex("TestInject", 2048, test_inject_thread, &inject);
+    furi_thread_start(thread);
+
+    uint8_t sent[2000];
+    test_fill_pattern(sent, sizeof(sent), 11);
+    for(size_t offset = 0; offset < sizeof(sent); offset += 100) {
+        CHECK_EQ(host_spi_receive(sent + offset, 100), 100);
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+    }
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+
+    const size_t total = sizeof(sent) + inject.length;
+    const uint64_t deadline = host_time_ns() + TEST_TIMEOUT_MS * 1000000ULL;
+    while(app->terminal_screen.stats.bytes_received < total && host_time_ns() < deadline) {
+        host_view_dispatcher_dispatch(app->view_dispatcher, 1);
+    }
+    const size_t dropped = app->terminal_screen.stats.bytes_dropped;
+    CHECK_EQ(app->terminal_screen.stats.bytes_received, total);
+    CHECK_EQ(test_app_wait_capture(app, total - dropped, TEST_TIMEOUT_MS), total - dropped);
+    test_exit(app);
+}
+
+typedef struct {
+    TerminalView* view;
+    atomic_bool stop;
+    atomic_size_t reads; // Reads, which returned data
+} TestDumpContext;
+
+// Like `spi dump`, the stream positions restart with every new buffer
+static int32_t test_dump_thread(void* context) {
+    TestDumpContext* dump = context;
+    uint8_t data[1024];
+    while(!atomic_load(&dump->stop)) {
+        size_t start, end;
+        terminal_view_get_capture_range(dump->view, &start, &end);
+        const size_t read = terminal_view_read_capture(dump->view, start, data, sizeof(data));
+        for(size_t i = 0; i < read; i++) {
+            CHECK_EQ(data[i], (uint8_t)(start + i));
+        }
+        if(read > 0) {
+            atomic_fetch_add(&dump->reads, 1);
+        }
+    }
+    return 0;
+}
+
+// The app thread replaces the capture buffer on entering the Terminal Screen, while the CLI may
+// dump it
+static void test_dump_during_resize(void) {
+    TestDumpContext dump = {.view = terminal_view_alloc()};
+    atomic_init(&dump.stop, false);
+    atomic_init(&dump.reads, 0);
+    FuriThread* thread = furi_thread_alloc_ex("TestDump", 2048, test_dump_thread, &dump);
+    furi_thread_start(thread);
+
+    uint8_t pattern[256];
+    for(size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = i;
+    }
+    for(size_t i = 0; i < 1000 || atomic_load(&dump.reads) < 1000; i++) {
+        terminal_view_set_capture_size(dump.view, i % 2 ? 2048 : 4096, 0);
+        for(size_t j = 0; j < 8; j++) {
+            terminal_view_append_data(dump.view, pattern, sizeof(pattern));
+        }
+    }
+
+    atomic_store(&dump.stop, true);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    terminal_view_free(dump.view);
+}
+
+int main(void) {
+    RUN_TEST(test_partial_half_is_flushed);
+    RUN_TEST(test_chip_select_wakes_idle_bus);
+    RUN_TEST(test_stream_every_buffer_size);
+    RUN_TEST(test_record_without_memory);
+    RUN_TEST(test_partial_row_width);
+    RUN_TEST(test_direct_ingest);
+    RUN_TEST(test_half_word_frames);
+    RUN_TEST(test_chip_select_framing);
+    RUN_TEST(test_master_loopback);
+    RUN_TEST(test_inactive_loses_frames);
+    RUN_TEST(test_reset_with_open_transaction);
+    RUN_TEST(test_dump_during_resize);
+    RUN_TEST(test_inject);
+    RUN_TEST(test_inject_while_receiving);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+// The cycle clock has to count wraps of the 32 bit counter without being read in between
+
+#include "test.h"
+
+#include "host.h"
+
+#include <cycle_clock.h>
+#include <furi_hal_cortex.h>
+
+#define TEST_CYCLES_PER_MS (HOST_CPU_FREQUENCY / 1000ULL)
+
+// The clock advanced by about milliseconds. The host keeps running meanwhile.
+static void test_check_advanced(uint64_t from, uint64_t to, uint32_t milliseconds) {
+    CHECK(to >= from + milliseconds * TEST_CYCLES_PER_MS);
+    CHECK(to < from + (milliseconds + 1000) * TEST_CYCLES_PER_MS);
+}
+
+static void test_short_intervals(void) {
+    CycleClock clock;
+    cycle_clock_reset(&clock);
+
+    uint64_t last = cycle_clock_now(&clock);
+    for(size_t i = 0; i < 100; i++) {
+        host_time_skip_ms(700);
+        const uint64_t now = cycle_clock_now(&clock);
+        test_check_advanced(last, now, 700);
+        last = now;
+    }
+}
+
+// 70 s are more than one wrap at 64 MHz
+static void test_one_wrap_unobserved(void) {
+    CycleClock clock;
+    cycle_clock_reset(&clock);
+
+    const uint64_t start = cycle_clock_now(&clock);
+    host_time_skip_ms(70 * 1000);
+    test_check_advanced(start, cycle_clock_now(&clock), 70 * 1000);
+}
+
+static void test_many_wraps_unobserved(void) {
+    CycleClock clock;
+    cycle_clock_reset(&clock);
+
+    const uint64_t start = cycle_clock_now(&clock);
+    host_time_skip_ms(10 * 60 * 1000);
+    test_check_advanced(start, cycle_clock_now(&clock), 10 * 60 * 1000);
+}
+
+// A counter value, which was captured before the clock wrapped, is extended into the past
+static void test_extend_across_wrap(void) {
+    CycleClock clock;
+    cycle_clock_reset(&clock);
+
+    host_time_skip_ms(65 * 1000);
+    const uint32_t captured = DWT->CYCCNT;
+    const uint64_t captured_now = cycle_clock_now(&clock);
+    host_time_skip_ms(2 * 1000);
+    const uint64_t extended = cycle_clock_extend(&clock, captured);
+    CHECK(extended <= captured_now);
+    CHECK(captured_now - extended < TEST_CYCLES_PER_MS * 100);
+    CHECK_EQ((uint32_t)extended, captured);
+}
+
+int main(void) {
+    RUN_TEST(test_short_intervals);
+    RUN_TEST(test_one_wrap_unobserved);
+    RUN_TEST(test_many_wraps_unobserved);
+    RUN_TEST(test_extend_across_wrap);
+    return EXIT_SUCCESS;
+}
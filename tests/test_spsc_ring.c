@@ -0,0 +1,170 @@
+// Ring buffer of the capture path: wrap around, chunked storage, full and empty rings
+
+#include "test.h"
+
+#include <furi.h>
+#include <spsc_ring.h>
+
+static void test_fill_pattern(uint8_t* data, size_t length, size_t position) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] = (position + i) * 7;
+    }
+}
+
+static void test_empty_and_full(void) {
+    SpscRing* ring = spsc_ring_alloc(16);
+    uint8_t data[20];
+    SpscRingSpan spans[2];
+
+    CHECK_EQ(spsc_ring_capacity(ring), 16);
+    CHECK_EQ(spsc_ring_size(ring), 0);
+    CHECK_EQ(spsc_ring_free_space(ring), 16);
+    CHECK_EQ(spsc_ring_read(ring, data, sizeof(data)), 0);
+    CHECK_EQ(spsc_ring_peek_span(ring, 0, sizeof(data), spans), 0);
+
+    // The whole capacity is usable
+    test_fill_pattern(data, sizeof(data), 0);
+    CHECK_EQ(spsc_ring_write(ring, data, sizeof(data)), 16);
+    CHECK_EQ(spsc_ring_size(ring), 16);
+    CHECK_EQ(spsc_ring_free_space(ring), 0);
+    CHECK_EQ(spsc_ring_write(ring, data, 1), 0);
+    CHECK_EQ(spsc_ring_reserve(ring, 1, spans), 0);
+
+    uint8_t read[16];
+    CHECK_EQ(spsc_ring_read(ring, read, sizeof(read)), 16);
+    CHECK_MEM(read, data, sizeof(read));
+    CHECK_EQ(spsc_ring_size(ring), 0);
+    CHECK_EQ(spsc_ring_position(ring), 16);
+    CHECK_EQ(spsc_ring_end_position(ring), 16);
+
+    spsc_ring_reset(ring);
+    CHECK_EQ(spsc_ring_size(ring), 0);
+    CHECK_EQ(spsc_ring_end_position(ring), 0);
+    spsc_ring_free(ring);
+}
+
+// Odd sizes move the wrap point through every index
+static void test_wrap_around(void) {
+    SpscRing* ring = spsc_ring_alloc(16);
+    uint8_t data[11];
+    uint8_t read[11];
+    size_t position = 0;
+
+    for(size_t i = 0; i < 100; i++) {
+        test_fill_pattern(data, sizeof(data), position);
+        CHECK_EQ(spsc_ring_write(ring, data, sizeof(data)), sizeof(data));
+
+        // A range across the end of the storage is split into two spans
+        SpscRingSpan spans[2];
+        CHECK_EQ(spsc_ring_peek_span(ring, 0, sizeof(data), spans), sizeof(data));
+        const size_t first = MIN(sizeof(data), 16 - position % 16);
+        CHECK_EQ(spans[0].length, first);
+        CHECK_EQ(spans[1].length, sizeof(data) - first);
+        CHECK_MEM(spans[0].data, data, spans[0].length);
+        CHECK_MEM(spans[1].data, data + first, spans[1].length);
+
+        CHECK_EQ(spsc_ring_read(ring, read, sizeof(read)), sizeof(read));
+        CHECK_MEM(read, data, sizeof(read));
+        position += sizeof(data);
+    }
+
+    CHECK_EQ(spsc_ring_position(ring), position);
+    spsc_ring_free(ring);
+}
+
+// head and tail are free running and may overflow
+static void test_counter_overflow(void) {
+    SpscRing* ring = spsc_ring_alloc(16);
+    atomic_store(&ring->head, SIZE_MAX - 4);
+    atomic_store(&ring->tail, SIZE_MAX - 4);
+
+    uint8_t data[12];
+    uint8_t read[12];
+    test_fill_pattern(data, sizeof(data), 3);
+    CHECK_EQ(spsc_ring_write(ring, data, sizeof(data)), sizeof(data));
+    CHECK_EQ(spsc_ring_size(ring), sizeof(data));
+    CHECK_EQ(spsc_ring_free_space(ring), 16 - sizeof(data));
+
+    const size_t start = spsc_ring_position(ring);
+    CHECK(spsc_ring_contains(ring, start, sizeof(data)));
+    CHECK(!spsc_ring_contains(ring, start, sizeof(data) + 1));
+    CHECK(!spsc_ring_contains(ring, start - 1, 1));
+
+    CHECK_EQ(spsc_ring_read(ring, read, sizeof(read)), sizeof(read));
+    CHECK_MEM(read, data, sizeof(read));
+    CHECK_EQ(spsc_ring_position(ring), 7);
+    spsc_ring_free(ring);
+}
+
+// Spans of a chunked ring stop at the end of the second chunk
+static void test_chunked_spans(void) {
+    uint8_t storage[4][8];
+    uint8_t* chunks[4] = {storage[0], storage[1], storage[2], storage[3]};
+    SpscRing ring;
+    spsc_ring_init_chunked(&ring, chunks, 4, 8);
+    CHECK_EQ(spsc_ring_capacity(&ring), 32);
+
+    uint8_t data[32];
+    test_fill_pattern(data, sizeof(data), 0);
+    CHECK_EQ(spsc_ring_write(&ring, data, sizeof(data)), sizeof(data));
+    for(size_t i = 0; i < 4; i++) {
+        CHECK_MEM(storage[i], data + i * 8, 8);
+    }
+    spsc_ring_consume(&ring, 5);
+
+    SpscRingSpan spans[2];
+    CHECK_EQ(spsc_ring_peek_span(&ring, 0, 27, spans), 3 + 8);
+    CHECK(spans[0].data == storage[0] + 5);
+    CHECK_EQ(spans[0].length, 3);
+    CHECK(spans[1].data == storage[1]);
+    CHECK_EQ(spans[1].length, 8);
+
+    // Reading repeats the spans, until everything is copied
+    uint8_t read[27];
+    CHECK_EQ(spsc_ring_read(&ring, read, sizeof(read)), sizeof(read));
+    CHECK_MEM(read, data + 5, sizeof(read));
+
+    // Reserving wraps around into the first chunk and also stops after two chunks
+    CHECK_EQ(spsc_ring_free_space(&ring), 32);
+    CHECK_EQ(spsc_ring_reserve(&ring, 32, spans), 16);
+    CHECK(spans[0].data == storage[0]);
+    CHECK_EQ(spans[0].length, 8);
+    CHECK(spans[1].data == storage[1]);
+    CHECK_EQ(spans[1].length, 8);
+}
+
+// A reader next to the consumer addresses bytes by stream position
+static void test_peek_span_at(void) {
+    uint8_t storage[4][8];
+    uint8_t* chunks[4] = {storage[0], storage[1], storage[2], storage[3]};
+    SpscRing ring;
+    spsc_ring_init_chunked(&ring, chunks, 4, 8);
+
+    uint8_t data[40];
+    test_fill_pattern(data, sizeof(data), 0);
+    CHECK_EQ(spsc_ring_write(&ring, data, 30), 30);
+    spsc_ring_consume(&ring, 20);
+    CHECK_EQ(spsc_ring_write(&ring, data + 30, 10), 10);
+
+    SpscRingSpan spans[2];
+    CHECK_EQ(spsc_ring_peek_span_at(&ring, 19, 4, spans), 0);
+    CHECK_EQ(spsc_ring_peek_span_at(&ring, 40, 4, spans), 0);
+    CHECK_EQ(spsc_ring_peek_span_at(&ring, 30, 100, spans), 10);
+    CHECK_MEM(spans[0].data, data + 30, spans[0].length);
+    CHECK_MEM(spans[1].data, data + 30 + spans[0].length, spans[1].length);
+
+    CHECK(spsc_ring_contains(&ring, 20, 20));
+    CHECK(spsc_ring_contains(&ring, 40, 0));
+    CHECK(!spsc_ring_contains(&ring, 19, 2));
+    spsc_ring_consume(&ring, 1);
+    CHECK(!spsc_ring_contains(&ring, 20, 1));
+}
+
+int main(void) {
+    RUN_TEST(test_empty_and_full);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_counter_overflow);
+    RUN_TEST(test_chunked_spans);
+    RUN_TEST(test_peek_span_at);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,259 @@
+// Encoder and decoder of the `spi stream` frames, including damaged and interrupted streams
+
+#include "test.h"
+
+#include <stream_frame.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEST_MAX_FRAMES 16
+#define TEST_COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+#define TEST_MIN(a, b)   ((a) < (b) ? (a) : (b))
+
+typedef struct {
+    uint8_t type;
+    uint32_t sequence;
+    uint64_t timestamp;
+    uint8_t payload[STREAM_FRAME_MAX_PAYLOAD];
+    size_t length;
+} TestFrame;
+
+typedef struct {
+    uint8_t data[4096];
+    size_t length;
+} TestStream;
+
+static void test_put_frame(
+    TestStream* stream,
+    uint8_t type,
+    uint32_t sequence,
+    uint64_t timestamp,
+    size_t length) {
+    uint8_t* dst = stream->data + stream->length;
+    uint8_t* payload = stream_frame_begin(dst, type, sequence, timestamp, length);
+    for(size_t i = 0; i < length; i++) {
+        payload[i] = sequence * 31 + i;
+    }
+    stream->length += stream_frame_end(dst);
+    CHECK(stream->length <= sizeof(stream->data));
+}
+
+static void test_put_text(TestStream* stream, const char* text) {
+    memcpy(stream->data + stream->length, text, strlen(text));
+    stream->length += strlen(text);
+}
+
+// Feeds the stream in pieces of chunk bytes like the receiver, which drains buffered frames
+static size_t test_decode(
+    StreamFrameDecoder* decoder,
+    const TestStream* stream,
+    size_t chunk,
+    TestFrame* frames) {
+    size_t count = 0;
+    for(size_t start = 0; start < stream->length; start += chunk) {
+        const size_t length = TEST_MIN(chunk, stream->length - start);
+        size_t offset = 0;
+        bool complete = true;
+        while(offset < length || complete) {
+            StreamFrame frame;
+            offset += stream_frame_decoder_feed(
+                decoder, stream->data + start + offset, length - offset, &frame, &complete);
+            if(complete) {
+                CHECK(count < TEST_MAX_FRAMES);
+                frames[count].type = frame.type;
+                frames[count].sequence = frame.sequence;
+                frames[count].timestamp = frame.timestamp;
+                frames[count].length = frame.length;
+                memcpy(frames[count].payload, frame.payload, frame.length);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static void
+    test_check_frame(const TestFrame* frame, uint8_t type, uint32_t sequence, size_t length) {
+    CHECK_EQ(frame->type, type);
+    CHECK_EQ(frame->sequence, sequence);
+    CHECK_EQ(frame->timestamp, 0x123456789ULL * sequence);
+    CHECK_EQ(frame->length, length);
+    for(size_t i = 0; i < length; i++) {
+        CHECK_EQ(frame->payload[i], (uint8_t)(sequence * 31 + i));
+    }
+}
+
+static void test_encoding(void) {
+    uint8_t frame[STREAM_FRAME_OVERHEAD + 2];
+    uint8_t* payload =
+        stream_frame_begin(frame, StreamFrameTypeData, 0x01020304, 0x1122334455667788ULL, 2);
+    CHECK(payload == frame + STREAM_FRAME_HEADER_SIZE);
+    payload[0] = 0xAB;
+    payload[1] = 0xCD;
+    CHECK_EQ(stream_frame_end(frame), sizeof(frame));
+
+    static const uint8_t header[STREAM_FRAME_HEADER_SIZE] = {
+        0xA5, 0x5A, StreamFrameTypeData, 0, 2, 0, 0x04, 0x03, 0x02,
+        0x01, 0x88, 0x77, 0x66,          0x55, 0x44, 0x33, 0x22, 0x11};
+    CHECK_MEM(frame, header, sizeof(header));
+}
+
+static void test_round_trip_every_chunk_size(void) {
+    TestStream stream = {0};
+    test_put_frame(&stream, StreamFrameTypeStart, 0, 0, 16);
+    test_put_frame(&stream, StreamFrameTypeData, 1, 0x123456789ULL, STREAM_FRAME_MAX_PAYLOAD);
+    test_put_frame(&stream, StreamFrameTypeData, 2, 0x123456789ULL * 2, 0);
+    test_put_frame(&stream, StreamFrameTypeOverrun, 3, 0x123456789ULL * 3, 4);
+    test_put_frame(&stream, StreamFrameTypeEnd, 4, 0x123456789ULL * 4, 8);
+
+    static const size_t chunks[] = {1, 2, 7, STREAM_FRAME_HEADER_SIZE, 64, 1000, 4096};
+    for(size_t i = 0; i < TEST_COUNT_OF(chunks); i++) {
+        StreamFrameDecoder decoder;
+        stream_frame_decoder_init(&decoder);
+        TestFrame frames[TEST_MAX_FRAMES];
+        CHECK_EQ(test_decode(&decoder, &stream, chunks[i], frames), 5);
+        test_check_frame(&frames[0], StreamFrameTypeStart, 0, 16);
+        test_check_frame(&frames[1], StreamFrameTypeData, 1, STREAM_FRAME_MAX_PAYLOAD);
+        test_check_frame(&frames[2], StreamFrameTypeData, 2, 0);
+        test_check_frame(&frames[3], StreamFrameTypeOverrun, 3, 4);
+        test_check_frame(&frames[4], StreamFrameTypeEnd, 4, 8);
+        CHECK_EQ(decoder.skipped, 0);
+        CHECK_EQ(decoder.crc_errors, 0);
+    }
+}
+
+// The CLI prints text before and after the stream, it may contain the sync bytes
+static void test_text_is_skipped(void) {
+    TestStream stream = {0};
+    test_put_text(&stream, ">: spi stream\r\n\xA5\xA5 \xA5");
+    const size_t text = stream.length;
+    test_put_frame(&stream, StreamFrameTypeStart, 0, 0, 16);
+    test_put_frame(&stream, StreamFrameTypeEnd, 1, 0x123456789ULL, 8);
+
+    StreamFrameDecoder decoder;
+    stream_frame_decoder_init(&decoder);
+    TestFrame frames[TEST_MAX_FRAMES];
+    CHECK_EQ(test_decode(&decoder, &stream, 5, frames), 2);
+    test_check_frame(&frames[0], StreamFrameTypeStart, 0, 16);
+    test_check_frame(&frames[1], StreamFrameTypeEnd, 1, 8);
+    CHECK_EQ(decoder.skipped, text);
+    CHECK_EQ(decoder.crc_errors, 0);
+}
+
+static void test_crc_error_drops_frame(void) {
+    TestStream stream = {0};
+    test_put_frame(&stream, StreamFrameTypeData, 1, 0x123456789ULL, 100);
+    const size_t damaged = stream.length + STREAM_FRAME_HEADER_SIZE + 50;
+    test_put_frame(&stream, StreamFrameTypeData, 2, 0x123456789ULL * 2, 100);
+    test_put_frame(&stream, StreamFrameTypeData, 3, 0x123456789ULL * 3, 100);
+    stream.data[damaged] ^= 0x10;
+
+    StreamFrameDecoder decoder;
+    stream_frame_decoder_init(&decoder);
+    TestFrame frames[TEST_MAX_FRAMES];
+    CHECK_EQ(test_decode(&decoder, &stream, 33, frames), 2);
+    test_check_frame(&frames[0], StreamFrameTypeData, 1, 100);
+    test_check_frame(&frames[1], StreamFrameTypeData, 3, 100);
+    CHECK_EQ(decoder.crc_errors, 1);
+    CHECK_EQ(decoder.skipped, 100 + STREAM_FRAME_OVERHEAD);
+}
+
+// A frame is cut off, its claimed length swallows the following frames. They are found again by
+// the resync and have to be delivered from the buffer, even if the stream ends there.
+static void test_resync_after_cut_frame(void) {
+    TestStream stream = {0};
+    test_put_frame(&stream, StreamFrameTypeData, 1, 0x123456789ULL, 200);
+    const size_t cut = STREAM_FRAME_HEADER_SIZE + 10;
+    stream.length -= 200 + STREAM_FRAME_OVERHEAD - cut;
+    test_put_frame(&stream, StreamFrameTypeData, 2, 0x123456789ULL * 2, 20);
+    test_put_frame(&stream, StreamFrameTypeData, 3, 0x123456789ULL * 3, 20);
+    test_put_frame(&stream, StreamFrameTypeEnd, 4, 0x123456789ULL * 4, 8);
+    CHECK(stream.length < 200 + STREAM_FRAME_OVERHEAD);
+
+    static const size_t chunks[] = {1, 13, 4096};
+    for(size_t i = 0; i < TEST_COUNT_OF(chunks); i++) {
+        StreamFrameDecoder decoder;
+        stream_frame_decoder_init(&decoder);
+        TestFrame frames[TEST_MAX_FRAMES];
+        // The cut frame is only given up, once its claimed length arrived
+        CHECK_EQ(test_decode(&decoder, &stream, chunks[i], frames), 0);
+        CHECK_EQ(decoder.crc_errors, 0);
+    }
+
+    // Padding completes the claimed length, the CRC fails and the swallowed frames follow
+    const size_t padding = 200 + STREAM_FRAME_OVERHEAD - stream.length;
+    memset(stream.data + stream.length, 0, padding);
+    stream.length += padding;
+    for(size_t i = 0; i < TEST_COUNT_OF(chunks); i++) {
+        StreamFrameDecoder decoder;
+        stream_frame_decoder_init(&decoder);
+        TestFrame frames[TEST_MAX_FRAMES];
+        CHECK_EQ(test_decode(&decoder, &stream, chunks[i], frames), 3);
+        test_check_frame(&frames[0], StreamFrameTypeData, 2, 20);
+        test_check_frame(&frames[1], StreamFrameTypeData, 3, 20);
+        test_check_frame(&frames[2], StreamFrameTypeEnd, 4, 8);
+        CHECK_EQ(decoder.crc_errors, 1);
+        CHECK_EQ(decoder.skipped, cut + padding);
+    }
+}
+
+// A length above the maximum can not be a frame, the decoder does not wait for it
+static void test_resync_after_invalid_length(void) {
+    TestStream stream = {0};
+    test_put_frame(&stream, StreamFrameTypeData, 1, 0x123456789ULL, 4);
+    stream.data[4] = (STREAM_FRAME_MAX_PAYLOAD + 1) & 0xFF;
+    stream.data[5] = (STREAM_FRAME_MAX_PAYLOAD + 1) >> 8;
+    const size_t invalid = stream.length;
+    test_put_frame(&stream, StreamFrameTypeEnd, 2, 0x123456789ULL * 2, 8);
+
+    StreamFrameDecoder decoder;
+    stream_frame_decoder_init(&decoder);
+    TestFrame frames[TEST_MAX_FRAMES];
+    CHECK_EQ(test_decode(&decoder, &stream, 4096, frames), 1);
+    test_check_frame(&frames[0], StreamFrameTypeEnd, 2, 8);
+    CHECK_EQ(decoder.crc_errors, 0);
+    CHECK_EQ(decoder.skipped, invalid);
+}
+
+// Without calls with zero new bytes, frames buffered by a resync stay undelivered
+static void test_buffered_frames_need_drain(void) {
+    TestStream stream = {0};
+    test_put_frame(&stream, StreamFrameTypeData, 1, 0x123456789ULL, 40);
+    test_put_frame(&stream, StreamFrameTypeData, 2, 0x123456789ULL * 2, 8);
+    test_put_frame(&stream, StreamFrameTypeEnd, 3, 0x123456789ULL * 3, 8);
+    // The first frame swallows the rest of the stream
+    const size_t claimed = stream.length - STREAM_FRAME_OVERHEAD;
+    stream.data[4] = claimed;
+    stream.data[5] = claimed >> 8;
+
+    StreamFrameDecoder decoder;
+    stream_frame_decoder_init(&decoder);
+    StreamFrame frame;
+    bool complete;
+    CHECK_EQ(
+        stream_frame_decoder_feed(&decoder, stream.data, stream.length, &frame, &complete),
+        stream.length);
+    CHECK(complete);
+    CHECK_EQ(frame.sequence, 2);
+
+    CHECK_EQ(stream_frame_decoder_feed(&decoder, NULL, 0, &frame, &complete), 0);
+    CHECK(complete);
+    CHECK_EQ(frame.type, StreamFrameTypeEnd);
+    CHECK_EQ(frame.sequence, 3);
+
+    CHECK_EQ(stream_frame_decoder_feed(&decoder, NULL, 0, &frame, &complete), 0);
+    CHECK(!complete);
+    CHECK_EQ(decoder.crc_errors, 1);
+}
+
+int main(void) {
+    RUN_TEST(test_encoding);
+    RUN_TEST(test_round_trip_every_chunk_size);
+    RUN_TEST(test_text_is_skipped);
+    RUN_TEST(test_crc_error_drops_frame);
+    RUN_TEST(test_resync_after_cut_frame);
+    RUN_TEST(test_resync_after_invalid_length);
+    RUN_TEST(test_buffered_frames_need_drain);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#include "byte_scan.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+#define BYTE_SCAN_ONES  0x01010101UL
+#define BYTE_SCAN_HIGHS 0x80808080UL
+// Words, which are counted in byte lanes, before the lanes are added up. A lane holds up to 255.
+#define BYTE_SCAN_COUNT_WORDS 255
+
+// Unaligned loads are allowed on the Cortex-M4. memcpy compiles to a single LDR.
+static inline uint32_t byte_scan_load(const uint8_t* data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Sets the high bit of every byte lane of word, which equals the lane of pattern
+static inline uint32_t byte_scan_equal_lanes(uint32_t word, uint32_t pattern) {
+    const uint32_t x = word ^ pattern;
+#if defined(__ARM_FEATURE_SIMD32)
+    // GE is set for every lane, which is not 0. SEL picks 0 for those.
+    (void)__usub8(x, BYTE_SCAN_ONES);
+    return __sel(0, BYTE_SCAN_HIGHS);
+#else
+    // The high bit is set for every lane, which is not 0. No carry crosses a lane.
+    const uint32_t nonzero = ((x & ~BYTE_SCAN_HIGHS) + ~BYTE_SCAN_HIGHS) | x;
+    return ~nonzero & BYTE_SCAN_HIGHS;
+#endif
+}
+
+// Lanes are stored little endian, the lowest set lane is the first byte
+static inline size_t byte_scan_first_lane(uint32_t lanes) {
+    return __builtin_ctz(lanes) / 8;
+}
+
+static size_t byte_scan_find_lanes(const uint8_t* data, size_t length, uint8_t value, bool equal) {
+    const uint32_t pattern = value * BYTE_SCAN_ONES;
+    const uint32_t flip = equal ? 0 : BYTE_SCAN_HIGHS;
+
+    size_t i = 0;
+    for(; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) {
+        const uint32_t lanes = byte_scan_equal_lanes(byte_scan_load(data + i), pattern) ^ flip;
+        if(lanes != 0) {
+            return i + byte_scan_first_lane(lanes);
+        }
+    }
+
+    for(; i < length; i++) {
+        if((data[i] == value) == equal) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+size_t byte_scan_find(const uint8_t* data, size_t length, uint8_t value) {
+    return byte_scan_find_lanes(data, length, value, true);
+}
+
+size_t byte_scan_find_not(const uint8_t* data, size_t length, uint8_t value) {
+    return byte_scan_find_lanes(data, length, value, false);
+}
+
+size_t byte_scan_count(const uint8_t* data, size_t length, uint8_t value) {
+    const uint32_t pattern = value * BYTE_SCAN_ONES;
+    size_t count = 0;
+
+    size_t i = 0;
+    while(i + sizeof(uint32_t) <= length) {
+        // Four counters of one byte each. Flushed, before one of them can overflow.
+        uint32_t lanes = 0;
+        size_t words = (length - i) / sizeof(uint32_t);
+        if(words > BYTE_SCAN_COUNT_WORDS) {
+            words = BYTE_SCAN_COUNT_WORDS;
+        }
+        for(const size_t end = i + words * sizeof(uint32_t); i < end; i += sizeof(uint32_t)) {
+            lanes += byte_scan_equal_lanes(byte_scan_load(data + i), pattern) >> 7;
+        }
+        lanes = (lanes & 0x00FF00FFUL) + ((lanes >> 8) & 0x00FF00FFUL);
+        count += (lanes & 0xFFFF) + (lanes >> 16);
+    }
+
+    for(; i < length; i++) {
+        count += data[i] == value;
+    }
+
+    return count;
+}
+
+size_t byte_scan_match_length(const uint8_t* a, const uint8_t* b, size_t length) {
+    size_t i = 0;
+    for(; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) {
+        const uint32_t x = byte_scan_load(a + i) ^ byte_scan_load(b + i);
+        if(x != 0) {
+            return i + byte_scan_first_lane(x);
+        }
+    }
+
+    while(i < length && a[i] == b[i]) {
+        i++;
+    }
+
+    return i;
+}
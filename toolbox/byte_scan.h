@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Word at a time byte scanning. Four bytes are compared at once, on the Cortex-M4 with the SIMD
+// instructions USUB8 and SEL, elsewhere with portable bit tricks. Both give the same results.
+
+// Index of the first byte, which equals value. length, if there is none.
+size_t byte_scan_find(const uint8_t* data, size_t length, uint8_t value);
+// Index of the first byte, which differs from value. length, if there is none.
+size_t byte_scan_find_not(const uint8_t* data, size_t length, uint8_t value);
+// Number of bytes, which equal value
+size_t byte_scan_count(const uint8_t* data, size_t length, uint8_t value);
+// Number of equal bytes at the start of a and b, e.g. to match a prefix or compare images
+size_t byte_scan_match_length(const uint8_t* a, const uint8_t* b, size_t length);
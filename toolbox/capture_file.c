@@ -0,0 +1,863 @@
+#include "capture_file.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define CAPTURE_FILE_HEADER_SIZE       24 // Without the config values
+#define CAPTURE_FILE_TABLE_HEADER_SIZE 32
+#define CAPTURE_FILE_SEGMENT_SIZE      32 // Table entry
+#define CAPTURE_FILE_BLOCK_SIZE        32 // Index entry
+#define CAPTURE_FILE_FRAME_SIZE        8
+#define CAPTURE_FILE_TIMESTAMP_SIZE    16
+#define CAPTURE_FILE_SCRATCH_SIZE      (CAPTURE_FILE_RECORD_HEADER + CAPTURE_FILE_INDEX_SIZE)
+// Offset of a segment, which was recovered from a file without table. Its index is kept in memory.
+#define CAPTURE_FILE_SEGMENT_RECOVERED UINT64_MAX
+#define CAPTURE_FILE_NO_SEGMENT        SIZE_MAX
+
+// Side record of a segment
+typedef struct {
+    uint32_t type;
+    uint32_t count; // Entries
+    uint64_t offset; // File offset of the record
+    uint64_t first; // Number of the first entry
+    uint64_t base; // Frames: End of the previous frame with flags. Timestamps: First position.
+} CaptureFileBlock;
+
+typedef struct {
+    uint32_t chunk_count;
+    uint32_t block_count;
+    uint64_t chunk_offsets[CAPTURE_FILE_SEGMENT_CHUNKS]; // File offsets of the data records
+    CaptureFileBlock blocks[CAPTURE_FILE_SEGMENT_BLOCKS];
+} CaptureFileIndex;
+
+typedef struct {
+    uint64_t offset; // File offset of the index record
+    uint64_t first_chunk;
+    uint64_t first_frame; // Frames in the side records of the previous segments
+    uint64_t first_timestamp;
+} CaptureFileSegment;
+
+typedef struct {
+    CaptureFileSegment* segments;
+    size_t count;
+    size_t capacity;
+} CaptureFileSegments;
+
+// Entries of a side stream, which were not written yet
+typedef struct {
+    uint8_t data[CAPTURE_FILE_SIDE_BLOCK_SIZE];
+    size_t length;
+    uint64_t written; // Entries in previous records
+    uint64_t base; // See CaptureFileBlock
+} CaptureFileSide;
+
+struct CaptureFileWriter {
+    CaptureFileIo io;
+    CaptureFileHeader header;
+    bool failed;
+    uint64_t offset; // File offset of the next record
+    uint64_t position; // Stream position
+    uint8_t* chunk;
+    size_t chunk_length;
+    uint64_t frame_end; // End of the last frame with flags
+    CaptureFileSide frames;
+    CaptureFileSide timestamps;
+    CaptureFileIndex index; // Records of the current segment
+    CaptureFileSegment segment; // Current segment
+    CaptureFileSegments segments; // Written segments
+    uint8_t scratch[CAPTURE_FILE_SCRATCH_SIZE];
+};
+
+struct CaptureFileReader {
+    CaptureFileIo io;
+    CaptureFileHeader header;
+    uint32_t header_length;
+    bool complete;
+    uint64_t size; // Of the file
+    uint64_t length; // Of the stream
+    uint64_t chunk_count;
+    uint64_t frame_count;
+    uint64_t timestamp_count;
+    CaptureFileSegments segments;
+    CaptureFileIndex index; // Cached index record
+    size_t index_segment; // Segment of index, CAPTURE_FILE_NO_SEGMENT => none
+    CaptureFileIndex recovered; // Records after the last index record of a recovered file
+    uint8_t scratch[CAPTURE_FILE_SCRATCH_SIZE];
+};
+
+static void capture_file_put_u16(uint8_t* data, uint16_t value) {
+    data[0] = value;
+    data[1] = value >> 8;
+}
+
+static void capture_file_put_u32(uint8_t* data, uint32_t value) {
+    capture_file_put_u16(data, value);
+    capture_file_put_u16(data + 2, value >> 16);
+}
+
+static void capture_file_put_u64(uint8_t* data, uint64_t value) {
+    capture_file_put_u32(data, value);
+    capture_file_put_u32(data + 4, value >> 32);
+}
+
+static uint16_t capture_file_get_u16(const uint8_t* data) {
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t capture_file_get_u32(const uint8_t* data) {
+    return capture_file_get_u16(data) | ((uint32_t)capture_file_get_u16(data + 2) << 16);
+}
+
+static uint64_t capture_file_get_u64(const uint8_t* data) {
+    return capture_file_get_u32(data) | ((uint64_t)capture_file_get_u32(data + 4) << 32);
+}
+
+static bool
+    capture_file_add_segment(CaptureFileSegments* segments, const CaptureFileSegment* segment) {
+    if(segments->count == segments->capacity) {
+        const size_t capacity = segments->capacity > 0 ? segments->capacity * 2 : 8;
+        CaptureFileSegment* resized =
+            realloc(segments->segments, capacity * sizeof(CaptureFileSegment));
+        if(resized == NULL) {
+            return false;
+        }
+        segments->segments = resized;
+        segments->capacity = capacity;
+    }
+
+    segments->segments[segments->count++] = *segment;
+    return true;
+}
+
+static uint64_t capture_file_segment_first(const CaptureFileSegment* segment, uint32_t type) {
+    switch(type) {
+    case CaptureFileRecordFrames:
+        return segment->first_frame;
+    case CaptureFileRecordTimestamps:
+        return segment->first_timestamp;
+    default:
+        return segment->first_chunk;
+    }
+}
+
+static bool
+    capture_file_writer_output(CaptureFileWriter* writer, const void* data, size_t length) {
+    if(!writer->failed && writer->io.write(writer->io.context, data, length) != length) {
+        writer->failed = true;
+    }
+    writer->offset += length;
+    return !writer->failed;
+}
+
+static void capture_file_writer_record_header(
+    CaptureFileWriter* writer,
+    uint32_t type,
+    uint32_t length) {
+    uint8_t header[CAPTURE_FILE_RECORD_HEADER];
+    capture_file_put_u32(header, type);
+    capture_file_put_u32(header + 4, length);
+    capture_file_writer_output(writer, header, sizeof(header));
+}
+
+static void capture_file_writer_record(
+    CaptureFileWriter* writer,
+    uint32_t type,
+    const void* payload,
+    uint32_t length) {
+    capture_file_writer_record_header(writer, type, length);
+    capture_file_writer_output(writer, payload, length);
+}
+
+// Ends the current segment with its index record
+static void capture_file_writer_write_index(CaptureFileWriter* writer) {
+    CaptureFileIndex* index = &writer->index;
+    if(index->chunk_count == 0 && index->block_count == 0) {
+        return;
+    }
+
+    writer->segment.offset = writer->offset;
+    if(!capture_file_add_segment(&writer->segments, &writer->segment)) {
+        writer->failed = true;
+    }
+
+    uint8_t* data = writer->scratch;
+    capture_file_put_u32(data, index->chunk_count);
+    capture_file_put_u32(data + 4, index->block_count);
+    size_t length = 8;
+    for(uint32_t i = 0; i < index->chunk_count; i++, length += 8) {
+        capture_file_put_u64(data + length, index->chunk_offsets[i]);
+    }
+    for(uint32_t i = 0; i < index->block_count; i++, length += CAPTURE_FILE_BLOCK_SIZE) {
+        const CaptureFileBlock* block = &index->blocks[i];
+        capture_file_put_u32(data + length, block->type);
+        capture_file_put_u32(data + length + 4, block->count);
+        capture_file_put_u64(data + length + 8, block->offset);
+        capture_file_put_u64(data + length + 16, block->first);
+        capture_file_put_u64(data + length + 24, block->base);
+    }
+    capture_file_writer_record(writer, CaptureFileRecordIndex, data, length);
+
+    writer->segment.first_chunk += index->chunk_count;
+    writer->segment.first_frame = writer->frames.written;
+    writer->segment.first_timestamp = writer->timestamps.written;
+    index->chunk_count = 0;
+    index->block_count = 0;
+}
+
+static void capture_file_writer_write_chunk(CaptureFileWriter* writer) {
+    CaptureFileIndex* index = &writer->index;
+    if(writer->chunk_length == 0) {
+        return;
+    }
+
+    index->chunk_offsets[index->chunk_count++] = writer->offset;
+    capture_file_writer_record(
+        writer, CaptureFileRecordData, writer->chunk, writer->chunk_length);
+    writer->chunk_length = 0;
+
+    if(index->chunk_count == CAPTURE_FILE_SEGMENT_CHUNKS) {
+        capture_file_writer_write_index(writer);
+    }
+}
+
+static void capture_file_writer_write_side(
+    CaptureFileWriter* writer,
+    CaptureFileSide* side,
+    uint32_t type,
+    size_t entry_size) {
+    CaptureFileIndex* index = &writer->index;
+    if(side->length == 0) {
+        return;
+    }
+
+    CaptureFileBlock* block = &index->blocks[index->block_count++];
+    block->type = type;
+    block->count = side->length / entry_size;
+    block->offset = writer->offset;
+    block->first = side->written;
+    block->base = side->base;
+    capture_file_writer_record(writer, type, side->data, side->length);
+    side->written += block->count;
+    side->length = 0;
+
+    if(index->block_count == CAPTURE_FILE_SEGMENT_BLOCKS) {
+        capture_file_writer_write_index(writer);
+    }
+}
+
+// Returns room for one entry. A full side record is written first.
+static uint8_t* capture_file_writer_add_entry(
+    CaptureFileWriter* writer,
+    CaptureFileSide* side,
+    uint32_t type,
+    size_t entry_size,
+    uint64_t base) {
+    if(side->length + entry_size > CAPTURE_FILE_SIDE_BLOCK_SIZE) {
+        capture_file_writer_write_side(writer, side, type, entry_size);
+    }
+    if(side->length == 0) {
+        side->base = base;
+    }
+
+    uint8_t* entry = side->data + side->length;
+    side->length += entry_size;
+    return entry;
+}
+
+CaptureFileWriter*
+    capture_file_writer_alloc(const CaptureFileIo* io, const CaptureFileHeader* header) {
+    if(header->chunk_size == 0 || header->config_count > CaptureFileConfigCount) {
+        return NULL;
+    }
+
+    CaptureFileWriter* writer = malloc(sizeof(CaptureFileWriter));
+    if(writer == NULL) {
+        return NULL;
+    }
+    memset(writer, 0, sizeof(CaptureFileWriter));
+    writer->io = *io;
+    writer->header = *header;
+    writer->chunk = malloc(header->chunk_size);
+
+    uint8_t* data = writer->scratch;
+    const size_t length = CAPTURE_FILE_HEADER_SIZE + header->config_count * sizeof(uint32_t);
+    capture_file_put_u32(data, CAPTURE_FILE_MAGIC);
+    capture_file_put_u16(data + 4, CAPTURE_FILE_VERSION);
+    capture_file_put_u16(data + 6, length);
+    capture_file_put_u32(data + 8, header->chunk_size);
+    capture_file_put_u32(data + 12, header->frame_size);
+    capture_file_put_u32(data + 16, header->clock_hz);
+    capture_file_put_u32(data + 20, header->config_count);
+    for(uint32_t i = 0; i < header->config_count; i++) {
+        capture_file_put_u32(data + CAPTURE_FILE_HEADER_SIZE + i * 4, header->config[i]);
+    }
+
+    if(writer->chunk == NULL || !capture_file_writer_output(writer, data, length)) {
+        capture_file_writer_free(writer);
+        return NULL;
+    }
+
+    writer->segment.offset = writer->offset;
+    return writer;
+}
+
+void capture_file_writer_free(CaptureFileWriter* writer) {
+    free(writer->segments.segments);
+    free(writer->chunk);
+    free(writer);
+}
+
+bool capture_file_writer_write(CaptureFileWriter* writer, const void* data, size_t length) {
+    const uint8_t* bytes = data;
+
+    while(length > 0) {
+        const size_t part = MIN(length, writer->header.chunk_size - writer->chunk_length);
+        memcpy(writer->chunk + writer->chunk_length, bytes, part);
+        writer->chunk_length += part;
+        writer->position += part;
+        bytes += part;
+        length -= part;
+
+        if(writer->chunk_length == writer->header.chunk_size) {
+            capture_file_writer_write_chunk(writer);
+        }
+    }
+
+    return !writer->failed;
+}
+
+bool capture_file_writer_end_frame(CaptureFileWriter* writer, bool gap) {
+    const uint64_t flags = gap ? CAPTURE_FILE_FRAME_GAP : 0;
+
+    if(writer->position == (writer->frame_end & CAPTURE_FILE_FRAME_POSITION)) {
+        // Empty frame. The last entry is always buffered, except at the start of the stream.
+        if(writer->frames.length > 0) {
+            writer->frame_end |= flags;
+            capture_file_put_u64(
+                writer->frames.data + writer->frames.length - CAPTURE_FILE_FRAME_SIZE,
+                writer->frame_end);
+        }
+        return !writer->failed;
+    }
+
+    uint8_t* entry = capture_file_writer_add_entry(
+        writer,
+        &writer->frames,
+        CaptureFileRecordFrames,
+        CAPTURE_FILE_FRAME_SIZE,
+        writer->frame_end);
+    writer->frame_end = writer->position | flags;
+    capture_file_put_u64(entry, writer->frame_end);
+
+    return !writer->failed;
+}
+
+bool capture_file_writer_add_timestamp(
+    CaptureFileWriter* writer,
+    uint64_t position,
+    uint64_t time) {
+    uint8_t* entry = capture_file_writer_add_entry(
+        writer,
+        &writer->timestamps,
+        CaptureFileRecordTimestamps,
+        CAPTURE_FILE_TIMESTAMP_SIZE,
+        position);
+    capture_file_put_u64(entry, position);
+    capture_file_put_u64(entry + 8, time);
+
+    return !writer->failed;
+}
+
+uint64_t capture_file_writer_get_position(CaptureFileWriter* writer) {
+    return writer->position;
+}
+
+bool capture_file_writer_finish(CaptureFileWriter* writer) {
+    capture_file_writer_end_frame(writer, false);
+    capture_file_writer_write_chunk(writer);
+    capture_file_writer_write_side(
+        writer, &writer->frames, CaptureFileRecordFrames, CAPTURE_FILE_FRAME_SIZE);
+    capture_file_writer_write_side(
+        writer, &writer->timestamps, CaptureFileRecordTimestamps, CAPTURE_FILE_TIMESTAMP_SIZE);
+    capture_file_writer_write_index(writer);
+
+    const uint64_t table = writer->offset;
+    const CaptureFileSegments* segments = &writer->segments;
+    uint8_t* data = writer->scratch;
+    capture_file_writer_record_header(
+        writer,
+        CaptureFileRecordTable,
+        CAPTURE_FILE_TABLE_HEADER_SIZE + segments->count * CAPTURE_FILE_SEGMENT_SIZE);
+    capture_file_put_u64(data, writer->position);
+    capture_file_put_u64(data + 8, writer->frames.written);
+    capture_file_put_u64(data + 16, writer->timestamps.written);
+    capture_file_put_u32(data + 24, segments->count);
+    capture_file_put_u32(data + 28, 0);
+    capture_file_writer_output(writer, data, CAPTURE_FILE_TABLE_HEADER_SIZE);
+
+    // Written in batches, which fit into scratch
+    size_t length = 0;
+    for(size_t i = 0; i < segments->count; i++) {
+        const CaptureFileSegment* segment = &segments->segments[i];
+        capture_file_put_u64(data + length, segment->offset);
+        capture_file_put_u64(data + length + 8, segment->first_chunk);
+        capture_file_put_u64(data + length + 16, segment->first_frame);
+        capture_file_put_u64(data + length + 24, segment->first_timestamp);
+        length += CAPTURE_FILE_SEGMENT_SIZE;
+        if(length + CAPTURE_FILE_SEGMENT_SIZE > CAPTURE_FILE_SCRATCH_SIZE) {
+            capture_file_writer_output(writer, data, length);
+            length = 0;
+        }
+    }
+    capture_file_writer_output(writer, data, length);
+
+    capture_file_put_u64(data, table);
+    capture_file_put_u32(data + 8, CAPTURE_FILE_TRAILER_MAGIC);
+    capture_file_put_u32(data + 12, 0);
+    return capture_file_writer_output(writer, data, CAPTURE_FILE_TRAILER_SIZE);
+}
+
+static bool capture_file_reader_read_at(
+    CaptureFileReader* reader,
+    uint64_t offset,
+    void* data,
+    size_t length) {
+    return reader->io.seek(reader->io.context, offset) &&
+           reader->io.read(reader->io.context, data, length) == length;
+}
+
+static bool capture_file_reader_read_header(CaptureFileReader* reader) {
+    CaptureFileHeader* header = &reader->header;
+    uint8_t* data = reader->scratch;
+
+    if(!capture_file_reader_read_at(reader, 0, data, CAPTURE_FILE_HEADER_SIZE) ||
+       capture_file_get_u32(data) != CAPTURE_FILE_MAGIC ||
+       capture_file_get_u16(data + 4) != CAPTURE_FILE_VERSION) {
+        return false;
+    }
+
+    reader->header_length = capture_file_get_u16(data + 6);
+    header->chunk_size = capture_file_get_u32(data + 8);
+    header->frame_size = capture_file_get_u32(data + 12);
+    header->clock_hz = capture_file_get_u32(data + 16);
+    const uint32_t config_count = capture_file_get_u32(data + 20);
+    if(header->chunk_size == 0 ||
+       reader->header_length < CAPTURE_FILE_HEADER_SIZE + (uint64_t)config_count * 4) {
+        return false;
+    }
+
+    header->config_count = MIN(config_count, (uint32_t)CaptureFileConfigCount);
+    if(!capture_file_reader_read_at(
+           reader, CAPTURE_FILE_HEADER_SIZE, data, header->config_count * sizeof(uint32_t))) {
+        return false;
+    }
+    for(uint32_t i = 0; i < header->config_count; i++) {
+        header->config[i] = capture_file_get_u32(data + i * 4);
+    }
+
+    return true;
+}
+
+// Reads the table via the trailer. Fails on a unfinished file.
+static bool capture_file_reader_read_table(CaptureFileReader* reader) {
+    uint8_t* data = reader->scratch;
+    const uint64_t size = reader->size;
+
+    if(size < reader->header_length + CAPTURE_FILE_TRAILER_SIZE ||
+       !capture_file_reader_read_at(
+           reader, size - CAPTURE_FILE_TRAILER_SIZE, data, CAPTURE_FILE_TRAILER_SIZE) ||
+       capture_file_get_u32(data + 8) != CAPTURE_FILE_TRAILER_MAGIC) {
+        return false;
+    }
+
+    const uint64_t table = capture_file_get_u64(data);
+    const size_t length = CAPTURE_FILE_RECORD_HEADER + CAPTURE_FILE_TABLE_HEADER_SIZE;
+    if(table < reader->header_length || table + length > size - CAPTURE_FILE_TRAILER_SIZE ||
+       !capture_file_reader_read_at(reader, table, data, length) ||
+       capture_file_get_u32(data) != CaptureFileRecordTable) {
+        return false;
+    }
+
+    const uint32_t count = capture_file_get_u32(data + 32);
+    if(capture_file_get_u32(data + 4) !=
+       CAPTURE_FILE_TABLE_HEADER_SIZE + (uint64_t)count * CAPTURE_FILE_SEGMENT_SIZE) {
+        return false;
+    }
+    reader->length = capture_file_get_u64(data + 8);
+    reader->frame_count = capture_file_get_u64(data + 16);
+    reader->timestamp_count = capture_file_get_u64(data + 24);
+
+    // Read in batches, which fit into scratch
+    const size_t batch = CAPTURE_FILE_SCRATCH_SIZE / CAPTURE_FILE_SEGMENT_SIZE;
+    for(uint32_t i = 0; i < count; i += batch) {
+        const size_t entries = MIN(count - i, batch);
+        const uint64_t offset = table + length + (uint64_t)i * CAPTURE_FILE_SEGMENT_SIZE;
+        if(!capture_file_reader_read_at(
+               reader, offset, data, entries * CAPTURE_FILE_SEGMENT_SIZE)) {
+            return false;
+        }
+
+        for(size_t j = 0; j < entries; j++) {
+            const uint8_t* entry = data + j * CAPTURE_FILE_SEGMENT_SIZE;
+            const CaptureFileSegment segment = {
+                .offset = capture_file_get_u64(entry),
+                .first_chunk = capture_file_get_u64(entry + 8),
+                .first_frame = capture_file_get_u64(entry + 16),
+                .first_timestamp = capture_file_get_u64(entry + 24),
+            };
+            if(!capture_file_add_segment(&reader->segments, &segment)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Rebuilds the table of a unfinished file from the records. The records after the last index
+// record form a segment, which is kept in memory. Stops at the first damaged record.
+static bool capture_file_reader_recover(CaptureFileReader* reader) {
+    CaptureFileIndex* tail = &reader->recovered;
+    const uint32_t chunk_size = reader->header.chunk_size;
+    uint8_t* data = reader->scratch;
+
+    reader->segments.count = 0;
+    reader->length = 0;
+    reader->chunk_count = 0;
+    reader->frame_count = 0;
+    reader->timestamp_count = 0;
+    memset(tail, 0, sizeof(CaptureFileIndex));
+
+    CaptureFileSegment segment = {0};
+    uint64_t frame_end = 0;
+    uint64_t offset = reader->header_length;
+    while(offset + CAPTURE_FILE_RECORD_HEADER <= reader->size &&
+          capture_file_reader_read_at(reader, offset, data, CAPTURE_FILE_RECORD_HEADER)) {
+        const uint32_t type = capture_file_get_u32(data);
+        uint64_t length = capture_file_get_u32(data + 4);
+        const uint64_t payload = offset + CAPTURE_FILE_RECORD_HEADER;
+        const bool truncated = payload + length > reader->size;
+
+        if(type == CaptureFileRecordData) {
+            // A cut off data record is the last one and keeps the bytes, which are there
+            length = MIN(length, reader->size - payload);
+            if(tail->chunk_count == CAPTURE_FILE_SEGMENT_CHUNKS || length > chunk_size ||
+               reader->length % chunk_size != 0) {
+                break;
+            }
+            tail->chunk_offsets[tail->chunk_count++] = offset;
+            reader->length += length;
+            reader->chunk_count++;
+        } else if(truncated) {
+            break;
+        } else if(type == CaptureFileRecordFrames || type == CaptureFileRecordTimestamps) {
+            const bool frames = type == CaptureFileRecordFrames;
+            const size_t entry_size = frames ? CAPTURE_FILE_FRAME_SIZE :
+                                               CAPTURE_FILE_TIMESTAMP_SIZE;
+            if(tail->block_count == CAPTURE_FILE_SEGMENT_BLOCKS || length == 0 ||
+               length % entry_size != 0) {
+                break;
+            }
+
+            CaptureFileBlock* block = &tail->blocks[tail->block_count++];
+            block->type = type;
+            block->count = length / entry_size;
+            block->offset = offset;
+            if(frames) {
+                // The base of the next record is the last entry of this one
+                if(!capture_file_reader_read_at(
+                       reader, payload + length - CAPTURE_FILE_FRAME_SIZE, data, 8)) {
+                    break;
+                }
+                block->first = reader->frame_count;
+                block->base = frame_end;
+                frame_end = capture_file_get_u64(data);
+                reader->frame_count += block->count;
+            } else {
+                if(!capture_file_reader_read_at(reader, payload, data, 8)) {
+                    break;
+                }
+                block->first = reader->timestamp_count;
+                block->base = capture_file_get_u64(data);
+                reader->timestamp_count += block->count;
+            }
+        } else if(type == CaptureFileRecordIndex) {
+            segment.offset = offset;
+            if(!capture_file_add_segment(&reader->segments, &segment)) {
+                return false;
+            }
+            segment.first_chunk = reader->chunk_count;
+            segment.first_frame = reader->frame_count;
+            segment.first_timestamp = reader->timestamp_count;
+            memset(tail, 0, sizeof(CaptureFileIndex));
+        } else if(type == CaptureFileRecordTable) {
+            break;
+        }
+        // Unknown records are skipped
+
+        offset = payload + length;
+    }
+
+    if(tail->chunk_count > 0 || tail->block_count > 0) {
+        segment.offset = CAPTURE_FILE_SEGMENT_RECOVERED;
+        if(!capture_file_add_segment(&reader->segments, &segment)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CaptureFileReader* capture_file_reader_alloc(const CaptureFileIo* io) {
+    CaptureFileReader* reader = malloc(sizeof(CaptureFileReader));
+    if(reader == NULL) {
+        return NULL;
+    }
+    memset(reader, 0, sizeof(CaptureFileReader));
+    reader->io = *io;
+    reader->size = io->size(io->context);
+    reader->index_segment = CAPTURE_FILE_NO_SEGMENT;
+
+    if(!capture_file_reader_read_header(reader)) {
+        capture_file_reader_free(reader);
+        return NULL;
+    }
+
+    reader->complete = capture_file_reader_read_table(reader);
+    if(!reader->complete && !capture_file_reader_recover(reader)) {
+        capture_file_reader_free(reader);
+        return NULL;
+    }
+
+    const uint32_t chunk_size = reader->header.chunk_size;
+    reader->chunk_count = (reader->length + chunk_size - 1) / chunk_size;
+
+    return reader;
+}
+
+void capture_file_reader_free(CaptureFileReader* reader) {
+    free(reader->segments.segments);
+    free(reader);
+}
+
+const CaptureFileHeader* capture_file_reader_get_header(CaptureFileReader* reader) {
+    return &reader->header;
+}
+
+bool capture_file_reader_is_complete(CaptureFileReader* reader) {
+    return reader->complete;
+}
+
+uint64_t capture_file_reader_get_length(CaptureFileReader* reader) {
+    return reader->length;
+}
+
+uint64_t capture_file_reader_get_frame_count(CaptureFileReader* reader) {
+    return reader->frame_count;
+}
+
+uint64_t capture_file_reader_get_timestamp_count(CaptureFileReader* reader) {
+    return reader->timestamp_count;
+}
+
+// Last segment, whose first record of type starts at most at number
+static size_t
+    capture_file_reader_find_segment(CaptureFileReader* reader, uint32_t type, uint64_t number) {
+    const CaptureFileSegment* segments = reader->segments.segments;
+    size_t low = 0;
+    size_t high = reader->segments.count;
+
+    while(high - low > 1) {
+        const size_t middle = low + (high - low) / 2;
+        if(capture_file_segment_first(&segments[middle], type) <= number) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Returns the index of a segment. Needs one read, if it is not cached.
+static const CaptureFileIndex*
+    capture_file_reader_load_index(CaptureFileReader* reader, size_t segment) {
+    if(segment >= reader->segments.count) {
+        return NULL;
+    }
+
+    const uint64_t offset = reader->segments.segments[segment].offset;
+    if(offset == CAPTURE_FILE_SEGMENT_RECOVERED) {
+        return &reader->recovered;
+    }
+    if(reader->index_segment == segment) {
+        return &reader->index;
+    }
+
+    // Header and payload at once. The record might be shorter than the largest index.
+    uint8_t* data = reader->scratch;
+    reader->index_segment = CAPTURE_FILE_NO_SEGMENT;
+    if(offset >= reader->size ||
+       !capture_file_reader_read_at(
+           reader, offset, data, MIN(reader->size - offset, CAPTURE_FILE_SCRATCH_SIZE))) {
+        return NULL;
+    }
+
+    CaptureFileIndex* index = &reader->index;
+    const uint8_t* payload = data + CAPTURE_FILE_RECORD_HEADER;
+    index->chunk_count = capture_file_get_u32(payload);
+    index->block_count = capture_file_get_u32(payload + 4);
+    if(capture_file_get_u32(data) != CaptureFileRecordIndex ||
+       index->chunk_count > CAPTURE_FILE_SEGMENT_CHUNKS ||
+       index->block_count > CAPTURE_FILE_SEGMENT_BLOCKS ||
+       capture_file_get_u32(data + 4) !=
+           8 + index->chunk_count * 8 + index->block_count * CAPTURE_FILE_BLOCK_SIZE ||
+       reader->size - offset <
+           CAPTURE_FILE_RECORD_HEADER + capture_file_get_u32(data + 4)) {
+        return NULL;
+    }
+
+    size_t position = 8;
+    for(uint32_t i = 0; i < index->chunk_count; i++, position += 8) {
+        index->chunk_offsets[i] = capture_file_get_u64(payload + position);
+    }
+    for(uint32_t i = 0; i < index->block_count; i++, position += CAPTURE_FILE_BLOCK_SIZE) {
+        CaptureFileBlock* block = &index->blocks[i];
+        block->type = capture_file_get_u32(payload + position);
+        block->count = capture_file_get_u32(payload + position + 4);
+        block->offset = capture_file_get_u64(payload + position + 8);
+        block->first = capture_file_get_u64(payload + position + 16);
+        block->base = capture_file_get_u64(payload + position + 24);
+    }
+
+    reader->index_segment = segment;
+    return index;
+}
+
+size_t capture_file_reader_read(
+    CaptureFileReader* reader,
+    uint64_t offset,
+    void* data,
+    size_t length) {
+    const uint32_t chunk_size = reader->header.chunk_size;
+    uint8_t* bytes = data;
+    size_t read = 0;
+
+    while(read < length && offset < reader->length) {
+        const uint64_t chunk = offset / chunk_size;
+        const size_t segment =
+            capture_file_reader_find_segment(reader, CaptureFileRecordData, chunk);
+        const CaptureFileIndex* index = capture_file_reader_load_index(reader, segment);
+        if(index == NULL) {
+            break;
+        }
+        const uint64_t number = chunk - reader->segments.segments[segment].first_chunk;
+        if(number >= index->chunk_count) {
+            break;
+        }
+
+        const uint32_t within = offset % chunk_size;
+        const size_t part =
+            MIN(MIN(length - read, chunk_size - within), reader->length - offset);
+        const uint64_t position =
+            index->chunk_offsets[number] + CAPTURE_FILE_RECORD_HEADER + within;
+        if(!capture_file_reader_read_at(reader, position, bytes + read, part)) {
+            break;
+        }
+
+        read += part;
+        offset += part;
+    }
+
+    return read;
+}
+
+// Side record of type, which contains the entry number
+static const CaptureFileBlock*
+    capture_file_reader_find_block(CaptureFileReader* reader, uint32_t type, uint64_t number) {
+    const size_t segment = capture_file_reader_find_segment(reader, type, number);
+    const CaptureFileIndex* index = capture_file_reader_load_index(reader, segment);
+    if(index == NULL) {
+        return NULL;
+    }
+
+    for(uint32_t i = 0; i < index->block_count; i++) {
+        const CaptureFileBlock* block = &index->blocks[i];
+        if(block->type == type && number >= block->first && number - block->first < block->count) {
+            return block;
+        }
+    }
+
+    return NULL;
+}
+
+bool capture_file_reader_get_frame(
+    CaptureFileReader* reader,
+    uint64_t number,
+    CaptureFileFrame* frame) {
+    if(number >= reader->frame_count) {
+        return false;
+    }
+
+    const CaptureFileBlock* block =
+        capture_file_reader_find_block(reader, CaptureFileRecordFrames, number);
+    if(block == NULL) {
+        return false;
+    }
+
+    // The start is the end of the previous frame
+    uint8_t* data = reader->scratch;
+    const uint64_t entry = number - block->first;
+    const uint64_t payload = block->offset + CAPTURE_FILE_RECORD_HEADER;
+    uint64_t previous = block->base;
+    uint64_t end;
+    if(entry > 0) {
+        if(!capture_file_reader_read_at(
+               reader, payload + (entry - 1) * CAPTURE_FILE_FRAME_SIZE, data, 16)) {
+            return false;
+        }
+        previous = capture_file_get_u64(data);
+        end = capture_file_get_u64(data + 8);
+    } else {
+        if(!capture_file_reader_read_at(reader, payload, data, 8)) {
+            return false;
+        }
+        end = capture_file_get_u64(data);
+    }
+
+    // Frames of a recovered file might go past the data
+    frame->start = MIN(previous & CAPTURE_FILE_FRAME_POSITION, reader->length);
+    frame->end = MIN(end & CAPTURE_FILE_FRAME_POSITION, reader->length);
+    frame->gap = (previous & CAPTURE_FILE_FRAME_GAP) != 0;
+    return true;
+}
+
+bool capture_file_reader_get_timestamp(
+    CaptureFileReader* reader,
+    uint64_t number,
+    CaptureFileTimestamp* timestamp) {
+    if(number >= reader->timestamp_count) {
+        return false;
+    }
+
+    const CaptureFileBlock* block =
+        capture_file_reader_find_block(reader, CaptureFileRecordTimestamps, number);
+    if(block == NULL) {
+        return false;
+    }
+
+    uint8_t* data = reader->scratch;
+    const uint64_t offset = block->offset + CAPTURE_FILE_RECORD_HEADER +
+                            (number - block->first) * CAPTURE_FILE_TIMESTAMP_SIZE;
+    if(!capture_file_reader_read_at(reader, offset, data, CAPTURE_FILE_TIMESTAMP_SIZE)) {
+        return false;
+    }
+
+    timestamp->position = capture_file_get_u64(data);
+    timestamp->time = capture_file_get_u64(data + 8);
+    return true;
+}
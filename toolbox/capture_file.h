@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Native capture file (.spicap). Made for fast reloading: Any byte offset and the boundaries of
+// any frame can be reached with one or two reads. Only depends on the C library, so tools on the
+// host can use the same code.
+//
+// All values are little endian. The file starts with a header (u32 magic, u16 version, u16 header
+// length, u32 chunk size, u32 frame size, u32 clock, u32 config count, u32 config values), which
+// is followed by records. Every record starts with a u32 type and a u32 payload length:
+// - Data: chunk_size bytes of the capture. Only the last one may be shorter.
+// - Frames: Ends of frames as u64 stream positions. Bit 63 marks a discontinuity at the position,
+//   e.g. while the capture was paused. The frames cover the whole stream without gaps.
+// - Timestamps: Pairs of u64 stream position and u64 time in units of clock_hz.
+// - Index: Written after at most CAPTURE_FILE_SEGMENT_CHUNKS data records. Lists the data and side
+//   records since the previous index record. Those records form a segment.
+// - Table: Lists every index record. Written once at the end and followed by the trailer (u64
+//   offset of the table record, u32 CAPTURE_FILE_TRAILER_MAGIC, u32 0).
+//
+// The table is small enough to be kept in memory. A byte offset needs the index record of its
+// segment and the data, a frame the index record and the frame entries. The last index record is
+// cached. A file without trailer, e.g. after a power loss, is recovered by scanning the records.
+
+#define CAPTURE_FILE_EXTENSION      ".spicap"
+#define CAPTURE_FILE_MAGIC          0x43495053 // "SPIC"
+#define CAPTURE_FILE_TRAILER_MAGIC  0x58495053 // "SPIX"
+#define CAPTURE_FILE_VERSION        1
+#define CAPTURE_FILE_TRAILER_SIZE   16
+#define CAPTURE_FILE_RECORD_HEADER  8
+#define CAPTURE_FILE_FRAME_GAP      (1ULL << 63)
+#define CAPTURE_FILE_FRAME_POSITION (~CAPTURE_FILE_FRAME_GAP)
+
+// Data records per segment
+#define CAPTURE_FILE_SEGMENT_CHUNKS 64
+// Side records per segment. The segment is closed early, if there are more.
+#define CAPTURE_FILE_SEGMENT_BLOCKS 16
+// Payload of a side record
+#define CAPTURE_FILE_SIDE_BLOCK_SIZE 512
+#define CAPTURE_FILE_INDEX_SIZE \
+    (8 + CAPTURE_FILE_SEGMENT_CHUNKS * 8 + CAPTURE_FILE_SEGMENT_BLOCKS * 32)
+// Most bytes, one writer call with up to chunk_size bytes of data writes. Except for finish.
+#define CAPTURE_FILE_WRITER_MAX_OUTPUT(chunk_size)                                   \
+    (3 * CAPTURE_FILE_RECORD_HEADER + (chunk_size) + CAPTURE_FILE_SIDE_BLOCK_SIZE + \
+     CAPTURE_FILE_INDEX_SIZE)
+
+typedef enum {
+    CaptureFileRecordData = 1,
+    CaptureFileRecordFrames,
+    CaptureFileRecordTimestamps,
+    CaptureFileRecordIndex,
+    CaptureFileRecordTable,
+} CaptureFileRecordType;
+
+// Settings of the capture. The first part mirrors FlipperSPITerminalAppConfig, the second part
+// LL_SPI_InitTypeDef. New values are only appended.
+typedef enum {
+    CaptureFileConfigDisplayMode,
+    CaptureFileConfigBufferBehaviour,
+    CaptureFileConfigCaptureBufferSize,
+    CaptureFileConfigIngestMode,
+    CaptureFileConfigRxDmaBufferSize,
+    CaptureFileConfigRefreshInterval,
+    CaptureFileConfigFramingMode,
+    CaptureFileConfigRecordBufferSize,
+    CaptureFileConfigSpiTransferDirection,
+    CaptureFileConfigSpiMode,
+    CaptureFileConfigSpiDataWidth,
+    CaptureFileConfigSpiClockPolarity,
+    CaptureFileConfigSpiClockPhase,
+    CaptureFileConfigSpiNss,
+    CaptureFileConfigSpiBaudRate,
+    CaptureFileConfigSpiBitOrder,
+    CaptureFileConfigSpiCrcCalculation,
+    CaptureFileConfigSpiCrcPoly,
+
+    CaptureFileConfigCount,
+} CaptureFileConfig;
+
+typedef struct {
+    uint32_t chunk_size; // Bytes per data record
+    uint32_t frame_size; // Bytes per SPI frame
+    uint32_t clock_hz; // Unit of the timestamps, 0 => unknown
+    uint32_t config_count; // Valid values in config. Values of newer versions are ignored.
+    uint32_t config[CaptureFileConfigCount];
+} CaptureFileHeader;
+
+typedef struct {
+    uint64_t start; // Stream position of the first byte
+    uint64_t end; // Stream position after the last byte
+    bool gap; // Data before start is missing
+} CaptureFileFrame;
+
+typedef struct {
+    uint64_t position;
+    uint64_t time;
+} CaptureFileTimestamp;
+
+// Access to the file. read and write return the number of bytes, which were transferred. The
+// writer only uses write, the reader everything else.
+typedef struct {
+    void* context;
+    size_t (*read)(void* context, void* data, size_t length);
+    size_t (*write)(void* context, const void* data, size_t length);
+    bool (*seek)(void* context, uint64_t offset); // From the start of the file
+    uint64_t (*size)(void* context);
+} CaptureFileIo;
+
+typedef struct CaptureFileWriter CaptureFileWriter;
+typedef struct CaptureFileReader CaptureFileReader;
+
+// Writes the header. Returns NULL on a write error.
+CaptureFileWriter*
+    capture_file_writer_alloc(const CaptureFileIo* io, const CaptureFileHeader* header);
+// Does not finish the file
+void capture_file_writer_free(CaptureFileWriter* writer);
+// Appends data to the stream. Returns false, if this or a previous write failed.
+bool capture_file_writer_write(CaptureFileWriter* writer, const void* data, size_t length);
+// Ends the current frame at the current stream position. Empty frames are merged into the
+// previous one. gap marks a discontinuity after the frame.
+bool capture_file_writer_end_frame(CaptureFileWriter* writer, bool gap);
+// Timestamps have to be added in order of their position
+bool capture_file_writer_add_timestamp(
+    CaptureFileWriter* writer,
+    uint64_t position,
+    uint64_t time);
+// Stream position, bytes of data written
+uint64_t capture_file_writer_get_position(CaptureFileWriter* writer);
+// Ends the last frame and writes everything, which is buffered, the table and the trailer
+bool capture_file_writer_finish(CaptureFileWriter* writer);
+
+// Reads the header and the table. Returns NULL, if this is no capture file.
+CaptureFileReader* capture_file_reader_alloc(const CaptureFileIo* io);
+void capture_file_reader_free(CaptureFileReader* reader);
+const CaptureFileHeader* capture_file_reader_get_header(CaptureFileReader* reader);
+// false, if the file was not finished and had to be recovered
+bool capture_file_reader_is_complete(CaptureFileReader* reader);
+// Bytes of data in the stream
+uint64_t capture_file_reader_get_length(CaptureFileReader* reader);
+uint64_t capture_file_reader_get_frame_count(CaptureFileReader* reader);
+uint64_t capture_file_reader_get_timestamp_count(CaptureFileReader* reader);
+// Reads up to length bytes of the stream, starting at offset. Returns the number of read bytes,
+// which is less on the end of the stream or a read error.
+size_t capture_file_reader_read(
+    CaptureFileReader* reader,
+    uint64_t offset,
+    void* data,
+    size_t length);
+bool capture_file_reader_get_frame(
+    CaptureFileReader* reader,
+    uint64_t number,
+    CaptureFileFrame* frame);
+bool capture_file_reader_get_timestamp(
+    CaptureFileReader* reader,
+    uint64_t number,
+    CaptureFileTimestamp* timestamp);
@@ -0,0 +1,57 @@
+#include "chunk_arena.h"
+
+#include <furi.h>
+
+// Bookkeeping of the heap for every block
+#define CHUNK_ARENA_BLOCK_OVERHEAD 16
+
+void chunk_arena_alloc(ChunkArena* arena, size_t chunk_size, size_t chunk_count) {
+    furi_check(arena);
+    furi_check(chunk_size > 0);
+    furi_check(chunk_count > 0);
+
+    chunk_arena_free(arena);
+
+    arena->chunks = malloc(sizeof(uint8_t*) * chunk_count);
+    for(size_t i = 0; i < chunk_count; i++) {
+        arena->chunks[i] = malloc(chunk_size);
+    }
+    arena->chunk_count = chunk_count;
+    arena->chunk_size = chunk_size;
+}
+
+void chunk_arena_free(ChunkArena* arena) {
+    furi_check(arena);
+
+    if(arena->chunks == NULL) {
+        return;
+    }
+
+    for(size_t i = 0; i < arena->chunk_count; i++) {
+        free(arena->chunks[i]);
+    }
+    free(arena->chunks);
+
+    arena->chunks = NULL;
+    arena->chunk_count = 0;
+    arena->chunk_size = 0;
+}
+
+size_t chunk_arena_max_chunk_count(size_t chunk_size, size_t reserve, size_t additional) {
+    furi_check(chunk_size > 0);
+
+    const size_t free_heap = memmgr_get_free_heap() + additional;
+    if(free_heap <= reserve + CHUNK_ARENA_BLOCK_OVERHEAD) {
+        return 0;
+    }
+
+    const size_t per_chunk = chunk_size + sizeof(uint8_t*) + CHUNK_ARENA_BLOCK_OVERHEAD;
+    const size_t fitting = (free_heap - reserve - CHUNK_ARENA_BLOCK_OVERHEAD) / per_chunk;
+
+    size_t count = 1;
+    while(count * 2 <= fitting) {
+        count *= 2;
+    }
+
+    return fitting == 0 ? 0 : count;
+}
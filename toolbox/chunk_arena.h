@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// List of equally sized heap blocks. Large buffers are split into chunks, because the heap is
+// usually too fragmented for a single block of this size.
+
+typedef struct {
+    uint8_t** chunks;
+    size_t chunk_count;
+    size_t chunk_size;
+} ChunkArena;
+
+// Frees a previous allocation of arena
+void chunk_arena_alloc(ChunkArena* arena, size_t chunk_size, size_t chunk_count);
+void chunk_arena_free(ChunkArena* arena);
+
+static inline size_t chunk_arena_size(const ChunkArena* arena) {
+    return arena->chunk_count * arena->chunk_size;
+}
+
+// Largest power of two chunk count, which can be allocated without touching the last reserve
+// bytes of the heap. additional is added to the free heap, e.g. for a arena, which is going to
+// be released before the new allocation.
+size_t chunk_arena_max_chunk_count(size_t chunk_size, size_t reserve, size_t additional);
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 as used by zlib, PNG and Ethernet (reflected, polynomial 0xEDB88320). Large data can be
+// checked in parts: Start with crc = 0 and pass the result of every call on to the next one.
+uint32_t crc32_update(uint32_t crc, const void* data, size_t length);
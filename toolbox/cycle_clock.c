@@ -0,0 +1,45 @@
+#include "cycle_clock.h"
+
+#include <furi.h>
+#include <furi_hal_cortex.h>
+
+void cycle_clock_reset(CycleClock* clock) {
+    furi_check(clock);
+
+    FURI_CRITICAL_ENTER();
+    clock->last = DWT->CYCCNT;
+    clock->tick = furi_get_tick();
+    FURI_CRITICAL_EXIT();
+}
+
+uint64_t cycle_clock_now(CycleClock* clock) {
+    const uint64_t cycles_per_tick = (uint64_t)furi_hal_cortex_instructions_per_microsecond() *
+                                     1000000 / furi_kernel_get_tick_frequency();
+    uint64_t now;
+
+    FURI_CRITICAL_ENTER();
+    const uint32_t cycles = DWT->CYCCNT;
+    const uint32_t tick = furi_get_tick();
+
+    // The counter only shows the time since the last call modulo one wrap. The tick is accurate
+    // to a fraction of a wrap and adds the missing whole wraps.
+    const uint32_t delta = cycles - (uint32_t)clock->last;
+    const uint64_t estimate = (uint64_t)(tick - clock->tick) * cycles_per_tick;
+    uint64_t wraps = 0;
+    if(estimate > delta) {
+        wraps = (estimate - delta + (1ULL << 31)) >> 32;
+    }
+
+    clock->last += (wraps << 32) + delta;
+    clock->tick = tick;
+    now = clock->last;
+    FURI_CRITICAL_EXIT();
+
+    return now;
+}
+
+uint64_t cycle_clock_extend(CycleClock* clock, uint32_t cycles) {
+    const uint64_t now = cycle_clock_now(clock);
+    // Wraps correctly, as long as cycles is less than one wrap old
+    return now - (uint32_t)((uint32_t)now - cycles);
+}
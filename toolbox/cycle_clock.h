@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+// 64 bit extension of the DWT cycle counter. The 32 bit counter wraps after about a minute at
+// 64 MHz. The RTOS tick tells, how many wraps happened since the last call, so the clock does not
+// have to be kept running. Calls have to be less than one tick counter wrap (49 days) apart.
+// Can be used from ISRs and threads at the same time.
+
+typedef struct {
+    uint64_t last; // Clock value at the last call
+    uint32_t tick; // RTOS tick at the last call
+} CycleClock;
+
+void cycle_clock_reset(CycleClock* clock);
+uint64_t cycle_clock_now(CycleClock* clock);
+// Extends a counter value, which was captured less than one wrap ago
+uint64_t cycle_clock_extend(CycleClock* clock, uint32_t cycles);
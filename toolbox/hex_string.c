@@ -0,0 +1,93 @@
+#include "hex_string.h"
+
+static int hex_string_nibble(char c) {
+    if(c >= '0' && c <= '9') {
+        return c - '0';
+    } else if(c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if(c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+// Returns the mask of the nibble c or -1. Don't-cares have a mask of 0.
+static int hex_string_nibble_masked(char c, int* value) {
+    if(c == '?' || c == 'x' || c == 'X') {
+        *value = 0;
+        return 0;
+    }
+
+    *value = hex_string_nibble(c);
+    return *value < 0 ? -1 : 0xF;
+}
+
+int hex_string_decode_masked(const char* str, uint8_t* data, uint8_t* mask, size_t max_length) {
+    size_t length = 0;
+
+    while(*str != '\0') {
+        if(*str == ' ' || *str == '\t') {
+            str++;
+            continue;
+        }
+
+        int high, low;
+        const int high_mask = hex_string_nibble_masked(str[0], &high);
+        const int low_mask = high_mask < 0 ? -1 : hex_string_nibble_masked(str[1], &low);
+        if(low_mask < 0 || length == max_length) {
+            return -1;
+        }
+
+        data[length] = (high << 4) | low;
+        if(mask != NULL) {
+            mask[length] = (high_mask << 4) | low_mask;
+        } else if(high_mask != 0xF || low_mask != 0xF) {
+            return -1;
+        }
+        length++;
+        str += 2;
+    }
+
+    return length;
+}
+
+int hex_string_decode(const char* str, uint8_t* data, size_t max_length) {
+    return hex_string_decode_masked(str, data, NULL, max_length);
+}
+
+static const char hex_string_digits[] = "0123456789ABCDEF";
+
+size_t hex_string_dump_line(char* line, uint32_t offset, const uint8_t* data, size_t length) {
+    char* dst = line;
+
+    for(int shift = 28; shift >= 0; shift -= 4) {
+        *dst++ = hex_string_digits[(offset >> shift) & 0xF];
+    }
+    *dst++ = ' ';
+
+    // Missing bytes of the last line are padded, so the ASCII column stays aligned
+    for(size_t i = 0; i < HEX_STRING_DUMP_BYTES; i++) {
+        if(i % 8 == 0) {
+            *dst++ = ' ';
+        }
+        if(i < length) {
+            *dst++ = hex_string_digits[data[i] >> 4];
+            *dst++ = hex_string_digits[data[i] & 0xF];
+        } else {
+            *dst++ = ' ';
+            *dst++ = ' ';
+        }
+        *dst++ = ' ';
+    }
+
+    *dst++ = ' ';
+    *dst++ = '|';
+    for(size_t i = 0; i < length && i < HEX_STRING_DUMP_BYTES; i++) {
+        *dst++ = (data[i] >= 0x20 && data[i] < 0x7F) ? data[i] : '.';
+    }
+    *dst++ = '|';
+    *dst++ = '\n';
+
+    return dst - line;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Decodes hex bytes like "9F 00 0A" or "9f000a". Bytes may be separated by spaces, but a byte
+// may not be split. Returns the number of bytes or -1 on invalid input or if the bytes do not
+// fit into data.
+int hex_string_decode(const char* str, uint8_t* data, size_t max_length);
+
+// Like hex_string_decode, but nibbles may be don't-cares, written as "?" or "X", e.g. "9F ?? X0".
+// The bits of a don't-care nibble are 0 in data and mask, every other bit is 1 in mask.
+int hex_string_decode_masked(const char* str, uint8_t* data, uint8_t* mask, size_t max_length);
+
+// Bytes per line of hex_string_dump_line
+#define HEX_STRING_DUMP_BYTES     16
+// Longest line of hex_string_dump_line, including the line break
+#define HEX_STRING_DUMP_LINE_SIZE 79
+
+// Formats up to HEX_STRING_DUMP_BYTES bytes like `hexdump -C`, e.g.
+// "00000010  9F EF 40 18 ...  |..@.|\n". line needs room for HEX_STRING_DUMP_LINE_SIZE chars, it
+// is not terminated. Returns the number of written chars.
+size_t hex_string_dump_line(char* line, uint32_t offset, const uint8_t* data, size_t length);
@@ -0,0 +1,39 @@
+#include "latency_histogram.h"
+#include <string.h>
+
+void latency_histogram_reset(LatencyHistogram* histogram) {
+    memset(histogram, 0, sizeof(LatencyHistogram));
+}
+
+void latency_histogram_add(LatencyHistogram* histogram, uint32_t cycles) {
+    // Bucket n contains all values with n significant bits
+    size_t bucket = cycles == 0 ? 0 : 32 - __builtin_clz(cycles);
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    if(cycles > histogram->max) {
+        histogram->max = cycles;
+    }
+}
+
+uint32_t latency_histogram_percentile(const LatencyHistogram* histogram, uint32_t percent) {
+    if(histogram->count == 0) {
+        return 0;
+    }
+
+    const uint64_t target = ((uint64_t)histogram->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for(size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if(seen >= target) {
+            if(i == 0) {
+                return 0;
+            }
+
+            const uint32_t upper_bound = i == 32 ? UINT32_MAX : (1UL << i) - 1;
+            return upper_bound < histogram->max ? upper_bound : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Log2 bucketed histogram for cycle counts. Adding a sample is cheap enough to be used in ISRs.
+// Percentiles are reported as the upper bound of the matching bucket.
+
+#define LATENCY_HISTOGRAM_BUCKETS 33
+
+typedef struct {
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+} LatencyHistogram;
+
+void latency_histogram_reset(LatencyHistogram* histogram);
+void latency_histogram_add(LatencyHistogram* histogram, uint32_t cycles);
+uint32_t latency_histogram_percentile(const LatencyHistogram* histogram, uint32_t percent);
@@ -0,0 +1,107 @@
+#include "page_cache.h"
+
+#include <furi.h>
+
+void page_cache_init(
+    PageCache* cache,
+    size_t page_size,
+    size_t page_count,
+    uint64_t length,
+    PageCacheReadCallback read,
+    void* context) {
+    furi_check(cache);
+    furi_check(read);
+    // page_size needs to be a power of two
+    furi_check(page_size != 0 && (page_size & (page_size - 1)) == 0);
+    furi_check(page_count > 0 && page_count <= PAGE_CACHE_MAX_PAGES);
+
+    memset(cache, 0, sizeof(PageCache));
+    cache->read = read;
+    cache->context = context;
+    cache->length = length;
+    cache->page_shift = __builtin_ctz(page_size);
+    cache->page_count = page_count;
+
+    // One block for all pages
+    cache->storage = malloc(page_size * page_count);
+    for(size_t i = 0; i < page_count; i++) {
+        cache->pages[i].data = cache->storage + i * page_size;
+    }
+}
+
+void page_cache_deinit(PageCache* cache) {
+    furi_check(cache);
+
+    free(cache->storage);
+    cache->storage = NULL;
+    cache->page_count = 0;
+    cache->last = NULL;
+}
+
+void page_cache_invalidate(PageCache* cache) {
+    furi_check(cache);
+
+    for(size_t i = 0; i < cache->page_count; i++) {
+        cache->pages[i].length = 0;
+    }
+    cache->last = NULL;
+}
+
+PageCachePage* page_cache_load(PageCache* cache, uint64_t offset) {
+    furi_check(cache);
+
+    if(offset >= cache->length) {
+        return NULL;
+    }
+
+    const uint64_t number = offset >> cache->page_shift;
+    PageCachePage* oldest = &cache->pages[0];
+    PageCachePage* page = NULL;
+    for(size_t i = 0; i < cache->page_count; i++) {
+        PageCachePage* candidate = &cache->pages[i];
+        if(candidate->length != 0 && candidate->number == number) {
+            page = candidate;
+            break;
+        }
+
+        // Empty pages are used first
+        if(candidate->length == 0 ||
+           (oldest->length != 0 && (int32_t)(candidate->used - oldest->used) < 0)) {
+            oldest = candidate;
+        }
+    }
+
+    if(page != NULL) {
+        cache->hits++;
+    } else {
+        page = oldest;
+        const size_t page_size = 1u << cache->page_shift;
+        const uint64_t start = number << cache->page_shift;
+        const size_t length = MIN((uint64_t)page_size, cache->length - start);
+
+        page->number = number;
+        page->length = cache->read(cache->context, start, page->data, length);
+        cache->misses++;
+        if(page->length == 0) {
+            return NULL; // Read error, tried again with the next access
+        }
+    }
+
+    page->used = ++cache->tick;
+    cache->last = page;
+    return page;
+}
+
+void page_cache_prefetch(PageCache* cache, uint64_t offset, uint64_t length) {
+    furi_check(cache);
+
+    if(offset >= cache->length || length == 0) {
+        return;
+    }
+
+    const uint64_t end = MIN(offset + length, cache->length);
+    const size_t page_size = 1u << cache->page_shift;
+    for(uint64_t start = offset & ~(uint64_t)(page_size - 1); start < end; start += page_size) {
+        page_cache_load(cache, start);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Small LRU cache of fixed size pages of a stream, which is too large for the RAM, e.g. a capture
+// file on the SD card. Pages are read on demand with the read callback. The page size has to be a
+// power of two, so the page of a offset is found with a shift.
+//
+// The last used page is checked first. Reading the bytes of a row therefore only searches the
+// pages on a page boundary.
+
+#define PAGE_CACHE_MAX_PAGES 16
+
+// Reads up to length bytes, starting at offset. Returns the number of read bytes.
+typedef size_t (*PageCacheReadCallback)(void* context, uint64_t offset, void* data, size_t length);
+
+typedef struct {
+    uint64_t number; // Page number, offset >> page_shift
+    uint32_t used; // Value of tick at the last access
+    size_t length; // Valid bytes, 0 => empty
+    uint8_t* data;
+} PageCachePage;
+
+typedef struct {
+    PageCacheReadCallback read;
+    void* context;
+    uint64_t length; // Bytes in the stream
+    size_t page_shift; // log2(page size)
+    size_t page_count;
+    uint32_t tick;
+    PageCachePage* last; // Page of the last access, NULL => none
+    PageCachePage pages[PAGE_CACHE_MAX_PAGES];
+    uint8_t* storage;
+    uint32_t hits;
+    uint32_t misses; // Pages, which were read
+} PageCache;
+
+void page_cache_init(
+    PageCache* cache,
+    size_t page_size,
+    size_t page_count,
+    uint64_t length,
+    PageCacheReadCallback read,
+    void* context);
+void page_cache_deinit(PageCache* cache);
+// Forgets all pages, e.g. after the stream changed
+void page_cache_invalidate(PageCache* cache);
+
+static inline uint64_t page_cache_length(const PageCache* cache) {
+    return cache->length;
+}
+
+// Page of offset. Reads it, if it is not cached yet. Returns NULL for offsets after the stream.
+PageCachePage* page_cache_load(PageCache* cache, uint64_t offset);
+// Reads the missing pages of length bytes, starting at offset
+void page_cache_prefetch(PageCache* cache, uint64_t offset, uint64_t length);
+
+// Byte at offset. Bytes, which can not be read, are 0.
+static inline uint8_t page_cache_get(PageCache* cache, uint64_t offset) {
+    const PageCachePage* page = cache->last;
+    if(page == NULL || (offset >> cache->page_shift) != page->number) {
+        page = page_cache_load(cache, offset);
+        if(page == NULL) {
+            return 0;
+        }
+    }
+
+    const size_t within = offset & ((1u << cache->page_shift) - 1);
+    return within < page->length ? page->data[within] : 0;
+}
@@ -0,0 +1,179 @@
+#include "spsc_ring.h"
+
+#include <furi.h>
+
+static inline uint8_t* spsc_ring_pointer(const SpscRing* ring, size_t position) {
+    const size_t index = position & ring->mask;
+    return ring->chunks[index >> ring->chunk_shift] + (index & ring->chunk_mask);
+}
+
+static size_t spsc_ring_split(
+    const SpscRing* ring,
+    size_t position,
+    size_t length,
+    SpscRingSpan spans[2]) {
+    const size_t chunk_size = ring->chunk_mask + 1;
+
+    const size_t first = chunk_size - (position & ring->chunk_mask);
+    spans[0].data = spsc_ring_pointer(ring, position);
+    spans[0].length = MIN(length, first);
+
+    spans[1].data = spsc_ring_pointer(ring, position + spans[0].length);
+    spans[1].length = MIN(length - spans[0].length, chunk_size);
+
+    return spans[0].length + spans[1].length;
+}
+
+static size_t spsc_ring_log2(size_t value) {
+    // value needs to be a power of two
+    furi_check(value != 0 && (value & (value - 1)) == 0);
+    return __builtin_ctz(value);
+}
+
+void spsc_ring_init_chunked(
+    SpscRing* ring,
+    uint8_t** chunks,
+    size_t chunk_count,
+    size_t chunk_size) {
+    furi_check(ring);
+    furi_check(chunks);
+
+    ring->chunks = chunks;
+    ring->chunk_shift = spsc_ring_log2(chunk_size);
+    ring->chunk_mask = chunk_size - 1;
+    ring->mask = (chunk_count << ring->chunk_shift) - 1;
+    furi_check(spsc_ring_capacity(ring) == chunk_count << ring->chunk_shift);
+    spsc_ring_log2(chunk_count);
+    ring->owns_data = false;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+void spsc_ring_init(SpscRing* ring, uint8_t* storage, size_t capacity) {
+    furi_check(ring);
+    furi_check(storage);
+
+    ring->single_chunk = storage;
+    spsc_ring_init_chunked(ring, &ring->single_chunk, 1, capacity);
+}
+
+SpscRing* spsc_ring_alloc(size_t capacity) {
+    SpscRing* ring = malloc(sizeof(SpscRing));
+    spsc_ring_init(ring, malloc(capacity), capacity);
+    ring->owns_data = true;
+    return ring;
+}
+
+void spsc_ring_free(SpscRing* ring) {
+    furi_check(ring);
+
+    if(ring->owns_data) {
+        free(ring->single_chunk);
+    }
+    free(ring);
+}
+
+void spsc_ring_reset(SpscRing* ring) {
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+}
+
+size_t spsc_ring_reserve(SpscRing* ring, size_t length, SpscRingSpan spans[2]) {
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const size_t free_space = spsc_ring_capacity(ring) - (head - tail);
+
+    if(length > free_space) {
+        length = free_space;
+    }
+
+    return spsc_ring_split(ring, head, length, spans);
+}
+
+void spsc_ring_commit(SpscRing* ring, size_t length) {
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + length, memory_order_release);
+}
+
+size_t spsc_ring_write(SpscRing* ring, const void* data, size_t length) {
+    const uint8_t* src = data;
+    size_t written = 0;
+
+    while(written < length) {
+        SpscRingSpan spans[2];
+        size_t reserved = spsc_ring_reserve(ring, length - written, spans);
+        if(reserved == 0) {
+            break;
+        }
+
+        memcpy(spans[0].data, src + written, spans[0].length);
+        memcpy(spans[1].data, src + written + spans[0].length, spans[1].length);
+
+        spsc_ring_commit(ring, reserved);
+        written += reserved;
+    }
+
+    return written;
+}
+
+size_t spsc_ring_peek_span(
+    const SpscRing* ring,
+    size_t offset,
+    size_t length,
+    SpscRingSpan spans[2]) {
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    const size_t used = head - tail;
+
+    if(offset >= used) {
+        length = 0;
+    } else if(length > used - offset) {
+        length = used - offset;
+    }
+
+    return spsc_ring_split(ring, tail + offset, length, spans);
+}
+
+size_t spsc_ring_peek_span_at(
+    const SpscRing* ring,
+    size_t position,
+    size_t length,
+    SpscRingSpan spans[2]) {
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    // Free running counters: position is in the ring, if it is not further from tail than head
+    if(position - tail >= head - tail) {
+        length = 0;
+    } else if(length > head - position) {
+        length = head - position;
+    }
+
+    return spsc_ring_split(ring, position, length, spans);
+}
+
+void spsc_ring_consume(SpscRing* ring, size_t length) {
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + length, memory_order_release);
+}
+
+size_t spsc_ring_read(SpscRing* ring, void* data, size_t length) {
+    uint8_t* dst = data;
+    size_t read = 0;
+
+    while(read < length) {
+        SpscRingSpan spans[2];
+        size_t peeked = spsc_ring_peek_span(ring, 0, length - read, spans);
+        if(peeked == 0) {
+            break;
+        }
+
+        memcpy(dst + read, spans[0].data, spans[0].length);
+        memcpy(dst + read + spans[0].length, spans[1].data, spans[1].length);
+
+        spsc_ring_consume(ring, peeked);
+        read += peeked;
+    }
+
+    return read;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free single producer / single consumer ring buffer.
+//
+// The capacity has to be a power of two. head and tail are free running counters, which are
+// masked on access. This avoids divisions and keeps the full capacity usable. The producer only
+// writes head, the consumer only writes tail. A ISR can therefore be the producer while a thread
+// is the consumer, without any locking.
+//
+// The storage is either one contiguous block or a list of equally sized chunks. Chunk count and
+// chunk size are powers of two, so every byte is still reachable with a shift and a mask.
+
+typedef struct {
+    uint8_t** chunks;
+    uint8_t* single_chunk; // chunks points here for contiguous storage
+    size_t chunk_shift; // log2(chunk size)
+    size_t chunk_mask; // chunk size - 1
+    size_t mask; // capacity - 1
+    atomic_size_t head; // Total number of committed bytes
+    atomic_size_t tail; // Total number of consumed bytes
+    bool owns_data;
+} SpscRing;
+
+// Contiguous part of the ring. A range in a contiguous ring consists of up to two spans. In a
+// chunked ring, the span functions stop at the end of the second chunk and need to be repeated.
+typedef struct {
+    uint8_t* data;
+    size_t length;
+} SpscRingSpan;
+
+void spsc_ring_init(SpscRing* ring, uint8_t* storage, size_t capacity);
+void spsc_ring_init_chunked(
+    SpscRing* ring,
+    uint8_t** chunks,
+    size_t chunk_count,
+    size_t chunk_size);
+SpscRing* spsc_ring_alloc(size_t capacity);
+void spsc_ring_free(SpscRing* ring);
+
+// Not thread safe. Neither producer nor consumer may access the ring at the same time.
+void spsc_ring_reset(SpscRing* ring);
+
+static inline size_t spsc_ring_capacity(const SpscRing* ring) {
+    return ring->mask + 1;
+}
+
+static inline size_t spsc_ring_size(const SpscRing* ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+static inline size_t spsc_ring_free_space(const SpscRing* ring) {
+    return spsc_ring_capacity(ring) - spsc_ring_size(ring);
+}
+
+// Stream offset of the oldest byte. This is the number of bytes, which were ever consumed.
+static inline size_t spsc_ring_position(const SpscRing* ring) {
+    return atomic_load_explicit(&ring->tail, memory_order_relaxed);
+}
+
+// Stream offset after the newest byte. This is the number of bytes, which were ever committed.
+static inline size_t spsc_ring_end_position(const SpscRing* ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire);
+}
+
+// Consumer side: Byte at offset, counted from the oldest byte. offset has to be < size.
+static inline uint8_t spsc_ring_get(const SpscRing* ring, size_t offset) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t index = (tail + offset) & ring->mask;
+    return ring->chunks[index >> ring->chunk_shift][index & ring->chunk_mask];
+}
+
+// Producer side: Reserves up to length bytes of free space. Returns the number of bytes, which
+// can be written into spans. Nothing is visible to the consumer before spsc_ring_commit.
+// Chunked rings may return less than the free space, see SpscRingSpan.
+size_t spsc_ring_reserve(SpscRing* ring, size_t length, SpscRingSpan spans[2]);
+void spsc_ring_commit(SpscRing* ring, size_t length);
+// Producer side: Copies up to length bytes into the ring. Returns the number of written bytes.
+size_t spsc_ring_write(SpscRing* ring, const void* data, size_t length);
+
+// Consumer side: Returns up to length bytes, starting at offset from the oldest byte, as spans.
+// Returns the number of bytes in spans.
+size_t spsc_ring_peek_span(
+    const SpscRing* ring,
+    size_t offset,
+    size_t length,
+    SpscRingSpan spans[2]);
+// Returns up to length bytes, starting at the stream position, as spans. Returns 0, if position
+// is not in the ring. Meant for a reader next to the consumer: The bytes may be released and
+// overwritten meanwhile, so a copy is only valid, if spsc_ring_contains is still true afterwards.
+size_t spsc_ring_peek_span_at(
+    const SpscRing* ring,
+    size_t position,
+    size_t length,
+    SpscRingSpan spans[2]);
+// True, if the bytes between the stream positions position and position + length are in the ring
+static inline bool spsc_ring_contains(const SpscRing* ring, size_t position, size_t length) {
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return position - tail <= head - tail && length <= head - position;
+}
+// Consumer side: Releases the length oldest bytes.
+void spsc_ring_consume(SpscRing* ring, size_t length);
+// Consumer side: Copies and consumes up to length bytes. Returns the number of read bytes.
+size_t spsc_ring_read(SpscRing* ring, void* data, size_t length);
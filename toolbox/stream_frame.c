@@ -0,0 +1,131 @@
+#include "stream_frame.h"
+#include "crc32.h"
+
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+static uint64_t stream_frame_get_u64(const uint8_t* data) {
+    return stream_frame_get_u32(data) | ((uint64_t)stream_frame_get_u32(data + 4) << 32);
+}
+
+static size_t stream_frame_get_length(const uint8_t* frame) {
+    return frame[4] | (frame[5] << 8);
+}
+
+uint8_t* stream_frame_begin(
+    uint8_t* dst,
+    uint8_t type,
+    uint32_t sequence,
+    uint64_t timestamp,
+    size_t length) {
+    dst[0] = STREAM_FRAME_SYNC & 0xFF;
+    dst[1] = STREAM_FRAME_SYNC >> 8;
+    dst[2] = type;
+    dst[3] = 0;
+    dst[4] = length;
+    dst[5] = length >> 8;
+    stream_frame_put_u32(dst + 6, sequence);
+    stream_frame_put_u32(dst + 10, timestamp);
+    stream_frame_put_u32(dst + 14, timestamp >> 32);
+    return dst + STREAM_FRAME_HEADER_SIZE;
+}
+
+size_t stream_frame_end(uint8_t* dst) {
+    const size_t length = STREAM_FRAME_HEADER_SIZE + stream_frame_get_length(dst);
+    stream_frame_put_u32(dst + length, crc32_update(0, dst + 2, length - 2));
+    return length + STREAM_FRAME_CRC_SIZE;
+}
+
+void stream_frame_decoder_init(StreamFrameDecoder* decoder) {
+    memset(decoder, 0, sizeof(StreamFrameDecoder));
+}
+
+// Drops the first byte of the buffered frame and searches the next sync word in the rest
+static void stream_frame_decoder_resync(StreamFrameDecoder* decoder) {
+    const uint8_t* start =
+        memchr(decoder->buffer + 1, STREAM_FRAME_SYNC & 0xFF, decoder->length - 1);
+    const size_t skip = start ? (size_t)(start - decoder->buffer) : decoder->length;
+    memmove(decoder->buffer, decoder->buffer + skip, decoder->length - skip);
+    decoder->length -= skip;
+    decoder->skipped += skip;
+}
+
+size_t stream_frame_decoder_feed(
+    StreamFrameDecoder* decoder,
+    const uint8_t* data,
+    size_t length,
+    StreamFrame* frame,
+    bool* complete) {
+    size_t taken = 0;
+    *complete = false;
+
+    // The previous frame was kept for the caller. Bytes after it were buffered by a resync.
+    if(decoder->consumed > 0) {
+        decoder->length -= decoder->consumed;
+        memmove(decoder->buffer, decoder->buffer + decoder->consumed, decoder->length);
+        decoder->consumed = 0;
+    }
+
+    for(;;) {
+        // Outside of a frame, everything up to the next sync byte is skipped at once
+        if(decoder->length == 0) {
+            const uint8_t* start =
+                memchr(data + taken, STREAM_FRAME_SYNC & 0xFF, length - taken);
+            const size_t skip = start ? (size_t)(start - (data + taken)) : length - taken;
+            decoder->skipped += skip;
+            taken += skip;
+        }
+
+        // Bytes after a returned frame do not have to start with the sync word
+        if(decoder->length > 0 && (decoder->buffer[0] != (STREAM_FRAME_SYNC & 0xFF) ||
+                                   (decoder->length >= 2 &&
+                                    decoder->buffer[1] != STREAM_FRAME_SYNC >> 8))) {
+            stream_frame_decoder_resync(decoder);
+            continue;
+        }
+
+        // Header first, the length of the rest is known afterwards
+        size_t needed = STREAM_FRAME_HEADER_SIZE;
+        if(decoder->length >= STREAM_FRAME_HEADER_SIZE) {
+            const size_t payload = stream_frame_get_length(decoder->buffer);
+            if(payload > STREAM_FRAME_MAX_PAYLOAD) {
+                stream_frame_decoder_resync(decoder);
+                continue;
+            }
+            needed += payload + STREAM_FRAME_CRC_SIZE;
+        }
+
+        if(decoder->length < needed) {
+            if(taken == length) {
+                break; // Needs more data
+            }
+            const size_t part = MIN(needed - decoder->length, length - taken);
+            memcpy(decoder->buffer + decoder->length, data + taken, part);
+            decoder->length += part;
+            taken += part;
+            continue;
+        }
+
+        const size_t crc_offset = needed - STREAM_FRAME_CRC_SIZE;
+        if(stream_frame_get_u32(decoder->buffer + crc_offset) !=
+           crc32_update(0, decoder->buffer + 2, crc_offset - 2)) {
+            decoder->crc_errors++;
+            stream_frame_decoder_resync(decoder);
+            continue;
+        }
+
+        frame->type = decoder->buffer[2];
+        frame->sequence = stream_frame_get_u32(decoder->buffer + 6);
+        frame->timestamp = stream_frame_get_u64(decoder->buffer + 10);
+        frame->payload = decoder->buffer + STREAM_FRAME_HEADER_SIZE;
+        frame->length = crc_offset - STREAM_FRAME_HEADER_SIZE;
+        decoder->consumed = needed;
+        *complete = true;
+        break;
+    }
+
+    return taken;
+}
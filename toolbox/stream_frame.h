@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Framed binary protocol of `spi stream`. Only depends on the C library, so the host receiver uses
+// the same code.
+//
+// All values are little endian. Every frame is: u16 STREAM_FRAME_SYNC, u8 type, u8 reserved (0),
+// u16 payload length, u32 sequence number, u64 timestamp, payload and a u32 CRC-32 (see crc32.h)
+// of everything after the sync word. The sequence number counts every frame, so lost frames are
+// noticed. Bytes outside of a frame, e.g. text of the CLI, are skipped by the decoder.
+//
+// Payloads:
+// - Start: u32 clock_hz (unit of the timestamps), u32 frame_size, u32 config count, u32 config
+//   values. Same as CaptureFileHeader, see capture_file.h.
+// - Data: Received bytes. The timestamp is the time, they were taken from the capture.
+// - Overrun: u32 bytes, which were dropped before the next Data frame.
+// - End: u32 sent bytes, u32 dropped bytes.
+
+#define STREAM_FRAME_SYNC        0x5AA5
+#define STREAM_FRAME_HEADER_SIZE 18
+#define STREAM_FRAME_CRC_SIZE    4
+#define STREAM_FRAME_OVERHEAD    (STREAM_FRAME_HEADER_SIZE + STREAM_FRAME_CRC_SIZE)
+#define STREAM_FRAME_MAX_PAYLOAD 1024
+
+typedef enum {
+    StreamFrameTypeStart = 1,
+    StreamFrameTypeData,
+    StreamFrameTypeOverrun,
+    StreamFrameTypeEnd,
+} StreamFrameType;
+
+typedef struct {
+    uint8_t type;
+    uint32_t sequence;
+    uint64_t timestamp;
+    const uint8_t* payload;
+    size_t length;
+} StreamFrame;
+
+// Writes the header of a frame with length bytes payload to dst and returns the payload, which has
+// to be filled in before stream_frame_end is called. dst needs room for length +
+// STREAM_FRAME_OVERHEAD bytes.
+uint8_t* stream_frame_begin(
+    uint8_t* dst,
+    uint8_t type,
+    uint32_t sequence,
+    uint64_t timestamp,
+    size_t length);
+// Appends the CRC and returns the size of the whole frame
+size_t stream_frame_end(uint8_t* dst);
+
+static inline void stream_frame_put_u32(uint8_t* dst, uint32_t value) {
+    dst[0] = value;
+    dst[1] = value >> 8;
+    dst[2] = value >> 16;
+    dst[3] = value >> 24;
+}
+
+static inline uint32_t stream_frame_get_u32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+typedef struct {
+    uint8_t buffer[STREAM_FRAME_OVERHEAD + STREAM_FRAME_MAX_PAYLOAD];
+    size_t length; // Buffered bytes
+    size_t consumed; // Bytes of the returned frame, which are dropped with the next call
+    uint32_t skipped; // Bytes outside of frames
+    uint32_t crc_errors; // Dropped frames
+} StreamFrameDecoder;
+
+void stream_frame_decoder_init(StreamFrameDecoder* decoder);
+// Takes bytes from data, until a frame is complete. Returns the number of taken bytes. frame is
+// only valid, if complete is true, and only until the next call. A resync can leave further frames
+// in the buffer, so calls with the remaining, even zero, bytes continue until complete is false.
+size_t stream_frame_decoder_feed(
+    StreamFrameDecoder* decoder,
+    const uint8_t* data,
+    size_t length,
+    StreamFrame* frame,
+    bool* complete);
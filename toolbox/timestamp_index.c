@@ -0,0 +1,94 @@
+#include "timestamp_index.h"
+
+#include <furi.h>
+
+// Kind + position delta + zigzag encoded cycle delta
+#define TIMESTAMP_INDEX_MAX_ENTRY_SIZE (1 + 5 + 10)
+
+static size_t timestamp_index_put_varint(uint8_t* dst, uint64_t value) {
+    size_t length = 0;
+    while(value >= 0x80) {
+        dst[length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    dst[length++] = value;
+    return length;
+}
+
+static size_t
+    timestamp_index_get_varint(const SpscRing* ring, size_t offset, uint64_t* value) {
+    size_t length = 0;
+    uint8_t byte;
+    *value = 0;
+    do {
+        byte = spsc_ring_get(ring, offset + length);
+        *value |= (uint64_t)(byte & 0x7F) << (7 * length);
+        length++;
+    } while(byte & 0x80);
+    return length;
+}
+
+TimestampIndex* timestamp_index_alloc(size_t capacity) {
+    TimestampIndex* index = malloc(sizeof(TimestampIndex));
+    index->ring = spsc_ring_alloc(capacity);
+    timestamp_index_reset(index);
+    return index;
+}
+
+void timestamp_index_free(TimestampIndex* index) {
+    furi_check(index);
+
+    spsc_ring_free(index->ring);
+    free(index);
+}
+
+void timestamp_index_reset(TimestampIndex* index) {
+    furi_check(index);
+
+    spsc_ring_reset(index->ring);
+    memset(&index->written, 0, sizeof(index->written));
+    memset(&index->read, 0, sizeof(index->read));
+}
+
+bool timestamp_index_add(TimestampIndex* index, const TimestampIndexEntry* entry) {
+    // Cycles are not monotonic, edges are captured before chunks are delivered
+    const int64_t delta = entry->cycles - index->written.cycles;
+
+    uint8_t data[TIMESTAMP_INDEX_MAX_ENTRY_SIZE];
+    size_t length = 0;
+    data[length++] = entry->kind;
+    length += timestamp_index_put_varint(data + length, entry->position - index->written.position);
+    length += timestamp_index_put_varint(data + length, (delta << 1) ^ (delta >> 63));
+
+    SpscRingSpan spans[2];
+    if(spsc_ring_reserve(index->ring, length, spans) != length) {
+        return false;
+    }
+
+    memcpy(spans[0].data, data, spans[0].length);
+    memcpy(spans[1].data, data + spans[0].length, spans[1].length);
+    spsc_ring_commit(index->ring, length);
+
+    index->written = *entry;
+    return true;
+}
+
+bool timestamp_index_read(TimestampIndex* index, TimestampIndexEntry* entry) {
+    if(spsc_ring_size(index->ring) == 0) {
+        return false;
+    }
+
+    uint64_t position;
+    uint64_t delta;
+    size_t length = 0;
+    entry->kind = spsc_ring_get(index->ring, length++);
+    length += timestamp_index_get_varint(index->ring, length, &position);
+    length += timestamp_index_get_varint(index->ring, length, &delta);
+    spsc_ring_consume(index->ring, length);
+
+    entry->position = index->read.position + (uint32_t)position;
+    entry->cycles = index->read.cycles + (int64_t)((delta >> 1) ^ -(delta & 1));
+
+    index->read = *entry;
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "spsc_ring.h"
+
+// Timestamps of positions in a data stream. Entries are delta encoded against the previous entry
+// (variable length, about 4 bytes for a entry) and passed from a single producer to a single
+// consumer, e.g. from a ISR to a thread. A entry is either written completely or not at all.
+
+typedef enum {
+    TimestampIndexKindChunk, // Data up to position was delivered
+    TimestampIndexKindFrameStart, // A transaction started at position
+    TimestampIndexKindFrameEnd, // A transaction ended at position
+} TimestampIndexKind;
+
+typedef struct {
+    TimestampIndexKind kind;
+    uint32_t position; // Stream offset
+    uint64_t cycles; // See CycleClock
+} TimestampIndexEntry;
+
+typedef struct {
+    SpscRing* ring;
+    TimestampIndexEntry written; // Producer side: Last written entry
+    TimestampIndexEntry read; // Consumer side: Last read entry
+} TimestampIndex;
+
+// capacity in bytes, has to be a power of two
+TimestampIndex* timestamp_index_alloc(size_t capacity);
+void timestamp_index_free(TimestampIndex* index);
+// Not thread safe. Neither producer nor consumer may access the index at the same time.
+void timestamp_index_reset(TimestampIndex* index);
+
+// Producer side. Returns false, if the index is full. The entry is dropped in this case.
+bool timestamp_index_add(TimestampIndex* index, const TimestampIndexEntry* entry);
+// Consumer side. Returns false, if there is no entry.
+bool timestamp_index_read(TimestampIndex* index, TimestampIndexEntry* entry);
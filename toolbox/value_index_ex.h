@@ -15,3 +15,13 @@ size_t value_index_buffer_behaviour(
     const TerminalBufferBehaviour value,
     const TerminalBufferBehaviour values[],
     size_t values_count);
+
+size_t value_index_ingest_mode(
+    const TerminalIngestMode value,
+    const TerminalIngestMode values[],
+    size_t values_count);
+
+size_t value_index_framing_mode(
+    const TerminalFramingMode value,
+    const TerminalFramingMode values[],
+    size_t values_count);
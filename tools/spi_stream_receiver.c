@@ -0,0 +1,273 @@
+// Receives `spi stream` from the CLI of a Flipper Zero and stores it as capture file (.spicap).
+//
+// Build on Linux from the root of the repository:
+//   gcc -O2 -o spi_stream_receiver tools/spi_stream_receiver.c toolbox/stream_frame.c
+//       toolbox/crc32.c toolbox/capture_file.c
+//
+// Usage: spi_stream_receiver /dev/ttyACM0 capture.spicap
+// Start the Terminal Screen first. Ctrl+C stops the stream and finishes the file.
+
+#include "../toolbox/capture_file.h"
+#include "../toolbox/stream_frame.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RECEIVER_CHUNK_SIZE  4096
+#define RECEIVER_READ_SIZE   (64 * 1024)
+#define RECEIVER_FILE_BUFFER (1024 * 1024)
+// Time for the End frame after Ctrl+C was sent
+#define RECEIVER_STOP_TIMEOUT_MS 2000
+
+typedef struct {
+    FILE* file;
+    CaptureFileWriter* writer; // NULL => no Start frame yet
+    uint32_t sequence; // Expected sequence number
+    uint64_t timestamp; // Of the last stored timestamp
+    uint64_t lost_frames;
+    uint64_t overruns;
+    uint64_t dropped; // Reported by Overrun frames
+    uint64_t bytes;
+    bool ended;
+} Receiver;
+
+static volatile sig_atomic_t receiver_interrupted = 0;
+
+static void receiver_on_signal(int signal) {
+    (void)signal;
+    receiver_interrupted = 1;
+}
+
+static uint64_t receiver_now_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static size_t receiver_write(void* context, const void* data, size_t length) {
+    return fwrite(data, 1, length, context);
+}
+
+static bool receiver_start(Receiver* receiver, const StreamFrame* frame, const char* path) {
+    if(frame->length < 12) {
+        return false;
+    }
+
+    CaptureFileHeader header = {
+        .chunk_size = RECEIVER_CHUNK_SIZE,
+        .clock_hz = stream_frame_get_u32(frame->payload),
+        .frame_size = stream_frame_get_u32(frame->payload + 4),
+    };
+    uint32_t count = stream_frame_get_u32(frame->payload + 8);
+    if(count > (frame->length - 12) / 4) {
+        return false;
+    }
+    header.config_count = count < CaptureFileConfigCount ? count : CaptureFileConfigCount;
+    for(uint32_t i = 0; i < header.config_count; i++) {
+        header.config[i] = stream_frame_get_u32(frame->payload + 12 + i * 4);
+    }
+
+    receiver->file = fopen(path, "wb");
+    if(receiver->file == NULL) {
+        fprintf(stderr, "Can not create %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    setvbuf(receiver->file, NULL, _IOFBF, RECEIVER_FILE_BUFFER);
+
+    const CaptureFileIo io = {
+        .context = receiver->file,
+        .write = receiver_write,
+    };
+    receiver->writer = capture_file_writer_alloc(&io, &header);
+    if(receiver->writer == NULL) {
+        fprintf(stderr, "Writing %s failed\n", path);
+        return false;
+    }
+
+    fprintf(stderr, "Receiving, clock %u Hz, frame size %u\n", header.clock_hz, header.frame_size);
+    return true;
+}
+
+static void receiver_handle(Receiver* receiver, const StreamFrame* frame, const char* path) {
+    if(receiver->writer == NULL) {
+        // Frames of a previous stream are skipped
+        if(frame->type == StreamFrameTypeStart) {
+            if(!receiver_start(receiver, frame, path)) {
+                receiver->ended = true;
+            }
+            receiver->sequence = frame->sequence + 1;
+        }
+        return;
+    }
+
+    if(frame->sequence != receiver->sequence) {
+        const uint32_t lost = frame->sequence - receiver->sequence;
+        fprintf(stderr, "%u frames lost\n", lost);
+        receiver->lost_frames += lost;
+        capture_file_writer_end_frame(receiver->writer, true);
+    }
+    receiver->sequence = frame->sequence + 1;
+
+    switch(frame->type) {
+    case StreamFrameTypeData:
+        if(frame->timestamp != receiver->timestamp) {
+            capture_file_writer_add_timestamp(
+                receiver->writer, receiver->bytes, frame->timestamp);
+            receiver->timestamp = frame->timestamp;
+        }
+        capture_file_writer_write(receiver->writer, frame->payload, frame->length);
+        receiver->bytes += frame->length;
+        break;
+
+    case StreamFrameTypeOverrun:
+        if(frame->length >= 4) {
+            const uint32_t dropped = stream_frame_get_u32(frame->payload);
+            fprintf(stderr, "Overrun, %u bytes dropped\n", dropped);
+            receiver->dropped += dropped;
+        }
+        receiver->overruns++;
+        capture_file_writer_end_frame(receiver->writer, true);
+        break;
+
+    case StreamFrameTypeEnd:
+        if(frame->length >= 8) {
+            fprintf(
+                stderr,
+                "Stream ended, %u bytes sent, %u bytes dropped\n",
+                stream_frame_get_u32(frame->payload),
+                stream_frame_get_u32(frame->payload + 4));
+        }
+        receiver->ended = true;
+        break;
+
+    default:
+        break; // Newer frame types
+    }
+}
+
+static bool receiver_open_tty(const char* path, int* fd) {
+    *fd = open(path, O_RDWR | O_NOCTTY);
+    if(*fd < 0) {
+        fprintf(stderr, "Can not open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    struct termios options;
+    if(tcgetattr(*fd, &options) == 0) {
+        cfmakeraw(&options);
+        options.c_cc[VMIN] = 0;
+        options.c_cc[VTIME] = 0;
+        tcsetattr(*fd, TCSANOW, &options);
+        tcflush(*fd, TCIFLUSH);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "Usage: %s <tty> <output.spicap>\n", argv[0]);
+        return 2;
+    }
+
+    int fd;
+    if(!receiver_open_tty(argv[1], &fd)) {
+        return 1;
+    }
+
+    signal(SIGINT, receiver_on_signal);
+    signal(SIGTERM, receiver_on_signal);
+
+    static const char command[] = "spi stream\r";
+    if(write(fd, command, sizeof(command) - 1) != sizeof(command) - 1) {
+        fprintf(stderr, "Sending the command failed: %s\n", strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    static uint8_t data[RECEIVER_READ_SIZE];
+    static StreamFrameDecoder decoder;
+    stream_frame_decoder_init(&decoder);
+    Receiver receiver = {0};
+    uint64_t deadline = 0; // Stop was requested, 0 => not yet
+    const uint64_t start = receiver_now_ms();
+
+    while(!receiver.ended) {
+        if(receiver_interrupted && deadline == 0) {
+            const uint8_t ctrl_c = 0x03;
+            if(write(fd, &ctrl_c, 1) != 1) {
+                break;
+            }
+            deadline = receiver_now_ms() + RECEIVER_STOP_TIMEOUT_MS;
+        }
+        if(deadline != 0 && receiver_now_ms() >= deadline) {
+            fprintf(stderr, "No end of the stream received\n");
+            break;
+        }
+
+        struct pollfd poll_fd = {.fd = fd, .events = POLLIN};
+        if(poll(&poll_fd, 1, 100) <= 0) {
+            continue;
+        }
+        const ssize_t length = read(fd, data, sizeof(data));
+        if(length <= 0) {
+            if(length < 0 && errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Connection closed\n");
+            break;
+        }
+
+        // Frames behind a resync are already buffered, so the decoder is called again without
+        // new bytes, until it has no more frames
+        size_t offset = 0;
+        bool complete = true;
+        while((offset < (size_t)length || complete) && !receiver.ended) {
+            StreamFrame frame;
+            offset += stream_frame_decoder_feed(
+                &decoder, data + offset, length - offset, &frame, &complete);
+            if(complete) {
+                receiver_handle(&receiver, &frame, argv[2]);
+            }
+        }
+    }
+
+    close(fd);
+
+    int result = 0;
+    if(receiver.writer != NULL) {
+        if(!capture_file_writer_finish(receiver.writer)) {
+            fprintf(stderr, "Writing %s failed\n", argv[2]);
+            result = 1;
+        }
+        capture_file_writer_free(receiver.writer);
+    } else {
+        fprintf(stderr, "No stream received\n");
+        result = 1;
+    }
+    if(receiver.file != NULL && fclose(receiver.file) != 0) {
+        result = 1;
+    }
+
+    const uint64_t elapsed = receiver_now_ms() - start;
+    fprintf(
+        stderr,
+        "%llu bytes in %llu ms (%llu KiB/s), %llu lost frames, %llu overruns with %llu bytes, "
+        "%u CRC errors\n",
+        (unsigned long long)receiver.bytes,
+        (unsigned long long)elapsed,
+        (unsigned long long)(receiver.bytes * 1000 / 1024 / (elapsed ? elapsed : 1)),
+        (unsigned long long)receiver.lost_frames,
+        (unsigned long long)receiver.overruns,
+        (unsigned long long)receiver.dropped,
+        decoder.crc_errors);
+
+    return result;
+}
@@ -1,20 +1,68 @@
 #include "terminal_view.h"
+#include "terminal_view_lut.h"
 #include <gui/canvas.h>
 #include <gui/elements.h>
+#include <furi_hal_cortex.h>
 
 #define TAG "Terminal View"
 
+#define TERMINAL_VIEW_CAPTURE_CHUNK_SIZE   1024
+// Heap, which is left for the GUI and the CLI on "Max". The reserve of the caller comes on top.
+#define TERMINAL_VIEW_CAPTURE_HEAP_RESERVE (16 * 1024)
+
+// Fits a row of every display mode on the 128 px wide screen, including padding
+#define TERMINAL_VIEW_ROW_MAX_LENGTH 64
+// Needs to be at least the number of visible rows
+#define TERMINAL_VIEW_ROW_CACHE_SIZE 8
+// Number of transactions, which are remembered. Older ones are dropped.
+#define TERMINAL_VIEW_TRANSACTION_INDEX_SIZE 128
+
 struct TerminalView {
     View* view;
 };
 
+// Transaction, e.g. everything between a CS assertion and deassertion. Stream offsets.
 typedef struct {
-    uint8_t buffer[4096];
-    uint8_t* tail;
-    size_t size;
+    size_t start;
+    size_t length;
+} TerminalViewTransaction;
+
+// Formatted row. Rows only change, if bytes were added or dropped.
+typedef struct {
+    bool valid;
+    size_t start; // Stream offset of the start of the row
+    size_t begin; // Stream offset of the first byte in the row
+    size_t end; // Stream offset after the last byte in the row
+    char text[TERMINAL_VIEW_ROW_MAX_LENGTH];
+} TerminalViewRowCacheEntry;
+
+typedef struct {
+    ChunkArena arena;
+    SpscRing ring; // Rolling buffer on top of arena. Oldest bytes are dropped, if it's full.
+    // The CLI thread reads the capture buffer, while the app thread may replace it. Both hold
+    // capture_lock. Appending does not need it, it never frees the buffer.
+    FuriMutex* capture_lock;
     size_t scroll_offset;
-    FuriString* tmp_str;
     TerminalDisplayMode display_mode;
+    size_t frame_size; // 1 or 2 bytes, see terminal_view_set_frame_size
+    LatencyHistogram* draw_profile;
+    FuriString* overlay_text;
+    bool overlay_visible;
+    char status[16]; // Always visible, '\0' => none
+    size_t row_cache_key; // Display mode, frame size and row length of the cached rows
+    TerminalViewRowCacheEntry row_cache[TERMINAL_VIEW_ROW_CACHE_SIZE];
+    // Side index of the capture ring. Every transaction starts on a new row.
+    TerminalViewTransaction transactions[TERMINAL_VIEW_TRANSACTION_INDEX_SIZE];
+    size_t transaction_head; // Total number of added transactions
+    size_t transaction_tail; // Total number of dropped transactions
+    size_t transaction_start; // Stream offset of the open transaction
+    // Paged source, which replaces the capture ring. NULL => ring. The GUI thread draws and the
+    // app thread prefetches, both hold pages_lock while they access it.
+    PageCache* pages;
+    FuriMutex* pages_lock;
+    size_t scroll_target; // Byte offset, the next redraw scrolls to. SIZE_MAX => none.
+    size_t row_bytes; // Bytes per row of the last redraw, 0 => not drawn yet
+    size_t visible_rows; // Rows of the last redraw
 } TerminalViewModel;
 
 #define TERMINAL_VIEW_CONTEXT_TO_TERMINAL(context) \
@@ -49,85 +97,103 @@ typedef struct {
     size_t total;
 } TerminalViewScrollInfo;
 
-typedef void (*TerminalViewDrawTableAddByteToStrCallback)(uint8_t byte, FuriString* str);
+// Writes the glyphs of value to dst and returns the end of them. value is a single byte or, for
+// hex and binary, a whole frame of frame_size bytes.
+typedef char* (*TerminalViewDrawTableAddFrameCallback)(uint16_t value, char* dst);
 
-typedef void (*TerminalViewDrawTableAddEndOfRowCallback)(
+// Appends something after the frames of a row. offset is the first byte of the row, which is
+// still in the buffer. missing bytes at the start of the row were dropped already.
+typedef char* (*TerminalViewDrawTableAddEndOfRowCallback)(
     TerminalViewModel* model,
-    uint8_t* start,
-    size_t row,
-    size_t byte_per_row,
-    size_t byte_in_row,
-    FuriString* str);
-
-static bool terminal_view_byte_is_printable(uint8_t b) {
-    return (b >= '!' && b <= '~');
-}
+    size_t offset,
+    size_t missing,
+    size_t length,
+    char* dst);
 
-static inline uint8_t* terminal_view_wrap_buffer_pointer(TerminalViewModel* model, uint8_t* ptr) {
-    int pos = ptr - model->buffer;
+typedef struct {
+    size_t frame_size;
+    size_t frames_per_row;
+    size_t chars_per_frame;
+    char separator; // '\0' => none
+    TerminalViewDrawTableAddFrameCallback add_frame_cb;
+    TerminalViewDrawTableAddEndOfRowCallback add_end_of_row_cb;
+} TerminalViewTableFormat;
 
-    int offset_from_start_of_buffer = pos % sizeof(model->buffer);
+static inline uint8_t terminal_view_get_byte_value_from_start(
+    TerminalViewModel* model,
+    size_t start,
+    size_t offset) {
+    if(model->pages) {
+        return page_cache_get(model->pages, start + offset);
+    }
+    return spsc_ring_get(&model->ring, start + offset);
+}
 
-    return model->buffer + offset_from_start_of_buffer;
+// Stream offset of the oldest byte. Offsets of a paged source start at 0.
+static inline size_t terminal_view_source_position(TerminalViewModel* model) {
+    return model->pages ? 0 : spsc_ring_position(&model->ring);
 }
 
-static inline uint8_t* terminal_view_buffer_get_byte_form_start(
-    TerminalViewModel* model,
-    uint8_t* start,
-    size_t offset) {
-    return terminal_view_wrap_buffer_pointer(model, start + offset);
+static inline size_t terminal_view_source_size(TerminalViewModel* model) {
+    return model->pages ? page_cache_length(model->pages) : spsc_ring_size(&model->ring);
 }
 
-static inline uint8_t terminal_view_get_byte_value_from_start(
+// Frames are stored little endian, just like the DMA writes them
+static inline uint16_t terminal_view_get_frame_value_from_start(
     TerminalViewModel* model,
-    uint8_t* start,
-    size_t offset) {
-    uint8_t* ptr = terminal_view_buffer_get_byte_form_start(model, start, offset);
-    return *ptr;
+    size_t start,
+    size_t offset,
+    size_t frame_size) {
+    uint16_t value = terminal_view_get_byte_value_from_start(model, start, offset);
+    if(frame_size == 2) {
+        value |= terminal_view_get_byte_value_from_start(model, start, offset + 1) << 8;
+    }
+    return value;
 }
 
-static uint8_t* terminal_view_get_start_of_data(TerminalViewModel* model, size_t bytes_in_row) {
-    uint8_t* start;
-    if(model->size != sizeof(model->buffer)) {
-        start = model->buffer;
-    } else {
-        start = model->tail;
+static void terminal_view_row_cache_invalidate(TerminalViewModel* model) {
+    for(size_t i = 0; i < TERMINAL_VIEW_ROW_CACHE_SIZE; i++) {
+        model->row_cache[i].valid = false;
     }
-
-    start = start + (model->scroll_offset * bytes_in_row);
-
-    return terminal_view_wrap_buffer_pointer(model, start);
 }
 
-static inline void terminal_view_draw_table_row(
-    Canvas* canvas,
+// Formats length bytes, starting at offset from the oldest byte, into line
+static void terminal_view_draw_table_render_row(
     TerminalViewModel* model,
-    const TerminalViewDrawInfo* info,
-    size_t row,
-    uint8_t* start,
-    size_t byte_per_row,
-    size_t byte_in_row,
-    size_t chars_per_byte,
-    FuriString* str,
-    TerminalViewDrawTableAddEndOfRowCallback add_end_of_row_cb) {
-    const size_t x = info->frame_padding;
-
-    const size_t y = info->frame_padding + // padding from top
-                     info->glyph_height + // strings start to drawing from the bottom
-                     (info->glyph_height * row); // offset for row
-
-    for(size_t i = byte_in_row; i < byte_per_row; i++) {
-        for(size_t j = 0; j < chars_per_byte; j++) {
-            furi_string_push_back(str, ' ');
+    const TerminalViewTableFormat* format,
+    size_t offset,
+    size_t missing,
+    size_t length,
+    char* line) {
+    const size_t frame_size = format->frame_size;
+    const size_t separator_width = format->separator != '\0' ? 1 : 0;
+    char* end = line;
+
+    // Frames, which were dropped already
+    const size_t missing_frames = missing / frame_size;
+    memset(end, ' ', missing_frames * (format->chars_per_frame + separator_width));
+    end += missing_frames * (format->chars_per_frame + separator_width);
+
+    for(size_t i = 0; i < length; i += frame_size) {
+        uint16_t value = terminal_view_get_frame_value_from_start(model, offset, i, frame_size);
+
+        end = format->add_frame_cb(value, end);
+
+        if(format->separator != '\0') { // separator between frames/chars
+            *end++ = format->separator;
         }
-        furi_string_push_back(str, ' ');
     }
 
-    if(add_end_of_row_cb) {
-        add_end_of_row_cb(model, start, row, byte_per_row, byte_in_row, str);
+    // Frames, which were not received yet
+    const size_t empty_frames = format->frames_per_row - missing_frames - (length / frame_size);
+    memset(end, ' ', empty_frames * (format->chars_per_frame + separator_width));
+    end += empty_frames * (format->chars_per_frame + separator_width);
+
+    if(format->add_end_of_row_cb) {
+        end = format->add_end_of_row_cb(model, offset, missing, length, end);
     }
 
-    canvas_draw_str(canvas, x, y, furi_string_get_cstr(str));
+    *end = '\0';
 }
 
 static inline size_t
@@ -140,77 +206,193 @@ static inline size_t
     }
 }
 
+// Visible row. All offsets are absolute stream offsets.
+typedef struct {
+    size_t start; // First byte of the row, may be before begin
+    size_t begin; // First byte in the buffer
+    size_t end; // After the last byte in the buffer
+} TerminalViewRow;
+
+// Offset of position relative to base. Positions before base are clamped to 0.
+static inline size_t terminal_view_relative_position(size_t base, size_t position) {
+    return (ptrdiff_t)(position - base) > 0 ? position - base : 0;
+}
+
+// Splits the buffer into rows and returns the total number of rows. rows is filled with the rows
+// from first to first + count. Rows are anchored to absolute stream offsets, which keeps the
+// content of a row stable, while old bytes are dropped. Every transaction starts a new row.
+static size_t terminal_view_layout_rows(
+    TerminalViewModel* model,
+    size_t bytes_per_row,
+    size_t frame_size,
+    size_t first,
+    size_t count,
+    TerminalViewRow* rows) {
+    const size_t oldest = terminal_view_source_position(model);
+    const size_t size = terminal_view_source_size(model) / frame_size * frame_size;
+
+    // Everything is calculated relative to base, which is the start of the row of the oldest byte
+    const size_t lead = oldest % bytes_per_row;
+    const size_t base = oldest - lead;
+    const size_t newest = lead + size;
+
+    // Transactions, which were dropped from the capture ring
+    while(model->transaction_tail != model->transaction_head) {
+        const TerminalViewTransaction* transaction =
+            &model->transactions[model->transaction_tail % TERMINAL_VIEW_TRANSACTION_INDEX_SIZE];
+        if((ptrdiff_t)(transaction->start + transaction->length - oldest) > 0) {
+            break;
+        }
+        model->transaction_tail++;
+    }
+
+    size_t total = 0;
+    size_t anchor = 0;
+    size_t begin = lead;
+    size_t index = model->transaction_tail;
+    while(begin < newest) {
+        // Segment ends at the next start or end of a transaction
+        size_t end = newest;
+        for(; index != model->transaction_head; index++) {
+            const TerminalViewTransaction* transaction =
+                &model->transactions[index % TERMINAL_VIEW_TRANSACTION_INDEX_SIZE];
+            const size_t start = terminal_view_relative_position(base, transaction->start);
+            const size_t stop =
+                terminal_view_relative_position(base, transaction->start + transaction->length);
+
+            if(start == begin || stop == begin) {
+                anchor = begin;
+            }
+            if(start > begin) {
+                end = MIN(start, newest);
+                break;
+            }
+            if(stop > begin) {
+                end = MIN(stop, newest);
+                break;
+            }
+        }
+
+        const size_t segment_rows =
+            terminal_view_draw_table_calculate_total_numer_of_rows(end - anchor, bytes_per_row);
+
+        // Only visible rows are filled in
+        const size_t from = MAX(first, total);
+        const size_t to = MIN(first + count, total + segment_rows);
+        for(size_t table_row = from; table_row < to; table_row++) {
+            const size_t row_start = anchor + (table_row - total) * bytes_per_row;
+            TerminalViewRow* row = &rows[table_row - first];
+            row->start = base + row_start;
+            row->begin = base + MAX(row_start, begin);
+            row->end = base + MIN(row_start + bytes_per_row, end);
+        }
+
+        total += segment_rows;
+        begin = end;
+        anchor = end;
+    }
+
+    return total;
+}
+
+// Returns the cache entry with the formatted row. used contains the entries, which are needed for
+// the current redraw and must not be replaced.
+static TerminalViewRowCacheEntry* terminal_view_row_cache_find(
+    TerminalViewModel* model,
+    const TerminalViewRow* row,
+    uint32_t* used) {
+    for(size_t i = 0; i < TERMINAL_VIEW_ROW_CACHE_SIZE; i++) {
+        TerminalViewRowCacheEntry* entry = &model->row_cache[i];
+        if(entry->valid && entry->start == row->start && entry->begin == row->begin &&
+           entry->end == row->end) {
+            *used |= 1 << i;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
 static TerminalViewScrollInfo terminal_view_draw_table(
     Canvas* canvas,
     TerminalViewModel* model,
     const TerminalViewDrawInfo* info,
-    size_t bytes_per_row,
-    size_t chars_per_byte,
-    const char* separator,
-    TerminalViewDrawTableAddByteToStrCallback add_byte_to_str_cb,
-    TerminalViewDrawTableAddEndOfRowCallback add_end_of_row_cb) {
-    const size_t bytes_on_screen = bytes_per_row * info->rows; // max number of bytes on screen
-    const size_t total_numer_of_rows =
-        terminal_view_draw_table_calculate_total_numer_of_rows(model->size, bytes_per_row);
+    const TerminalViewTableFormat* format) {
+    const size_t frame_size = format->frame_size;
+    const size_t bytes_per_row = format->frames_per_row * frame_size;
+    furi_check(bytes_per_row > 0);
+    furi_check(info->rows <= TERMINAL_VIEW_ROW_CACHE_SIZE);
+
+    // Row including padding, the ASCII column of Hex and the terminator has to fit into a entry
+    const size_t end_of_row_length = format->add_end_of_row_cb ? 2 + bytes_per_row : 0;
+    furi_check(
+        format->frames_per_row * (format->chars_per_frame + 1) + end_of_row_length <
+        TERMINAL_VIEW_ROW_MAX_LENGTH);
+
+    // Cached rows are only valid for the format, they were rendered with
+    const size_t cache_key = (model->display_mode << 16) | (frame_size << 8) | bytes_per_row;
+    if(model->row_cache_key != cache_key) {
+        terminal_view_row_cache_invalidate(model);
+        model->row_cache_key = cache_key;
+    }
+
+    model->row_bytes = bytes_per_row;
+    model->visible_rows = info->rows;
+    if(model->scroll_target != SIZE_MAX) {
+        // Rows of a paged source are not split by transactions
+        model->scroll_offset = model->scroll_target / bytes_per_row;
+        model->scroll_target = SIZE_MAX;
+    }
+
+    TerminalViewRow rows[TERMINAL_VIEW_ROW_CACHE_SIZE];
+    const size_t total_numer_of_rows = terminal_view_layout_rows(
+        model, bytes_per_row, frame_size, model->scroll_offset, info->rows, rows);
     if(model->scroll_offset + info->rows > total_numer_of_rows) {
         if(total_numer_of_rows < info->rows) {
             model->scroll_offset = 0;
         } else {
             model->scroll_offset = total_numer_of_rows - info->rows;
         }
-    }
-
-    uint8_t* start = terminal_view_get_start_of_data(model, bytes_per_row);
-
-    furi_string_reset(model->tmp_str);
-    size_t to_print =
-        MIN(model->size - (model->scroll_offset * bytes_per_row),
-            bytes_on_screen); // how many chars need to be printed
-    size_t current_row = 0; // offset of current row
-    size_t in_row = 0; // printed number of bytes in current row
-    size_t offset = 0; // offset of current byte
-    while(to_print > 0) {
-        uint8_t b = terminal_view_get_byte_value_from_start(model, start, offset);
 
-        add_byte_to_str_cb(b, model->tmp_str);
+        terminal_view_layout_rows(
+            model, bytes_per_row, frame_size, model->scroll_offset, info->rows, rows);
+    }
 
-        furi_string_cat_str(model->tmp_str, separator); // separator between bytes/chars
+    const size_t visible_rows = MIN(info->rows, total_numer_of_rows - model->scroll_offset);
 
-        offset++;
-        to_print--;
+    // Cached rows first, so they are not replaced by rows, which need to be formatted
+    uint32_t used = 0;
+    TerminalViewRowCacheEntry* entries[TERMINAL_VIEW_ROW_CACHE_SIZE];
+    for(size_t row = 0; row < visible_rows; row++) {
+        entries[row] = terminal_view_row_cache_find(model, &rows[row], &used);
+    }
 
-        in_row++;
-        if(in_row >= bytes_per_row) { // end of row reached
-            terminal_view_draw_table_row(
-                canvas,
+    const size_t oldest = terminal_view_source_position(model);
+    const size_t x = info->frame_padding;
+    for(size_t row = 0; row < visible_rows; row++) {
+        TerminalViewRowCacheEntry* entry = entries[row];
+        if(entry == NULL) {
+            const size_t index = __builtin_ctz(~used);
+            used |= 1 << index;
+
+            entry = &model->row_cache[index];
+            entry->valid = true;
+            entry->start = rows[row].start;
+            entry->begin = rows[row].begin;
+            entry->end = rows[row].end;
+            terminal_view_draw_table_render_row(
                 model,
-                info,
-                current_row,
-                start,
-                bytes_per_row,
-                in_row,
-                chars_per_byte,
-                model->tmp_str,
-                add_end_of_row_cb);
-            furi_string_reset(model->tmp_str);
-
-            in_row = 0;
-            current_row++;
+                format,
+                entry->begin - oldest,
+                entry->begin - entry->start,
+                entry->end - entry->begin,
+                entry->text);
         }
-    }
 
-    if(in_row > 0) {
-        terminal_view_draw_table_row(
-            canvas,
-            model,
-            info,
-            current_row,
-            start,
-            bytes_per_row,
-            in_row,
-            chars_per_byte,
-            model->tmp_str,
-            add_end_of_row_cb);
+        const size_t y = info->frame_padding + // padding from top
+                         info->glyph_height + // strings start to drawing from the bottom
+                         (info->glyph_height * row); // offset for row
+        canvas_draw_str(canvas, x, y, entry->text);
     }
 
     TerminalViewScrollInfo ret = {
@@ -220,137 +402,117 @@ static TerminalViewScrollInfo terminal_view_draw_table(
     return ret;
 }
 
-static void terminal_view_draw_auto_add_byte_to_str(uint8_t byte, FuriString* str) {
-    if(terminal_view_byte_is_printable(byte) && byte != '"' && byte != '\\' && byte != ' ' &&
-       byte != '\'') {
-        furi_string_push_back(str, byte);
-        furi_string_push_back(str, ' ');
-    } else {
-        if(byte == '\a') {
-            furi_string_cat_str(str, "\\a");
-        } else if(byte == '\b') {
-            furi_string_cat_str(str, "\\b");
-        } else if(byte == '\e') {
-            furi_string_cat_str(str, "\\e");
-        } else if(byte == '\f') {
-            furi_string_cat_str(str, "\\f");
-        } else if(byte == '\n') {
-            furi_string_cat_str(str, "\\n");
-        } else if(byte == '\r') {
-            furi_string_cat_str(str, "\\r");
-        } else if(byte == '\t') {
-            furi_string_cat_str(str, "\\t");
-        } else if(byte == '\v') {
-            furi_string_cat_str(str, "\\v");
-        } else if(byte == '\\') {
-            furi_string_cat_str(str, "\\\\");
-        } else if(byte == '\'') {
-            furi_string_cat_str(str, "\\'");
-        } else if(byte == '\"') {
-            furi_string_cat_str(str, "\\\"");
-        } else if(byte == ' ') {
-            furi_string_cat_str(str, "\\ ");
-        } else {
-            furi_string_cat_printf(str, "%02X", byte);
-        }
-    }
+static char* terminal_view_draw_auto_add_byte(uint16_t byte, char* dst) {
+    memcpy(dst, terminal_view_lut_auto[byte], 2);
+    return dst + 2;
 }
 
 static inline TerminalViewScrollInfo terminal_view_draw_auto(
     Canvas* canvas,
     TerminalViewModel* model,
     const TerminalViewDrawInfo* info) {
-    return terminal_view_draw_table(
-        canvas,
-        model,
-        info,
-        info->columns / 2,
-        2,
-        "",
-        terminal_view_draw_auto_add_byte_to_str,
-        NULL);
-}
-
-static void terminal_view_draw_text_add_byte_to_str(uint8_t byte, FuriString* str) {
-    if(terminal_view_byte_is_printable(byte)) {
-        furi_string_push_back(str, byte);
-    } else {
-        furi_string_push_back(str, ' ');
-    }
+    const TerminalViewTableFormat format = {
+        .frame_size = 1,
+        .frames_per_row = info->columns / 2,
+        .chars_per_frame = 2,
+        .separator = '\0',
+        .add_frame_cb = terminal_view_draw_auto_add_byte,
+        .add_end_of_row_cb = NULL,
+    };
+    return terminal_view_draw_table(canvas, model, info, &format);
+}
+
+static char* terminal_view_draw_text_add_byte(uint16_t byte, char* dst) {
+    *dst = terminal_view_lut_text[byte];
+    return dst + 1;
 }
 
 static inline TerminalViewScrollInfo terminal_view_draw_text(
     Canvas* canvas,
     TerminalViewModel* model,
     const TerminalViewDrawInfo* info) {
-    return terminal_view_draw_table(
-        canvas, model, info, info->columns, 1, "", terminal_view_draw_text_add_byte_to_str, NULL);
+    const TerminalViewTableFormat format = {
+        .frame_size = 1,
+        .frames_per_row = info->columns,
+        .chars_per_frame = 1,
+        .separator = '\0',
+        .add_frame_cb = terminal_view_draw_text_add_byte,
+        .add_end_of_row_cb = NULL,
+    };
+    return terminal_view_draw_table(canvas, model, info, &format);
+}
+
+static char* terminal_view_draw_hex_add_byte(uint16_t byte, char* dst) {
+    memcpy(dst, terminal_view_lut_hex[byte], 2);
+    return dst + 2;
 }
 
-static void terminal_view_draw_hex_add_byte_to_string(uint8_t byte, FuriString* str) {
-    furi_string_cat_printf(str, "%02X", byte);
+static char* terminal_view_draw_hex_add_frame(uint16_t frame, char* dst) {
+    dst = terminal_view_draw_hex_add_byte(frame >> 8, dst);
+    return terminal_view_draw_hex_add_byte(frame & 0xFF, dst);
 }
 
-static void terminal_view_draw_hex_append_data_as_string(
+static char* terminal_view_draw_hex_append_data_as_string(
     TerminalViewModel* model,
-    uint8_t* start,
-    size_t row,
-    size_t byte_per_row,
-    size_t byte_in_row,
-    FuriString* str) {
-    furi_string_push_back(str, '|');
-    furi_string_push_back(str, ' ');
-
-    for(size_t i = 0; i < byte_in_row; i++) {
-        uint8_t b =
-            terminal_view_get_byte_value_from_start(model, start, (row * byte_per_row) + i);
-
-        if(terminal_view_byte_is_printable(b)) {
-            furi_string_push_back(str, b);
-        } else {
-            furi_string_push_back(str, ' ');
-        }
+    size_t offset,
+    size_t missing,
+    size_t length,
+    char* dst) {
+    *dst++ = '|';
+    *dst++ = ' ';
+
+    memset(dst, ' ', missing);
+    dst += missing;
+
+    for(size_t i = 0; i < length; i++) {
+        uint8_t b = terminal_view_get_byte_value_from_start(model, offset, i);
+        *dst++ = terminal_view_lut_text[b];
     }
+
+    return dst;
 }
 
 static inline TerminalViewScrollInfo terminal_view_draw_hex(
     Canvas* canvas,
     TerminalViewModel* model,
     const TerminalViewDrawInfo* info) {
-    return terminal_view_draw_table(
-        canvas,
-        model,
-        info,
-        4,
-        2,
-        " ",
-        terminal_view_draw_hex_add_byte_to_string,
-        terminal_view_draw_hex_append_data_as_string);
-}
-
-static void terminal_view_draw_binary_add_byte_to_string(uint8_t byte, FuriString* str) {
-    for(int i = 7; i >= 0; i--) {
-        if(byte & (1 << i)) {
-            furi_string_push_back(str, '1');
-        } else {
-            furi_string_push_back(str, '0');
-        }
-    }
+    const TerminalViewTableFormat format = {
+        .frame_size = model->frame_size,
+        .frames_per_row = 4 / model->frame_size, // 4 byte per row
+        .chars_per_frame = 2 * model->frame_size,
+        .separator = ' ',
+        .add_frame_cb = model->frame_size == 2 ? terminal_view_draw_hex_add_frame :
+                                                 terminal_view_draw_hex_add_byte,
+        .add_end_of_row_cb = terminal_view_draw_hex_append_data_as_string,
+    };
+    return terminal_view_draw_table(canvas, model, info, &format);
+}
+
+static char* terminal_view_draw_binary_add_byte(uint16_t byte, char* dst) {
+    memcpy(dst, terminal_view_lut_binary[byte], 8);
+    return dst + 8;
+}
+
+static char* terminal_view_draw_binary_add_frame(uint16_t frame, char* dst) {
+    dst = terminal_view_draw_binary_add_byte(frame >> 8, dst);
+    return terminal_view_draw_binary_add_byte(frame & 0xFF, dst);
 }
 
 static inline TerminalViewScrollInfo terminal_view_draw_binary(
     Canvas* canvas,
     TerminalViewModel* model,
     const TerminalViewDrawInfo* info) {
-    return terminal_view_draw_table(
-        canvas,
-        model,
-        info,
-        info->columns / (8 + 1), // 8 => Bit per byte; 1 => Separator
-        8,
-        " ",
-        terminal_view_draw_binary_add_byte_to_string,
-        NULL);
+    const size_t bits = 8 * model->frame_size;
+    const TerminalViewTableFormat format = {
+        .frame_size = model->frame_size,
+        .frames_per_row = info->columns / (bits + 1), // 1 => Separator
+        .chars_per_frame = bits,
+        .separator = ' ',
+        .add_frame_cb = model->frame_size == 2 ? terminal_view_draw_binary_add_frame :
+                                                 terminal_view_draw_binary_add_byte,
+        .add_end_of_row_cb = NULL,
+    };
+    return terminal_view_draw_table(canvas, model, info, &format);
 }
 
 static TerminalViewScrollInfo terminal_view_call_draw(
@@ -376,10 +538,77 @@ static TerminalViewScrollInfo terminal_view_call_draw(
     }
 }
 
+static void terminal_view_draw_overlay(
+    Canvas* canvas,
+    TerminalViewModel* model,
+    const TerminalViewDrawInfo* info) {
+    const char* text = furi_string_get_cstr(model->overlay_text);
+
+    size_t lines = 1;
+    size_t longest_line = 0;
+    size_t line_length = 0;
+    for(const char* c = text; *c != '\0'; c++) {
+        if(*c == '\n') {
+            lines++;
+            line_length = 0;
+        } else {
+            line_length++;
+            longest_line = MAX(longest_line, line_length);
+        }
+    }
+
+    const size_t padding = 2;
+    const size_t width = MIN(longest_line * info->glyph_width + padding * 2, info->frame_width);
+    const size_t height = MIN(lines * info->glyph_height + padding * 2, info->frame_height);
+    const size_t x = info->frame_width - width;
+
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_box(canvas, x, 0, width, height);
+    canvas_set_color(canvas, ColorBlack);
+    elements_slightly_rounded_frame(canvas, x, 0, width, height);
+
+    char line[32];
+    size_t row = 0;
+    while(*text != '\0') {
+        size_t length = strcspn(text, "\n");
+        size_t copy = MIN(length, sizeof(line) - 1);
+        memcpy(line, text, copy);
+        line[copy] = '\0';
+
+        canvas_draw_str(canvas, x + padding, padding + info->glyph_height * (row + 1), line);
+
+        text += length;
+        if(*text == '\n') {
+            text++;
+        }
+        row++;
+    }
+}
+
+// Inverted label in the lower right corner of the frame
+static void terminal_view_draw_status(
+    Canvas* canvas,
+    TerminalViewModel* model,
+    const TerminalViewDrawInfo* info) {
+    const size_t padding = 1;
+    const size_t width = strlen(model->status) * info->glyph_width + padding * 2;
+    const size_t height = info->glyph_height + padding * 2;
+    const size_t x = info->frame_width - width;
+    const size_t y = info->frame_height - height;
+
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_box(canvas, x, y, width, height);
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_str(canvas, x + padding, y + padding + info->glyph_height - 1, model->status);
+    canvas_set_color(canvas, ColorBlack);
+}
+
 static void terminal_view_draw_callback(Canvas* canvas, void* context) {
     furi_check(canvas);
     TERMINAL_VIEW_CONTEXT_TO_MODEL(context);
 
+    const uint32_t start = DWT->CYCCNT;
+
     canvas_set_font(canvas, FontKeyboard);
 
     TerminalViewDrawInfo info = {0};
@@ -398,9 +627,23 @@ static void terminal_view_draw_callback(Canvas* canvas, void* context) {
 
     elements_slightly_rounded_frame(canvas, 0, 0, info.frame_width, info.frame_height);
 
+    if(model->pages) {
+        furi_mutex_acquire(model->pages_lock, FuriWaitForever);
+    }
     TerminalViewScrollInfo scroll_bar_draw_info = terminal_view_call_draw(canvas, model, &info);
+    if(model->pages) {
+        furi_mutex_release(model->pages_lock);
+    }
     elements_scrollbar(canvas, scroll_bar_draw_info.position, scroll_bar_draw_info.total);
 
+    if(model->status[0] != '\0') {
+        terminal_view_draw_status(canvas, model, &info);
+    }
+
+    if(model->overlay_visible && !furi_string_empty(model->overlay_text)) {
+        terminal_view_draw_overlay(canvas, model, &info);
+    }
+
     FURI_LOG_T(
         TAG,
         "Scrolling:\n"
@@ -408,6 +651,53 @@ static void terminal_view_draw_callback(Canvas* canvas, void* context) {
         "\tPosition: %zu",
         scroll_bar_draw_info.total,
         scroll_bar_draw_info.position);
+
+    if(model->draw_profile) {
+        latency_histogram_add(model->draw_profile, DWT->CYCCNT - start);
+    }
+}
+
+// Reads the pages of the screen at offset and of the next screen in direction, so the redraw does
+// not wait for the SD card. Called by the app thread, before the redraw is requested.
+static void terminal_view_prefetch(TerminalViewModel* model, size_t offset, int direction) {
+    const size_t screen = model->row_bytes * model->visible_rows;
+    if(model->pages == NULL || screen == 0) {
+        return; // The first redraw reads, what it needs
+    }
+
+    furi_mutex_acquire(model->pages_lock, FuriWaitForever);
+    page_cache_prefetch(model->pages, offset, screen);
+    if(direction > 0) {
+        page_cache_prefetch(model->pages, offset + screen, screen);
+    } else if(direction < 0) {
+        const size_t start = offset > screen ? offset - screen : 0;
+        page_cache_prefetch(model->pages, start, offset - start);
+    }
+    furi_mutex_release(model->pages_lock);
+}
+
+// Left and Right jump by a 16th of a paged source, holding them jumps to the start or the end
+static bool terminal_view_jump(TerminalViewModel* model, InputEvent* event) {
+    const size_t length = page_cache_length(model->pages);
+    const size_t top = model->scroll_offset * model->row_bytes;
+    const size_t step = MAX(length / 16, MAX(model->row_bytes, 1u));
+    const int direction = event->key == InputKeyRight ? 1 : -1;
+
+    size_t target;
+    if(event->type == InputTypeLong) {
+        target = direction > 0 ? length : 0;
+    } else if(direction > 0) {
+        target = MIN(top + step, length);
+    } else {
+        target = top > step ? top - step : 0;
+    }
+
+    model->scroll_target = target;
+    // The end is drawn with the last full screen
+    const size_t screen = model->row_bytes * model->visible_rows;
+    const size_t first = (target == length && length > screen) ? length - screen : target;
+    terminal_view_prefetch(model, first, 0);
+    return target != top;
 }
 
 static bool terminal_view_input_callback(InputEvent* event, void* context) {
@@ -431,13 +721,43 @@ static bool terminal_view_input_callback(InputEvent* event, void* context) {
                 }
 
                 handled = model->scroll_offset != old_offset;
+                if(handled) {
+                    terminal_view_prefetch(
+                        model,
+                        model->scroll_offset * model->row_bytes,
+                        event->key == InputKeyDown ? 1 : -1);
+                }
             },
             handled);
 
         return handled;
+    } else if((event->key == InputKeyLeft || event->key == InputKeyRight) &&
+              (event->type == InputTypeShort || event->type == InputTypeRepeat ||
+               event->type == InputTypeLong)) {
+        bool handled = false;
+        bool paged = false;
+        with_view_model(
+            view,
+            TerminalViewModel * model,
+            {
+                paged = model->pages != NULL;
+                if(paged) {
+                    handled = terminal_view_jump(model, event);
+                }
+            },
+            handled);
+
+        return paged;
     } else if(event->key == InputKeyBack && event->type == InputTypeLong) {
         terminal_view_reset(terminal);
         return true;
+    } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+        with_view_model(
+            view,
+            TerminalViewModel * model,
+            { model->overlay_visible = !model->overlay_visible; },
+            true);
+        return true;
     }
 
     return false;
@@ -457,12 +777,26 @@ TerminalView* terminal_view_alloc() {
         TerminalViewModel * model,
         {
             model->display_mode = TerminalDisplayModeText;
-            model->tail = model->buffer;
-            model->size = 0;
+            model->frame_size = 1;
+            // Capture buffer is allocated by terminal_view_set_capture_size
+            memset(&model->arena, 0, sizeof(model->arena));
+            memset(&model->ring, 0, sizeof(model->ring));
+            terminal_view_row_cache_invalidate(model);
+            model->transaction_head = 0;
+            model->transaction_tail = 0;
+            model->transaction_start = 0;
             model->scroll_offset = 0;
-
-            model->tmp_str = furi_string_alloc();
-            furi_string_reserve(model->tmp_str, 64);
+            model->draw_profile = NULL;
+            model->pages = NULL;
+            model->pages_lock = furi_mutex_alloc(FuriMutexTypeNormal);
+            model->capture_lock = furi_mutex_alloc(FuriMutexTypeNormal);
+            model->scroll_target = SIZE_MAX;
+            model->row_bytes = 0;
+            model->visible_rows = 0;
+
+            model->overlay_text = furi_string_alloc();
+            model->overlay_visible = false;
+            model->status[0] = '\0';
         },
         true);
 
@@ -479,7 +813,15 @@ void terminal_view_free(TerminalView* terminal) {
     furi_check(terminal);
 
     with_view_model(
-        terminal->view, TerminalViewModel * model, { furi_string_free(model->tmp_str); }, true);
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            furi_string_free(model->overlay_text);
+            furi_mutex_free(model->pages_lock);
+            furi_mutex_free(model->capture_lock);
+            chunk_arena_free(&model->arena);
+        },
+        true);
 
     furi_check(terminal->view);
     view_free(terminal->view);
@@ -494,9 +836,45 @@ void terminal_view_reset(TerminalView* terminal) {
         terminal->view,
         TerminalViewModel * model,
         {
-            model->tail = model->buffer;
-            model->size = 0;
+            spsc_ring_reset(&model->ring);
+            terminal_view_row_cache_invalidate(model);
+            model->transaction_head = 0;
+            model->transaction_tail = 0;
+            // An open transaction starts with the next appended byte
+            model->transaction_start = spsc_ring_end_position(&model->ring);
+            model->scroll_offset = 0;
+            model->scroll_target = SIZE_MAX;
+        },
+        true);
+}
+
+void terminal_view_set_pages(TerminalView* terminal, PageCache* pages) {
+    furi_check(terminal);
+
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            // A redraw may still use the previous source
+            furi_mutex_acquire(model->pages_lock, FuriWaitForever);
+            model->pages = pages;
+            furi_mutex_release(model->pages_lock);
+            terminal_view_row_cache_invalidate(model);
             model->scroll_offset = 0;
+            model->scroll_target = SIZE_MAX;
+        },
+        true);
+}
+
+void terminal_view_scroll_to(TerminalView* terminal, size_t offset) {
+    furi_check(terminal);
+
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            model->scroll_target = offset;
+            terminal_view_prefetch(model, offset, 1);
         },
         true);
 }
@@ -509,56 +887,271 @@ void terminal_view_set_display_mode(TerminalView* terminal, TerminalDisplayMode
         terminal->view, TerminalViewModel * model, { model->display_mode = mode; }, true);
 }
 
-void terminal_view_debug_print_buffer(TerminalView* terminal) {
+void terminal_view_set_frame_size(TerminalView* terminal, size_t frame_size) {
+    furi_check(terminal);
+    furi_check(frame_size == 1 || frame_size == 2);
+
+    with_view_model(
+        terminal->view, TerminalViewModel * model, { model->frame_size = frame_size; }, true);
+}
+
+void terminal_view_set_overlay_text(TerminalView* terminal, const char* text) {
+    furi_check(terminal);
+    furi_check(text);
+
+    bool update;
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            furi_string_set_str(model->overlay_text, text);
+            update = model->overlay_visible;
+        },
+        update);
+}
+
+void terminal_view_set_status(TerminalView* terminal, const char* status) {
+    furi_check(terminal);
+    furi_check(status);
+
+    bool update;
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            update = strcmp(model->status, status) != 0;
+            snprintf(model->status, sizeof(model->status), "%s", status);
+        },
+        update);
+}
+
+void terminal_view_set_draw_profile(TerminalView* terminal, LatencyHistogram* histogram) {
+    furi_check(terminal);
+
+    with_view_model(
+        terminal->view, TerminalViewModel * model, { model->draw_profile = histogram; }, false);
+}
+
+void terminal_view_get_capture_range(TerminalView* terminal, size_t* start, size_t* end) {
+    furi_check(terminal);
+    furi_check(start);
+    furi_check(end);
+
     with_view_model(
         terminal->view,
         TerminalViewModel * model,
         {
-            for(size_t i = 0; i < sizeof(model->buffer); i++) {
-                uint8_t c = model->buffer[i];
-                printf("\n%3zu: %02X", i, c);
+            *start = spsc_ring_position(&model->ring);
+            *end = spsc_ring_end_position(&model->ring);
+        },
+        false);
+}
+
+size_t terminal_view_read_capture(
+    TerminalView* terminal,
+    size_t position,
+    uint8_t* data,
+    size_t length) {
+    furi_check(terminal);
+    furi_check(data || length == 0);
 
-                if((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
-                    printf(" (%c)", c);
+    size_t read = 0;
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            furi_mutex_acquire(model->capture_lock, FuriWaitForever);
+
+            // Chunked ring, spans stop at the end of the second chunk
+            while(model->arena.chunks != NULL && read < length) {
+                SpscRingSpan spans[2];
+                const size_t part = spsc_ring_peek_span_at(
+                    &model->ring, position + read, length - read, spans);
+                if(part == 0) {
+                    break;
                 }
+                memcpy(data + read, spans[0].data, spans[0].length);
+                memcpy(data + read + spans[0].length, spans[1].data, spans[1].length);
+                read += part;
             }
+
+            // New data drops the oldest bytes, while this runs on another thread
+            if(read > 0 && !spsc_ring_contains(&model->ring, position, read)) {
+                read = 0;
+            }
+
+            furi_mutex_release(model->capture_lock);
         },
         false);
+
+    return read;
 }
 
-static bool
-    terminal_view_read_data_from_stream(TerminalViewModel* model, FuriStreamBuffer* stream) {
-    const uint8_t* end_of_buffer = model->buffer + sizeof(model->buffer);
-    size_t free = end_of_buffer - model->tail;
-    if(free == 0) {
-        free = sizeof(model->buffer);
-        model->tail = model->buffer;
+static size_t
+    terminal_view_resize_capture(TerminalViewModel* model, size_t size, size_t reserve) {
+    const size_t chunk_size = TERMINAL_VIEW_CAPTURE_CHUNK_SIZE;
+    const size_t current = chunk_arena_size(&model->arena);
+
+    // The current buffer is released before the new one is allocated
+    const size_t max_count = chunk_arena_max_chunk_count(
+        chunk_size, TERMINAL_VIEW_CAPTURE_HEAP_RESERVE + reserve, current);
+    size_t count = (size == 0) ? max_count : MIN(size / chunk_size, max_count);
+    count = MAX(count, 1u);
+
+    if(count * chunk_size == current) {
+        return current; // Keep the content
     }
 
-    size_t read = furi_stream_buffer_receive(stream, model->tail, free, 0);
+    if(size != 0 && count * chunk_size < size) {
+        FURI_LOG_W(TAG, "Not enough memory for %zu bytes capture buffer", size);
+    }
+    FURI_LOG_I(TAG, "Capture buffer: %zu x %zu bytes", count, chunk_size);
 
-    if(read == 0) {
-        return false;
+    chunk_arena_alloc(&model->arena, chunk_size, count);
+    spsc_ring_init_chunked(&model->ring, model->arena.chunks, count, chunk_size);
+    terminal_view_row_cache_invalidate(model);
+    model->transaction_head = 0;
+    model->transaction_tail = 0;
+    model->transaction_start = 0;
+    model->scroll_offset = 0;
+
+    return count * chunk_size;
+}
+
+static void
+    terminal_view_write_data(TerminalViewModel* model, const uint8_t* data, size_t length) {
+    if(model->arena.chunks == NULL) {
+        return; // No capture buffer yet
+    }
+
+    const size_t capacity = spsc_ring_capacity(&model->ring);
+
+    // Only the last capacity bytes would survive anyway
+    if(length > capacity) {
+        data += length - capacity;
+        length = capacity;
+    }
+
+    // Rolling buffer: Make room by dropping the oldest bytes. Only whole frames are dropped, to
+    // keep the oldest byte at the start of a frame.
+    const size_t free_space = spsc_ring_free_space(&model->ring);
+    if(free_space < length) {
+        size_t drop = length - free_space;
+        drop = MIN(
+            (drop + model->frame_size - 1) / model->frame_size * model->frame_size,
+            spsc_ring_size(&model->ring));
+        spsc_ring_consume(&model->ring, drop);
     }
 
-    model->size = model->size + read;
-    if(model->size > sizeof(model->buffer)) {
-        model->size = sizeof(model->buffer);
+    spsc_ring_write(&model->ring, data, length);
+}
+
+static bool
+    terminal_view_read_data_from_ring(TerminalViewModel* model, SpscRing* source, size_t length) {
+    SpscRingSpan spans[2];
+    length = spsc_ring_peek_span(source, 0, length, spans);
+
+    if(length == 0) {
+        return false;
     }
 
-    model->tail = terminal_view_wrap_buffer_pointer(model, model->tail + read);
+    terminal_view_write_data(model, spans[0].data, spans[0].length);
+    terminal_view_write_data(model, spans[1].data, spans[1].length);
+    spsc_ring_consume(source, length);
 
     return true;
 }
 
-void terminal_view_append_data_from_stream(TerminalView* terminal, FuriStreamBuffer* stream) {
+void terminal_view_append_data(TerminalView* terminal, const uint8_t* data, size_t length) {
     furi_check(terminal);
-    furi_check(stream);
+    furi_check(data || length == 0);
+
+    if(length == 0) {
+        return;
+    }
+
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        { terminal_view_write_data(model, data, length); },
+        true);
+}
+
+void terminal_view_append_data_from_ring(TerminalView* terminal, SpscRing* source, size_t length) {
+    furi_check(terminal);
+    furi_check(source);
 
     bool update;
     with_view_model(
         terminal->view,
         TerminalViewModel * model,
-        { update = terminal_view_read_data_from_stream(model, stream); },
+        { update = terminal_view_read_data_from_ring(model, source, length); },
         update)
 }
+
+size_t terminal_view_set_capture_size(TerminalView* terminal, size_t size, size_t reserve) {
+    furi_check(terminal);
+
+    size_t capacity;
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            // A dump may still read the current buffer
+            furi_mutex_acquire(model->capture_lock, FuriWaitForever);
+            capacity = terminal_view_resize_capture(model, size, reserve);
+            furi_mutex_release(model->capture_lock);
+        },
+        true);
+
+    return capacity;
+}
+
+void terminal_view_end_transaction(TerminalView* terminal) {
+    furi_check(terminal);
+
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            const size_t end = spsc_ring_end_position(&model->ring);
+
+            // Empty transactions would not change the layout
+            if(end != model->transaction_start) {
+                if(model->transaction_head - model->transaction_tail ==
+                   TERMINAL_VIEW_TRANSACTION_INDEX_SIZE) {
+                    model->transaction_tail++;
+                }
+
+                TerminalViewTransaction* transaction =
+                    &model->transactions
+                         [model->transaction_head % TERMINAL_VIEW_TRANSACTION_INDEX_SIZE];
+                transaction->start = model->transaction_start;
+                transaction->length = end - model->transaction_start;
+                model->transaction_head++;
+                model->transaction_start = end;
+            }
+        },
+        false);
+}
+
+void terminal_view_keep_last(TerminalView* terminal, size_t length) {
+    furi_check(terminal);
+
+    with_view_model(
+        terminal->view,
+        TerminalViewModel * model,
+        {
+            const size_t size = spsc_ring_size(&model->ring);
+            if(size > length) {
+                // Whole frames, like the rolling buffer
+                size_t drop = size - length;
+                drop = MIN(
+                    (drop + model->frame_size - 1) / model->frame_size * model->frame_size, size);
+                spsc_ring_consume(&model->ring, drop);
+                terminal_view_row_cache_invalidate(model);
+                model->scroll_offset = 0;
+            }
+        },
+        true);
+}
@@ -3,6 +3,11 @@
 #include <gui/view.h>
 #include <gui/scene_manager.h>
 
+#include "../toolbox/chunk_arena.h"
+#include "../toolbox/latency_histogram.h"
+#include "../toolbox/page_cache.h"
+#include "../toolbox/spsc_ring.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,8 +29,42 @@ View* terminal_view_get_view(TerminalView* terminal);
 void terminal_view_free(TerminalView* terminal);
 void terminal_view_reset(TerminalView* terminal);
 void terminal_view_set_display_mode(TerminalView* terminal, TerminalDisplayMode mode);
-void terminal_view_append_data_from_stream(TerminalView* terminal, FuriStreamBuffer* buffer);
-void terminal_view_debug_print_buffer(TerminalView* view);
+// Bytes per SPI frame (1 or 2). Hex and Binary show whole frames. Frames of 2 bytes are stored
+// little endian.
+void terminal_view_set_frame_size(TerminalView* terminal, size_t frame_size);
+// Resizes the capture buffer. 0 uses all free memory, except reserve bytes, which the caller
+// allocates later on, and the heap of the GUI and the CLI. The content is kept, if the resulting
+// size did not change. Returns the actual size, which may be smaller than size on low memory.
+size_t terminal_view_set_capture_size(TerminalView* terminal, size_t size, size_t reserve);
+// Appends up to length bytes from source
+void terminal_view_append_data_from_ring(TerminalView* terminal, SpscRing* source, size_t length);
+void terminal_view_append_data(TerminalView* terminal, const uint8_t* data, size_t length);
+// Ends the transaction, which started at the previous call. Data, which is appended after this
+// call, starts on a new row.
+void terminal_view_end_transaction(TerminalView* terminal);
+void terminal_view_set_overlay_text(TerminalView* terminal, const char* text);
+// Short text like "Armed", which is always shown in the lower right corner. "" hides it.
+void terminal_view_set_status(TerminalView* terminal, const char* status);
+// Drops everything except the newest length bytes, e.g. to cut a capture to a trigger window
+void terminal_view_keep_last(TerminalView* terminal, size_t length);
+// Shows a paged source instead of the capture buffer, e.g. a capture file. NULL shows the capture
+// buffer again. The view does not own pages, it has to stay valid until it is replaced. Left and
+// Right jump through a paged source.
+void terminal_view_set_pages(TerminalView* terminal, PageCache* pages);
+// Scrolls to the row, which contains the byte offset, with the next redraw. Only for a paged
+// source, it does not have transactions.
+void terminal_view_scroll_to(TerminalView* terminal, size_t offset);
+// Stream positions of the oldest byte and after the newest byte of the capture buffer
+void terminal_view_get_capture_range(TerminalView* terminal, size_t* start, size_t* end);
+// Copies up to length bytes of the capture buffer, starting at the stream position, to data. Can
+// be called from another thread, while data is appended or the buffer is resized. Returns the
+// number of copied bytes, 0 if position is at the end or was dropped meanwhile.
+size_t terminal_view_read_capture(
+    TerminalView* terminal,
+    size_t position,
+    uint8_t* data,
+    size_t length);
+void terminal_view_set_draw_profile(TerminalView* terminal, LatencyHistogram* histogram);
 
 #ifdef __cplusplus
 }
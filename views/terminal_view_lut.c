@@ -0,0 +1,54 @@
+#include "terminal_view_lut.h"
+
+#define LUT_PRINTABLE(b) ((b) >= '!' && (b) <= '~')
+
+#define LUT_HEX_DIGIT(n) ((n) < 10 ? '0' + (n) : 'A' + (n) - 10)
+#define LUT_HEX_HIGH(b)  LUT_HEX_DIGIT(((b) >> 4) & 0xF)
+#define LUT_HEX_LOW(b)   LUT_HEX_DIGIT((b) & 0xF)
+
+#define LUT_BIT(b, n) ('0' + (((b) >> (n)) & 1))
+
+// Second char of the C escape sequence, 0 if there is none
+#define LUT_ESCAPE(b)     \
+    ((b) == '\a' ? 'a' :  \
+     (b) == '\b' ? 'b' :  \
+     (b) == '\e' ? 'e' :  \
+     (b) == '\f' ? 'f' :  \
+     (b) == '\n' ? 'n' :  \
+     (b) == '\r' ? 'r' :  \
+     (b) == '\t' ? 't' :  \
+     (b) == '\v' ? 'v' :  \
+     (b) == '\\' ? '\\' : \
+     (b) == '\'' ? '\'' : \
+     (b) == '\"' ? '\"' : \
+     (b) == ' '  ? ' ' :  \
+                   0)
+#define LUT_AUTO_PLAIN(b) (LUT_PRINTABLE(b) && LUT_ESCAPE(b) == 0)
+
+#define LUT_ENTRY_HEX(b) {LUT_HEX_HIGH(b), LUT_HEX_LOW(b)}
+#define LUT_ENTRY_BINARY(b) \
+    {LUT_BIT(b, 7),         \
+     LUT_BIT(b, 6),         \
+     LUT_BIT(b, 5),         \
+     LUT_BIT(b, 4),         \
+     LUT_BIT(b, 3),         \
+     LUT_BIT(b, 2),         \
+     LUT_BIT(b, 1),         \
+     LUT_BIT(b, 0)}
+#define LUT_ENTRY_AUTO(b)                                              \
+    {LUT_AUTO_PLAIN(b) ? (b) : LUT_ESCAPE(b) ? '\\' : LUT_HEX_HIGH(b), \
+     LUT_AUTO_PLAIN(b) ? ' ' : LUT_ESCAPE(b) ? LUT_ESCAPE(b) : LUT_HEX_LOW(b)}
+#define LUT_ENTRY_TEXT(b) (LUT_PRINTABLE(b) ? (b) : ' ')
+
+// Expands entry for every value from 0 to 255
+#define LUT_4(entry, b)  entry(b), entry((b) + 1), entry((b) + 2), entry((b) + 3)
+#define LUT_16(entry, b) \
+    LUT_4(entry, b), LUT_4(entry, (b) + 4), LUT_4(entry, (b) + 8), LUT_4(entry, (b) + 12)
+#define LUT_64(entry, b) \
+    LUT_16(entry, b), LUT_16(entry, (b) + 16), LUT_16(entry, (b) + 32), LUT_16(entry, (b) + 48)
+#define LUT_256(entry) LUT_64(entry, 0), LUT_64(entry, 64), LUT_64(entry, 128), LUT_64(entry, 192)
+
+const char terminal_view_lut_hex[256][2] = {LUT_256(LUT_ENTRY_HEX)};
+const char terminal_view_lut_binary[256][8] = {LUT_256(LUT_ENTRY_BINARY)};
+const char terminal_view_lut_auto[256][2] = {LUT_256(LUT_ENTRY_AUTO)};
+const char terminal_view_lut_text[256] = {LUT_256(LUT_ENTRY_TEXT)};
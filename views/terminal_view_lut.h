@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Glyphs for every byte value, used by the terminal view renderers. The tables are generated by
+// the preprocessor and live in flash. None of them is null terminated.
+
+extern const char terminal_view_lut_hex[256][2];
+extern const char terminal_view_lut_binary[256][8];
+// Char followed by a space, C escape sequence or hex
+extern const char terminal_view_lut_auto[256][2];
+// Char or a space, if it is not printable
+extern const char terminal_view_lut_text[256];